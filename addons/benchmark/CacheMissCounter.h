@@ -0,0 +1,64 @@
+#ifndef _CACHE_MISS_COUNTER_H
+#define _CACHE_MISS_COUNTER_H
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+struct CacheMissCounterInfo {
+	/// file descriptor of the hardware counter (-1 if not available)
+	int fd;
+
+	/// number of cache misses between cache_miss_counter_start() and
+	/// cache_miss_counter_stop() (-1 if not available)
+	long long count;
+};
+
+/// starts counting the cache misses of the calling thread (uses the Linux
+/// perf events and fails silently if they are not available, e.g. because
+/// of kernel.perf_event_paranoid or inside of virtual machines)
+inline void cache_miss_counter_start (CacheMissCounterInfo *counter) {
+	counter->fd = -1;
+	counter->count = -1;
+
+#ifdef __linux__
+	struct perf_event_attr attr;
+	memset (&attr, 0, sizeof (attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof (attr);
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	counter->fd = static_cast<int>(syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0));
+	if (counter->fd == -1)
+		return;
+
+	ioctl (counter->fd, PERF_EVENT_IOC_RESET, 0);
+	ioctl (counter->fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+inline long long cache_miss_counter_stop (CacheMissCounterInfo *counter) {
+#ifdef __linux__
+	if (counter->fd != -1) {
+		ioctl (counter->fd, PERF_EVENT_IOC_DISABLE, 0);
+
+		long long count;
+		if (read (counter->fd, &count, sizeof (count)) == sizeof (count))
+			counter->count = count;
+
+		close (counter->fd);
+		counter->fd = -1;
+	}
+#endif
+
+	return counter->count;
+}
+
+#endif
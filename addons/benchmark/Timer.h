@@ -2,6 +2,7 @@
 #define _TIMER_H
 
 #include <ctime>
+#include <chrono>
 
 struct TimerInfo {
 	/// time stamp when timer_start() gets called
@@ -26,4 +27,10 @@ inline double timer_stop (TimerInfo *timer) {
 	return timer->duration_sec;
 }
 
+/// wall clock time in seconds (clock() adds up the cpu time of all threads
+/// and is therefore unsuitable for multi-threaded code)
+inline double wall_clock_time () {
+	return std::chrono::duration<double> (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 #endif
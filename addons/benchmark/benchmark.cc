@@ -12,6 +12,7 @@
 #include "Human36Model.h"
 #include "SampleData.h"
 #include "Timer.h"
+#include "CacheMissCounter.h"
 
 #ifdef RBDL_BUILD_ADDON_LUAMODEL
 #include "../addons/luamodel/luamodel.h"
@@ -33,13 +34,20 @@ using namespace RigidBodyDynamics::Math;
 
 int benchmark_sample_count = 1000;
 int benchmark_model_max_depth = 5;
+int benchmark_batch_size = 64;
+int benchmark_max_thread_count = 0;
 
 bool benchmark_run_fd_aba = true;
+bool benchmark_run_fd_batch = true;
+bool benchmark_run_fd_simd = true;
+bool benchmark_run_fd_packed = true;
 bool benchmark_run_fd_lagrangian = true;
 bool benchmark_run_id_rnea = true;
 bool benchmark_run_crba = true;
 bool benchmark_run_nle = true;
 bool benchmark_run_contacts = false;
+bool benchmark_run_parallel = true;
+bool benchmark_run_derivatives = true;
 
 string model_file = "";
 
@@ -75,7 +83,167 @@ double run_forward_dynamics_ABA_benchmark (Model *model, int sample_count) {
 	return duration;
 }
 
-double run_forward_dynamics_lagrangian_benchmark (Model *model, int sample_count) {
+double run_forward_dynamics_batch_benchmark (Model *model, int sample_count, int batch_size) {
+	SampleData sample_data;
+	sample_data.fillRandom(model->dof_count, sample_count);
+
+	if (batch_size > sample_count)
+		batch_size = sample_count;
+	if (batch_size < 1)
+		batch_size = 1;
+
+	int batch_count = sample_count / batch_size;
+	int batched_sample_count = batch_count * batch_size;
+
+	vector<MatrixNd> Q (batch_count, MatrixNd (model->q_size, batch_size));
+	vector<MatrixNd> QDot (batch_count, MatrixNd (model->qdot_size, batch_size));
+	vector<MatrixNd> QDDot (batch_count, MatrixNd (model->qdot_size, batch_size));
+	vector<MatrixNd> Tau (batch_count, MatrixNd (model->qdot_size, batch_size));
+
+	for (int i = 0; i < batched_sample_count; i++) {
+		Q[i / batch_size].col(i % batch_size) = sample_data.q[i];
+		QDot[i / batch_size].col(i % batch_size) = sample_data.qdot[i];
+		Tau[i / batch_size].col(i % batch_size) = sample_data.tau[i];
+	}
+
+	TimerInfo tinfo;
+	timer_start (&tinfo);
+
+	for (int i = 0; i < batched_sample_count; i++) {
+		ForwardDynamics (*model,
+				sample_data.q[i],
+				sample_data.qdot[i],
+				sample_data.tau[i],
+				sample_data.qddot[i]);
+	}
+
+	double duration_scalar = timer_stop (&tinfo);
+
+	BatchDynamicsWorkspace ws (*model, batch_size);
+
+	timer_start (&tinfo);
+
+	for (int i = 0; i < batch_count; i++) {
+		ForwardDynamicsBatch (*model, ws, Q[i], QDot[i], Tau[i], QDDot[i]);
+	}
+
+	double duration = timer_stop (&tinfo);
+
+	cout << "#DOF: " << setw(3) << model->dof_count 
+		<< " #samples: " << batched_sample_count 
+		<< " #batch: " << batch_size
+		<< " duration = " << setw(10) << duration << "(s)"
+		<< " (~" << setw(10) << duration / batched_sample_count << "(s) per sample,"
+		<< " scalar ~" << setw(10) << duration_scalar / batched_sample_count << "(s),"
+		<< " speedup " << setw(6) << duration_scalar / duration << ")" << endl;
+
+	return duration;
+}
+
+template <unsigned int L>
+double run_forward_dynamics_simd_benchmark (Model *model, int sample_count) {
+	SampleData sample_data;
+	sample_data.fillRandom(model->dof_count, sample_count);
+
+	MatrixNd Q (model->q_size, sample_count);
+	MatrixNd QDot (model->qdot_size, sample_count);
+	MatrixNd QDDot (model->qdot_size, sample_count);
+	MatrixNd Tau (model->qdot_size, sample_count);
+
+	for (int i = 0; i < sample_count; i++) {
+		Q.col(i) = sample_data.q[i];
+		QDot.col(i) = sample_data.qdot[i];
+		Tau.col(i) = sample_data.tau[i];
+	}
+
+	TimerInfo tinfo;
+	timer_start (&tinfo);
+
+	for (int i = 0; i < sample_count; i++) {
+		ForwardDynamics (*model,
+				sample_data.q[i],
+				sample_data.qdot[i],
+				sample_data.tau[i],
+				sample_data.qddot[i]);
+	}
+
+	double duration_scalar = timer_stop (&tinfo);
+
+	SIMDDynamicsWorkspace<L> ws (*model);
+
+	timer_start (&tinfo);
+
+	ForwardDynamicsSIMD (*model, ws, Q, QDot, Tau, QDDot);
+
+	double duration = timer_stop (&tinfo);
+
+	cout << "#DOF: " << setw(3) << model->dof_count 
+		<< " #samples: " << sample_count 
+		<< " #lanes: " << L
+		<< " duration = " << setw(10) << duration << "(s)"
+		<< " (~" << setw(10) << duration / sample_count << "(s) per sample,"
+		<< " scalar ~" << setw(10) << duration_scalar / sample_count << "(s),"
+		<< " speedup " << setw(6) << duration_scalar / duration << ")" << endl;
+
+	return duration;
+}
+
+double run_forward_dynamics_packed_benchmark (Model *model, int sample_count) {
+	SampleData sample_data;
+	sample_data.fillRandom(model->dof_count, sample_count);
+
+	PackedDynamicsWorkspace ws_aos (*model, PackedLayoutAoS);
+	PackedDynamicsWorkspace ws_soa (*model, PackedLayoutSoA);
+
+	const char *names[3] = { "vectors", "packed AoS", "packed SoA" };
+	double duration_vectors = 0.;
+
+	for (int method = 0; method < 3; method++) {
+		TimerInfo tinfo;
+		CacheMissCounterInfo cinfo;
+		timer_start (&tinfo);
+		cache_miss_counter_start (&cinfo);
+
+		for (int i = 0; i < sample_count; i++) {
+			if (method == 0) {
+				ForwardDynamics (*model,
+						sample_data.q[i],
+						sample_data.qdot[i],
+						sample_data.tau[i],
+						sample_data.qddot[i]);
+			} else {
+				ForwardDynamicsPacked (*model,
+						method == 1 ? ws_aos : ws_soa,
+						sample_data.q[i],
+						sample_data.qdot[i],
+						sample_data.tau[i],
+						sample_data.qddot[i]);
+			}
+		}
+
+		long long cache_misses = cache_miss_counter_stop (&cinfo);
+		double duration = timer_stop (&tinfo);
+
+		if (method == 0)
+			duration_vectors = duration;
+
+		cout << "#DOF: " << setw(3) << model->dof_count 
+			<< " " << setw(10) << left << names[method] << right
+			<< " duration = " << setw(10) << duration << "(s)"
+			<< " (~" << setw(10) << duration / sample_count << "(s) per call,"
+			<< " speedup " << setw(6) << duration_vectors / duration << ","
+			<< " cache misses ";
+
+		if (cache_misses >= 0)
+			cout << setw(8) << static_cast<double>(cache_misses) / sample_count << " per call)" << endl;
+		else
+			cout << "n/a)" << endl;
+	}
+
+	return duration_vectors;
+}
+
+double run_forward_dynamics_lagrangian_benchmark (Model *model, int sample_count, Math::LinearSolver linear_solver = Math::LinearSolverPartialPivLU) {
 	SampleData sample_data;
 	sample_data.fillRandom(model->dof_count, sample_count);
 
@@ -91,7 +259,7 @@ double run_forward_dynamics_lagrangian_benchmark (Model *model, int sample_count
 				sample_data.qdot[i],
 				sample_data.tau[i],
 				sample_data.qddot[i],
-				Math::LinearSolverPartialPivLU,
+				linear_solver,
 				NULL,
 				&H,
 				&C
@@ -437,6 +605,285 @@ double contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
 	return duration;
 }
 
+double contacts_scaling_benchmark (int sample_count) {
+	// initialize the human model
+	Model *model = new Model();
+	generate_human36model(model);
+
+	unsigned int foot_r = model->GetBodyId ("foot_r");
+	unsigned int foot_l = model->GetBodyId ("foot_l");
+
+	cout << "= #DOF: " << setw(3) << model->dof_count << endl;
+	cout << "= #samples: " << sample_count << endl;
+	cout << "= duration per call in (s), more than 6 constraints per foot are redundant" << endl;
+	cout << "#constraints "
+		<< setw(12) << "Lagrangian"
+		<< setw(12) << "RangeSparse"
+		<< setw(12) << "NullSpace"
+		<< setw(12) << "Kokkevis" << endl;
+
+	double duration = 0.;
+
+	for (unsigned int count = 2; count <= 24; count += 2) {
+		ConstraintSet constraint_set;
+
+		// alternately add the constraints to the feet such that each foot
+		// gets contact points at its heel and toes with the normals along
+		// all three axes
+		for (unsigned int ci = 0; ci < count; ci++) {
+			unsigned int foot_id = ci % 2 == 0 ? foot_r : foot_l;
+			unsigned int k = ci / 2;
+			Vector3d normal (Vector3d::Zero());
+			normal[k % 3] = 1.;
+			Vector3d point (0.15 - 0.2 * ((k / 3) % 2), 0.03 * (k / 6 == 0 ? 1. : -1.), -0.05);
+
+			constraint_set.AddConstraint (foot_id, point, normal);
+		}
+		constraint_set.Bind (*model);
+
+		cout << setw(12) << count;
+		duration = run_contacts_lagrangian_benchmark (model, &constraint_set, sample_count);
+		cout << setw(12) << duration / sample_count;
+		duration = run_contacts_lagrangian_sparse_benchmark (model, &constraint_set, sample_count);
+		cout << setw(12) << duration / sample_count;
+		duration = run_contacts_null_space (model, &constraint_set, sample_count);
+		cout << setw(12) << duration / sample_count;
+		duration = run_contacts_kokkevis_benchmark (model, &constraint_set, sample_count);
+		cout << setw(12) << duration / sample_count << endl;
+	}
+
+	delete model;
+
+	return duration;
+}
+
+double contacts_friction_benchmark (int sample_count) {
+	// initialize the human model
+	Model *model = new Model();
+	generate_human36model(model);
+
+	unsigned int foot_r = model->GetBodyId ("foot_r");
+	unsigned int foot_l = model->GetBodyId ("foot_l");
+
+	// four frictional contacts at the corners of each foot
+	ConstraintSet constraint_set;
+	for (unsigned int k = 0; k < 4; k++) {
+		Vector3d point (0.15 - 0.2 * (k / 2), 0.03 * (k % 2 == 0 ? 1. : -1.), -0.05);
+		constraint_set.AddFrictionContact (foot_r, point, Vector3d (0., 0., 1.), 0.8);
+		constraint_set.AddFrictionContact (foot_l, point, Vector3d (0., 0., 1.), 0.8);
+	}
+	constraint_set.Bind (*model);
+
+	// a slowly changing state as during a simulation at control rate
+	SampleData sample_data;
+	sample_data.fillRandom(model->dof_count, 1);
+
+	VectorNd q (sample_data.q[0]);
+	VectorNd qdot (sample_data.qdot[0]);
+	VectorNd tau (sample_data.tau[0]);
+	VectorNd qddot (VectorNd::Zero (model->qdot_size));
+
+	cout << "= #DOF: " << setw(3) << model->dof_count << endl;
+	cout << "= #samples: " << sample_count << endl;
+	cout << "= #constraints: " << constraint_set.size() << endl;
+	cout << "= max. iterations: " << constraint_set.friction_max_iterations << endl;
+	cout << setw(12) << "start" << setw(16) << "duration (s)" << setw(16) << "iterations" << endl;
+
+	double duration = 0.;
+
+	for (unsigned int warm_start = 0; warm_start < 2; warm_start++) {
+		unsigned long iterations = 0;
+		constraint_set.force.setZero();
+
+		TimerInfo tinfo;
+		timer_start (&tinfo);
+
+		for (int i = 0; i < sample_count; i++) {
+			if (!warm_start)
+				constraint_set.force.setZero();
+
+			q += 1.0e-3 * qdot;
+			ForwardDynamicsContactsFriction (*model, q, qdot, tau, constraint_set, qddot);
+			iterations += constraint_set.friction_iterations;
+		}
+
+		duration = timer_stop (&tinfo);
+
+		cout << setw(12) << (warm_start ? "warm" : "cold")
+			<< setw(16) << duration / sample_count
+			<< setw(16) << static_cast<double>(iterations) / sample_count << endl;
+	}
+
+	delete model;
+
+	return duration;
+}
+
+double parallel_scaling_benchmark (int sample_count, int max_thread_count) {
+	// initialize the human model
+	Model *model = new Model();
+	generate_human36model(model);
+
+	ConstraintSet feet_constraints;
+	feet_constraints.linear_solver = LinearSolverPartialPivLU;
+
+	unsigned int foot_r = model->GetBodyId ("foot_r");
+	unsigned int foot_l = model->GetBodyId ("foot_l");
+
+	feet_constraints.AddConstraint (foot_r, Vector3d (0.1, 0., -0.05), Vector3d (1., 0., 0.));
+	feet_constraints.AddConstraint (foot_r, Vector3d (0.1, 0., -0.05), Vector3d (0., 1., 0.));
+	feet_constraints.AddConstraint (foot_r, Vector3d (0.1, 0., -0.05), Vector3d (0., 0., 1.));
+	feet_constraints.AddConstraint (foot_l, Vector3d (0.1, 0., -0.05), Vector3d (1., 0., 0.));
+	feet_constraints.AddConstraint (foot_l, Vector3d (0.1, 0., -0.05), Vector3d (0., 1., 0.));
+	feet_constraints.AddConstraint (foot_l, Vector3d (0.1, 0., -0.05), Vector3d (0., 0., 1.));
+	feet_constraints.Bind (*model);
+
+	SampleData sample_data;
+	sample_data.fillRandom(model->dof_count, sample_count);
+
+	MatrixNd Q (model->q_size, sample_count);
+	MatrixNd QDot (model->qdot_size, sample_count);
+	MatrixNd QDDot (model->qdot_size, sample_count);
+	MatrixNd Tau (model->qdot_size, sample_count);
+	std::vector<MatrixNd> H;
+
+	for (int i = 0; i < sample_count; i++) {
+		Q.col(i) = sample_data.q[i];
+		QDot.col(i) = sample_data.qdot[i];
+		QDDot.col(i) = sample_data.qddot[i];
+		Tau.col(i) = sample_data.tau[i];
+	}
+
+	if (max_thread_count < 1) {
+		ThreadPool pool;
+		max_thread_count = pool.GetThreadCount();
+	}
+
+	const char *names[4] = { "ForwardDynamics", "InverseDynamics", "CRBA", "ForwardDynamicsContactsDirect" };
+	double durations_single[4] = { 0., 0., 0., 0. };
+
+	cout << "= #DOF: " << setw(3) << model->dof_count << endl;
+	cout << "= #samples: " << sample_count << endl;
+
+	for (int thread_count = 1; thread_count <= max_thread_count; thread_count++) {
+		ParallelDynamicsWorkspace ws (*model, thread_count);
+
+		// warm up: starts the threads and binds the constraint sets
+		ForwardDynamicsContactsParallel (*model, ws, Q, QDot, Tau, feet_constraints, QDDot);
+
+		for (int method = 0; method < 4; method++) {
+			double time_start = wall_clock_time();
+
+			if (method == 0) {
+				ForwardDynamicsParallel (*model, ws, Q, QDot, Tau, QDDot);
+			} else if (method == 1) {
+				InverseDynamicsParallel (*model, ws, Q, QDot, QDDot, Tau);
+			} else if (method == 2) {
+				CompositeRigidBodyAlgorithmParallel (*model, ws, Q, H);
+			} else {
+				ForwardDynamicsContactsParallel (*model, ws, Q, QDot, Tau, feet_constraints, QDDot);
+			}
+
+			double duration = wall_clock_time() - time_start;
+
+			if (thread_count == 1)
+				durations_single[method] = duration;
+
+			cout << "#threads: " << setw(3) << thread_count
+				<< " " << setw(30) << left << names[method] << right
+				<< " duration = " << setw(10) << duration << "(s)"
+				<< " (~" << setw(10) << duration / sample_count << "(s) per sample,"
+				<< " speedup " << setw(6) << durations_single[method] / duration 
+				<< ", efficiency " << setw(6) << durations_single[method] / duration / thread_count << ")" << endl;
+		}
+	}
+
+	delete model;
+
+	return 0.;
+}
+
+double derivatives_benchmark (int sample_count) {
+	// initialize the human model
+	Model *model = new Model();
+	generate_human36model(model);
+
+	unsigned int n = model->qdot_size;
+
+	SampleData sample_data;
+	sample_data.fillRandom(model->dof_count, sample_count);
+
+	DynamicsDerivativesWorkspace dws (*model);
+	MatrixNd dqddot_dq (MatrixNd::Zero (n, n));
+	MatrixNd dqddot_dqdot (MatrixNd::Zero (n, n));
+	MatrixNd dqddot_dtau (MatrixNd::Zero (n, n));
+
+	cout << "= #DOF: " << setw(3) << model->dof_count << endl;
+	cout << "= #samples: " << sample_count << endl;
+
+	TimerInfo tinfo;
+	timer_start (&tinfo);
+
+	for (int i = 0; i < sample_count; i++) {
+		ForwardDynamicsDerivatives (*model, *model, dws,
+				sample_data.q[i],
+				sample_data.qdot[i],
+				sample_data.tau[i],
+				sample_data.qddot[i],
+				dqddot_dq,
+				dqddot_dqdot,
+				dqddot_dtau
+				);
+	}
+
+	double duration_analytical = timer_stop (&tinfo);
+
+	cout << "Analytical derivatives:      "
+		<< " duration = " << setw(10) << duration_analytical << "(s)"
+		<< " (~" << setw(10) << duration_analytical / sample_count << "(s) per call)" << endl;
+
+	// forward differences need 2 n + 1 evaluations of the forward dynamics
+	const double h = 1.0e-8;
+	VectorNd q (VectorNd::Zero (n));
+	VectorNd qdot (VectorNd::Zero (n));
+	VectorNd tau (VectorNd::Zero (n));
+	VectorNd qddot (VectorNd::Zero (n));
+	VectorNd qddot_h (VectorNd::Zero (n));
+
+	timer_start (&tinfo);
+
+	for (int i = 0; i < sample_count; i++) {
+		q = sample_data.q[i];
+		qdot = sample_data.qdot[i];
+		tau = sample_data.tau[i];
+
+		ForwardDynamics (*model, q, qdot, tau, qddot);
+
+		for (unsigned int k = 0; k < n; k++) {
+			q[k] += h;
+			ForwardDynamics (*model, q, qdot, tau, qddot_h);
+			dqddot_dq.col(k) = (qddot_h - qddot) / h;
+			q[k] = sample_data.q[i][k];
+
+			qdot[k] += h;
+			ForwardDynamics (*model, q, qdot, tau, qddot_h);
+			dqddot_dqdot.col(k) = (qddot_h - qddot) / h;
+			qdot[k] = sample_data.qdot[i][k];
+		}
+	}
+
+	double duration_fd = timer_stop (&tinfo);
+
+	cout << "Finite differences (q, qdot):"
+		<< " duration = " << setw(10) << duration_fd << "(s)"
+		<< " (~" << setw(10) << duration_fd / sample_count << "(s) per call,"
+		<< " analytical speedup " << setw(6) << duration_fd / duration_analytical << ")" << endl;
+
+	delete model;
+
+	return duration_analytical;
+}
+
 void print_usage () {
 #if defined (RBDL_BUILD_ADDON_LUAMODEL) || defined (RBDL_BUILD_ADDON_URDFREADER)
 	cout << "Usage: benchmark [--count|-c <sample_count>] [--depth|-d <depth>] <model.lua>" << endl;
@@ -451,6 +898,14 @@ void print_usage () {
 	cout << "  --no-fd                     : disables benchmarking of forward dynamics." << endl;
 	cout << "  --no-fd-aba                 : disables benchmark for forwards dynamics using" << endl;
 	cout << "                                the Articulated Body Algorithm" << endl;
+	cout << "  --no-fd-batch               : disables benchmark for batched forward dynamics" << endl;
+	cout << "                                using the Articulated Body Algorithm." << endl;
+	cout << "  --no-fd-simd                : disables benchmark for forward dynamics using" << endl;
+	cout << "                                the SIMD Articulated Body Algorithm." << endl;
+	cout << "  --no-fd-packed              : disables benchmark for forward dynamics using" << endl;
+	cout << "                                the packed workspace (AoS and SoA layouts)." << endl;
+	cout << "  --batch-size | -b <size>    : sets the number of states per call of the" << endl;
+	cout << "                                batched forward dynamics (default: 64)." << endl;
 	cout << "  --no-fd-lagrangian          : disables benchmark for forward dynamics via" << endl;
 	cout << "                                solving the lagrangian equation." << endl;
 	cout << "  --no-id-rnea                : disables benchmark for inverse dynamics using" << endl;
@@ -460,16 +915,29 @@ void print_usage () {
 	cout << "  --no-nle                    : disables benchmark for the nonlinear effects." << endl;
 	cout << "                                body algorithm." << endl;
 	cout << "  --only-contacts | -C        : only runs contact model benchmarks." << endl;
+	cout << "  --no-derivatives            : disables the benchmark of the analytical" << endl;
+	cout << "                                dynamics derivatives." << endl;
+	cout << "  --no-parallel               : disables the thread scaling benchmark of the" << endl;
+	cout << "                                parallel algorithms." << endl;
+	cout << "  --only-parallel | -P        : only runs the thread scaling benchmark." << endl;
+	cout << "  --threads | -t <count>      : sets the maximum number of threads for the" << endl;
+	cout << "                                scaling benchmark (default: number of" << endl;
+	cout << "                                hardware threads)." << endl;
 	cout << "  --help | -h                 : prints this help." << endl;
 }
 
 void disable_all_benchmarks () {
 	benchmark_run_fd_aba = false;
+	benchmark_run_fd_batch = false;
+	benchmark_run_fd_simd = false;
+	benchmark_run_fd_packed = false;
 	benchmark_run_fd_lagrangian = false;
 	benchmark_run_id_rnea = false;
 	benchmark_run_crba = false;
 	benchmark_run_nle = false;
 	benchmark_run_contacts = false;
+	benchmark_run_parallel = false;
+	benchmark_run_derivatives = false;
 }
 
 void parse_args (int argc, char* argv[]) {
@@ -505,11 +973,44 @@ void parse_args (int argc, char* argv[]) {
 			stringstream depth_stream (argv[argi]);
 
 			depth_stream >> benchmark_model_max_depth;
+		} else if (arg == "--batch-size" || arg == "-b" ) {
+			if (argi == argc - 1) {
+				print_usage();
+
+				cerr << "Error: missing number for batch size!" << endl;
+				exit (1);
+			}
+
+			argi++;
+			stringstream batch_stream (argv[argi]);
+
+			batch_stream >> benchmark_batch_size;
+		} else if (arg == "--threads" || arg == "-t" ) {
+			if (argi == argc - 1) {
+				print_usage();
+
+				cerr << "Error: missing number of threads!" << endl;
+				exit (1);
+			}
+
+			argi++;
+			stringstream threads_stream (argv[argi]);
+
+			threads_stream >> benchmark_max_thread_count;
 		} else if (arg == "--no-fd" ) {
 			benchmark_run_fd_aba = false;
+			benchmark_run_fd_batch = false;
+			benchmark_run_fd_simd = false;
+			benchmark_run_fd_packed = false;
 			benchmark_run_fd_lagrangian = false;
 		} else if (arg == "--no-fd-aba" ) {
 			benchmark_run_fd_aba = false;
+		} else if (arg == "--no-fd-batch" ) {
+			benchmark_run_fd_batch = false;
+		} else if (arg == "--no-fd-simd" ) {
+			benchmark_run_fd_simd = false;
+		} else if (arg == "--no-fd-packed" ) {
+			benchmark_run_fd_packed = false;
 		} else if (arg == "--no-fd-lagrangian" ) {
 			benchmark_run_fd_lagrangian = false;
 		} else if (arg == "--no-id-rnea" ) {
@@ -521,6 +1022,13 @@ void parse_args (int argc, char* argv[]) {
 		} else if (arg == "--only-contacts" || arg == "-C") {
 			disable_all_benchmarks();
 			benchmark_run_contacts = true;
+		} else if (arg == "--no-derivatives" ) {
+			benchmark_run_derivatives = false;
+		} else if (arg == "--no-parallel" ) {
+			benchmark_run_parallel = false;
+		} else if (arg == "--only-parallel" || arg == "-P") {
+			disable_all_benchmarks();
+			benchmark_run_parallel = true;
 #if defined (RBDL_BUILD_ADDON_LUAMODEL) || defined (RBDL_BUILD_ADDON_URDFREADER)
 		} else if (model_file == "") {
 			model_file = arg;
@@ -564,9 +1072,28 @@ int main (int argc, char *argv[]) {
 			run_forward_dynamics_ABA_benchmark (model, benchmark_sample_count);
 		}
 
+		if (benchmark_run_fd_batch) {
+			cout << "= Forward Dynamics: ABA (batched) =" << endl;
+			run_forward_dynamics_batch_benchmark (model, benchmark_sample_count, benchmark_batch_size);
+		}
+
+		if (benchmark_run_fd_simd) {
+			cout << "= Forward Dynamics: ABA (SIMD) =" << endl;
+			run_forward_dynamics_simd_benchmark<1> (model, benchmark_sample_count);
+			run_forward_dynamics_simd_benchmark<RBDL_SIMD_LANES> (model, benchmark_sample_count);
+		}
+
+		if (benchmark_run_fd_packed) {
+			cout << "= Forward Dynamics: ABA (packed workspace) =" << endl;
+			run_forward_dynamics_packed_benchmark (model, benchmark_sample_count);
+		}
+
 		if (benchmark_run_fd_lagrangian) {
 			cout << "= Forward Dynamics: Lagrangian (Piv. LU decomposition) =" << endl;
 			run_forward_dynamics_lagrangian_benchmark (model, benchmark_sample_count);
+
+			cout << "= Forward Dynamics: Lagrangian (sparse LTL factorization) =" << endl;
+			run_forward_dynamics_lagrangian_benchmark (model, benchmark_sample_count, Math::LinearSolverSparseLTL);
 		}
 
 		if (benchmark_run_id_rnea) {
@@ -607,6 +1134,52 @@ int main (int argc, char *argv[]) {
 		cout << endl;
 	}
 
+	if (benchmark_run_fd_batch) {
+		cout << "= Forward Dynamics: ABA (batched) =" << endl;
+		for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
+			model = new Model();
+			model->gravity = Vector3d (0., -9.81, 0.);
+
+			generate_planar_tree (model, depth);
+
+			run_forward_dynamics_batch_benchmark (model, benchmark_sample_count, benchmark_batch_size);
+
+			delete model;
+		}
+		cout << endl;
+	}
+
+	if (benchmark_run_fd_simd) {
+		cout << "= Forward Dynamics: ABA (SIMD) =" << endl;
+		for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
+			model = new Model();
+			model->gravity = Vector3d (0., -9.81, 0.);
+
+			generate_planar_tree (model, depth);
+
+			run_forward_dynamics_simd_benchmark<1> (model, benchmark_sample_count);
+			run_forward_dynamics_simd_benchmark<RBDL_SIMD_LANES> (model, benchmark_sample_count);
+
+			delete model;
+		}
+		cout << endl;
+	}
+
+	if (benchmark_run_fd_packed) {
+		cout << "= Forward Dynamics: ABA (packed workspace) =" << endl;
+		for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
+			model = new Model();
+			model->gravity = Vector3d (0., -9.81, 0.);
+
+			generate_planar_tree (model, depth);
+
+			run_forward_dynamics_packed_benchmark (model, benchmark_sample_count);
+
+			delete model;
+		}
+		cout << endl;
+	}
+
 	if (benchmark_run_fd_lagrangian) {
 		cout << "= Forward Dynamics: Lagrangian (Piv. LU decomposition) =" << endl;
 		for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
@@ -622,6 +1195,21 @@ int main (int argc, char *argv[]) {
 		cout << endl;
 	}
 
+	if (benchmark_run_fd_lagrangian) {
+		cout << "= Forward Dynamics: Lagrangian (sparse LTL factorization) =" << endl;
+		for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
+			model = new Model();
+			model->gravity = Vector3d (0., -9.81, 0.);
+
+			generate_planar_tree (model, depth);
+
+			run_forward_dynamics_lagrangian_benchmark (model, benchmark_sample_count, Math::LinearSolverSparseLTL);
+
+			delete model;
+		}
+		cout << endl;
+	}
+
 	if (benchmark_run_id_rnea) {
 		cout << "= Inverse Dynamics: RNEA =" << endl;
 		for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
@@ -679,6 +1267,22 @@ int main (int argc, char *argv[]) {
 
 		cout << "= Contacts: ForwardDynamicsContactsKokkevis" << endl;
 		contacts_benchmark (benchmark_sample_count, ContactsMethodKokkevis);
+
+		cout << "= Contacts: scaling with the number of foot contacts on the Human36 model" << endl;
+		contacts_scaling_benchmark (benchmark_sample_count);
+
+		cout << "= Contacts: ForwardDynamicsContactsFriction with eight foot contacts on the Human36 model" << endl;
+		contacts_friction_benchmark (benchmark_sample_count);
+	}
+
+	if (benchmark_run_derivatives) {
+		cout << "= Derivatives: ForwardDynamicsDerivatives vs. finite differences on the Human36 model" << endl;
+		derivatives_benchmark (benchmark_sample_count);
+	}
+
+	if (benchmark_run_parallel) {
+		cout << "= Parallel: thread scaling on the Human36 model" << endl;
+		parallel_scaling_benchmark (benchmark_sample_count, benchmark_max_thread_count);
 	}
 
 	return 0;
@@ -0,0 +1,1085 @@
+#include <rbdl/rbdl.h>
+
+#include <cstdlib>
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "codegen.h"
+
+using namespace std;
+
+namespace RigidBodyDynamics {
+
+using namespace Math;
+
+namespace Addons {
+
+/** \brief Operator precedence of generated expressions (used to decide
+ * where parentheses are required) */
+enum CodegenPrecedence {
+	CodegenPrecedenceAtom = 0,
+	CodegenPrecedenceProduct,
+	CodegenPrecedenceSum
+};
+
+/** \brief A scalar of the generated code
+ *
+ * Either a constant that is known at generation time or a C++ expression.
+ * All arithmetic on constants is carried out during generation, products
+ * with zero or one and sums with zero are folded away.
+ */
+struct CodegenExpr {
+	CodegenExpr () :
+		is_constant (true),
+		value (0.),
+		level (CodegenPrecedenceAtom),
+		is_negation (false),
+		negated_level (CodegenPrecedenceAtom)
+	{}
+	CodegenExpr (double value) :
+		is_constant (true),
+		value (value),
+		level (CodegenPrecedenceAtom),
+		is_negation (false),
+		negated_level (CodegenPrecedenceAtom)
+	{}
+	CodegenExpr (const std::string &code, int level = CodegenPrecedenceAtom) :
+		is_constant (false),
+		value (0.),
+		code (code),
+		level (level),
+		is_negation (false),
+		negated_level (CodegenPrecedenceAtom)
+	{}
+
+	bool isZero () const {
+		return is_constant && value == 0.;
+	}
+	bool isOne () const {
+		return is_constant && value == 1.;
+	}
+	bool isNegative () const {
+		return (is_constant && value < 0.) || is_negation;
+	}
+
+	bool is_constant;
+	double value;
+	std::string code;
+	int level;
+
+	/// \brief If the expression is -x, x is stored here for sign folding
+	bool is_negation;
+	std::string negated_code;
+	int negated_level;
+};
+
+/// \brief Shortest decimal representation that reads back as the same double
+static std::string codegen_literal (double value) {
+	std::string result;
+
+	for (int precision = 1; precision <= 17; precision++) {
+		std::ostringstream out;
+		out << std::setprecision (precision) << value;
+		result = out.str();
+
+		if (strtod (result.c_str(), NULL) == value)
+			break;
+	}
+
+	if (result.find_first_of (".e") == std::string::npos)
+		result += ".";
+
+	return result;
+}
+
+static std::string codegen_str (const CodegenExpr &e) {
+	if (e.is_constant)
+		return codegen_literal (e.value);
+
+	return e.code;
+}
+
+/// \brief Renders e as an operand of an operator with the given precedence
+static std::string codegen_operand (const CodegenExpr &e, int max_level) {
+	int level = e.level;
+	if (e.is_constant && e.value < 0.)
+		level = CodegenPrecedenceProduct;
+
+	if (level > max_level)
+		return "(" + codegen_str (e) + ")";
+
+	return codegen_str (e);
+}
+
+static CodegenExpr operator- (const CodegenExpr &a) {
+	if (a.is_constant)
+		return CodegenExpr (-a.value);
+
+	if (a.is_negation)
+		return CodegenExpr (a.negated_code, a.negated_level);
+
+	CodegenExpr result ("-" + codegen_operand (a, CodegenPrecedenceProduct), CodegenPrecedenceProduct);
+	result.is_negation = true;
+	result.negated_code = a.code;
+	result.negated_level = a.level;
+
+	return result;
+}
+
+static CodegenExpr operator- (const CodegenExpr &a, const CodegenExpr &b);
+
+static CodegenExpr operator+ (const CodegenExpr &a, const CodegenExpr &b) {
+	if (a.is_constant && b.is_constant)
+		return CodegenExpr (a.value + b.value);
+	if (a.isZero())
+		return b;
+	if (b.isZero())
+		return a;
+	if (b.isNegative())
+		return a - (-b);
+	if (a.isNegative())
+		return b - (-a);
+
+	// a sum that starts with a negative term, e.g. -x - y
+	std::string b_code = codegen_str (b);
+	if (b_code[0] == '-')
+		return CodegenExpr (codegen_str (a) + " - " + b_code.substr (1), CodegenPrecedenceSum);
+
+	return CodegenExpr (codegen_str (a) + " + " + b_code, CodegenPrecedenceSum);
+}
+
+static CodegenExpr operator- (const CodegenExpr &a, const CodegenExpr &b) {
+	if (a.is_constant && b.is_constant)
+		return CodegenExpr (a.value - b.value);
+	if (b.isZero())
+		return a;
+	if (a.isZero())
+		return -b;
+	if (b.isNegative())
+		return a + (-b);
+
+	return CodegenExpr (codegen_str (a) + " - " + codegen_operand (b, CodegenPrecedenceProduct), CodegenPrecedenceSum);
+}
+
+static CodegenExpr operator* (const CodegenExpr &a, const CodegenExpr &b) {
+	if (a.is_constant && b.is_constant)
+		return CodegenExpr (a.value * b.value);
+	if (a.isZero() || b.isZero())
+		return CodegenExpr (0.);
+	if (a.isOne())
+		return b;
+	if (b.isOne())
+		return a;
+	if (a.isNegative())
+		return -((-a) * b);
+	if (b.isNegative())
+		return -(a * (-b));
+
+	return CodegenExpr (codegen_operand (a, CodegenPrecedenceProduct) + " * " + codegen_operand (b, CodegenPrecedenceProduct), CodegenPrecedenceProduct);
+}
+
+static CodegenExpr operator/ (const CodegenExpr &a, const CodegenExpr &b) {
+	if (a.is_constant && b.is_constant)
+		return CodegenExpr (a.value / b.value);
+	if (a.isZero())
+		return CodegenExpr (0.);
+	if (b.isOne())
+		return a;
+	if (a.isNegative())
+		return -((-a) / b);
+	if (b.isNegative())
+		return -(a / (-b));
+
+	return CodegenExpr (codegen_operand (a, CodegenPrecedenceProduct) + " / " + codegen_operand (b, CodegenPrecedenceAtom), CodegenPrecedenceProduct);
+}
+
+static CodegenExpr codegen_input (const char *name, unsigned int index) {
+	std::ostringstream code;
+	code << name << "[" << index << "]";
+	return CodegenExpr (code.str());
+}
+
+/** \brief Collects the statements of a single generated function
+ *
+ * Intermediate values are stored in constants t0, t1, ... . Statements
+ * whose values are not needed for any output are removed when the
+ * function is written.
+ */
+struct CodegenWriter {
+	CodegenWriter () : temp_count (0) {}
+
+	struct Statement {
+		/// \brief Index of the defined constant or -1 for outputs
+		int temp_index;
+		std::string code;
+	};
+
+	/** \brief Stores e in a new constant unless it is trivial (or always
+	 * if force is true, e.g. for function calls) */
+	CodegenExpr define (const CodegenExpr &e, bool force = false) {
+		if (e.is_constant)
+			return e;
+		if (!force && e.level == CodegenPrecedenceAtom)
+			return e;
+		if (!force && e.is_negation && e.negated_level == CodegenPrecedenceAtom)
+			return e;
+
+		std::ostringstream name;
+		name << "t" << temp_count;
+
+		Statement statement;
+		statement.temp_index = temp_count;
+		statement.code = "const double " + name.str() + " = " + codegen_str (e) + ";";
+		statements.push_back (statement);
+		temp_count++;
+
+		return CodegenExpr (name.str());
+	}
+
+	void define (CodegenExpr *values, unsigned int count) {
+		for (unsigned int i = 0; i < count; i++)
+			values[i] = define (values[i]);
+	}
+
+	/// \brief Adds an output statement
+	void assign (const std::string &lhs, const CodegenExpr &e) {
+		Statement statement;
+		statement.temp_index = -1;
+		statement.code = lhs + " = " + codegen_str (e) + ";";
+		statements.push_back (statement);
+	}
+
+	/// \brief Writes all statements that contribute to an output
+	void write (std::ostream &out) const {
+		std::vector<bool> used (temp_count, false);
+		std::vector<bool> keep (statements.size(), false);
+
+		for (int i = (int) statements.size() - 1; i >= 0; i--) {
+			const Statement &statement = statements[i];
+			if (statement.temp_index >= 0 && !used[statement.temp_index])
+				continue;
+
+			keep[i] = true;
+
+			// mark all constants t<number> that are referenced
+			const std::string &code = statement.code;
+			for (std::string::size_type k = 0; k < code.size(); k++) {
+				if (code[k] != 't' || (k > 0 && (isalnum (code[k - 1]) || code[k - 1] == '_')))
+					continue;
+
+				std::string::size_type end = k + 1;
+				while (end < code.size() && isdigit (code[end]))
+					end++;
+
+				if (end == k + 1)
+					continue;
+
+				unsigned int index = atoi (code.substr (k + 1, end - k - 1).c_str());
+				if (index < temp_count && (int) index != statement.temp_index)
+					used[index] = true;
+			}
+		}
+
+		for (unsigned int i = 0; i < statements.size(); i++) {
+			if (keep[i])
+				out << "\t" << statements[i].code << std::endl;
+		}
+	}
+
+	std::vector<Statement> statements;
+	unsigned int temp_count;
+};
+
+/** \brief Writes a function with the statements of w
+ *
+ * \param head       return type and name of the function
+ * \param parameters comma separated pointer parameters, the names of
+ * parameters that are not used by any statement are omitted
+ */
+static void codegen_write_function (std::ostream &out, const std::string &head, const std::string &parameters, const CodegenWriter &w) {
+	std::ostringstream body;
+	w.write (body);
+
+	out << head << " (";
+
+	std::string::size_type begin = 0;
+	while (begin < parameters.size()) {
+		std::string::size_type end = parameters.find (", ", begin);
+		if (end == std::string::npos)
+			end = parameters.size();
+
+		std::string parameter = parameters.substr (begin, end - begin);
+		std::string::size_type name_begin = parameter.rfind ('*') + 1;
+		std::string name = parameter.substr (name_begin);
+
+		if (begin > 0)
+			out << ", ";
+
+		if (body.str().find (name + "[") != std::string::npos)
+			out << parameter;
+		else
+			out << parameter.substr (0, name_begin);
+
+		begin = end + 2;
+	}
+
+	out << ") {" << std::endl
+		<< body.str()
+		<< "}" << std::endl;
+}
+
+struct CodegenVector6 {
+	CodegenExpr v[6];
+};
+
+/// \brief Spatial transform with E stored row by row
+struct CodegenTransform {
+	CodegenExpr E[9];
+	CodegenExpr r[3];
+};
+
+struct CodegenInertia {
+	CodegenExpr m;
+	CodegenExpr h[3];
+	/// \brief Inertia at the origin stored row by row
+	CodegenExpr I[9];
+};
+
+struct CodegenMatrix6 {
+	CodegenExpr e[36];
+};
+
+static void codegen_cross (const CodegenExpr *a, const CodegenExpr *b, CodegenExpr *result) {
+	CodegenExpr c0 = a[1] * b[2] - a[2] * b[1];
+	CodegenExpr c1 = a[2] * b[0] - a[0] * b[2];
+	CodegenExpr c2 = a[0] * b[1] - a[1] * b[0];
+	result[0] = c0;
+	result[1] = c1;
+	result[2] = c2;
+}
+
+static void codegen_mat3_mul (const CodegenExpr *E, const CodegenExpr *v, CodegenExpr *result) {
+	for (unsigned int i = 0; i < 3; i++)
+		result[i] = E[i * 3] * v[0] + E[i * 3 + 1] * v[1] + E[i * 3 + 2] * v[2];
+}
+
+static void codegen_mat3_transpose_mul (const CodegenExpr *E, const CodegenExpr *v, CodegenExpr *result) {
+	for (unsigned int i = 0; i < 3; i++)
+		result[i] = E[i] * v[0] + E[3 + i] * v[1] + E[6 + i] * v[2];
+}
+
+static void codegen_mat3_mul_mat3 (const CodegenExpr *A, const CodegenExpr *B, CodegenExpr *result) {
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < 3; j++)
+			result[i * 3 + j] = A[i * 3] * B[j] + A[i * 3 + 1] * B[3 + j] + A[i * 3 + 2] * B[6 + j];
+	}
+}
+
+static void codegen_cross_matrix (const CodegenExpr *v, CodegenExpr *result) {
+	result[0] = CodegenExpr (0.); result[1] = -v[2]; result[2] = v[1];
+	result[3] = v[2]; result[4] = CodegenExpr (0.); result[5] = -v[0];
+	result[6] = -v[1]; result[7] = v[0]; result[8] = CodegenExpr (0.);
+}
+
+static CodegenExpr codegen_dot (const CodegenVector6 &a, const CodegenVector6 &b) {
+	CodegenExpr result;
+	for (unsigned int i = 0; i < 6; i++)
+		result = result + a.v[i] * b.v[i];
+	return result;
+}
+
+static CodegenVector6 codegen_constant (const SpatialVector &value) {
+	CodegenVector6 result;
+	for (unsigned int i = 0; i < 6; i++)
+		result.v[i] = CodegenExpr (value[i]);
+	return result;
+}
+
+static CodegenTransform codegen_constant (const SpatialTransform &X) {
+	CodegenTransform result;
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < 3; j++)
+			result.E[i * 3 + j] = CodegenExpr (X.E(i,j));
+		result.r[i] = CodegenExpr (X.r[i]);
+	}
+	return result;
+}
+
+static CodegenInertia codegen_constant (const SpatialRigidBodyInertia &I) {
+	CodegenInertia result;
+	result.m = CodegenExpr (I.m);
+	for (unsigned int i = 0; i < 3; i++)
+		result.h[i] = CodegenExpr (I.h[i]);
+
+	result.I[0] = I.Ixx; result.I[1] = I.Iyx; result.I[2] = I.Izx;
+	result.I[3] = I.Iyx; result.I[4] = I.Iyy; result.I[5] = I.Izy;
+	result.I[6] = I.Izx; result.I[7] = I.Izy; result.I[8] = I.Izz;
+
+	return result;
+}
+
+static CodegenVector6 codegen_add (CodegenWriter &w, const CodegenVector6 &a, const CodegenVector6 &b) {
+	CodegenVector6 result;
+	for (unsigned int i = 0; i < 6; i++)
+		result.v[i] = a.v[i] + b.v[i];
+	w.define (result.v, 6);
+	return result;
+}
+
+static CodegenVector6 codegen_scale (CodegenWriter &w, const CodegenVector6 &a, const CodegenExpr &s) {
+	CodegenVector6 result;
+	for (unsigned int i = 0; i < 6; i++)
+		result.v[i] = a.v[i] * s;
+	w.define (result.v, 6);
+	return result;
+}
+
+/// \brief Same as SpatialTransform::apply()
+static CodegenVector6 codegen_apply (CodegenWriter &w, const CodegenTransform &X, const CodegenVector6 &v) {
+	CodegenExpr rxw[3];
+	codegen_cross (X.r, v.v, rxw);
+
+	CodegenExpr v_rxw[3];
+	for (unsigned int i = 0; i < 3; i++)
+		v_rxw[i] = v.v[3 + i] - rxw[i];
+	w.define (v_rxw, 3);
+
+	CodegenVector6 result;
+	codegen_mat3_mul (X.E, v.v, result.v);
+	codegen_mat3_mul (X.E, v_rxw, result.v + 3);
+	w.define (result.v, 6);
+
+	return result;
+}
+
+/// \brief Same as SpatialTransform::applyTranspose()
+static CodegenVector6 codegen_apply_transpose (CodegenWriter &w, const CodegenTransform &X, const CodegenVector6 &f) {
+	CodegenVector6 result;
+	codegen_mat3_transpose_mul (X.E, f.v + 3, result.v + 3);
+	w.define (result.v + 3, 3);
+
+	CodegenExpr E_T_n[3], rxf[3];
+	codegen_mat3_transpose_mul (X.E, f.v, E_T_n);
+	codegen_cross (X.r, result.v + 3, rxf);
+	for (unsigned int i = 0; i < 3; i++)
+		result.v[i] = E_T_n[i] + rxf[i];
+	w.define (result.v, 3);
+
+	return result;
+}
+
+/// \brief Same as SpatialTransform::operator*()
+static CodegenTransform codegen_compose (CodegenWriter &w, const CodegenTransform &X1, const CodegenTransform &X2) {
+	CodegenTransform result;
+	codegen_mat3_mul_mat3 (X1.E, X2.E, result.E);
+	codegen_mat3_transpose_mul (X2.E, X1.r, result.r);
+	for (unsigned int i = 0; i < 3; i++)
+		result.r[i] = X2.r[i] + result.r[i];
+
+	w.define (result.E, 9);
+	w.define (result.r, 3);
+
+	return result;
+}
+
+/// \brief Same as crossm (v1, v2)
+static CodegenVector6 codegen_crossm (CodegenWriter &w, const CodegenVector6 &v1, const CodegenVector6 &v2) {
+	CodegenVector6 result;
+	CodegenExpr a[3], b[3];
+
+	codegen_cross (v1.v, v2.v, result.v);
+	codegen_cross (v1.v, v2.v + 3, a);
+	codegen_cross (v1.v + 3, v2.v, b);
+	for (unsigned int i = 0; i < 3; i++)
+		result.v[3 + i] = a[i] + b[i];
+
+	w.define (result.v, 6);
+	return result;
+}
+
+/// \brief Same as crossf (v1, v2)
+static CodegenVector6 codegen_crossf (CodegenWriter &w, const CodegenVector6 &v1, const CodegenVector6 &v2) {
+	CodegenVector6 result;
+	CodegenExpr a[3], b[3];
+
+	codegen_cross (v1.v, v2.v, a);
+	codegen_cross (v1.v + 3, v2.v + 3, b);
+	for (unsigned int i = 0; i < 3; i++)
+		result.v[i] = a[i] + b[i];
+	codegen_cross (v1.v, v2.v + 3, result.v + 3);
+
+	w.define (result.v, 6);
+	return result;
+}
+
+/// \brief Same as SpatialRigidBodyInertia::operator*()
+static CodegenVector6 codegen_inertia_mul (CodegenWriter &w, const CodegenInertia &I, const CodegenVector6 &v) {
+	CodegenVector6 result;
+	CodegenExpr hxv[3], hxw[3];
+
+	codegen_mat3_mul (I.I, v.v, result.v);
+	codegen_cross (I.h, v.v + 3, hxv);
+	codegen_cross (I.h, v.v, hxw);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		result.v[i] = result.v[i] + hxv[i];
+		result.v[3 + i] = I.m * v.v[3 + i] - hxw[i];
+	}
+
+	w.define (result.v, 6);
+	return result;
+}
+
+static CodegenInertia codegen_inertia_add (CodegenWriter &w, const CodegenInertia &a, const CodegenInertia &b) {
+	CodegenInertia result;
+	result.m = w.define (a.m + b.m);
+	for (unsigned int i = 0; i < 3; i++)
+		result.h[i] = a.h[i] + b.h[i];
+	for (unsigned int i = 0; i < 9; i++)
+		result.I[i] = a.I[i] + b.I[i];
+
+	w.define (result.h, 3);
+	w.define (result.I, 9);
+	return result;
+}
+
+/// \brief Same as SpatialTransform::applyTranspose() for inertias (X^T I X)
+static CodegenInertia codegen_inertia_apply_transpose (CodegenWriter &w, const CodegenTransform &X, const CodegenInertia &I) {
+	CodegenInertia result;
+	result.m = I.m;
+
+	CodegenExpr E_T_h[3];
+	codegen_mat3_transpose_mul (X.E, I.h, E_T_h);
+	w.define (E_T_h, 3);
+
+	for (unsigned int i = 0; i < 3; i++)
+		result.h[i] = E_T_h[i] + I.m * X.r[i];
+	w.define (result.h, 3);
+
+	// E^T I E
+	CodegenExpr E_T[9], E_T_I[9], E_T_I_E[9];
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < 3; j++)
+			E_T[i * 3 + j] = X.E[j * 3 + i];
+	}
+	codegen_mat3_mul_mat3 (E_T, I.I, E_T_I);
+	w.define (E_T_I, 9);
+	codegen_mat3_mul_mat3 (E_T_I, X.E, E_T_I_E);
+
+	// - rx (E^T h)x - (E^T h + m r)x rx
+	CodegenExpr rx[9], E_T_hx[9], hx[9], a[9], b[9];
+	codegen_cross_matrix (X.r, rx);
+	codegen_cross_matrix (E_T_h, E_T_hx);
+	codegen_cross_matrix (result.h, hx);
+	codegen_mat3_mul_mat3 (rx, E_T_hx, a);
+	codegen_mat3_mul_mat3 (hx, rx, b);
+
+	for (unsigned int i = 0; i < 9; i++)
+		result.I[i] = E_T_I_E[i] - a[i] - b[i];
+
+	// the result is symmetric
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = i; j < 3; j++) {
+			result.I[i * 3 + j] = w.define (result.I[i * 3 + j]);
+			result.I[j * 3 + i] = result.I[i * 3 + j];
+		}
+	}
+
+	return result;
+}
+
+/// \brief Same as SpatialRigidBodyInertia::toMatrix()
+static CodegenMatrix6 codegen_inertia_to_matrix (const CodegenInertia &I) {
+	CodegenMatrix6 result;
+	CodegenExpr hx[9];
+	codegen_cross_matrix (I.h, hx);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < 3; j++) {
+			result.e[i * 6 + j] = I.I[i * 3 + j];
+			result.e[i * 6 + 3 + j] = hx[i * 3 + j];
+			result.e[(3 + i) * 6 + j] = -hx[i * 3 + j];
+			result.e[(3 + i) * 6 + 3 + j] = (i == j) ? I.m : CodegenExpr (0.);
+		}
+	}
+
+	return result;
+}
+
+/// \brief Same as SpatialTransform::toMatrix()
+static CodegenMatrix6 codegen_transform_to_matrix (CodegenWriter &w, const CodegenTransform &X) {
+	CodegenMatrix6 result;
+	CodegenExpr rx[9], Erx[9];
+	codegen_cross_matrix (X.r, rx);
+	codegen_mat3_mul_mat3 (X.E, rx, Erx);
+	w.define (Erx, 9);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < 3; j++) {
+			result.e[i * 6 + j] = X.E[i * 3 + j];
+			result.e[i * 6 + 3 + j] = CodegenExpr (0.);
+			result.e[(3 + i) * 6 + j] = -Erx[i * 3 + j];
+			result.e[(3 + i) * 6 + 3 + j] = X.E[i * 3 + j];
+		}
+	}
+
+	return result;
+}
+
+static CodegenVector6 codegen_matrix_mul (CodegenWriter &w, const CodegenMatrix6 &M, const CodegenVector6 &v) {
+	CodegenVector6 result;
+	for (unsigned int i = 0; i < 6; i++) {
+		CodegenExpr sum;
+		for (unsigned int j = 0; j < 6; j++)
+			sum = sum + M.e[i * 6 + j] * v.v[j];
+		result.v[i] = sum;
+	}
+
+	w.define (result.v, 6);
+	return result;
+}
+
+/// \brief Computes X^T M X for a symmetric matrix M
+static CodegenMatrix6 codegen_congruence (CodegenWriter &w, const CodegenTransform &X, const CodegenMatrix6 &M) {
+	CodegenMatrix6 X_mat = codegen_transform_to_matrix (w, X);
+	CodegenMatrix6 M_X, result;
+
+	for (unsigned int i = 0; i < 6; i++) {
+		for (unsigned int j = 0; j < 6; j++) {
+			CodegenExpr sum;
+			for (unsigned int k = 0; k < 6; k++)
+				sum = sum + M.e[i * 6 + k] * X_mat.e[k * 6 + j];
+			M_X.e[i * 6 + j] = w.define (sum);
+		}
+	}
+
+	for (unsigned int i = 0; i < 6; i++) {
+		for (unsigned int j = i; j < 6; j++) {
+			CodegenExpr sum;
+			for (unsigned int k = 0; k < 6; k++)
+				sum = sum + X_mat.e[k * 6 + i] * M_X.e[k * 6 + j];
+			result.e[i * 6 + j] = w.define (sum);
+			result.e[j * 6 + i] = result.e[i * 6 + j];
+		}
+	}
+
+	return result;
+}
+
+static bool codegen_is_supported (const Joint &joint) {
+	if (joint.mDoFCount != 1)
+		return false;
+
+	return joint.mJointType == JointTypeRevolute
+		|| joint.mJointType == JointTypePrismatic
+		|| joint.mJointType == JointTypeRevoluteX
+		|| joint.mJointType == JointTypeRevoluteY
+		|| joint.mJointType == JointTypeRevoluteZ;
+}
+
+static bool codegen_check_model (const Model &model) {
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		if (!codegen_is_supported (model.mJoints[i])) {
+			LOG << "Joint of body " << i << " is not supported by rbdl_codegen" << endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// \brief Joint transformation (same as jcalc_XJ())
+static CodegenTransform codegen_joint_transform (CodegenWriter &w, const Model &model, unsigned int i, const CodegenExpr &q) {
+	const Joint &joint = model.mJoints[i];
+	const SpatialVector &S = model.S[i];
+
+	CodegenTransform result = codegen_constant (SpatialTransform());
+
+	if (joint.mJointType == JointTypePrismatic) {
+		for (unsigned int k = 0; k < 3; k++)
+			result.r[k] = w.define (CodegenExpr (S[3 + k]) * q);
+		return result;
+	}
+
+	CodegenExpr s = w.define (CodegenExpr ("std::sin (" + codegen_str (q) + ")"), true);
+	CodegenExpr c = w.define (CodegenExpr ("std::cos (" + codegen_str (q) + ")"), true);
+
+	if (joint.mJointType == JointTypeRevoluteX) {
+		result.E[4] = c; result.E[5] = s;
+		result.E[7] = -s; result.E[8] = c;
+	} else if (joint.mJointType == JointTypeRevoluteY) {
+		result.E[0] = c; result.E[2] = -s;
+		result.E[6] = s; result.E[8] = c;
+	} else if (joint.mJointType == JointTypeRevoluteZ) {
+		result.E[0] = c; result.E[1] = s;
+		result.E[3] = -s; result.E[4] = c;
+	} else {
+		CodegenExpr a[3] = { CodegenExpr (S[0]), CodegenExpr (S[1]), CodegenExpr (S[2]) };
+		CodegenExpr one_minus_c = w.define (CodegenExpr (1.) - c);
+
+		result.E[0] = a[0] * a[0] * one_minus_c + c;
+		result.E[1] = a[1] * a[0] * one_minus_c + a[2] * s;
+		result.E[2] = a[0] * a[2] * one_minus_c - a[1] * s;
+
+		result.E[3] = a[0] * a[1] * one_minus_c - a[2] * s;
+		result.E[4] = a[1] * a[1] * one_minus_c + c;
+		result.E[5] = a[1] * a[2] * one_minus_c + a[0] * s;
+
+		result.E[6] = a[0] * a[2] * one_minus_c + a[1] * s;
+		result.E[7] = a[1] * a[2] * one_minus_c - a[0] * s;
+		result.E[8] = a[2] * a[2] * one_minus_c + c;
+
+		w.define (result.E, 9);
+	}
+
+	return result;
+}
+
+static CodegenTransform codegen_X_lambda (CodegenWriter &w, const Model &model, unsigned int i) {
+	CodegenExpr q = codegen_input ("q", model.mJoints[i].q_index);
+	return codegen_compose (w, codegen_joint_transform (w, model, i, q), codegen_constant (model.X_T[i]));
+}
+
+static CodegenVector6 codegen_gravity_acceleration (const Model &model) {
+	return codegen_constant (SpatialVector (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]));
+}
+
+static void codegen_inverse_dynamics (const Model &model, std::ostream &out) {
+	CodegenWriter w;
+	unsigned int body_count = model.mBodies.size();
+
+	std::vector<CodegenTransform> X_lambda (body_count);
+	std::vector<CodegenVector6> v (body_count), a (body_count), f (body_count);
+
+	for (unsigned int i = 1; i < body_count; i++) {
+		unsigned int lambda = model.lambda[i];
+		unsigned int q_index = model.mJoints[i].q_index;
+		CodegenVector6 S = codegen_constant (model.S[i]);
+
+		X_lambda[i] = codegen_X_lambda (w, model, i);
+
+		CodegenVector6 v_J = codegen_scale (w, S, codegen_input ("qdot", q_index));
+
+		if (lambda != 0) {
+			v[i] = codegen_add (w, codegen_apply (w, X_lambda[i], v[lambda]), v_J);
+			CodegenVector6 c = codegen_crossm (w, v[i], v_J);
+			a[i] = codegen_add (w, codegen_apply (w, X_lambda[i], a[lambda]), c);
+		} else {
+			v[i] = v_J;
+			a[i] = codegen_apply (w, X_lambda[i], codegen_gravity_acceleration (model));
+		}
+
+		a[i] = codegen_add (w, a[i], codegen_scale (w, S, codegen_input ("qddot", q_index)));
+
+		CodegenInertia I = codegen_constant (model.I[i]);
+		f[i] = codegen_add (w,
+				codegen_inertia_mul (w, I, a[i]),
+				codegen_crossf (w, v[i], codegen_inertia_mul (w, I, v[i])));
+	}
+
+	for (unsigned int i = body_count - 1; i > 0; i--) {
+		unsigned int lambda = model.lambda[i];
+		unsigned int q_index = model.mJoints[i].q_index;
+
+		std::ostringstream lhs;
+		lhs << "tau[" << q_index << "]";
+		w.assign (lhs.str(), codegen_dot (codegen_constant (model.S[i]), f[i]));
+
+		if (lambda != 0)
+			f[lambda] = codegen_add (w, f[lambda], codegen_apply_transpose (w, X_lambda[i], f[i]));
+	}
+
+	codegen_write_function (out, "void InverseDynamics", "const double *q, const double *qdot, const double *qddot, double *tau", w);
+}
+
+static void codegen_forward_dynamics (const Model &model, std::ostream &out) {
+	CodegenWriter w;
+	unsigned int body_count = model.mBodies.size();
+
+	std::vector<CodegenTransform> X_lambda (body_count);
+	std::vector<CodegenVector6> v (body_count), c (body_count), pA (body_count), U (body_count), a (body_count);
+	std::vector<CodegenMatrix6> IA (body_count);
+	std::vector<CodegenExpr> d_inv (body_count), u (body_count);
+
+	for (unsigned int i = 1; i < body_count; i++) {
+		unsigned int lambda = model.lambda[i];
+		CodegenVector6 S = codegen_constant (model.S[i]);
+
+		X_lambda[i] = codegen_X_lambda (w, model, i);
+
+		CodegenVector6 v_J = codegen_scale (w, S, codegen_input ("qdot", model.mJoints[i].q_index));
+
+		if (lambda != 0) {
+			v[i] = codegen_add (w, codegen_apply (w, X_lambda[i], v[lambda]), v_J);
+			c[i] = codegen_crossm (w, v[i], v_J);
+		} else {
+			v[i] = v_J;
+		}
+
+		CodegenInertia I = codegen_constant (model.I[i]);
+		IA[i] = codegen_inertia_to_matrix (I);
+		pA[i] = codegen_crossf (w, v[i], codegen_inertia_mul (w, I, v[i]));
+	}
+
+	for (unsigned int i = body_count - 1; i > 0; i--) {
+		unsigned int lambda = model.lambda[i];
+		CodegenVector6 S = codegen_constant (model.S[i]);
+
+		U[i] = codegen_matrix_mul (w, IA[i], S);
+		d_inv[i] = w.define (CodegenExpr (1.) / w.define (codegen_dot (S, U[i])));
+		u[i] = w.define (codegen_input ("tau", model.mJoints[i].q_index) - codegen_dot (S, pA[i]));
+
+		if (lambda != 0) {
+			CodegenVector6 U_d_inv = codegen_scale (w, U[i], d_inv[i]);
+
+			CodegenMatrix6 Ia;
+			for (unsigned int r = 0; r < 6; r++) {
+				for (unsigned int k = r; k < 6; k++) {
+					Ia.e[r * 6 + k] = w.define (IA[i].e[r * 6 + k] - U[i].v[r] * U_d_inv.v[k]);
+					Ia.e[k * 6 + r] = Ia.e[r * 6 + k];
+				}
+			}
+
+			CodegenVector6 pa = codegen_add (w,
+					codegen_add (w, pA[i], codegen_matrix_mul (w, Ia, c[i])),
+					codegen_scale (w, U_d_inv, u[i]));
+
+			CodegenMatrix6 X_T_Ia_X = codegen_congruence (w, X_lambda[i], Ia);
+			for (unsigned int k = 0; k < 36; k++)
+				IA[lambda].e[k] = IA[lambda].e[k] + X_T_Ia_X.e[k];
+			w.define (IA[lambda].e, 36);
+
+			pA[lambda] = codegen_add (w, pA[lambda], codegen_apply_transpose (w, X_lambda[i], pa));
+		}
+	}
+
+	for (unsigned int i = 1; i < body_count; i++) {
+		unsigned int lambda = model.lambda[i];
+		unsigned int q_index = model.mJoints[i].q_index;
+
+		if (lambda != 0)
+			a[i] = codegen_add (w, codegen_apply (w, X_lambda[i], a[lambda]), c[i]);
+		else
+			a[i] = codegen_apply (w, X_lambda[i], codegen_gravity_acceleration (model));
+
+		CodegenExpr qddot = w.define ((u[i] - codegen_dot (U[i], a[i])) * d_inv[i]);
+
+		std::ostringstream lhs;
+		lhs << "qddot[" << q_index << "]";
+		w.assign (lhs.str(), qddot);
+
+		a[i] = codegen_add (w, a[i], codegen_scale (w, codegen_constant (model.S[i]), qddot));
+	}
+
+	codegen_write_function (out, "void ForwardDynamics", "const double *q, const double *qdot, const double *tau, double *qddot", w);
+}
+
+static void codegen_composite_rigid_body (const Model &model, std::ostream &out) {
+	CodegenWriter w;
+	unsigned int body_count = model.mBodies.size();
+	unsigned int dof_count = model.dof_count;
+
+	std::vector<CodegenTransform> X_lambda (body_count);
+	std::vector<CodegenInertia> Ic (body_count);
+	std::vector<CodegenExpr> H (dof_count * dof_count);
+
+	for (unsigned int i = 1; i < body_count; i++) {
+		X_lambda[i] = codegen_X_lambda (w, model, i);
+		Ic[i] = codegen_constant (model.I[i]);
+	}
+
+	for (unsigned int i = body_count - 1; i > 0; i--) {
+		unsigned int lambda = model.lambda[i];
+		unsigned int dof_index_i = model.mJoints[i].q_index;
+
+		if (lambda != 0)
+			Ic[lambda] = codegen_inertia_add (w, Ic[lambda], codegen_inertia_apply_transpose (w, X_lambda[i], Ic[i]));
+
+		CodegenVector6 F = codegen_inertia_mul (w, Ic[i], codegen_constant (model.S[i]));
+		H[dof_index_i * dof_count + dof_index_i] = codegen_dot (codegen_constant (model.S[i]), F);
+
+		unsigned int j = i;
+		while (model.lambda[j] != 0) {
+			F = codegen_apply_transpose (w, X_lambda[j], F);
+			j = model.lambda[j];
+
+			unsigned int dof_index_j = model.mJoints[j].q_index;
+			H[dof_index_i * dof_count + dof_index_j] = w.define (codegen_dot (F, codegen_constant (model.S[j])));
+			H[dof_index_j * dof_count + dof_index_i] = H[dof_index_i * dof_count + dof_index_j];
+		}
+	}
+
+	for (unsigned int k = 0; k < dof_count * dof_count; k++) {
+		std::ostringstream lhs;
+		lhs << "H[" << k << "]";
+		w.assign (lhs.str(), H[k]);
+	}
+
+	codegen_write_function (out, "void CompositeRigidBodyAlgorithm", "const double *q, double *H", w);
+}
+
+/// \brief Writes the point jacobian of the movable body body_id
+static void codegen_point_jacobian (const Model &model, unsigned int body_id, std::ostream &out) {
+	CodegenWriter w;
+	unsigned int body_count = model.mBodies.size();
+	unsigned int dof_count = model.dof_count;
+
+	std::vector<unsigned int> chain;
+	for (unsigned int j = body_id; j != 0; j = model.lambda[j])
+		chain.insert (chain.begin(), j);
+
+	std::vector<CodegenTransform> X_base (body_count);
+	for (unsigned int k = 0; k < chain.size(); k++) {
+		unsigned int j = chain[k];
+		CodegenTransform X_lambda = codegen_X_lambda (w, model, j);
+
+		if (model.lambda[j] != 0)
+			X_base[j] = codegen_compose (w, X_lambda, X_base[model.lambda[j]]);
+		else
+			X_base[j] = X_lambda;
+	}
+
+	CodegenExpr point[3] = { codegen_input ("point", 0), codegen_input ("point", 1), codegen_input ("point", 2) };
+	CodegenExpr point_base[3];
+	codegen_mat3_transpose_mul (X_base[body_id].E, point, point_base);
+	for (unsigned int k = 0; k < 3; k++)
+		point_base[k] = X_base[body_id].r[k] + point_base[k];
+	w.define (point_base, 3);
+
+	std::vector<CodegenExpr> G (3 * dof_count);
+
+	for (unsigned int k = 0; k < chain.size(); k++) {
+		unsigned int j = chain[k];
+		unsigned int q_index = model.mJoints[j].q_index;
+		CodegenVector6 S = codegen_constant (model.S[j]);
+
+		CodegenExpr omega[3], v[3], rxw[3], wxp[3];
+		codegen_mat3_transpose_mul (X_base[j].E, S.v, omega);
+		w.define (omega, 3);
+		codegen_mat3_transpose_mul (X_base[j].E, S.v + 3, v);
+		codegen_cross (X_base[j].r, omega, rxw);
+		codegen_cross (omega, point_base, wxp);
+
+		for (unsigned int r = 0; r < 3; r++)
+			G[r * dof_count + q_index] = v[r] + rxw[r] + wxp[r];
+	}
+
+	for (unsigned int k = 0; k < 3 * dof_count; k++) {
+		std::ostringstream lhs;
+		lhs << "G[" << k << "]";
+		w.assign (lhs.str(), G[k]);
+	}
+
+	std::ostringstream head;
+	head << "static void point_jacobian_" << body_id;
+	codegen_write_function (out, head.str(), "const double *q, const double *point, double *G", w);
+}
+
+static void codegen_point_jacobian_dispatch (const Model &model, std::ostream &out) {
+	out << "bool CalcPointJacobian (const double *q, unsigned int body_id, const double *point, double *G) {" << endl
+		<< "\tswitch (body_id) {" << endl;
+
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		out << "\t\tcase " << i << ":" << endl
+			<< "\t\t\tpoint_jacobian_" << i << " (q, point, G);" << endl
+			<< "\t\t\treturn true;" << endl;
+	}
+
+	for (unsigned int i = 0; i < model.mFixedBodies.size(); i++) {
+		const SpatialTransform &X = model.mFixedBodies[i].mParentTransform;
+		CodegenTransform X_parent = codegen_constant (X);
+
+		CodegenExpr point[3] = { codegen_input ("point", 0), codegen_input ("point", 1), codegen_input ("point", 2) };
+		CodegenExpr point_parent[3];
+		codegen_mat3_transpose_mul (X_parent.E, point, point_parent);
+
+		out << "\t\tcase " << model.fixed_body_discriminator + i << ": {" << endl
+			<< "\t\t\tconst double fixed_point[3] = { ";
+		for (unsigned int k = 0; k < 3; k++)
+			out << codegen_str (X_parent.r[k] + point_parent[k]) << (k < 2 ? ", " : " };");
+		out << endl
+			<< "\t\t\tpoint_jacobian_" << model.mFixedBodies[i].mMovableParent << " (q, fixed_point, G);" << endl
+			<< "\t\t\treturn true;" << endl
+			<< "\t\t}" << endl;
+	}
+
+	out << "\t\tdefault:" << endl
+		<< "\t\t\tbreak;" << endl
+		<< "\t}" << endl
+		<< endl
+		<< "\treturn false;" << endl
+		<< "}" << endl;
+}
+
+RBDL_DLLAPI bool CodegenWriteSource (const Model &model, const std::string &name, std::ostream &out) {
+	if (!codegen_check_model (model))
+		return false;
+
+	out << "/*" << endl
+		<< " * Dynamics of the model " << name << " (" << model.dof_count << " degrees of freedom)" << endl
+		<< " * generated by rbdl_codegen. Do not edit." << endl
+		<< " */" << endl
+		<< endl
+		<< "#include <cmath>" << endl
+		<< endl
+		<< "namespace " << name << " {" << endl
+		<< endl;
+
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		codegen_point_jacobian (model, i, out);
+		out << endl;
+	}
+
+	codegen_forward_dynamics (model, out);
+	out << endl;
+	codegen_inverse_dynamics (model, out);
+	out << endl;
+	codegen_composite_rigid_body (model, out);
+	out << endl;
+	codegen_point_jacobian_dispatch (model, out);
+	out << endl
+		<< "}" << endl;
+
+	return true;
+}
+
+RBDL_DLLAPI bool CodegenWriteHeader (const Model &model, const std::string &name, std::ostream &out) {
+	if (!codegen_check_model (model))
+		return false;
+
+	std::string guard = name;
+	for (unsigned int i = 0; i < guard.size(); i++)
+		guard[i] = toupper (guard[i]);
+	guard = "_" + guard + "_H";
+
+	out << "/*" << endl
+		<< " * Dynamics of the model " << name << " (" << model.dof_count << " degrees of freedom)" << endl
+		<< " * generated by rbdl_codegen. Do not edit." << endl
+		<< " */" << endl
+		<< endl
+		<< "#ifndef " << guard << endl
+		<< "#define " << guard << endl
+		<< endl
+		<< "namespace " << name << " {" << endl
+		<< endl
+		<< "enum { dof_count = " << model.dof_count << " };" << endl
+		<< endl
+		<< "void ForwardDynamics (const double *q, const double *qdot, const double *tau, double *qddot);" << endl
+		<< "void InverseDynamics (const double *q, const double *qdot, const double *qddot, double *tau);" << endl
+		<< "void CompositeRigidBodyAlgorithm (const double *q, double *H);" << endl
+		<< "bool CalcPointJacobian (const double *q, unsigned int body_id, const double *point, double *G);" << endl
+		<< endl
+		<< "}" << endl
+		<< endl
+		<< "/* " << guard << " */" << endl
+		<< "#endif" << endl;
+
+	return true;
+}
+
+}
+
+}
@@ -0,0 +1,80 @@
+#ifndef _RBDL_CODEGEN_H
+#define _RBDL_CODEGEN_H
+
+#include <rbdl/rbdl_config.h>
+
+#include <iostream>
+#include <string>
+
+namespace RigidBodyDynamics {
+
+struct Model;
+
+namespace Addons {
+
+	/** \page addon_codegen_page Addon: rbdl_codegen
+	 * @{
+	 *
+	 * The Addon Codegen writes the dynamics of a single \link
+	 * RigidBodyDynamics::Model Model\endlink as standalone C++ source. The
+	 * generated code contains no loops, performs no heap allocations, and
+	 * only depends on <cmath>, which allows to embed the exact dynamics of
+	 * a robot in control loops that cannot link against RBDL. This addon is
+	 * not enabled by default and one has to enable it by setting
+	 * RBDL_BUILD_ADDON_CODEGEN to true when configuring the RBDL with CMake.
+	 *
+	 * All constant values of the model (joint frames, motion subspaces,
+	 * inertias, and gravity) are folded into the generated code such that
+	 * products with zeros and ones, e.g. of axis-aligned joints or joint
+	 * frames that are pure translations, vanish.
+	 *
+	 * The generated source defines the following functions in a namespace
+	 * of the given name (all vectors are plain arrays of size dof_count, all
+	 * matrices are stored row by row):
+	 *
+	 * \code
+	 * void ForwardDynamics (const double *q, const double *qdot, const double *tau, double *qddot);
+	 * void InverseDynamics (const double *q, const double *qdot, const double *qddot, double *tau);
+	 * void CompositeRigidBodyAlgorithm (const double *q, double *H);
+	 * bool CalcPointJacobian (const double *q, unsigned int body_id, const double *point, double *G);
+	 * \endcode
+	 *
+	 * They compute the same values as the functions of RBDL with the same
+	 * name without external forces. Unlike in RBDL all entries of H and G
+	 * are written. CalcPointJacobian() returns false for invalid body ids.
+	 *
+	 * This addon comes with the standalone utility rbdl_codegen_util that
+	 * loads a model from a Lua file (requires the addon LuaModel) or from
+	 * an URDF file (requires the addon URDFReader) and writes the source
+	 * and the matching header. Use the -h switch to see available options.
+	 *
+	 * \note Only joints with a single degree of freedom (revolute and
+	 * prismatic joints, including emulated multi-DoF joints) are supported.
+	 */
+
+	/** \brief Writes the straight-line dynamics of a model as C++ source
+	 *
+	 * \param model the model
+	 * \param name  the namespace of the generated functions
+	 * \param out   the stream the source is written to
+	 *
+	 * \returns false if the model contains unsupported joints (nothing is
+	 * written in that case)
+	 */
+	RBDL_DLLAPI bool CodegenWriteSource (const Model &model, const std::string &name, std::ostream &out);
+
+	/** \brief Writes the declarations of the functions written by
+	 * CodegenWriteSource()
+	 *
+	 * \returns false if the model contains unsupported joints (nothing is
+	 * written in that case)
+	 */
+	RBDL_DLLAPI bool CodegenWriteHeader (const Model &model, const std::string &name, std::ostream &out);
+
+	/** @} */
+}
+
+}
+
+/* _RBDL_CODEGEN_H */
+#endif
@@ -0,0 +1,114 @@
+#include <rbdl/rbdl.h>
+
+#include "codegen.h"
+
+#ifdef RBDL_BUILD_ADDON_LUAMODEL
+#include "../luamodel/luamodel.h"
+#endif
+
+#ifdef RBDL_BUILD_ADDON_URDFREADER
+#include "../urdfreader/urdfreader.h"
+#endif
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+void usage (const char* argv_0) {
+	cerr << "Usage: " << argv_0 << " [-v] [-n <name>] [-o <source.cc>] [-H <header.h>] <model.lua|robot.urdf>" << endl;
+	cerr << "  -v | --verbose            enable additional output" << endl;
+	cerr << "  -n | --name <name>        namespace of the generated functions (default: model)" << endl;
+	cerr << "  -o | --output <file>      write the source to <file> (default: standard output)" << endl;
+	cerr << "  -H | --header <file>      write the declarations to <file>" << endl;
+	cerr << "  -h | --help               print this help" << endl;
+	exit (1);
+}
+
+static bool has_extension (const string &filename, const string &extension) {
+	return filename.size() >= extension.size()
+		&& filename.compare (filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+int main (int argc, char *argv[]) {
+	if (argc < 2)
+		usage (argv[0]);
+
+	bool verbose = false;
+	string name = "model";
+	string output_filename = "";
+	string header_filename = "";
+	string filename = "";
+
+	for (int i = 1; i < argc; i++) {
+		string arg (argv[i]);
+
+		if (arg == "-v" || arg == "--verbose")
+			verbose = true;
+		else if ((arg == "-n" || arg == "--name") && i + 1 < argc)
+			name = argv[++i];
+		else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+			output_filename = argv[++i];
+		else if ((arg == "-H" || arg == "--header") && i + 1 < argc)
+			header_filename = argv[++i];
+		else if (arg == "-h" || arg == "--help")
+			usage (argv[0]);
+		else
+			filename = arg;
+	}
+
+	if (filename == "")
+		usage (argv[0]);
+
+	RigidBodyDynamics::Model model;
+	bool loaded = false;
+
+	if (has_extension (filename, ".lua")) {
+#ifdef RBDL_BUILD_ADDON_LUAMODEL
+		loaded = RigidBodyDynamics::Addons::LuaModelReadFromFile (filename.c_str(), &model, verbose);
+#else
+		cerr << "Error: RBDL was built without the addon LuaModel." << endl;
+		return -1;
+#endif
+	} else if (has_extension (filename, ".urdf")) {
+#ifdef RBDL_BUILD_ADDON_URDFREADER
+		loaded = RigidBodyDynamics::Addons::URDFReadFromFile (filename.c_str(), &model, verbose);
+#else
+		cerr << "Error: RBDL was built without the addon URDFReader." << endl;
+		return -1;
+#endif
+	} else {
+		cerr << "Error: unknown model format of file " << filename << " (expected .lua or .urdf)." << endl;
+		return -1;
+	}
+
+	if (!loaded) {
+		cerr << "Loading of model " << filename << " failed!" << endl;
+		return -1;
+	}
+
+	bool written = false;
+	if (output_filename != "") {
+		ofstream output (output_filename.c_str());
+		written = RigidBodyDynamics::Addons::CodegenWriteSource (model, name, output);
+	} else {
+		written = RigidBodyDynamics::Addons::CodegenWriteSource (model, name, cout);
+	}
+
+	if (written && header_filename != "") {
+		ofstream header (header_filename.c_str());
+		written = RigidBodyDynamics::Addons::CodegenWriteHeader (model, name, header);
+	}
+
+	if (!written) {
+		cerr << "Error: model " << filename << " contains joints that are not supported by rbdl_codegen." << endl;
+		return -1;
+	}
+
+	if (verbose)
+		cerr << "Generated dynamics of " << name << " (" << model.dof_count << " degrees of freedom)." << endl;
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include <UnitTest++.h>
+
+#include <iostream>
+#include <sstream>
+
+#include <rbdl/rbdl.h>
+
+#include "../codegen.h"
+#include "TestModel.h"
+#include "codegen_test_model.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double TEST_PREC = 1.0e-11;
+
+struct CodegenFixture {
+	CodegenFixture () {
+		CreateCodegenTestModel (model);
+
+		q = VectorNd::Zero (model.q_size);
+		qdot = VectorNd::Zero (model.qdot_size);
+		qddot = VectorNd::Zero (model.qdot_size);
+		tau = VectorNd::Zero (model.qdot_size);
+
+		for (unsigned int i = 0; i < model.q_size; i++) {
+			q[i] = 0.3 * i - 0.8;
+			qdot[i] = 0.7 - 0.2 * i;
+			qddot[i] = 0.1 * i * i - 0.6;
+			tau[i] = 0.4 * i - 1.2;
+		}
+	}
+
+	Model model;
+	VectorNd q, qdot, qddot, tau;
+};
+
+TEST_FIXTURE (CodegenFixture, TestCodegenDofCount) {
+	CHECK_EQUAL ((unsigned int) codegen_test_model::dof_count, model.dof_count);
+}
+
+TEST_FIXTURE (CodegenFixture, TestCodegenForwardDynamics) {
+	VectorNd qddot_rbdl (VectorNd::Zero (model.qdot_size));
+	VectorNd qddot_generated (VectorNd::Zero (model.qdot_size));
+
+	ForwardDynamics (model, q, qdot, tau, qddot_rbdl);
+	codegen_test_model::ForwardDynamics (q.data(), qdot.data(), tau.data(), qddot_generated.data());
+
+	CHECK_ARRAY_CLOSE (qddot_rbdl.data(), qddot_generated.data(), model.qdot_size, TEST_PREC);
+}
+
+TEST_FIXTURE (CodegenFixture, TestCodegenInverseDynamics) {
+	VectorNd tau_rbdl (VectorNd::Zero (model.qdot_size));
+	VectorNd tau_generated (VectorNd::Zero (model.qdot_size));
+
+	InverseDynamics (model, q, qdot, qddot, tau_rbdl);
+	codegen_test_model::InverseDynamics (q.data(), qdot.data(), qddot.data(), tau_generated.data());
+
+	CHECK_ARRAY_CLOSE (tau_rbdl.data(), tau_generated.data(), model.qdot_size, TEST_PREC);
+}
+
+TEST_FIXTURE (CodegenFixture, TestCodegenCompositeRigidBody) {
+	MatrixNd H_rbdl (MatrixNd::Zero (model.qdot_size, model.qdot_size));
+	// the generated function writes all entries
+	MatrixNd H_generated (MatrixNd::Constant (model.qdot_size, model.qdot_size, 1.));
+
+	CompositeRigidBodyAlgorithm (model, q, H_rbdl);
+	codegen_test_model::CompositeRigidBodyAlgorithm (q.data(), H_generated.data());
+
+	CHECK_ARRAY_CLOSE (H_rbdl.data(), H_generated.data(), model.qdot_size * model.qdot_size, TEST_PREC);
+}
+
+TEST_FIXTURE (CodegenFixture, TestCodegenPointJacobian) {
+	Vector3d point (0.2, -0.3, 0.1);
+	unsigned int body_count = model.mBodies.size();
+
+	std::vector<unsigned int> body_ids;
+	for (unsigned int i = 1; i < body_count; i++)
+		body_ids.push_back (i);
+	body_ids.push_back (model.GetBodyId ("tool"));
+
+	for (unsigned int k = 0; k < body_ids.size(); k++) {
+		MatrixNd G_rbdl (MatrixNd::Zero (3, model.qdot_size));
+		CalcPointJacobian (model, q, body_ids[k], point, G_rbdl);
+
+		// the generated jacobian is stored row by row
+		MatrixNd G_generated (MatrixNd::Constant (model.qdot_size, 3, 1.));
+		CHECK (codegen_test_model::CalcPointJacobian (q.data(), body_ids[k], point.data(), G_generated.data()));
+
+		MatrixNd G_generated_T = G_generated.transpose();
+		CHECK_ARRAY_CLOSE (G_rbdl.data(), G_generated_T.data(), 3 * model.qdot_size, TEST_PREC);
+	}
+
+	MatrixNd G (MatrixNd::Zero (model.qdot_size, 3));
+	CHECK (!codegen_test_model::CalcPointJacobian (q.data(), body_count, point.data(), G.data()));
+}
+
+TEST_FIXTURE (CodegenFixture, TestCodegenFoldsConstants) {
+	std::ostringstream source;
+	CHECK (Addons::CodegenWriteSource (model, "codegen_test_model", source));
+
+	std::string code = source.str();
+	CHECK (code.find (" * 0.;") == std::string::npos);
+	CHECK (code.find (" * 0. ") == std::string::npos);
+	CHECK (code.find (" * 1.;") == std::string::npos);
+	CHECK (code.find (" * 1. ") == std::string::npos);
+	CHECK (code.find (" + 0.;") == std::string::npos);
+	CHECK (code.find ("for (") == std::string::npos);
+}
+
+TEST (TestCodegenUnsupportedJoint) {
+	Model model;
+	Body body (1., Vector3d (0., 0., 0.), Vector3d (1., 1., 1.));
+	model.AddBody (0, Xtrans (Vector3d (0., 0., 0.)), Joint (JointTypeSpherical), body);
+
+	std::ostringstream source, header;
+	CHECK (!Addons::CodegenWriteSource (model, "unsupported", source));
+	CHECK (!Addons::CodegenWriteHeader (model, "unsupported", header));
+	CHECK (source.str().empty());
+	CHECK (header.str().empty());
+}
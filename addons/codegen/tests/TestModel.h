@@ -0,0 +1,47 @@
+#ifndef _RBDL_CODEGEN_TEST_MODEL_H
+#define _RBDL_CODEGEN_TEST_MODEL_H
+
+#include <rbdl/rbdl.h>
+
+/** \brief Creates the model that is used to test the generated code
+ *
+ * A floating base (emulated 6-DoF joint) with two branches that contain
+ * axis-aligned and general revolute joints, a prismatic joint, rotated
+ * joint frames and a fixed body.
+ */
+inline void CreateCodegenTestModel (RigidBodyDynamics::Model &model) {
+	using namespace RigidBodyDynamics;
+	using namespace RigidBodyDynamics::Math;
+
+	model.gravity = Vector3d (0., -9.81, 0.);
+
+	Body body_a (1.1, Vector3d (0.1, 0.4, -0.2), Vector3d (0.3, 0.5, 0.2));
+	Body body_b (0.7, Vector3d (-0.2, 0.3, 0.1), Vector3d (0.2, 0.1, 0.4));
+	Body body_c (1.9, Vector3d (0.3, -0.1, 0.2), Vector3d (0.6, 0.4, 0.5));
+
+	Joint joint_floating_base (
+			SpatialVector (0., 0., 0., 1., 0., 0.),
+			SpatialVector (0., 0., 0., 0., 1., 0.),
+			SpatialVector (0., 0., 0., 0., 0., 1.),
+			SpatialVector (0., 0., 1., 0., 0., 0.),
+			SpatialVector (0., 1., 0., 0., 0., 0.),
+			SpatialVector (1., 0., 0., 0., 0., 0.)
+			);
+
+	Joint joint_3dof (
+			SpatialVector (0., 0., 1., 0., 0., 0.),
+			SpatialVector (0., 0.6, 0.8, 0., 0., 0.),
+			SpatialVector (1., 0., 0., 0., 0., 0.)
+			);
+
+	unsigned int base_id = model.AddBody (0, Xtrans (Vector3d (0., 0.2, 0.)), joint_floating_base, body_c, "base");
+	unsigned int hip_id = model.AddBody (base_id, Xtrans (Vector3d (0., 0., 0.3)), Joint (JointTypeRevoluteZ), body_b, "hip");
+	unsigned int knee_id = model.AddBody (hip_id, Xrotx (0.3) * Xtrans (Vector3d (0.5, 0., 0.)), Joint (JointTypeRevoluteX), body_a, "knee");
+	model.AddBody (knee_id, Xtrans (Vector3d (0., -0.6, 0.1)), Joint (JointTypePrismatic, Vector3d (0., 1., 0.)), body_b, "foot");
+	unsigned int arm_id = model.AddBody (base_id, Xtrans (Vector3d (0., 0.4, 0.)), joint_3dof, body_a, "arm");
+	unsigned int hand_id = model.AddBody (arm_id, Xroty (-0.4) * Xtrans (Vector3d (0.3, 0., 0.)), Joint (JointTypeRevoluteY), body_b, "hand");
+	model.AddBody (hand_id, Xtrans (Vector3d (0.1, -0.1, 0.)), Joint (JointTypeFixed), body_c, "tool");
+}
+
+/* _RBDL_CODEGEN_TEST_MODEL_H */
+#endif
@@ -0,0 +1,28 @@
+#include <rbdl/rbdl.h>
+
+#include "../codegen.h"
+#include "TestModel.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+int main (int argc, char *argv[]) {
+	if (argc != 3) {
+		cerr << "Usage: " << argv[0] << " <source.cc> <header.h>" << endl;
+		return -1;
+	}
+
+	RigidBodyDynamics::Model model;
+	CreateCodegenTestModel (model);
+
+	ofstream source (argv[1]);
+	ofstream header (argv[2]);
+
+	if (!RigidBodyDynamics::Addons::CodegenWriteSource (model, "codegen_test_model", source)
+			|| !RigidBodyDynamics::Addons::CodegenWriteHeader (model, "codegen_test_model", header))
+		return -1;
+
+	return 0;
+}
@@ -136,7 +136,9 @@
  * \li \subpage kinematics_page
  * \li \subpage dynamics_page
  * \li \subpage contacts_page
+ * \li \subpage fixed_topology_page
  * \li \subpage addon_luamodel_page 
+ * \li \subpage addon_codegen_page
  *
  * The page \subpage api_version_checking_page contains information about
  * incompatibilities of the existing versions and how to migrate.
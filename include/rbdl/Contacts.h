@@ -143,10 +143,20 @@ namespace RigidBodyDynamics {
  * - ComputeContactImpulsesRangeSpaceSparse()
  * - ComputeContactImpulsesNullSpace()
  *
+ * \subsection solving_friction_contacts Unilateral Contacts with Friction
+ *
+ * Contacts that can only push and whose tangential forces are limited by
+ * Coulomb friction are added with ConstraintSet::AddFrictionContact().
+ * ForwardDynamicsContactsFriction() computes the accelerations and forces
+ * of such contacts (and of additional bilateral constraints) by solving
+ * the linear complementarity problem on top of the range-space operator
+ * \f$K = G H^{-1} G^T\f$ with projected Gauss-Seidel iterations.
+ *
  * @{
  */
 
 struct Model;
+struct DynamicsWorkspace;
 
 /** \brief Structure that contains both constraint information and workspace memory.
  *
@@ -160,7 +170,16 @@ struct Model;
 struct RBDL_DLLAPI ConstraintSet {
 	ConstraintSet() :
 		linear_solver (Math::LinearSolverColPivHouseholderQR),
-		bound (false)
+		bound (false),
+		friction_max_iterations (100),
+		friction_tolerance (1.0e-10),
+		friction_iterations (0),
+		factorization_solver (Math::LinearSolverColPivHouseholderQR),
+		A_factorized (false),
+		range_space_factorized (false),
+		range_space_K_factorized (false),
+		null_space_factorized (false),
+		factorization_reuse_count (0)
 	{}
 
 	/** \brief Adds a constraint to the constraint set.
@@ -181,6 +200,35 @@ struct RBDL_DLLAPI ConstraintSet {
 			const char *constraint_name = NULL,
 			double normal_acceleration = 0.);
 
+	/** \brief Adds a unilateral contact with Coulomb friction to the
+	 * constraint set.
+	 *
+	 * The contact consists of three constraints: one along the normal
+	 * followed by two along orthogonal tangential directions. The force
+	 * along the normal is restricted to be non-negative and the magnitude
+	 * of each tangential force to be at most friction_coefficient times
+	 * the normal force (i.e. the friction cone is approximated by a four
+	 * sided pyramid). These restrictions are only taken into account by
+	 * ForwardDynamicsContactsFriction(), all other methods treat the
+	 * constraints as bilateral.
+	 *
+	 * \param body_id the body which is affected directly by the contact
+	 * \param body_point the point of the contact relative to the contact
+	 * body
+	 * \param world_normal the (unit) normal of the contact surface (in base
+	 * coordinates)
+	 * \param friction_coefficient the Coulomb friction coefficient
+	 * \param constraint_name a human readable name (optional, default: NULL)
+	 *
+	 * \returns the index of the constraint along the normal
+	 */
+	unsigned int AddFrictionContact (
+			unsigned int body_id,
+			const Math::Vector3d &body_point,
+			const Math::Vector3d &world_normal,
+			double friction_coefficient,
+			const char *constraint_name = NULL);
+
 	/** \brief Copies the constraints and resets its ConstraintSet::bound
 	 * flag.
 	 */
@@ -192,6 +240,13 @@ struct RBDL_DLLAPI ConstraintSet {
 	}
 
 	/** \brief Specifies which method should be used for solving undelying linear systems.
+	 *
+	 * With Math::LinearSolverSparseLTL the Direct methods eliminate the
+	 * accelerations using the sparse factorization of H (i.e. they
+	 * compute the same as the RangeSpaceSparse methods), the NullSpace
+	 * methods use a partial pivoting LU for the small systems in the
+	 * constraint space, and ForwardDynamicsContactsKokkevis() solves its
+	 * symmetric system with a LDLT factorization.
 	 */
 	void SetSolver (Math::LinearSolver solver) {
 		linear_solver = solver;
@@ -239,6 +294,24 @@ struct RBDL_DLLAPI ConstraintSet {
 	 * calling ComputeContactImpulsesLagrangian */
 	Math::VectorNd v_plus;
 
+	// Variables used by ForwardDynamicsContactsFriction()
+
+	/// Whether the force of each constraint has to be non-negative.
+	std::vector<bool> unilateral;
+	/** Index of the normal constraint of the contact for the tangential
+	 * constraints added by AddFrictionContact(), the index of the
+	 * constraint itself for all other constraints. */
+	std::vector<unsigned int> friction_normal;
+	/// Friction coefficient of each tangential constraint (0. for all other constraints).
+	std::vector<double> friction_coefficient;
+	/// Maximum number of projected Gauss-Seidel iterations (default: 100).
+	unsigned int friction_max_iterations;
+	/** Iterations stop once no force changes by more than this value
+	 * (default: 1.0e-10). */
+	double friction_tolerance;
+	/// Number of iterations performed by the last call of ForwardDynamicsContactsFriction().
+	unsigned int friction_iterations;
+
 	// Variables used by the Lagrangian methods
 
 	/// Workspace for the joint space inertia matrix.
@@ -248,12 +321,29 @@ struct RBDL_DLLAPI ConstraintSet {
 	/// Workspace of the lower part of b.
 	Math::VectorNd gamma;
 	Math::MatrixNd G;
+	/** Start of the entries of each row of G in ConstraintSet::G_column
+	 * and ConstraintSet::G_value (size: number of constraints + 1).
+	 *
+	 * A row of G only has non-zero entries for the degrees of freedom of
+	 * the joints on the path from the constrained body to the root. The
+	 * entries of row i are stored at the positions G_row_start[i] to
+	 * G_row_start[i + 1] - 1 in ascending column order.
+	 */
+	std::vector<unsigned int> G_row_start;
+	/// Column (degree of freedom) of each non-zero entry of G.
+	std::vector<unsigned int> G_column;
+	/// Values of the non-zero entries of G (see CalcContactJacobianSparse()).
+	Math::VectorNd G_value;
 	/// Workspace for the Lagrangian left-hand-side matrix.
 	Math::MatrixNd A;
 	/// Workspace for the Lagrangian right-hand-side.
 	Math::VectorNd b;
 	/// Workspace for the Lagrangian solution.
 	Math::VectorNd x;
+	/// Workspace for the upper part of the right-hand-side (Tau - C or H * QDotMinus).
+	Math::VectorNd c;
+	/// Workspace for vectors of size \f$ n_\textit{dof} \f$ of the range-space and null-space methods.
+	Math::VectorNd z;
 
 	/// Workspace for the QR decomposition of the null-space method
 #ifdef RBDL_USE_SIMPLE_MATH
@@ -263,17 +353,105 @@ struct RBDL_DLLAPI ConstraintSet {
 #endif
 
 	Math::MatrixNd GT_qr_Q;
+	/// Workspace for the evaluation of GT_qr_Q.
+	Math::VectorNd GT_qr_work;
 	Math::MatrixNd Y;
 	Math::MatrixNd Z;
+	/// Workspace for G * Y.
+	Math::MatrixNd GY;
+	/// Workspace for (G * Y)^T.
+	Math::MatrixNd GYt;
+	/// Workspace for H * Z.
+	Math::MatrixNd HZ;
+	/// Workspace for Z^T * H * Z.
+	Math::MatrixNd ZHZ;
 	Math::VectorNd qddot_y;
 	Math::VectorNd qddot_z;
 
+	// Variables used to share factorizations between the solvers
+
+	/** H for which the cached factorizations were computed.
+	 *
+	 * The Direct, RangeSpaceSparse and NullSpace methods keep their
+	 * factorizations as long as H, G and the linear solver do not change,
+	 * e.g. ComputeContactImpulsesDirect() and ForwardDynamicsContactsDirect()
+	 * for the same state only factorize the system once.
+	 */
+	Math::MatrixNd factorization_H;
+	/// Non-zero values of G for which the cached factorizations were computed.
+	Math::VectorNd factorization_G_value;
+	/// Linear solver for which the cached factorizations were computed.
+	Math::LinearSolver factorization_solver;
+	/// Whether the factorization of A (Direct methods) is valid.
+	bool A_factorized;
+	/// Whether L, range_space_Y_value and K (RangeSpaceSparse methods) are valid.
+	bool range_space_factorized;
+	/// Whether K_llt (RangeSpaceSparse methods) is valid.
+	bool range_space_K_factorized;
+	/// Whether GT_qr, Y, Z and the factorizations of GY, GYt and ZHZ (NullSpace methods) are valid.
+	bool null_space_factorized;
+	/// Number of solves that reused the cached factorizations.
+	unsigned int factorization_reuse_count;
+
+	/// Sparse factorization \f$ H = L^T L \f$ (RangeSpaceSparse methods).
+	Math::MatrixNd L;
+	/** Non-zero entries of \f$ L^{-T} G^T \f$ (RangeSpaceSparse methods).
+	 *
+	 * Column i has the same non-zero structure as row i of G and is stored
+	 * at the same positions as in ConstraintSet::G_value.
+	 */
+	Math::VectorNd range_space_Y_value;
+
+#ifdef RBDL_USE_SIMPLE_MATH
+	// SimpleMath does not have a LU solver so its QR solver is used instead
+	SimpleMath::HouseholderQR<Math::MatrixNd> A_lu;
+	SimpleMath::ColPivHouseholderQR<Math::MatrixNd> A_colpiv_qr;
+	SimpleMath::HouseholderQR<Math::MatrixNd> A_qr;
+	SimpleMath::LLT<Math::MatrixNd> K_llt;
+	SimpleMath::HouseholderQR<Math::MatrixNd> GY_lu;
+	SimpleMath::ColPivHouseholderQR<Math::MatrixNd> GY_colpiv_qr;
+	SimpleMath::HouseholderQR<Math::MatrixNd> GY_qr;
+	SimpleMath::HouseholderQR<Math::MatrixNd> GYt_lu;
+	SimpleMath::ColPivHouseholderQR<Math::MatrixNd> GYt_colpiv_qr;
+	SimpleMath::HouseholderQR<Math::MatrixNd> GYt_qr;
+	SimpleMath::LLT<Math::MatrixNd> ZHZ_llt;
+#else
+	/// Factorizations of A (Direct methods).
+	Eigen::PartialPivLU<Math::MatrixNd> A_lu;
+	Eigen::ColPivHouseholderQR<Math::MatrixNd> A_colpiv_qr;
+	Eigen::HouseholderQR<Math::MatrixNd> A_qr;
+	/// Factorization of \f$ K = G H^{-1} G^T \f$ (RangeSpaceSparse methods).
+	Eigen::LLT<Math::MatrixNd> K_llt;
+	/// Factorizations of \f$ G Y \f$ (NullSpace methods).
+	Eigen::PartialPivLU<Math::MatrixNd> GY_lu;
+	Eigen::ColPivHouseholderQR<Math::MatrixNd> GY_colpiv_qr;
+	Eigen::HouseholderQR<Math::MatrixNd> GY_qr;
+	/// Factorizations of \f$ (G Y)^T \f$ (NullSpace methods).
+	Eigen::PartialPivLU<Math::MatrixNd> GYt_lu;
+	Eigen::ColPivHouseholderQR<Math::MatrixNd> GYt_colpiv_qr;
+	Eigen::HouseholderQR<Math::MatrixNd> GYt_qr;
+	/// Factorization of \f$ Z^T H Z \f$ (NullSpace methods).
+	Eigen::LLT<Math::MatrixNd> ZHZ_llt;
+#endif
+
 	// Variables used by the IABI methods
 
 	/// Workspace for the Inverse Articulated-Body Inertia.
 	Math::MatrixNd K;
 	/// Workspace for the accelerations of due to the test forces
 	Math::VectorNd a;
+
+	/// Factorizations of K (Kokkevis method).
+#ifdef RBDL_USE_SIMPLE_MATH
+	SimpleMath::HouseholderQR<Math::MatrixNd> K_lu;
+	SimpleMath::ColPivHouseholderQR<Math::MatrixNd> K_colpiv_qr;
+	SimpleMath::HouseholderQR<Math::MatrixNd> K_qr;
+#else
+	Eigen::PartialPivLU<Math::MatrixNd> K_lu;
+	Eigen::ColPivHouseholderQR<Math::MatrixNd> K_colpiv_qr;
+	Eigen::HouseholderQR<Math::MatrixNd> K_qr;
+	Eigen::LDLT<Math::MatrixNd> K_ldlt;
+#endif
 	/// Workspace for the test accelerations.
 	Math::VectorNd QDDot_t;
 	/// Workspace for the default accelerations.
@@ -284,6 +462,18 @@ struct RBDL_DLLAPI ConstraintSet {
 	std::vector<Math::SpatialVector> f_ext_constraints;
 	/// Workspace for the default point accelerations.
 	std::vector<Math::Vector3d> point_accel_0;
+	/// Workspace for the spatial forces (in body coordinates of
+	/// ConstraintSet::movable_body) of unit forces along the contact normals.
+	std::vector<Math::SpatialVector> f_normal;
+
+	/// Movable body of each constraint (differs from ConstraintSet::body
+	/// for constraints on fixed bodies).
+	std::vector<unsigned int> movable_body;
+	/** Bodies that are on the path from any of the constrained bodies to
+	 * the root in ascending order. Only these bodies are updated when
+	 * computing the effects of the test forces.
+	 */
+	std::vector<unsigned int> support_bodies;
 
 	/// Workspace for the bias force due to the test force
 	std::vector<Math::SpatialVector> d_pA;
@@ -318,6 +508,54 @@ void CalcContactJacobian(
 		bool update_kinematics = true
 		);
 
+/** \brief Same as CalcContactJacobian() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcContactJacobian (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const ConstraintSet &CS,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the non-zero entries of the Jacobian of a bound
+ * ConstraintSet
+ *
+ * Only the entries of the degrees of freedom that support the constrained
+ * bodies are evaluated (see ConstraintSet::G_row_start). They are stored
+ * in ConstraintSet::G_value and the corresponding entries of
+ * ConstraintSet::G. All other entries of ConstraintSet::G are left
+ * untouched, i.e. they stay zero as long as ConstraintSet::G is only
+ * modified by this function.
+ *
+ * \param model the model
+ * \param Q     the generalized positions of the joints
+ * \param CS    the bound constraint set for which the Jacobian should be computed
+ * \param update_kinematics whether the kinematics of the model should be updated from Q
+ */
+RBDL_DLLAPI
+void CalcContactJacobianSparse (
+		Model &model,
+		const Math::VectorNd &Q,
+		ConstraintSet &CS,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcContactJacobianSparse() but stores all intermediate
+ * values in the DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcContactJacobianSparse (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		ConstraintSet &CS,
+		bool update_kinematics = true
+		);
+
 RBDL_DLLAPI
 void CalcContactSystemVariables (
 		Model &model,
@@ -327,6 +565,19 @@ void CalcContactSystemVariables (
 		ConstraintSet &CS
 		);
 
+/** \brief Same as CalcContactSystemVariables() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcContactSystemVariables (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS
+		);
+
 /** \brief Computes forward dynamics with contact by constructing and solving the full lagrangian equation
  *
  * This method builds and solves the linear system \f[
@@ -387,6 +638,20 @@ void ForwardDynamicsContactsDirect (
 		Math::VectorNd &QDDot
 		);
 
+/** \brief Same as ForwardDynamicsContactsDirect() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsDirect (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		);
+
 RBDL_DLLAPI
 void ForwardDynamicsContactsRangeSpaceSparse (
 		Model &model,
@@ -397,6 +662,20 @@ void ForwardDynamicsContactsRangeSpaceSparse (
 		Math::VectorNd &QDDot
 		);
 
+/** \brief Same as ForwardDynamicsContactsRangeSpaceSparse() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsRangeSpaceSparse (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		);
+
 RBDL_DLLAPI
 void ForwardDynamicsContactsNullSpace (
 		Model &model,
@@ -407,6 +686,77 @@ void ForwardDynamicsContactsNullSpace (
 		Math::VectorNd &QDDot
 		);
 
+/** \brief Same as ForwardDynamicsContactsNullSpace() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsNullSpace (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		);
+
+/** \brief Computes forward dynamics with unilateral frictional contacts
+ *
+ * Computes the constraint forces \f$\lambda\f$ with projected
+ * Gauss-Seidel iterations on the linear complementarity problem \f[
+   w = K \lambda - a, \quad
+   K = G H^{-1} G^T, \quad
+   a = \gamma - G H^{-1} (\tau - C)
+ \f] where \f$w\f$ is the difference between the constraint accelerations
+ * and ConstraintSet::acceleration. For the normal of a contact that was
+ * added with ConstraintSet::AddFrictionContact() either the force or the
+ * acceleration is zero and both are non-negative. The tangential forces
+ * are bounded by the friction coefficient times the normal force and
+ * their accelerations vanish unless they are at the bound. All other
+ * constraints are bilateral (\f$w = 0\f$).
+ *
+ * The iterations start from the values of ConstraintSet::force, i.e. the
+ * forces of the previous call are used as warm start. The number of
+ * performed iterations is stored in ConstraintSet::friction_iterations.
+ *
+ * The operator \f$K\f$ and the sparse factorization of \f$H\f$ are the
+ * ones of the RangeSpaceSparse methods and are shared with them.
+ *
+ * \param model rigid body model
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param Tau   actuations of the internal joints
+ * \param CS    the description of all acting constraints
+ * \param QDDot accelerations of the internals joints (output)
+ *
+ * \note The friction forces only depend on the accelerations, i.e. the
+ * contacts are assumed to be sticking or starting to slide. The direction
+ * of the velocity of sliding contacts is not taken into account.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsFriction (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		);
+
+/** \brief Same as ForwardDynamicsContactsFriction() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsFriction (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		);
+
 /** \brief Computes forward dynamics that accounts for active contacts in ConstraintSet.
  *
  * The method used here is the one described by Kokkevis and Metaxas in the
@@ -479,6 +829,20 @@ void ForwardDynamicsContactsKokkevis (
 		Math::VectorNd &QDDot
 		);
 
+/** \brief Same as ForwardDynamicsContactsKokkevis() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsKokkevis (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		);
+
 /** \brief Computes forward dynamics with contact by constructing and solving the full lagrangian equation
  *
  * This method builds and solves the linear system \f[
@@ -535,6 +899,19 @@ void ComputeContactImpulsesDirect (
 		Math::VectorNd &QDotPlus
 		);
 
+/** \brief Same as ComputeContactImpulsesDirect() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ComputeContactImpulsesDirect (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDotMinus,
+		ConstraintSet &CS,
+		Math::VectorNd &QDotPlus
+		);
+
 RBDL_DLLAPI
 void ComputeContactImpulsesRangeSpaceSparse (
 		Model &model,
@@ -544,6 +921,19 @@ void ComputeContactImpulsesRangeSpaceSparse (
 		Math::VectorNd &QDotPlus
 		);
 
+/** \brief Same as ComputeContactImpulsesRangeSpaceSparse() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ComputeContactImpulsesRangeSpaceSparse (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDotMinus,
+		ConstraintSet &CS,
+		Math::VectorNd &QDotPlus
+		);
+
 RBDL_DLLAPI
 void ComputeContactImpulsesNullSpace (
 		Model &model,
@@ -553,6 +943,19 @@ void ComputeContactImpulsesNullSpace (
 		Math::VectorNd &QDotPlus
 		);
 
+/** \brief Same as ComputeContactImpulsesNullSpace() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ComputeContactImpulsesNullSpace (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDotMinus,
+		ConstraintSet &CS,
+		Math::VectorNd &QDotPlus
+		);
+
 /** \brief Solves the full contact system directly, i.e. simultaneously for contact forces and joint accelerations.
  *
  * This solves a \f$ (n_\textit{dof} +
@@ -602,7 +1005,7 @@ void SolveContactSystemDirect (
  */
 RBDL_DLLAPI
 void SolveContactSystemRangeSpaceSparse (
-		Model &model, 
+		const Model &model, 
 		Math::MatrixNd &H, 
 		const Math::MatrixNd &G, 
 		const Math::VectorNd &c, 
@@ -19,6 +19,8 @@
 namespace RigidBodyDynamics {
 
 struct Model;
+struct DynamicsWorkspace;
+struct BatchDynamicsWorkspace;
 
 /** \page dynamics_page Dynamics
  *
@@ -54,6 +56,86 @@ void ForwardDynamics (
 		std::vector<Math::SpatialVector> *f_ext = NULL
 		);
 
+/** \brief Same as ForwardDynamics() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ForwardDynamics (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		Math::VectorNd &QDDot,
+		std::vector<Math::SpatialVector> *f_ext = NULL
+		);
+
+/** \brief Computes forward dynamics with the Articulated Body Algorithm for
+ * many states at once
+ *
+ * Each column of Q, QDot and Tau describes one state of the model and the
+ * corresponding column of QDDot receives its generalized accelerations.
+ * The results are the same as calling ForwardDynamics() for every column.
+ *
+ * The bodies are traversed in the outer loop and the samples in the inner
+ * loop. The joint type dispatch and the topology traversal are therefore
+ * only performed once for the whole batch.
+ *
+ * \param model rigid body model
+ * \param ws    batch workspace (is (re-)initialized if it does not match
+ * the number of columns of Q)
+ * \param Q     state vectors of the internal joints (q_size x N)
+ * \param QDot  velocity vectors of the internal joints (qdot_size x N)
+ * \param Tau   actuations of the internal joints (qdot_size x N)
+ * \param QDDot accelerations of the internal joints (output, qdot_size x N)
+ *
+ * \note External forces are not supported by the batched version.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsBatch (
+		const Model &model,
+		BatchDynamicsWorkspace &ws,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		const Math::MatrixNd &Tau,
+		Math::MatrixNd &QDDot
+		);
+
+/** \brief Temporary values of ForwardDynamicsLagrangian()
+ *
+ * Holds the joint space inertia matrix, the bias forces, the right hand
+ * side of the linear system and one factorization object for each \ref
+ * Math::LinearSolver. All of them are sized once for the model such that
+ * ForwardDynamicsLagrangian() does not allocate any heap memory when it is
+ * called with this workspace.
+ *
+ * \note A workspace has to be (re-)initialized with Init() whenever bodies
+ * are added to the model.
+ */
+struct RBDL_DLLAPI LagrangianWorkspace {
+	LagrangianWorkspace() {}
+	/// \brief Creates a workspace with storage for the model
+	explicit LagrangianWorkspace (const Model &model);
+
+	/// \brief Allocates the storage for the degrees of freedom of the model
+	void Init (const Model &model);
+
+	/// \brief The joint space inertia matrix
+	Math::MatrixNd H;
+	/// \brief The bias forces (coriolis, centrifugal, gravitational, and
+	/// external forces)
+	Math::VectorNd C;
+	/// \brief The right hand side Tau - C of the linear system
+	Math::VectorNd rhs;
+
+#ifndef RBDL_USE_SIMPLE_MATH
+	Eigen::PartialPivLU<Math::MatrixNd> partial_piv_lu;
+	Eigen::ColPivHouseholderQR<Math::MatrixNd> col_piv_householder_qr;
+	Eigen::HouseholderQR<Math::MatrixNd> householder_qr;
+	Eigen::LLT<Math::MatrixNd> llt;
+#endif
+};
+
 /** \brief Computes forward dynamics by building and solving the full Lagrangian equation
  *
  * This method builds and solves the linear system
@@ -71,6 +153,10 @@ void ForwardDynamics (
  * \param f_ext External forces acting on the body in base coordinates (optional, defaults to NULL)
  * \param H     preallocated workspace area for the joint space inertia matrix of size dof_count x dof_count (optional, defaults to NULL and allocates temporary matrix)
  * \param C     preallocated workspace area for the right hand side vector of size dof_count x 1 (optional, defaults to NULL and allocates temporary vector)
+ *
+ * \note For Math::LinearSolverSparseLTL the factorization exploits the
+ * branch induced sparsity of H which is considerably faster for wide
+ * branched models. H then contains the factor L of H = L^T L afterwards.
  */
 RBDL_DLLAPI
 void ForwardDynamicsLagrangian (
@@ -85,6 +171,58 @@ void ForwardDynamicsLagrangian (
 		Math::VectorNd *C = NULL	
 		);
 
+/** \brief Same as ForwardDynamicsLagrangian() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsLagrangian (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		Math::VectorNd &QDDot,
+		Math::LinearSolver linear_solver = Math::LinearSolverColPivHouseholderQR,
+		std::vector<Math::SpatialVector> *f_ext = NULL,
+		Math::MatrixNd *H = NULL,
+		Math::VectorNd *C = NULL	
+		);
+
+/** \brief Same as ForwardDynamicsLagrangian() but uses the matrices and
+ * factorizations of a LagrangianWorkspace
+ *
+ * Once the workspace is initialized for the model this function does not
+ * allocate any heap memory which allows to use it in real-time loops. The
+ * joint space inertia matrix and the bias forces of the last call are
+ * available in LagrangianWorkspace::H and LagrangianWorkspace::C.
+ *
+ * \note For Math::LinearSolverSparseLTL the matrix H is factorized in
+ * place with SparseFactorizeLTL() and therefore contains the factor L
+ * afterwards.
+ *
+ * \param model rigid body model
+ * \param ws    workspace for the intermediate values of the algorithms
+ * \param lws   workspace for the linear system
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param Tau   actuations of the internal joints
+ * \param QDDot accelerations of the internal joints (output)
+ * \param linear_solver specification which method should be used for solving the linear system
+ * \param f_ext External forces acting on the body in base coordinates (optional, defaults to NULL)
+ */
+RBDL_DLLAPI
+void ForwardDynamicsLagrangian (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		LagrangianWorkspace &lws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		Math::VectorNd &QDDot,
+		Math::LinearSolver linear_solver = Math::LinearSolverColPivHouseholderQR,
+		std::vector<Math::SpatialVector> *f_ext = NULL
+		);
+
 /** \brief Computes the coriolis forces
  *
  * This function computes the generalized forces from given generalized
@@ -104,6 +242,18 @@ void NonlinearEffects (
 		Math::VectorNd &Tau
 		);
 
+/** \brief Same as NonlinearEffects() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void NonlinearEffects (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		Math::VectorNd &Tau
+		);
+
 /** \brief Computes inverse dynamics with the Newton-Euler Algorithm
  *
  * This function computes the generalized forces from given generalized
@@ -127,6 +277,20 @@ void InverseDynamics (
 		std::vector<Math::SpatialVector> *f_ext = NULL
 		);
 
+/** \brief Same as InverseDynamics() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void InverseDynamics (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &QDDot,
+		Math::VectorNd &Tau,
+		std::vector<Math::SpatialVector> *f_ext = NULL
+		);
+
 /** \brief Computes the joint space inertia matrix by using the Composite Rigid Body Algorithm
  *
  * This function computes the joint space inertia matrix from a given model and
@@ -150,6 +314,185 @@ void CompositeRigidBodyAlgorithm (
 		bool update_kinematics = true
 		);
 
+/** \brief Same as CompositeRigidBodyAlgorithm() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CompositeRigidBodyAlgorithm (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		Math::MatrixNd &H,
+		bool update_kinematics = true
+		);
+
+/** \brief Temporary values of InverseDynamicsDerivatives() and
+ * ForwardDynamicsDerivatives()
+ *
+ * The derivative algorithms work with quantities that are expressed in
+ * base coordinates. The per-body values are indexed by the body id, the
+ * per-degree-of-freedom values by the index into QDot.
+ *
+ * \note A workspace has to be (re-)initialized with Init() whenever bodies
+ * are added to the model.
+ */
+struct RBDL_DLLAPI DynamicsDerivativesWorkspace {
+	DynamicsDerivativesWorkspace() {}
+	/// \brief Creates a workspace with storage for the model
+	explicit DynamicsDerivativesWorkspace (const Model &model);
+
+	/// \brief Allocates the storage for the bodies and degrees of freedom of the model
+	void Init (const Model &model);
+
+	/// \brief The spatial velocity of the bodies
+	std::vector<Math::SpatialVector> v;
+	/// \brief The spatial acceleration of the bodies (including gravity)
+	std::vector<Math::SpatialVector> a;
+	/// \brief The spatial force transmitted by the joint of each body
+	std::vector<Math::SpatialVector> f;
+	/// \brief The composite spatial inertia of the subtree of each body
+	std::vector<Math::SpatialMatrix> Ic;
+	/// \brief The composite of the velocity dependent matrices B(v, I) of
+	/// the subtree of each body
+	std::vector<Math::SpatialMatrix> Bc;
+
+	/// \brief Motion subspace of each degree of freedom
+	std::vector<Math::SpatialVector> S;
+	/// \brief Time derivative of S
+	std::vector<Math::SpatialVector> S_dot;
+	/// \brief Derivative of the spatial velocity with respect to the
+	/// position of each degree of freedom
+	std::vector<Math::SpatialVector> Psi_dot;
+	/// \brief Derivative of the spatial acceleration with respect to the
+	/// position of each degree of freedom
+	std::vector<Math::SpatialVector> Psi_ddot;
+
+	/// \brief The joint space inertia matrix (contains its factor L of
+	/// SparseFactorizeLTL() after ForwardDynamicsDerivatives())
+	Math::MatrixNd H;
+	/// \brief Generalized forces of the last evaluation
+	Math::VectorNd tau;
+	/// \brief Temporary column for the solves with H
+	Math::VectorNd column;
+};
+
+/** \brief Computes inverse dynamics and its derivatives with respect to
+ * the generalized positions and velocities
+ *
+ * Computes the partial derivatives of \f$ \tau = ID(q, \dot{q},
+ * \ddot{q}) \f$ analytically with a forward and a backward sweep over the
+ * model (Carpentier and Mansard, "Analytical Derivatives of Rigid Body
+ * Dynamics Algorithms", RSS 2018). The cost is proportional to the number
+ * of degrees of freedom times the depth of the kinematic tree, compared to
+ * 2 n + 1 evaluations of InverseDynamics() for central finite differences.
+ * The derivative with respect to \f$ \ddot{q} \f$ is the joint space
+ * inertia matrix, see CompositeRigidBodyAlgorithm().
+ *
+ * The columns of spherical joints are derivatives with respect to a
+ * rotation of the joint about its local axes (i.e. in the tangent space of
+ * the quaternion) which is why DTauDQ is always of size dof_count x
+ * dof_count.
+ *
+ * \param model rigid body model
+ * \param ws    workspace for the intermediate values of the algorithms
+ * \param dws   workspace for the intermediate values of the derivatives
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param QDDot accelerations of the internals joints
+ * \param Tau   actuations of the internal joints (output)
+ * \param DTauDQ    derivative of Tau with respect to Q (output, dof_count x dof_count)
+ * \param DTauDQDot derivative of Tau with respect to QDot (output, dof_count x dof_count)
+ *
+ * \note External forces are not supported.
+ */
+RBDL_DLLAPI
+void InverseDynamicsDerivatives (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		DynamicsDerivativesWorkspace &dws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &QDDot,
+		Math::VectorNd &Tau,
+		Math::MatrixNd &DTauDQ,
+		Math::MatrixNd &DTauDQDot
+		);
+
+/** \brief Same as InverseDynamicsDerivatives() but stores all
+ * intermediate values in the model and in a temporary
+ * DynamicsDerivativesWorkspace.
+ */
+RBDL_DLLAPI
+void InverseDynamicsDerivatives (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &QDDot,
+		Math::VectorNd &Tau,
+		Math::MatrixNd &DTauDQ,
+		Math::MatrixNd &DTauDQDot
+		);
+
+/** \brief Computes forward dynamics and its derivatives with respect to
+ * the generalized positions, velocities, and forces
+ *
+ * Uses that \f$ \ddot{q} = FD(q, \dot{q}, \tau) \f$ is the inverse of
+ * \f$ ID \f$, i.e.
+ * \f[
+ *   \frac{\partial \ddot{q}}{\partial q} = -H^{-1} \frac{\partial ID}{\partial q},
+ *   \quad
+ *   \frac{\partial \ddot{q}}{\partial \dot{q}} = -H^{-1} \frac{\partial ID}{\partial \dot{q}},
+ *   \quad
+ *   \frac{\partial \ddot{q}}{\partial \tau} = H^{-1}
+ * \f]
+ * where the derivatives of ID are evaluated with InverseDynamicsDerivatives()
+ * at the accelerations computed by ForwardDynamics(). The solves with H use
+ * SparseFactorizeLTL().
+ *
+ * \param model rigid body model
+ * \param ws    workspace for the intermediate values of the algorithms
+ * \param dws   workspace for the intermediate values of the derivatives
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param Tau   actuations of the internal joints
+ * \param QDDot accelerations of the internal joints (output)
+ * \param DQDDotDQ    derivative of QDDot with respect to Q (output, dof_count x dof_count)
+ * \param DQDDotDQDot derivative of QDDot with respect to QDot (output, dof_count x dof_count)
+ * \param DQDDotDTau  derivative of QDDot with respect to Tau, i.e. the
+ * inverse of the joint space inertia matrix (output, dof_count x dof_count)
+ *
+ * \note External forces are not supported.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsDerivatives (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		DynamicsDerivativesWorkspace &dws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		Math::VectorNd &QDDot,
+		Math::MatrixNd &DQDDotDQ,
+		Math::MatrixNd &DQDDotDQDot,
+		Math::MatrixNd &DQDDotDTau
+		);
+
+/** \brief Same as ForwardDynamicsDerivatives() but stores all
+ * intermediate values in the model and in a temporary
+ * DynamicsDerivativesWorkspace.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsDerivatives (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		Math::VectorNd &QDDot,
+		Math::MatrixNd &DQDDotDQ,
+		Math::MatrixNd &DQDDotDQDot,
+		Math::MatrixNd &DQDDotDTau
+		);
+
 /** @} */
 
 }
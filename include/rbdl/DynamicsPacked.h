@@ -0,0 +1,155 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_DYNAMICS_PACKED_H
+#define RBDL_DYNAMICS_PACKED_H
+
+#include <cstddef>
+#include <vector>
+
+#include "rbdl/rbdl_math.h"
+#include "rbdl/Model.h"
+
+namespace RigidBodyDynamics {
+
+/** \brief Memory layout of a PackedDynamicsWorkspace
+ */
+enum PackedLayout {
+	/// \brief Array of structures: all values of a body form one block
+	PackedLayoutAoS = 0,
+	/// \brief Structure of arrays: each value is stored for all bodies in one array
+	PackedLayoutSoA
+};
+
+/** \brief Temporary values of ForwardDynamicsPacked() in a single
+ * cache-line aligned arena
+ *
+ * The DynamicsWorkspace stores each per-body value in a separate
+ * std::vector such that a single iteration of the Articulated Body
+ * Algorithm touches many unrelated memory regions. This workspace stores
+ * the values that are used by the sweeps of ForwardDynamicsPacked() in one
+ * contiguous allocation. The bodies are stored in depth-first order of the
+ * tree such that bodies of the same branch are close to each other in
+ * memory.
+ *
+ * With PackedLayoutAoS all values of a body are stored in a single block
+ * that starts at a cache line. With PackedLayoutSoA each value is stored in
+ * an array that starts at a cache line.
+ *
+ * The values are accessed by the storage slot of a body, i.e. v(slot[i])
+ * is the velocity of body i.
+ *
+ * \note A workspace has to be (re-)initialized with Init() whenever bodies
+ * are added to the model.
+ */
+struct RBDL_DLLAPI PackedDynamicsWorkspace {
+	PackedDynamicsWorkspace();
+	/// \brief Creates a workspace for the model with the given layout
+	explicit PackedDynamicsWorkspace (const Model &model, PackedLayout layout = PackedLayoutAoS);
+	~PackedDynamicsWorkspace();
+
+	/// \brief (Re-)allocates the arena for the model with the given layout
+	void Init (const Model &model, PackedLayout layout = PackedLayoutAoS);
+
+	/// \brief Layout of the arena
+	PackedLayout layout;
+	/// \brief Number of bodies (including the root body) stored in the arena
+	unsigned int body_count;
+	/// \brief Id of the body that is stored in each slot (depth-first order)
+	std::vector<unsigned int> order;
+	/// \brief Storage slot of each body
+	std::vector<unsigned int> slot;
+	/// \brief Storage slot of the parent of the body stored in each slot
+	std::vector<unsigned int> parent_slot;
+	/// \brief Size of the arena in bytes
+	size_t arena_size;
+
+	Math::SpatialTransform& X_lambda (unsigned int s) { return value<Math::SpatialTransform> (FieldXLambda, s); }
+	Math::SpatialVector& v (unsigned int s) { return value<Math::SpatialVector> (FieldV, s); }
+	Math::SpatialVector& c (unsigned int s) { return value<Math::SpatialVector> (FieldC, s); }
+	Math::SpatialVector& pA (unsigned int s) { return value<Math::SpatialVector> (FieldPA, s); }
+	Math::SpatialMatrix& IA (unsigned int s) { return value<Math::SpatialMatrix> (FieldIA, s); }
+	Math::SpatialVector& U (unsigned int s) { return value<Math::SpatialVector> (FieldU, s); }
+	double& d (unsigned int s) { return value<double> (FieldD, s); }
+	double& u (unsigned int s) { return value<double> (FieldUScalar, s); }
+	Math::SpatialVector& a (unsigned int s) { return value<Math::SpatialVector> (FieldA, s); }
+
+	/// \brief Values for joints with 3 degrees of freedom (only valid if
+	/// the model contains such joints)
+	Math::Matrix63& multdof3_S (unsigned int s) { return value<Math::Matrix63> (FieldMultdof3S, s); }
+	Math::Matrix63& multdof3_U (unsigned int s) { return value<Math::Matrix63> (FieldMultdof3U, s); }
+	Math::Matrix3d& multdof3_Dinv (unsigned int s) { return value<Math::Matrix3d> (FieldMultdof3Dinv, s); }
+	Math::Vector3d& multdof3_u (unsigned int s) { return value<Math::Vector3d> (FieldMultdof3UVector, s); }
+
+	private:
+		enum Field {
+			FieldXLambda = 0,
+			FieldV,
+			FieldC,
+			FieldPA,
+			FieldIA,
+			FieldU,
+			FieldD,
+			FieldUScalar,
+			FieldA,
+			FieldMultdof3S,
+			FieldMultdof3U,
+			FieldMultdof3Dinv,
+			FieldMultdof3UVector,
+			FieldCount
+		};
+
+		template <typename T>
+		T& value (Field field, unsigned int s) {
+			return *reinterpret_cast<T*> (arena + field_offset[field] + s * field_stride[field]);
+		}
+
+		/// \brief Start of the cache line aligned arena
+		char *arena;
+		/// \brief The allocation that contains the arena
+		char *arena_allocation;
+		/// \brief Offset of the value of slot 0 for each field
+		size_t field_offset[FieldCount];
+		/// \brief Distance in bytes between the values of consecutive slots
+		size_t field_stride[FieldCount];
+
+		PackedDynamicsWorkspace (const PackedDynamicsWorkspace&);
+		PackedDynamicsWorkspace& operator= (const PackedDynamicsWorkspace&);
+};
+
+/** \ingroup dynamics_group
+ * @{
+ */
+
+/** \brief Computes forward dynamics with the Articulated Body Algorithm
+ * using the packed storage of a PackedDynamicsWorkspace
+ *
+ * Gives the same results as ForwardDynamics() without external forces.
+ *
+ * \param model rigid body model
+ * \param ws    packed workspace that was initialized for the model
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param Tau   actuations of the internal joints
+ * \param QDDot accelerations of the internal joints (output)
+ */
+RBDL_DLLAPI
+void ForwardDynamicsPacked (
+		const Model &model,
+		PackedDynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		Math::VectorNd &QDDot
+		);
+
+/** @} */
+
+}
+
+/* RBDL_DYNAMICS_PACKED_H */
+#endif
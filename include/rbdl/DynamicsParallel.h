@@ -0,0 +1,291 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_DYNAMICS_PARALLEL_H
+#define RBDL_DYNAMICS_PARALLEL_H
+
+#include <vector>
+
+#include "rbdl/rbdl_math.h"
+#include "rbdl/Model.h"
+#include "rbdl/Kinematics.h"
+#include "rbdl/Contacts.h"
+#include "rbdl/ThreadPool.h"
+
+namespace RigidBodyDynamics {
+
+/** \brief Signature of the ForwardDynamicsContacts*() functions that take a
+ * DynamicsWorkspace, e.g. ForwardDynamicsContactsDirect or
+ * ForwardDynamicsContactsKokkevis.
+ */
+typedef void (*ForwardDynamicsContactsFunction) (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		);
+
+/** \brief Thread pool and per-worker temporary values of the parallel
+ * batch algorithms
+ *
+ * Each worker of the pool owns a DynamicsWorkspace, copies of the
+ * ConstraintSet and the InverseKinematicsConstraintSet and buffers for a
+ * single state. The model itself is
+ * shared by all workers and is never copied.
+ *
+ * \note A workspace has to be (re-)initialized with Init() whenever bodies
+ * are added to the model.
+ */
+struct RBDL_DLLAPI ParallelDynamicsWorkspace {
+	ParallelDynamicsWorkspace();
+	/** \brief Creates a workspace and starts the worker threads
+	 *
+	 * \param model the model that is evaluated
+	 * \param thread_count number of workers (optional, defaults to 0 which
+	 * uses the number of hardware threads)
+	 */
+	explicit ParallelDynamicsWorkspace (const Model &model, unsigned int thread_count = 0);
+	~ParallelDynamicsWorkspace();
+
+	/// \brief (Re-)starts the worker threads and allocates their storage
+	void Init (const Model &model, unsigned int thread_count = 0);
+
+	/// \brief Returns the number of workers
+	unsigned int GetThreadCount () const;
+
+	/// \brief The worker threads
+	ThreadPool *pool;
+	/// \brief Number of states per chunk of work (0 chooses it automatically)
+	unsigned int chunk_size;
+
+	/// \brief Temporary values of the algorithms for each worker
+	std::vector<DynamicsWorkspace> worker_ws;
+	/// \brief Copies of the constraint set for each worker (bound to the model)
+	std::vector<ConstraintSet> worker_CS;
+	/// \brief Copies of the inverse kinematics constraints for each worker
+	std::vector<InverseKinematicsConstraintSet> worker_ik_CS;
+
+	/// \brief Buffers for the state that is currently processed by each worker
+	std::vector<Math::VectorNd> worker_q;
+	std::vector<Math::VectorNd> worker_qdot;
+	std::vector<Math::VectorNd> worker_qddot;
+	std::vector<Math::VectorNd> worker_tau;
+
+	private:
+		ParallelDynamicsWorkspace (const ParallelDynamicsWorkspace&);
+		ParallelDynamicsWorkspace& operator= (const ParallelDynamicsWorkspace&);
+};
+
+/** \ingroup dynamics_group
+ * @{
+ */
+
+/** \brief Computes forward dynamics for many states using all workers of
+ * the thread pool
+ *
+ * Same as calling ForwardDynamics() for every column of Q, QDot, and Tau.
+ *
+ * \param model rigid body model
+ * \param ws    parallel workspace
+ * \param Q     state vectors of the internal joints (q_size x N)
+ * \param QDot  velocity vectors of the internal joints (qdot_size x N)
+ * \param Tau   actuations of the internal joints (qdot_size x N)
+ * \param QDDot accelerations of the internal joints (output, qdot_size x N)
+ */
+RBDL_DLLAPI
+void ForwardDynamicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		const Math::MatrixNd &Tau,
+		Math::MatrixNd &QDDot
+		);
+
+/** \brief Computes inverse dynamics for many states using all workers of
+ * the thread pool
+ *
+ * Same as calling InverseDynamics() for every column of Q, QDot, and
+ * QDDot.
+ *
+ * \param model rigid body model
+ * \param ws    parallel workspace
+ * \param Q     state vectors of the internal joints (q_size x N)
+ * \param QDot  velocity vectors of the internal joints (qdot_size x N)
+ * \param QDDot accelerations of the internal joints (qdot_size x N)
+ * \param Tau   actuations of the internal joints (output, qdot_size x N)
+ */
+RBDL_DLLAPI
+void InverseDynamicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		const Math::MatrixNd &QDDot,
+		Math::MatrixNd &Tau
+		);
+
+/** \brief Computes the joint space inertia matrices for many states using
+ * all workers of the thread pool
+ *
+ * Same as calling CompositeRigidBodyAlgorithm() for every column of Q.
+ * Unlike CompositeRigidBodyAlgorithm() the matrices do not have to be
+ * zeroed before.
+ *
+ * \param model rigid body model
+ * \param ws    parallel workspace
+ * \param Q     state vectors of the internal joints (q_size x N)
+ * \param H     joint space inertia matrix for each column of Q (output)
+ */
+RBDL_DLLAPI
+void CompositeRigidBodyAlgorithmParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const Math::MatrixNd &Q,
+		std::vector<Math::MatrixNd> &H
+		);
+
+/** @} */
+
+/** \ingroup contacts_group
+ * @{
+ */
+
+/** \brief Computes forward dynamics with contacts for many states using all
+ * workers of the thread pool
+ *
+ * Same as calling the given contact method for every column of Q, QDot,
+ * and Tau. Each worker uses its own copy of CS that is bound to the model
+ * on the first call. The constraint definitions are copied again on every
+ * call (i.e. CS may be modified in place between calls), the copies are
+ * only bound again when the constrained bodies change. The method is
+ * called with the forces of CS for every column such that
+ * ForwardDynamicsContactsFriction() is warm started from CS.force for all
+ * states.
+ *
+ * \param model  rigid body model
+ * \param ws     parallel workspace
+ * \param Q      state vectors of the internal joints (q_size x N)
+ * \param QDot   velocity vectors of the internal joints (qdot_size x N)
+ * \param Tau    actuations of the internal joints (qdot_size x N)
+ * \param CS     the description of all acting constraints
+ * \param QDDot  accelerations of the internal joints (output, qdot_size x N)
+ * \param method the contact method (optional, defaults to
+ * ForwardDynamicsContactsDirect)
+ * \param Forces constraint forces for each state (optional output, CS.size() x N)
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		const Math::MatrixNd &Tau,
+		const ConstraintSet &CS,
+		Math::MatrixNd &QDDot,
+		ForwardDynamicsContactsFunction method = ForwardDynamicsContactsDirect,
+		Math::MatrixNd *Forces = NULL
+		);
+
+/** @} */
+
+/** \ingroup kinematics_group
+ * @{
+ */
+
+/** \brief Computes the inverse kinematics of a sequence of frames using all
+ * workers of the thread pool
+ *
+ * The frames are split into contiguous chunks of ws.chunk_size frames
+ * (16 frames if ws.chunk_size is 0). The first frame of each chunk starts
+ * at Qinit, every further frame is warm started from the solution of the
+ * previous frame, including the damping factor reached there. The result
+ * therefore only depends on the chunk size and not on the number of
+ * workers.
+ *
+ * Each worker uses its own copy of CS that is bound to the model on the
+ * first call and only bound again when the constraint types change. The
+ * constraint definitions, solver parameters and joint limits are copied on
+ * every call.
+ *
+ * \param model rigid body model
+ * \param ws    parallel workspace
+ * \param Qinit initial guess for the first frame of each chunk
+ * \param CS    the constraints and solver parameters (the targets of CS are
+ * ignored)
+ * \param target_positions target positions for each frame, one per
+ * constraint (the entries of orientation constraints are ignored), may be
+ * empty if there are only orientation constraints
+ * \param target_orientations target orientations for each frame, one per
+ * constraint (the entries of position constraints are ignored), may be
+ * empty if there are no orientation constraints
+ * \param QRes  solutions of all frames (output, q_size x N)
+ * \param num_steps number of solver steps of each frame (optional output)
+ * \param error_norms norm of the remaining constraint error of each frame
+ * (optional output)
+ *
+ * \returns true if the solver converged for all frames
+ */
+RBDL_DLLAPI
+bool InverseKinematicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const Math::VectorNd &Qinit,
+		const InverseKinematicsConstraintSet &CS,
+		const std::vector<std::vector<Math::Vector3d> > &target_positions,
+		const std::vector<std::vector<Math::Matrix3d> > &target_orientations,
+		Math::MatrixNd &QRes,
+		std::vector<unsigned int> *num_steps = NULL,
+		Math::VectorNd *error_norms = NULL
+		);
+
+/** \brief Computes the inverse kinematics of point targets for a sequence
+ * of frames using all workers of the thread pool
+ *
+ * The body points are added as point constraints to an
+ * InverseKinematicsConstraintSet, which is then solved with the
+ * InverseKinematicsConstraintSet version of InverseKinematicsParallel().
+ * Each frame therefore runs the Levenberg-Marquardt solver of
+ * InverseKinematics (const Model&, DynamicsWorkspace&, const VectorNd&,
+ * InverseKinematicsConstraintSet&, VectorNd&) with adaptive damping, and
+ * not the fixed damping of the point version of InverseKinematics(). The
+ * parameters are mapped onto the constraint set as follows (all other
+ * parameters keep their defaults):
+ *
+ * - step_tol is used as InverseKinematicsConstraintSet::step_tol and as
+ *   InverseKinematicsConstraintSet::constraint_tol
+ * - lambda is InverseKinematicsConstraintSet::lambda, the damping of the
+ *   first frame of each chunk (further frames start with the damping
+ *   reached at the previous frame)
+ * - max_iter is InverseKinematicsConstraintSet::max_steps, i.e. it counts
+ *   accepted and discarded steps
+ */
+RBDL_DLLAPI
+bool InverseKinematicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const Math::VectorNd &Qinit,
+		const std::vector<unsigned int>& body_id,
+		const std::vector<Math::Vector3d>& body_point,
+		const std::vector<std::vector<Math::Vector3d> > &target_pos,
+		Math::MatrixNd &QRes,
+		double step_tol = 1.0e-12,
+		double lambda = 0.01,
+		unsigned int max_iter = 50,
+		std::vector<unsigned int> *num_steps = NULL,
+		Math::VectorNd *error_norms = NULL
+		);
+
+/** @} */
+
+}
+
+/* RBDL_DYNAMICS_PARALLEL_H */
+#endif
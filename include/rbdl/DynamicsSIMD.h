@@ -0,0 +1,164 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_DYNAMICS_SIMD_H
+#define RBDL_DYNAMICS_SIMD_H
+
+#include <vector>
+
+#include "rbdl/rbdl_math.h"
+#include "rbdl/SpatialAlgebraSIMD.h"
+
+namespace RigidBodyDynamics {
+
+struct Model;
+
+/** \brief Temporary values of the SIMD algorithms for L states
+ *
+ * All per-body values are stored in structure-of-arrays form, i.e. every
+ * coefficient holds the values of all L states that are evaluated
+ * together. The algorithms process the columns of the given state
+ * matrices in chunks of L states.
+ *
+ * The library contains the algorithms for L = 1, 2, 4, and 8 where L = 1
+ * is the scalar fallback. RBDL_SIMD_LANES is the lane count that matches
+ * the instruction set the library was compiled for.
+ *
+ * \note A workspace has to be (re-)initialized with Init() whenever bodies
+ * are added to the model.
+ */
+template <unsigned int L>
+struct RBDL_DLLAPI SIMDDynamicsWorkspace {
+	SIMDDynamicsWorkspace() {}
+	/// \brief Creates a workspace with storage for all bodies of the model
+	explicit SIMDDynamicsWorkspace (const Model &model);
+
+	/// \brief Allocates the storage for all bodies of the model
+	void Init (const Model &model);
+
+	/// \brief Transformations from the parent body to the current body
+	std::vector<Math::SIMDSpatialTransform<L> > X_lambda;
+	/// \brief The spatial velocity of the bodies
+	std::vector<Math::SIMDSpatialVector<L> > v;
+	/// \brief The spatial acceleration of the bodies
+	std::vector<Math::SIMDSpatialVector<L> > a;
+	/// \brief The velocity dependent spatial acceleration
+	std::vector<Math::SIMDSpatialVector<L> > c;
+	/// \brief The articulated body inertia of the bodies
+	std::vector<Math::SIMDSpatialMatrix<L> > IA;
+	/// \brief The spatial bias force
+	std::vector<Math::SIMDSpatialVector<L> > pA;
+	/// \brief Temporary variable U_i (RBDA p. 130)
+	std::vector<Math::SIMDSpatialVector<L> > U;
+	/// \brief Temporary variable D_i (RBDA p. 130)
+	std::vector<Math::SIMDScalar<L> > d;
+	/// \brief Temporary variable u (RBDA p. 130)
+	std::vector<Math::SIMDScalar<L> > u;
+	/// \brief Internal forces on the body (used only by the RNEA)
+	std::vector<Math::SIMDSpatialVector<L> > f;
+
+	/// \brief Values for joints with 3 degrees of freedom
+	std::vector<Math::SIMDMatrix63<L> > multdof3_S;
+	std::vector<Math::SIMDMatrix63<L> > multdof3_U;
+	std::vector<Math::SIMDMatrix3d<L> > multdof3_Dinv;
+	std::vector<Math::SIMDVector3d<L> > multdof3_u;
+
+	/// \brief Joint velocities of the body that is currently processed
+	Math::SIMDSpatialVector<L> v_J;
+	/// \brief Joint accelerations of the body that is currently processed
+	Math::SIMDSpatialVector<L> c_J;
+
+	/// \brief States of the chunk that is currently processed (one column per lane)
+	Math::MatrixNd Q;
+	Math::MatrixNd QDot;
+	/// \brief Per-lane output of the joint calculations
+	std::vector<Math::SpatialTransform> lane_X_lambda;
+	std::vector<Math::SpatialVector> lane_v_J;
+	std::vector<Math::SpatialVector> lane_c_J;
+	std::vector<Math::Matrix63> lane_S;
+};
+
+/** \ingroup dynamics_group
+ * @{
+ */
+
+/** \brief Computes forward dynamics with the Articulated Body Algorithm
+ * for many states using SIMD lanes
+ *
+ * Same as ForwardDynamicsBatch() but the states are evaluated in chunks
+ * of L states. All spatial algebra operations of a chunk are performed in
+ * structure-of-arrays form such that each operation runs on all L states
+ * at once.
+ *
+ * \param model rigid body model
+ * \param ws    SIMD workspace for L lanes
+ * \param Q     state vectors of the internal joints (q_size x N)
+ * \param QDot  velocity vectors of the internal joints (qdot_size x N)
+ * \param Tau   actuations of the internal joints (qdot_size x N)
+ * \param QDDot accelerations of the internal joints (output, qdot_size x N)
+ */
+template <unsigned int L>
+RBDL_DLLAPI
+void ForwardDynamicsSIMD (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		const Math::MatrixNd &Tau,
+		Math::MatrixNd &QDDot
+		);
+
+/** \brief Computes inverse dynamics with the Newton-Euler Algorithm for
+ * many states using SIMD lanes
+ *
+ * Same as calling InverseDynamics() for every column of Q, QDot, and
+ * QDDot. External forces are not supported.
+ *
+ * \param model rigid body model
+ * \param ws    SIMD workspace for L lanes
+ * \param Q     state vectors of the internal joints (q_size x N)
+ * \param QDot  velocity vectors of the internal joints (qdot_size x N)
+ * \param QDDot accelerations of the internal joints (qdot_size x N)
+ * \param Tau   actuations of the internal joints (output, qdot_size x N)
+ */
+template <unsigned int L>
+RBDL_DLLAPI
+void InverseDynamicsSIMD (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		const Math::MatrixNd &QDDot,
+		Math::MatrixNd &Tau
+		);
+
+/** \brief Computes the coriolis forces for many states using SIMD lanes
+ *
+ * Same as calling NonlinearEffects() for every column of Q and QDot.
+ *
+ * \param model rigid body model
+ * \param ws    SIMD workspace for L lanes
+ * \param Q     state vectors of the internal joints (q_size x N)
+ * \param QDot  velocity vectors of the internal joints (qdot_size x N)
+ * \param Tau   actuations of the internal joints (output, qdot_size x N)
+ */
+template <unsigned int L>
+RBDL_DLLAPI
+void NonlinearEffectsSIMD (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		Math::MatrixNd &Tau
+		);
+
+/** @} */
+
+}
+
+/* RBDL_DYNAMICS_SIMD_H */
+#endif
@@ -0,0 +1,696 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_FIXED_TOPOLOGY_H
+#define RBDL_FIXED_TOPOLOGY_H
+
+#include <iostream>
+#include <string>
+
+#include "rbdl/rbdl_math.h"
+#include "rbdl/Model.h"
+#include "rbdl/Joint.h"
+
+namespace RigidBodyDynamics {
+
+/** \page fixed_topology_page Fixed Topology Models
+ *
+ * For models whose kinematic tree is known at build time the algorithms can
+ * be instantiated for that tree. The number of bodies, the parent of each
+ * body, the joint types and the indices of the joints in q are then
+ * compile-time constants: all sweeps over the bodies are unrolled, the
+ * joint calculations are resolved without any dispatch and all states use
+ * fixed-size Eigen types.
+ *
+ * The topology is described by a traits struct that can be generated from
+ * any Model (created from code, from a Lua file, or from an URDF file)
+ * with WriteFixedTopology():
+ *
+ * \code
+ * struct MyRobot {
+ * 	enum { body_count = 3, dof_count = 2 };
+ * 	template <unsigned int body_id> struct Body;
+ * };
+ * template <> struct MyRobot::Body<1> { enum { parent = 0, joint_type = RigidBodyDynamics::JointTypeRevoluteZ, q_index = 0 }; };
+ * template <> struct MyRobot::Body<2> { enum { parent = 1, joint_type = RigidBodyDynamics::JointTypeRevoluteY, q_index = 1 }; };
+ * \endcode
+ *
+ * The geometric and inertial parameters remain runtime values that are
+ * copied from the Model by FixedModel::Init():
+ *
+ * \code
+ * FixedModel<MyRobot> fixed_model (model);
+ * FixedModel<MyRobot>::VectorQ q, qdot, tau, qddot;
+ * ForwardDynamics (fixed_model, q, qdot, tau, qddot);
+ * \endcode
+ *
+ * \note Only joints with a single degree of freedom (JointTypeRevoluteX,
+ * JointTypeRevoluteY, JointTypeRevoluteZ, JointTypeRevolute, and
+ * JointTypePrismatic) are supported, which includes emulated multi-DoF
+ * joints. Fixed bodies are merged into their movable parents as in Model.
+ * FixedModel is not available when RBDL is built with
+ * RBDL_USE_SIMPLE_MATH.
+ */
+
+/** \brief Writes the fixed topology traits of a model as C++ source
+ *
+ * \param model the model
+ * \param name  the name of the traits struct
+ * \param out   the stream the definition is written to
+ *
+ * \returns false if the model contains joints that are not supported by
+ * FixedModel (nothing is written in that case)
+ */
+RBDL_DLLAPI
+bool WriteFixedTopology (const Model &model, const std::string &name, std::ostream &out);
+
+// FixedModel relies on fixed-size Eigen types
+#ifndef RBDL_USE_SIMPLE_MATH
+
+namespace FixedTopology {
+
+/** \brief Joint calculations for each supported joint type
+ *
+ * All supported joints have a single degree of freedom, therefore the
+ * joint velocity is S qdot and the velocity product acceleration c_J is
+ * zero. The primary template is not defined such that unsupported joint
+ * types fail to compile.
+ */
+template <int joint_type>
+struct JointKernel;
+
+template <>
+struct JointKernel<JointTypeRevoluteX> {
+	static inline Math::SpatialTransform XJ (const Math::SpatialVector &, double q) {
+		return Math::Xrotx (q);
+	}
+};
+
+template <>
+struct JointKernel<JointTypeRevoluteY> {
+	static inline Math::SpatialTransform XJ (const Math::SpatialVector &, double q) {
+		return Math::Xroty (q);
+	}
+};
+
+template <>
+struct JointKernel<JointTypeRevoluteZ> {
+	static inline Math::SpatialTransform XJ (const Math::SpatialVector &, double q) {
+		return Math::Xrotz (q);
+	}
+};
+
+template <>
+struct JointKernel<JointTypeRevolute> {
+	static inline Math::SpatialTransform XJ (const Math::SpatialVector &S, double q) {
+		return Math::Xrot (q, Math::Vector3d (S[0], S[1], S[2]));
+	}
+};
+
+template <>
+struct JointKernel<JointTypePrismatic> {
+	static inline Math::SpatialTransform XJ (const Math::SpatialVector &S, double q) {
+		return Math::Xtrans (Math::Vector3d (S[3] * q, S[4] * q, S[5] * q));
+	}
+};
+
+/// \brief Calls op.Visit<i>() for i = begin, ..., end - 1
+template <typename Op, unsigned int begin, unsigned int end>
+struct ForwardSweep {
+	static inline void Run (Op &op) {
+		op.template Visit<begin>();
+		ForwardSweep<Op, begin + 1, end>::Run (op);
+	}
+};
+
+template <typename Op, unsigned int end>
+struct ForwardSweep<Op, end, end> {
+	static inline void Run (Op &) {}
+};
+
+/// \brief Calls op.Visit<i>() for i = begin, ..., 1
+template <typename Op, unsigned int begin>
+struct BackwardSweep {
+	static inline void Run (Op &op) {
+		op.template Visit<begin>();
+		BackwardSweep<Op, begin - 1>::Run (op);
+	}
+};
+
+template <typename Op>
+struct BackwardSweep<Op, 0> {
+	static inline void Run (Op &) {}
+};
+
+/// \brief Calls op.Visit<j>() for body_id and all its ancestors except the root
+template <typename Topology, typename Op, unsigned int body_id>
+struct AncestorSweep {
+	static inline void Run (Op &op) {
+		op.template Visit<body_id>();
+		AncestorSweep<Topology, Op, Topology::template Body<body_id>::parent>::Run (op);
+	}
+};
+
+template <typename Topology, typename Op>
+struct AncestorSweep<Topology, Op, 0> {
+	static inline void Run (Op &) {}
+};
+
+}
+
+/** \brief Model parameters and temporary values for a topology known at
+ * compile time
+ *
+ * \param Topology the traits struct as written by WriteFixedTopology()
+ *
+ * All arrays are indexed by the body ids of the Model the FixedModel was
+ * initialized from (entry 0 is the root).
+ */
+template <typename Topology>
+struct FixedModel {
+	enum {
+		body_count = Topology::body_count,
+		dof_count = Topology::dof_count
+	};
+
+	typedef Eigen::Matrix<double, dof_count, 1> VectorQ;
+	typedef Eigen::Matrix<double, dof_count, dof_count> MatrixQ;
+	typedef Eigen::Matrix<double, 3, dof_count> Matrix3Q;
+	typedef Eigen::Matrix<double, 6, dof_count> Matrix6Q;
+
+	FixedModel() {}
+	/** \brief Creates a fixed model with the parameters of the model
+	 *
+	 * \note Aborts if the topology of the model does not match Topology,
+	 * use Init() to check it instead.
+	 */
+	explicit FixedModel (const Model &model) {
+		if (!Init (model)) {
+			std::cerr << "Error: the topology of the model does not match the fixed topology!" << std::endl;
+			assert (0);
+			abort();
+		}
+	}
+
+	/** \brief Copies the parameters of the model
+	 *
+	 * \returns false if the topology of the model does not match Topology
+	 */
+	bool Init (const Model &model);
+
+	/// \brief Spatial gravity (0, 0, 0, gravity)
+	Math::SpatialVector spatial_gravity;
+
+	// Model parameters
+	Math::SpatialTransform X_T[body_count];
+	Math::SpatialVector S[body_count];
+	Math::SpatialRigidBodyInertia I[body_count];
+
+	// Temporary values
+	Math::SpatialTransform X_lambda[body_count];
+	Math::SpatialTransform X_base[body_count];
+	Math::SpatialVector v[body_count];
+	Math::SpatialVector a[body_count];
+	Math::SpatialVector c[body_count];
+	Math::SpatialVector f[body_count];
+	Math::SpatialMatrix IA[body_count];
+	Math::SpatialVector pA[body_count];
+	Math::SpatialVector U[body_count];
+	double d[body_count];
+	double u[body_count];
+	Math::SpatialRigidBodyInertia Ic[body_count];
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+namespace FixedTopology {
+
+template <typename Topology>
+struct CheckTopologyOp {
+	CheckTopologyOp (const Model &model) : model (model), valid (true) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		if (model.lambda[i] != (unsigned int) B::parent
+				|| model.mJoints[i].mJointType != (JointType) B::joint_type
+				|| model.mJoints[i].q_index != (unsigned int) B::q_index
+				|| model.mJoints[i].mDoFCount != 1)
+			valid = false;
+	}
+
+	const Model &model;
+	bool valid;
+};
+
+/// \brief Joint transformation and parent to body transformation
+template <typename Topology, unsigned int i>
+inline void jcalc_X_lambda (FixedModel<Topology> &fmodel, double q) {
+	typedef typename Topology::template Body<i> B;
+
+	fmodel.X_lambda[i] = JointKernel<B::joint_type>::XJ (fmodel.S[i], q) * fmodel.X_T[i];
+}
+
+template <typename Topology>
+struct PositionsOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	PositionsOp (FixedModel<Topology> &fmodel, const VectorQ &Q) : fmodel (fmodel), Q (Q) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		jcalc_X_lambda<Topology, i> (fmodel, Q[B::q_index]);
+
+		if (B::parent != 0)
+			fmodel.X_base[i] = fmodel.X_lambda[i] * fmodel.X_base[B::parent];
+		else
+			fmodel.X_base[i] = fmodel.X_lambda[i];
+	}
+
+	FixedModel<Topology> &fmodel;
+	const VectorQ &Q;
+};
+
+template <typename Topology>
+struct KinematicsOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	KinematicsOp (FixedModel<Topology> &fmodel, const VectorQ &Q, const VectorQ &QDot, const VectorQ &QDDot) :
+		fmodel (fmodel), Q (Q), QDot (QDot), QDDot (QDDot) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		jcalc_X_lambda<Topology, i> (fmodel, Q[B::q_index]);
+
+		Math::SpatialVector v_J = fmodel.S[i] * QDot[B::q_index];
+
+		if (B::parent != 0) {
+			fmodel.X_base[i] = fmodel.X_lambda[i] * fmodel.X_base[B::parent];
+			fmodel.v[i] = fmodel.X_lambda[i].apply (fmodel.v[B::parent]) + v_J;
+			fmodel.c[i] = Math::crossm (fmodel.v[i], v_J);
+			fmodel.a[i] = fmodel.X_lambda[i].apply (fmodel.a[B::parent]) + fmodel.c[i];
+		} else {
+			fmodel.X_base[i] = fmodel.X_lambda[i];
+			fmodel.v[i] = v_J;
+			fmodel.c[i].setZero();
+			fmodel.a[i].setZero();
+		}
+
+		fmodel.a[i] += fmodel.S[i] * QDDot[B::q_index];
+	}
+
+	FixedModel<Topology> &fmodel;
+	const VectorQ &Q;
+	const VectorQ &QDot;
+	const VectorQ &QDDot;
+};
+
+template <typename Topology>
+struct InverseDynamicsForwardOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	InverseDynamicsForwardOp (FixedModel<Topology> &fmodel, const VectorQ &Q, const VectorQ &QDot, const VectorQ &QDDot) :
+		fmodel (fmodel), Q (Q), QDot (QDot), QDDot (QDDot) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		jcalc_X_lambda<Topology, i> (fmodel, Q[B::q_index]);
+
+		Math::SpatialVector v_J = fmodel.S[i] * QDot[B::q_index];
+
+		if (B::parent != 0) {
+			fmodel.v[i] = fmodel.X_lambda[i].apply (fmodel.v[B::parent]) + v_J;
+			fmodel.c[i] = Math::crossm (fmodel.v[i], v_J);
+			fmodel.a[i] = fmodel.X_lambda[i].apply (fmodel.a[B::parent]) + fmodel.c[i];
+		} else {
+			fmodel.v[i] = v_J;
+			fmodel.c[i].setZero();
+			fmodel.a[i] = fmodel.X_lambda[i].apply (fmodel.spatial_gravity * -1.);
+		}
+
+		fmodel.a[i] += fmodel.S[i] * QDDot[B::q_index];
+
+		fmodel.f[i] = fmodel.I[i] * fmodel.a[i] + Math::crossf (fmodel.v[i], fmodel.I[i] * fmodel.v[i]);
+	}
+
+	FixedModel<Topology> &fmodel;
+	const VectorQ &Q;
+	const VectorQ &QDot;
+	const VectorQ &QDDot;
+};
+
+template <typename Topology>
+struct InverseDynamicsBackwardOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	InverseDynamicsBackwardOp (FixedModel<Topology> &fmodel, VectorQ &Tau) : fmodel (fmodel), Tau (Tau) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		Tau[B::q_index] = fmodel.S[i].dot (fmodel.f[i]);
+
+		if (B::parent != 0)
+			fmodel.f[B::parent] += fmodel.X_lambda[i].applyTranspose (fmodel.f[i]);
+	}
+
+	FixedModel<Topology> &fmodel;
+	VectorQ &Tau;
+};
+
+template <typename Topology>
+struct ArticulatedBodyForwardOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	ArticulatedBodyForwardOp (FixedModel<Topology> &fmodel, const VectorQ &Q, const VectorQ &QDot) :
+		fmodel (fmodel), Q (Q), QDot (QDot) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		jcalc_X_lambda<Topology, i> (fmodel, Q[B::q_index]);
+
+		Math::SpatialVector v_J = fmodel.S[i] * QDot[B::q_index];
+
+		if (B::parent != 0) {
+			fmodel.v[i] = fmodel.X_lambda[i].apply (fmodel.v[B::parent]) + v_J;
+			fmodel.c[i] = Math::crossm (fmodel.v[i], v_J);
+		} else {
+			fmodel.v[i] = v_J;
+			fmodel.c[i].setZero();
+		}
+
+		fmodel.IA[i] = fmodel.I[i].toMatrix();
+		fmodel.pA[i] = Math::crossf (fmodel.v[i], fmodel.I[i] * fmodel.v[i]);
+	}
+
+	FixedModel<Topology> &fmodel;
+	const VectorQ &Q;
+	const VectorQ &QDot;
+};
+
+template <typename Topology>
+struct ArticulatedBodyBackwardOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	ArticulatedBodyBackwardOp (FixedModel<Topology> &fmodel, const VectorQ &Tau) : fmodel (fmodel), Tau (Tau) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		fmodel.U[i] = fmodel.IA[i] * fmodel.S[i];
+		fmodel.d[i] = fmodel.S[i].dot (fmodel.U[i]);
+		fmodel.u[i] = Tau[B::q_index] - fmodel.S[i].dot (fmodel.pA[i]);
+
+		if (B::parent != 0) {
+			Math::SpatialMatrix Ia = fmodel.IA[i] - fmodel.U[i] * (fmodel.U[i] / fmodel.d[i]).transpose();
+			Math::SpatialVector pa = fmodel.pA[i] + Ia * fmodel.c[i] + fmodel.U[i] * fmodel.u[i] / fmodel.d[i];
+
+			fmodel.IA[B::parent].noalias() += fmodel.X_lambda[i].toMatrixTranspose() * Ia * fmodel.X_lambda[i].toMatrix();
+			fmodel.pA[B::parent].noalias() += fmodel.X_lambda[i].applyTranspose (pa);
+		}
+	}
+
+	FixedModel<Topology> &fmodel;
+	const VectorQ &Tau;
+};
+
+template <typename Topology>
+struct ArticulatedBodyAccelerationOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	ArticulatedBodyAccelerationOp (FixedModel<Topology> &fmodel, VectorQ &QDDot) : fmodel (fmodel), QDDot (QDDot) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		if (B::parent != 0)
+			fmodel.a[i] = fmodel.X_lambda[i].apply (fmodel.a[B::parent]) + fmodel.c[i];
+		else
+			fmodel.a[i] = fmodel.X_lambda[i].apply (fmodel.spatial_gravity * -1.);
+
+		QDDot[B::q_index] = (fmodel.u[i] - fmodel.U[i].dot (fmodel.a[i])) / fmodel.d[i];
+		fmodel.a[i] += fmodel.S[i] * QDDot[B::q_index];
+	}
+
+	FixedModel<Topology> &fmodel;
+	VectorQ &QDDot;
+};
+
+/// \brief Fills row i of the joint space inertia matrix with the ancestors of body i
+template <typename Topology>
+struct CompositeInertiaRowOp {
+	typedef typename FixedModel<Topology>::MatrixQ MatrixQ;
+
+	CompositeInertiaRowOp (FixedModel<Topology> &fmodel, MatrixQ &H, unsigned int dof_index_i, const Math::SpatialVector &F) :
+		fmodel (fmodel), H (H), dof_index_i (dof_index_i), F (F) {}
+
+	template <unsigned int j>
+	void Visit () {
+		typedef typename Topology::template Body<j> B;
+
+		H(dof_index_i, B::q_index) = F.dot (fmodel.S[j]);
+		H(B::q_index, dof_index_i) = H(dof_index_i, B::q_index);
+
+		if (B::parent != 0)
+			F = fmodel.X_lambda[j].applyTranspose (F);
+	}
+
+	FixedModel<Topology> &fmodel;
+	MatrixQ &H;
+	unsigned int dof_index_i;
+	Math::SpatialVector F;
+};
+
+template <typename Topology>
+struct CompositeInertiaOp {
+	typedef typename FixedModel<Topology>::MatrixQ MatrixQ;
+
+	CompositeInertiaOp (FixedModel<Topology> &fmodel, MatrixQ &H) : fmodel (fmodel), H (H) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		if (B::parent != 0)
+			fmodel.Ic[B::parent] = fmodel.Ic[B::parent] + fmodel.X_lambda[i].applyTranspose (fmodel.Ic[i]);
+
+		Math::SpatialVector F = fmodel.Ic[i] * fmodel.S[i];
+		H(B::q_index, B::q_index) = fmodel.S[i].dot (F);
+
+		if (B::parent != 0) {
+			CompositeInertiaRowOp<Topology> row (fmodel, H, B::q_index, fmodel.X_lambda[i].applyTranspose (F));
+			AncestorSweep<Topology, CompositeInertiaRowOp<Topology>, B::parent>::Run (row);
+		}
+	}
+
+	FixedModel<Topology> &fmodel;
+	MatrixQ &H;
+};
+
+template <typename Topology>
+struct CompositeInertiaInitOp {
+	typedef typename FixedModel<Topology>::VectorQ VectorQ;
+
+	CompositeInertiaInitOp (FixedModel<Topology> &fmodel, const VectorQ &Q) : fmodel (fmodel), Q (Q) {}
+
+	template <unsigned int i>
+	void Visit () {
+		typedef typename Topology::template Body<i> B;
+
+		jcalc_X_lambda<Topology, i> (fmodel, Q[B::q_index]);
+		fmodel.Ic[i] = fmodel.I[i];
+	}
+
+	FixedModel<Topology> &fmodel;
+	const VectorQ &Q;
+};
+
+template <typename Topology>
+struct PointJacobianOp {
+	typedef typename FixedModel<Topology>::Matrix3Q Matrix3Q;
+
+	PointJacobianOp (const FixedModel<Topology> &fmodel, const Math::Vector3d &point_base, Matrix3Q &G) :
+		fmodel (fmodel), point_base (point_base), G (G) {}
+
+	template <unsigned int j>
+	void Visit () {
+		typedef typename Topology::template Body<j> B;
+
+		const Math::SpatialVector &S_j = fmodel.S[j];
+		const Math::Matrix3d &E = fmodel.X_base[j].E;
+
+		Math::Vector3d omega = E.transpose() * Math::Vector3d (S_j[0], S_j[1], S_j[2]);
+		Math::Vector3d v = E.transpose() * Math::Vector3d (S_j[3], S_j[4], S_j[5]) + fmodel.X_base[j].r.cross (omega);
+
+		G.col (B::q_index) = v + omega.cross (point_base);
+	}
+
+	const FixedModel<Topology> &fmodel;
+	const Math::Vector3d &point_base;
+	Matrix3Q &G;
+};
+
+}
+
+template <typename Topology>
+bool FixedModel<Topology>::Init (const Model &model) {
+	if (model.mBodies.size() != (unsigned int) body_count
+			|| model.dof_count != (unsigned int) dof_count
+			|| model.q_size != (unsigned int) dof_count)
+		return false;
+
+	FixedTopology::CheckTopologyOp<Topology> check (model);
+	FixedTopology::ForwardSweep<FixedTopology::CheckTopologyOp<Topology>, 1, body_count>::Run (check);
+
+	if (!check.valid)
+		return false;
+
+	spatial_gravity = Math::SpatialVector (0., 0., 0., model.gravity[0], model.gravity[1], model.gravity[2]);
+
+	for (unsigned int i = 0; i < (unsigned int) body_count; i++) {
+		X_T[i] = model.X_T[i];
+		S[i] = model.S[i];
+		I[i] = model.I[i];
+
+		X_lambda[i] = Math::SpatialTransform();
+		X_base[i] = Math::SpatialTransform();
+		v[i].setZero();
+		a[i].setZero();
+		c[i].setZero();
+		f[i].setZero();
+	}
+
+	return true;
+}
+
+/** \brief Computes the positions of all bodies (same as
+ * UpdateKinematicsCustom() with only Q) */
+template <typename Topology>
+void UpdateKinematicsCustom (
+		FixedModel<Topology> &fmodel,
+		const typename FixedModel<Topology>::VectorQ &Q) {
+	FixedTopology::PositionsOp<Topology> op (fmodel, Q);
+	FixedTopology::ForwardSweep<FixedTopology::PositionsOp<Topology>, 1, Topology::body_count>::Run (op);
+}
+
+/** \brief Computes positions, velocities, and accelerations of all bodies
+ * (same as UpdateKinematics()) */
+template <typename Topology>
+void UpdateKinematics (
+		FixedModel<Topology> &fmodel,
+		const typename FixedModel<Topology>::VectorQ &Q,
+		const typename FixedModel<Topology>::VectorQ &QDot,
+		const typename FixedModel<Topology>::VectorQ &QDDot) {
+	FixedTopology::KinematicsOp<Topology> op (fmodel, Q, QDot, QDDot);
+	FixedTopology::ForwardSweep<FixedTopology::KinematicsOp<Topology>, 1, Topology::body_count>::Run (op);
+}
+
+/** \brief Returns the base coordinates of a point given in body coordinates
+ * (same as CalcBodyToBaseCoordinates() without updating the kinematics)
+ */
+template <typename Topology>
+Math::Vector3d CalcBodyToBaseCoordinates (
+		const FixedModel<Topology> &fmodel,
+		unsigned int body_id,
+		const Math::Vector3d &point_body_coordinates) {
+	return fmodel.X_base[body_id].r + fmodel.X_base[body_id].E.transpose() * point_body_coordinates;
+}
+
+/** \brief Computes the point jacobian of a point on the body body_id (same
+ * as CalcPointJacobian())
+ *
+ * Only the ancestors of body_id are visited and only their columns of G
+ * are written, all other entries have to be zero.
+ */
+template <unsigned int body_id, typename Topology>
+void CalcPointJacobian (
+		FixedModel<Topology> &fmodel,
+		const typename FixedModel<Topology>::VectorQ &Q,
+		const Math::Vector3d &point_position,
+		typename FixedModel<Topology>::Matrix3Q &G,
+		bool update_kinematics = true) {
+	if (update_kinematics)
+		UpdateKinematicsCustom (fmodel, Q);
+
+	Math::Vector3d point_base = CalcBodyToBaseCoordinates (fmodel, body_id, point_position);
+
+	FixedTopology::PointJacobianOp<Topology> op (fmodel, point_base, G);
+	FixedTopology::AncestorSweep<Topology, FixedTopology::PointJacobianOp<Topology>, body_id>::Run (op);
+}
+
+/** \brief Computes inverse dynamics with the Newton-Euler algorithm (same
+ * as InverseDynamics() without external forces) */
+template <typename Topology>
+void InverseDynamics (
+		FixedModel<Topology> &fmodel,
+		const typename FixedModel<Topology>::VectorQ &Q,
+		const typename FixedModel<Topology>::VectorQ &QDot,
+		const typename FixedModel<Topology>::VectorQ &QDDot,
+		typename FixedModel<Topology>::VectorQ &Tau) {
+	FixedTopology::InverseDynamicsForwardOp<Topology> forward (fmodel, Q, QDot, QDDot);
+	FixedTopology::ForwardSweep<FixedTopology::InverseDynamicsForwardOp<Topology>, 1, Topology::body_count>::Run (forward);
+
+	FixedTopology::InverseDynamicsBackwardOp<Topology> backward (fmodel, Tau);
+	FixedTopology::BackwardSweep<FixedTopology::InverseDynamicsBackwardOp<Topology>, Topology::body_count - 1>::Run (backward);
+}
+
+/** \brief Computes forward dynamics with the Articulated Body Algorithm
+ * (same as ForwardDynamics() without external forces) */
+template <typename Topology>
+void ForwardDynamics (
+		FixedModel<Topology> &fmodel,
+		const typename FixedModel<Topology>::VectorQ &Q,
+		const typename FixedModel<Topology>::VectorQ &QDot,
+		const typename FixedModel<Topology>::VectorQ &Tau,
+		typename FixedModel<Topology>::VectorQ &QDDot) {
+	FixedTopology::ArticulatedBodyForwardOp<Topology> forward (fmodel, Q, QDot);
+	FixedTopology::ForwardSweep<FixedTopology::ArticulatedBodyForwardOp<Topology>, 1, Topology::body_count>::Run (forward);
+
+	FixedTopology::ArticulatedBodyBackwardOp<Topology> backward (fmodel, Tau);
+	FixedTopology::BackwardSweep<FixedTopology::ArticulatedBodyBackwardOp<Topology>, Topology::body_count - 1>::Run (backward);
+
+	FixedTopology::ArticulatedBodyAccelerationOp<Topology> acceleration (fmodel, QDDot);
+	FixedTopology::ForwardSweep<FixedTopology::ArticulatedBodyAccelerationOp<Topology>, 1, Topology::body_count>::Run (acceleration);
+}
+
+/** \brief Computes the joint space inertia matrix with the Composite Rigid
+ * Body Algorithm (same as CompositeRigidBodyAlgorithm())
+ *
+ * All entries of H that do not couple a body with one of its ancestors
+ * are left untouched and have to be zero.
+ */
+template <typename Topology>
+void CompositeRigidBodyAlgorithm (
+		FixedModel<Topology> &fmodel,
+		const typename FixedModel<Topology>::VectorQ &Q,
+		typename FixedModel<Topology>::MatrixQ &H) {
+	FixedTopology::CompositeInertiaInitOp<Topology> init (fmodel, Q);
+	FixedTopology::ForwardSweep<FixedTopology::CompositeInertiaInitOp<Topology>, 1, Topology::body_count>::Run (init);
+
+	FixedTopology::CompositeInertiaOp<Topology> composite (fmodel, H);
+	FixedTopology::BackwardSweep<FixedTopology::CompositeInertiaOp<Topology>, Topology::body_count - 1>::Run (composite);
+}
+
+/* RBDL_USE_SIMPLE_MATH */
+#endif
+
+}
+
+/* RBDL_FIXED_TOPOLOGY_H */
+#endif
@@ -17,6 +17,7 @@
 namespace RigidBodyDynamics {
 
 struct Model;
+struct DynamicsWorkspace;
 
 /** \page joint_description Joint Modeling
  *
@@ -566,6 +567,56 @@ struct RBDL_DLLAPI Joint {
 	unsigned int q_index;
 };
 
+/** \brief Function that evaluates the joint model of a single joint type
+ *
+ * The kernel of each body is selected by jcalc_select_kernel() when the
+ * body is added to the model and stored in Model::mJointKernels such that
+ * jcalc() does not have to dispatch on the joint type. The values of q and
+ * qdot are the full joint state and velocity vectors.
+ *
+ * \note Kernels of joints with 3 degrees of freedom only write the
+ * non-zero entries of S.
+ */
+typedef void (*JointKernel) (
+		const Model &model,
+		unsigned int joint_id,
+		const double *q,
+		const double *qdot,
+		Math::SpatialTransform &X_J,
+		Math::SpatialVector &v_J,
+		Math::SpatialVector &c_J,
+		Math::Matrix63 &S
+		);
+
+/** \brief Function that only evaluates the joint transformation and the
+ * motion subspace of a single joint type (see Model::mJointPositionKernels)
+ */
+typedef void (*JointPositionKernel) (
+		const Model &model,
+		unsigned int joint_id,
+		const double *q,
+		Math::SpatialTransform &X_J,
+		Math::Matrix63 &S
+		);
+
+/** \brief Returns the kernel that is used by jcalc() for the given joint
+ * type (aborts when called for unsupported types)
+ */
+RBDL_DLLAPI
+JointKernel jcalc_select_kernel (JointType joint_type);
+
+/** \brief Returns the kernel that is used by jcalc_X_lambda_S() for the
+ * given joint type (aborts when called for unsupported types)
+ */
+RBDL_DLLAPI
+JointPositionKernel jcalc_select_position_kernel (JointType joint_type);
+
+/** \brief Returns the kind of the rotation of the joint transformation
+ * X_J of the given joint type (see Math::SpatialTransformKind)
+ */
+RBDL_DLLAPI
+Math::SpatialTransformKind jcalc_transform_kind (JointType joint_type);
+
 /** \brief Computes all variables for a joint model
  *
  *	By appropriate modification of this function all types of joints can be
@@ -587,9 +638,48 @@ void jcalc (
 		const Math::VectorNd &qdot
 		);
 
+/** \brief Computes joint transformation and velocities and stores them in the given workspace.
+ */
+RBDL_DLLAPI
+void jcalc (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		unsigned int joint_id,
+		const Math::VectorNd &q,
+		const Math::VectorNd &qdot
+		);
+
+/** \brief Computes the joint variables of a single joint for many states at once.
+ *
+ * The joint kernel of the body is evaluated for every column of Q and
+ * QDot. The output arrays must hold at
+ * least Q.cols() elements.
+ *
+ * \param model      the rigid body model
+ * \param joint_id   the id of the joint we are interested in
+ * \param Q          column-stacked joint state variables (q_size x N)
+ * \param QDot       column-stacked joint velocity variables (qdot_size x N)
+ * \param X_lambda   transformations from the parent body frame (output)
+ * \param v_J        joint velocities (output)
+ * \param c_J        joint accelerations for rhenomic joints (output)
+ * \param multdof3_S motion subspaces of joints with 3 degrees of freedom
+ * (output, may be NULL for joints with a single degree of freedom)
+ */
+RBDL_DLLAPI
+void jcalc_batch (
+		const Model &model,
+		unsigned int joint_id,
+		const Math::MatrixNd &Q,
+		const Math::MatrixNd &QDot,
+		Math::SpatialTransform *X_lambda,
+		Math::SpatialVector *v_J,
+		Math::SpatialVector *c_J,
+		Math::Matrix63 *multdof3_S
+		);
+
 RBDL_DLLAPI
 Math::SpatialTransform jcalc_XJ (
-		Model &model,
+		const Model &model,
 		unsigned int joint_id,
 		const Math::VectorNd &q);
 
@@ -600,6 +690,14 @@ void jcalc_X_lambda_S (
 		const Math::VectorNd &q
 		);
 
+RBDL_DLLAPI
+void jcalc_X_lambda_S (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		unsigned int joint_id,
+		const Math::VectorNd &q
+		);
+
 }
 
 /* RBDL_JOINT_H */
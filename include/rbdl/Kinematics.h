@@ -15,6 +15,9 @@
 
 namespace RigidBodyDynamics {
 
+struct Model;
+struct DynamicsWorkspace;
+
 /** \page kinematics_page Kinematics
  * All functions related to kinematics are specified in the \ref
  * kinematics_group "Kinematics Module".
@@ -46,6 +49,16 @@ void UpdateKinematics (Model &model,
 		const Math::VectorNd &QDDot
 		);
 
+/** \brief Same as UpdateKinematics() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void UpdateKinematics (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &QDDot
+		);
+
 /** \brief Selectively updates model internal states of body positions, velocities and/or accelerations.
  *
  * This function updates the kinematic variables such as body velocities and
@@ -67,6 +80,56 @@ void UpdateKinematicsCustom (Model &model,
 		const Math::VectorNd *QDDot
 		);
 
+/** \brief Same as UpdateKinematicsCustom() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void UpdateKinematicsCustom (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd *Q,
+		const Math::VectorNd *QDot,
+		const Math::VectorNd *QDDot
+		);
+
+/** \brief Updates the kinematics only for the bodies whose state changed
+ * since the last call.
+ *
+ * Compares Q, QDot, and QDDot joint by joint with the values of the
+ * previous call and recomputes the transformations, velocities, and
+ * accelerations only for the subtrees (see Model::mu) below the joints
+ * whose values differ. The result is the same as the one of
+ * UpdateKinematicsCustom() with the same arguments.
+ *
+ * The first call, or any call after a different function has updated the
+ * kinematics of the workspace (e.g. ForwardDynamics()), recomputes all
+ * bodies. The number of recomputed bodies is stored in
+ * DynamicsWorkspace::incremental_update_count.
+ *
+ * \param model the model
+ * \param Q     the positional variables of the model
+ * \param QDot  the generalized velocities of the joints (optional)
+ * \param QDDot the generalized accelerations of the joints (optional,
+ * requires QDot)
+ *
+ * \note QDot and QDDot that are not passed are treated as changed on the
+ * next call that passes them.
+ */
+RBDL_DLLAPI
+void UpdateKinematicsIncremental (Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd *QDot = NULL,
+		const Math::VectorNd *QDDot = NULL
+		);
+
+/** \brief Same as UpdateKinematicsIncremental() but stores all intermediate
+ * values in the DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void UpdateKinematicsIncremental (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd *QDot = NULL,
+		const Math::VectorNd *QDDot = NULL
+		);
+
 /** \brief Returns the base coordinates of a point given in body coordinates.
  *
  * \param model the rigid body model
@@ -86,6 +149,18 @@ Math::Vector3d CalcBodyToBaseCoordinates (
 		const Math::Vector3d &body_point_position,
 		bool update_kinematics = true);
 
+/** \brief Same as CalcBodyToBaseCoordinates() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+Math::Vector3d CalcBodyToBaseCoordinates (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		const Math::Vector3d &body_point_position,
+		bool update_kinematics = true);
+
 /** \brief Returns the body coordinates of a point given in base coordinates.
  *
  * \param model the rigid body model
@@ -105,6 +180,18 @@ Math::Vector3d CalcBaseToBodyCoordinates (
 		const Math::Vector3d &base_point_position,
 		bool update_kinematics = true);
 
+/** \brief Same as CalcBaseToBodyCoordinates() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+Math::Vector3d CalcBaseToBodyCoordinates (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		const Math::Vector3d &base_point_position,
+		bool update_kinematics = true);
+
 /** \brief Returns the orientation of a given body as 3x3 matrix
  *
  * \param model the rigid body model
@@ -123,6 +210,17 @@ Math::Matrix3d CalcBodyWorldOrientation (
 		const unsigned int body_id,
 		bool update_kinematics = true);
 
+/** \brief Same as CalcBodyWorldOrientation() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+Math::Matrix3d CalcBodyWorldOrientation (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const unsigned int body_id,
+		bool update_kinematics = true);
+
 /** \brief Computes the point jacobian for a point on a body
  *
  * If a position of a point is computed by a function \f$g(q(t))\f$ for which its
@@ -152,6 +250,18 @@ void CalcPointJacobian (Model &model,
 		bool update_kinematics = true
 		);
 
+/** \brief Same as CalcPointJacobian() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcPointJacobian (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
 /** \brief Computes the spatial jacobian for a body
  *
  * The spatial velocity of a body at the origin of the base coordinate
@@ -181,6 +291,292 @@ void CalcBodySpatialJacobian (
 		bool update_kinematics = true
 		);
 
+/** \brief Same as CalcBodySpatialJacobian() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcBodySpatialJacobian (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the point jacobians of multiple points stacked into a
+ * single matrix
+ *
+ * Rows 3 k to 3 k + 2 of G contain the jacobian of point_positions[k] on
+ * body_ids[k] as computed by CalcPointJacobian(). The kinematics are
+ * updated at most once and the motion subspaces of the joints that are
+ * shared by the points are transformed to base coordinates only once.
+ *
+ * \param model     rigid body model
+ * \param Q         state vector of the internal joints
+ * \param body_ids  the ids of the bodies
+ * \param point_positions the positions of the points in body-local data
+ * \param G         a matrix of dimensions 3 * \#points x \#qdot_size where the result will be stored in
+ * \param update_kinematics whether UpdateKinematics() should be called or not (default: true)
+ *
+ * \note This function only evaluates the entries of G that are non-zero.
+ * Before calling this function one has to ensure that all other values
+ * have been set to zero, e.g. by calling G.setZero().
+ */
+RBDL_DLLAPI
+void CalcPointJacobians (Model &model,
+		const Math::VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcPointJacobians() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcPointJacobians (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the spatial jacobians of multiple bodies stacked into a
+ * single matrix
+ *
+ * Rows 6 k to 6 k + 5 of G contain the jacobian of body_ids[k] as computed
+ * by CalcBodySpatialJacobian().
+ *
+ * \param model    rigid body model
+ * \param Q        state vector of the internal joints
+ * \param body_ids the ids of the bodies
+ * \param G        a matrix of size 6 * \#bodies x \#qdot_size where the result will be stored in
+ * \param update_kinematics whether UpdateKinematics() should be called or not (default: true)
+ *
+ * \note This function only evaluates the entries of G that are non-zero.
+ * Before calling this function one has to ensure that all other values
+ * have been set to zero, e.g. by calling G.setZero().
+ */
+RBDL_DLLAPI
+void CalcBodySpatialJacobians (
+		Model &model,
+		const Math::VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcBodySpatialJacobians() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcBodySpatialJacobians (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the time derivative of the point jacobian of a point on
+ * a body
+ *
+ * Computes \f$\dot{G}(q, \dot{q})\f$ for the jacobian \f$G(q)\f$ of
+ * CalcPointJacobian() such that the acceleration of the point is \f$G(q)
+ * \ddot{q} + \dot{G}(q, \dot{q}) \dot{q}\f$.
+ *
+ * \param model   rigid body model
+ * \param Q       state vector of the internal joints
+ * \param QDot    velocity vector of the internal joints
+ * \param body_id the id of the body
+ * \param point_position the position of the point in body-local data
+ * \param G       a matrix of dimensions 3 x \#qdot_size where the result will be stored in
+ * \param update_kinematics whether UpdateKinematicsCustom() should be
+ * called with Q and QDot or not (default: true)
+ *
+ * \note This function only evaluates the entries of G that are non-zero.
+ * Before calling this function one has to ensure that all other values
+ * have been set to zero, e.g. by calling G.setZero().
+ */
+RBDL_DLLAPI
+void CalcPointJacobianDot (Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcPointJacobianDot() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcPointJacobianDot (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the time derivatives of the point jacobians of multiple
+ * points stacked into a single matrix
+ *
+ * Rows 3 k to 3 k + 2 of G contain the result of CalcPointJacobianDot()
+ * for point_positions[k] on body_ids[k].
+ *
+ * \note This function only evaluates the entries of G that are non-zero.
+ * Before calling this function one has to ensure that all other values
+ * have been set to zero, e.g. by calling G.setZero().
+ */
+RBDL_DLLAPI
+void CalcPointJacobiansDot (Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcPointJacobiansDot() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcPointJacobiansDot (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the bias acceleration \f$\dot{G}(q, \dot{q})
+ * \dot{q}\f$ of a point on a body
+ *
+ * This is the acceleration of the point for \f$\ddot{q} = 0\f$, i.e. the
+ * same as CalcPointAcceleration() with a zero QDDot, but it does not
+ * update the accelerations of the bodies.
+ *
+ * \param model   rigid body model
+ * \param Q       state vector of the internal joints
+ * \param QDot    velocity vector of the internal joints
+ * \param body_id the id of the body
+ * \param point_position the position of the point in body-local data
+ * \param update_kinematics whether UpdateKinematicsCustom() should be
+ * called with Q and QDot or not (default: true)
+ *
+ * \returns the bias acceleration of the point in base coordinates
+ */
+RBDL_DLLAPI
+Math::Vector3d CalcPointJacobianDotQDot (Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcPointJacobianDotQDot() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+Math::Vector3d CalcPointJacobianDotQDot (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the bias accelerations of multiple points stacked into
+ * a single vector
+ *
+ * Entries 3 k to 3 k + 2 of result contain the result of
+ * CalcPointJacobianDotQDot() for point_positions[k] on body_ids[k].
+ */
+RBDL_DLLAPI
+void CalcPointJacobiansDotQDot (Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::VectorNd &result,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcPointJacobiansDotQDot() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcPointJacobiansDotQDot (const Model &model, DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::VectorNd &result,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the time derivative of the spatial jacobian of a body
+ *
+ * Computes \f$\dot{G}(q, \dot{q})\f$ for the jacobian \f$G(q)\f$ of
+ * CalcBodySpatialJacobian(), i.e. the result is expressed in the
+ * coordinates of the (moving) body.
+ *
+ * \param model   rigid body model
+ * \param Q       state vector of the internal joints
+ * \param QDot    velocity vector of the internal joints
+ * \param body_id the id of the body
+ * \param G       a matrix of size 6 x \#qdot_size where the result will be stored in
+ * \param update_kinematics whether UpdateKinematicsCustom() should be
+ * called with Q and QDot or not (default: true)
+ *
+ * \note This function only evaluates the entries of G that are non-zero.
+ * Before calling this function one has to ensure that all other values
+ * have been set to zero, e.g. by calling G.setZero().
+ */
+RBDL_DLLAPI
+void CalcBodySpatialJacobianDot (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Same as CalcBodySpatialJacobianDot() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+void CalcBodySpatialJacobianDot (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		Math::MatrixNd &G,
+		bool update_kinematics = true
+		);
+
+/** \brief Computes the motion subspaces of all joints in base coordinates
+ *
+ * Stores the result in DynamicsWorkspace::S_base using the current
+ * DynamicsWorkspace::X_base. Nothing is computed if S_base is still valid,
+ * i.e. if jcalc() was not called since the last computation. This is used
+ * by all jacobian functions.
+ */
+RBDL_DLLAPI
+void CalcBaseMotionSubspaces (const Model &model, DynamicsWorkspace &ws);
+
 /** \brief Computes the velocity of a point on a body 
  *
  * \param model   rigid body model
@@ -202,6 +598,20 @@ Math::Vector3d CalcPointVelocity (
 		bool update_kinematics = true
 		);
 
+/** \brief Same as CalcPointVelocity() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+Math::Vector3d CalcPointVelocity (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		bool update_kinematics = true
+		);
+
 /** \brief Computes the acceleration of a point on a body 
  *
  * \param model   rigid body model
@@ -240,6 +650,21 @@ Math::Vector3d CalcPointAcceleration (
 		bool update_kinematics = true
 	);
 
+/** \brief Same as CalcPointAcceleration() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+Math::Vector3d CalcPointAcceleration (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &QDDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		bool update_kinematics = true
+	);
+
 /** \brief Computes the inverse kinematics iteratively using a damped Levenberg-Marquardt method (also known as Damped Least Squares method)
  *
  * \param model rigid body model
@@ -266,10 +691,15 @@ Math::Vector3d CalcPointAcceleration (
  * The parameter \f$\lambda\f$ is the damping factor that has to
  * be chosen carefully. In case of unreachable positions higher values (e.g
  * 0.9) can be helpful. Otherwise values of 0.0001, 0.001, 0.01, 0.1 might
- * yield good results. See the literature for best practices.
+ * yield good results. See the literature for best practices. Without
+ * damping (\f$\lambda = 0\f$) the step is the least squares step, which
+ * is ill-conditioned close to singular poses.
  *
  * \warning The actual accuracy might be rather low (~1.0e-2)! Use this function with a
  * grain of suspicion.
+ *
+ * \sa InverseKinematicsConstraintSet for orientation targets, joint
+ * limits, and repeated solves without heap allocations.
  */
 RBDL_DLLAPI
 bool InverseKinematics (
@@ -284,6 +714,229 @@ bool InverseKinematics (
 		unsigned int max_iter = 50
 		);
 
+/** \brief Same as InverseKinematics() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+bool InverseKinematics (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Qinit,
+		const std::vector<unsigned int>& body_id,
+		const std::vector<Math::Vector3d>& body_point,
+		const std::vector<Math::Vector3d>& target_pos,
+		Math::VectorNd &Qres,
+		double step_tol = 1.0e-12,
+		double lambda = 0.01,
+		unsigned int max_iter = 50
+		);
+
+/** \brief Description, parameters, statistics, and preallocated storage of
+ * the inverse kinematics solver
+ *
+ * The targets are added with AddPointConstraint(),
+ * AddOrientationConstraint(), or AddFullConstraint(). Before it is used
+ * the first time the set has to be bound to a model using Bind() which
+ * allocates all temporary values such that InverseKinematics() does not
+ * allocate any heap memory. The targets of existing constraints can be
+ * changed at any time, e.g. for every frame of a motion, without binding
+ * the set again.
+ *
+ * The solver uses a Levenberg-Marquardt method with adaptive damping: a
+ * step that reduces the error is accepted and the damping is reduced by
+ * lambda_decrease, otherwise the step is discarded and the damping is
+ * increased by lambda_increase. Discarded steps reuse the jacobian of the
+ * current state.
+ *
+ * \note Joint limits q_min and q_max (of size q_size) are enforced by
+ * projecting each step onto the box. The limits of spherical joints are
+ * ignored.
+ */
+struct RBDL_DLLAPI InverseKinematicsConstraintSet {
+	enum ConstraintType {
+		ConstraintTypePosition = 0,
+		ConstraintTypeOrientation,
+		ConstraintTypeFull
+	};
+
+	InverseKinematicsConstraintSet();
+
+	/** \brief Adds a target position for a point on a body
+	 *
+	 * \param body_id the id of the body
+	 * \param body_point the point in body coordinates
+	 * \param target_pos the target position in base coordinates
+	 *
+	 * \returns the index of the constraint
+	 */
+	unsigned int AddPointConstraint (
+			unsigned int body_id,
+			const Math::Vector3d &body_point,
+			const Math::Vector3d &target_pos
+			);
+
+	/** \brief Adds a target orientation of a body
+	 *
+	 * \param body_id the id of the body
+	 * \param target_orientation the target orientation in the same
+	 * convention as CalcBodyWorldOrientation(), i.e. the rotation from base
+	 * to body coordinates
+	 *
+	 * \returns the index of the constraint
+	 */
+	unsigned int AddOrientationConstraint (
+			unsigned int body_id,
+			const Math::Matrix3d &target_orientation
+			);
+
+	/** \brief Adds a target position and a target orientation of a body
+	 *
+	 * \returns the index of the constraint
+	 */
+	unsigned int AddFullConstraint (
+			unsigned int body_id,
+			const Math::Vector3d &body_point,
+			const Math::Vector3d &target_pos,
+			const Math::Matrix3d &target_orientation
+			);
+
+	/// \brief Removes all constraints (the set has to be bound again)
+	void ClearConstraints ();
+
+	/** \brief Sets the joint limits
+	 *
+	 * Both vectors have to be of size q_size. Use +/- infinity for
+	 * unlimited coordinates. Empty vectors disable the limits.
+	 */
+	void SetJointLimits (const Math::VectorNd &q_min, const Math::VectorNd &q_max);
+
+	/// \brief Allocates the temporary values for the model and the constraints
+	bool Bind (const Model &model);
+
+	/// \brief Returns the number of constraints
+	size_t size() const {
+		return body_ids.size();
+	}
+
+	/// \brief Returns the number of rows of the stacked constraint error
+	unsigned int GetNumRows() const {
+		return num_rows;
+	}
+
+	// Constraint description
+	std::vector<ConstraintType> constraint_type;
+	std::vector<unsigned int> body_ids;
+	std::vector<Math::Vector3d> body_points;
+	std::vector<Math::Vector3d> target_positions;
+	std::vector<Math::Matrix3d> target_orientations;
+	/// \brief First row of each constraint in J and e
+	std::vector<unsigned int> constraint_row_index;
+	unsigned int num_rows;
+
+	// Joint limits
+	Math::VectorNd q_min;
+	Math::VectorNd q_max;
+
+	// Solver parameters
+	/// \brief Initial damping factor
+	double lambda;
+	/// \brief Lower bound of the adapted damping factor
+	double lambda_min;
+	/// \brief Upper bound of the adapted damping factor, the solver stops
+	/// when a step with this damping does not reduce the error
+	double lambda_max;
+	/// \brief Factor of the damping after a discarded step
+	double lambda_increase;
+	/// \brief Factor of the damping after an accepted step
+	double lambda_decrease;
+	/// \brief Convergence tolerance of the norm of an accepted step
+	double step_tol;
+	/// \brief Convergence tolerance of the norm of the constraint error
+	double constraint_tol;
+	/// \brief Maximum number of (accepted and discarded) steps
+	unsigned int max_steps;
+	/** \brief Whether a solve starts with the damping of the previous solve
+	 * instead of lambda (useful if Qinit is the solution of the previous
+	 * frame of a motion)
+	 */
+	bool warm_start;
+
+	// Statistics
+	/// \brief Number of steps of the last solve
+	unsigned int num_steps;
+	/// \brief Number of discarded steps of the last solve
+	unsigned int num_rejected_steps;
+	/// \brief Norm of the constraint error at the result of the last solve
+	double error_norm;
+	/// \brief Norm of the last accepted step
+	double delta_q_norm;
+	/// \brief Damping factor at the end of the last solve
+	double lambda_last;
+	/// \brief Whether the last solve converged
+	bool converged;
+	/// \brief Number of solves since the last call of ResetStatistics()
+	unsigned int solve_count;
+	/// \brief Number of steps since the last call of ResetStatistics()
+	unsigned int total_steps;
+
+	/// \brief Resets the accumulated statistics and the warm start state
+	void ResetStatistics();
+
+	// Temporary values
+	bool bound;
+	/// \brief Stacked jacobian of the constraints (num_rows x qdot_size)
+	Math::MatrixNd J;
+	/// \brief Constraint error at the current state
+	Math::VectorNd e;
+	/// \brief Constraint error at the trial state
+	Math::VectorNd e_trial;
+	/// \brief Undamped normal matrix, J J^T or J^T J whichever is smaller
+	Math::MatrixNd JJt;
+	/// \brief Damped normal matrix
+	Math::MatrixNd A;
+	/// \brief Right hand side and solution of the damped system
+	Math::VectorNd z;
+	Math::VectorNd delta_q;
+	Math::VectorNd Q_trial;
+
+#ifndef RBDL_USE_SIMPLE_MATH
+	Eigen::LLT<Math::MatrixNd> llt;
+#endif
+};
+
+/** \brief Computes the inverse kinematics of the constraints in CS
+ *
+ * Iterates until the norm of the constraint error is below
+ * CS.constraint_tol or the norm of an accepted step is below CS.step_tol.
+ * The statistics of the solve are stored in CS.
+ *
+ * \param model rigid body model
+ * \param Qinit initial guess for the state (may be the same vector as Qres)
+ * \param CS    the constraints, parameters, and temporary values
+ * \param Qres  output of the computed inverse kinematics
+ *
+ * \returns true if the solver converged, false otherwise
+ */
+RBDL_DLLAPI
+bool InverseKinematics (
+		Model &model,
+		const Math::VectorNd &Qinit,
+		InverseKinematicsConstraintSet &CS,
+		Math::VectorNd &Qres
+		);
+
+/** \brief Same as InverseKinematics() but stores all intermediate values in the
+ * DynamicsWorkspace ws instead of the model.
+ */
+RBDL_DLLAPI
+bool InverseKinematics (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Qinit,
+		InverseKinematicsConstraintSet &CS,
+		Math::VectorNd &Qres
+		);
+
 /** @} */
 
 }
@@ -96,6 +96,199 @@ namespace RigidBodyDynamics {
  * RigidBodyDynamics::Addons::URDFReadFromFile \endlink.
  */
 
+struct Model;
+
+/** \brief Per-evaluation state and temporary values of the algorithms
+ *
+ * This structure contains all values that are written by the algorithms
+ * of the \ref kinematics_group, \ref dynamics_group and \ref
+ * contacts_group modules, e.g. joint transformations, spatial velocities,
+ * accelerations and the articulated body inertias. The structural
+ * information of the model (topology, joints, inertias) is kept in \link
+ * RigidBodyDynamics::Model Model\endlink.
+ *
+ * All algorithms have an overload that takes a <tt>const Model &</tt>
+ * together with a DynamicsWorkspace. This allows to evaluate a single
+ * model concurrently from multiple threads by using one workspace per
+ * thread. The overloads that only take a <tt>Model &</tt> use the
+ * workspace that is contained in the model itself.
+ *
+ * Once a workspace is initialized UpdateKinematics(),
+ * UpdateKinematicsCustom(), UpdateKinematicsIncremental(), the point and Jacobian functions of the \ref
+ * kinematics_group module, ForwardDynamics(), InverseDynamics(),
+ * NonlinearEffects(), and CompositeRigidBodyAlgorithm() do not allocate
+ * any heap memory which makes them suitable for real-time loops.
+ *
+ * \note A workspace has to be (re-)initialized with Init() whenever bodies
+ * are added to the model.
+ */
+struct RBDL_DLLAPI DynamicsWorkspace {
+	DynamicsWorkspace() :
+		incremental_q_valid (false),
+		incremental_qdot_valid (false),
+		incremental_qddot_valid (false),
+		incremental_update_count (0),
+		S_base_valid (false),
+		S_dot_base_valid (false)
+	{}
+	/// \brief Creates a workspace with storage for all bodies of the model
+	explicit DynamicsWorkspace (const Model &model);
+
+	/// \brief Allocates and initializes the storage for all bodies of the model
+	void Init (const Model &model);
+
+	// State information
+	/// \brief The spatial velocity of the bodies
+	std::vector<Math::SpatialVector> v;
+	/// \brief The spatial acceleration of the bodies
+	std::vector<Math::SpatialVector> a;
+
+	////////////////////////////////////
+	// Joint state variables
+	std::vector<Math::SpatialTransform> X_J;
+	std::vector<Math::SpatialVector> v_J;
+	std::vector<Math::SpatialVector> c_J;
+
+	////////////////////////////////////
+	// Special variables for joints with 3 degrees of freedom
+	/// \brief Motion subspace for joints with 3 degrees of freedom
+	std::vector<Math::Matrix63> multdof3_S;
+	std::vector<Math::Matrix63> multdof3_U;
+	std::vector<Math::Matrix3d> multdof3_Dinv;
+	std::vector<Math::Vector3d> multdof3_u;
+
+	////////////////////////////////////
+	// Dynamics variables
+
+	/// \brief The velocity dependent spatial acceleration
+	std::vector<Math::SpatialVector> c;
+	/// \brief The spatial inertia of the bodies 
+	std::vector<Math::SpatialMatrix> IA;
+	/// \brief The spatial bias force
+	std::vector<Math::SpatialVector> pA;
+	/// \brief Temporary variable U_i (RBDA p. 130)
+	std::vector<Math::SpatialVector> U;
+	/// \brief Temporary variable D_i (RBDA p. 130)
+	Math::VectorNd d;
+	/// \brief Temporary variable u (RBDA p. 130)
+	Math::VectorNd u;
+	/// \brief Internal forces on the body (used only InverseDynamics())
+	std::vector<Math::SpatialVector> f;
+	/// \brief The composite spatial inertia (used only in CompositeRigidBodyAlgorithm())
+	std::vector<Math::SpatialRigidBodyInertia> Ic;
+	std::vector<Math::SpatialVector> hc;
+
+	////////////////////////////////////
+	// Bodies
+
+	/** \brief Transformation from the parent body to the current body
+	 * \f[
+	 *	X_{\lambda(i)} = {}^{i} X_{\lambda(i)}
+	 * \f]
+	 */
+	std::vector<Math::SpatialTransform> X_lambda;
+	/// \brief Transformation from the base to bodies reference frame
+	std::vector<Math::SpatialTransform> X_base;
+
+	////////////////////////////////////
+	// Incremental kinematics (see UpdateKinematicsIncremental())
+
+	/// \brief Q, QDot and QDDot of the last call to UpdateKinematicsIncremental()
+	Math::VectorNd incremental_q;
+	Math::VectorNd incremental_qdot;
+	Math::VectorNd incremental_qddot;
+	/** \brief Whether the kinematic values still belong to incremental_q,
+	 * incremental_qdot, and incremental_qddot
+	 *
+	 * These are cleared by jcalc() and jcalc_X_lambda_S(), i.e. by every
+	 * algorithm that overwrites the kinematics with a different state.
+	 */
+	bool incremental_q_valid;
+	bool incremental_qdot_valid;
+	bool incremental_qddot_valid;
+	/// \brief Per-body recomputation level of UpdateKinematicsIncremental()
+	std::vector<unsigned char> incremental_dirty;
+	/// \brief Number of bodies recomputed by the last call of UpdateKinematicsIncremental()
+	unsigned int incremental_update_count;
+
+	////////////////////////////////////
+	// Jacobians
+
+	/** \brief Motion subspaces of all degrees of freedom in base coordinates
+	 * (6 x qdot_size)
+	 *
+	 * The Jacobian functions compute this once from X_base and reuse it
+	 * until jcalc() or jcalc_X_lambda_S() change the kinematics.
+	 */
+	Math::MatrixNd S_base;
+	/// \brief Whether S_base belongs to the current X_base
+	bool S_base_valid;
+	/** \brief Time derivatives of S_base (6 x qdot_size)
+	 *
+	 * Computed from the velocities v by the jacobian derivative functions
+	 * such as CalcPointJacobianDot().
+	 */
+	Math::MatrixNd S_dot_base;
+	/// \brief Whether S_dot_base belongs to the current X_base and v
+	bool S_dot_base_valid;
+};
+
+/** \brief Temporary values for evaluating many states of a model at once
+ *
+ * This structure is used by the batched algorithms such as
+ * ForwardDynamicsBatch(). All per-body values are stored for every sample
+ * of the batch. The value of body i for sample k is stored at index
+ * <tt>i * sample_count + k</tt> so that the values of all samples of a
+ * single body are contiguous in memory.
+ *
+ * \note A workspace has to be (re-)initialized with Init() whenever bodies
+ * are added to the model or the number of samples changes.
+ */
+struct RBDL_DLLAPI BatchDynamicsWorkspace {
+	BatchDynamicsWorkspace() :
+		sample_count (0)
+	{}
+	/// \brief Creates a workspace for sample_count states of the model
+	BatchDynamicsWorkspace (const Model &model, unsigned int sample_count);
+
+	/// \brief Allocates the storage for sample_count states of the model
+	void Init (const Model &model, unsigned int sample_count);
+
+	/// \brief Number of samples the workspace was initialized for
+	unsigned int sample_count;
+
+	/// \brief Transformations from the parent body to the current body
+	std::vector<Math::SpatialTransform> X_lambda;
+	/// \brief The spatial velocity of the bodies
+	std::vector<Math::SpatialVector> v;
+	/// \brief The spatial acceleration of the bodies
+	std::vector<Math::SpatialVector> a;
+	/// \brief The velocity dependent spatial acceleration
+	std::vector<Math::SpatialVector> c;
+	/// \brief The articulated body inertia of the bodies
+	std::vector<Math::SpatialMatrix> IA;
+	/// \brief The spatial bias force
+	std::vector<Math::SpatialVector> pA;
+	/// \brief Temporary variable U_i (RBDA p. 130)
+	std::vector<Math::SpatialVector> U;
+	/// \brief Temporary variable D_i (RBDA p. 130)
+	Math::VectorNd d;
+	/// \brief Temporary variable u (RBDA p. 130)
+	Math::VectorNd u;
+
+	/// \brief Values for joints with 3 degrees of freedom (only allocated
+	/// if the model contains such joints)
+	std::vector<Math::Matrix63> multdof3_S;
+	std::vector<Math::Matrix63> multdof3_U;
+	std::vector<Math::Matrix3d> multdof3_Dinv;
+	std::vector<Math::Vector3d> multdof3_u;
+
+	/// \brief Joint velocities of the body that is currently processed
+	std::vector<Math::SpatialVector> v_J;
+	/// \brief Joint accelerations of the body that is currently processed
+	std::vector<Math::SpatialVector> c_J;
+};
+
 /** \brief Contains all information about the rigid body model
  *
  * This class contains all information required to perform the forward
@@ -111,9 +304,14 @@ namespace RigidBodyDynamics {
  * and tau however start at 0 such that the first entry (e.g. q[0]) always
  * specifies the value for the first moving body.
  *
+ * The model also contains a DynamicsWorkspace that is used by all
+ * algorithms that are called with a non-const Model. To evaluate the same
+ * model from multiple threads, create a separate DynamicsWorkspace for
+ * each thread and use the overloads that take a <tt>const Model &</tt>.
+ *
  * \note To query the number of degrees of freedom use Model::dof_count.
  */
-struct RBDL_DLLAPI Model {
+struct RBDL_DLLAPI Model : public DynamicsWorkspace {
 	Model();
 
 	// Structural information
@@ -152,77 +350,61 @@ struct RBDL_DLLAPI Model {
 	/// \brief the cartesian vector of the gravity
 	Math::Vector3d gravity;
 
-	// State information
-	/// \brief The spatial velocity of the bodies
-	std::vector<Math::SpatialVector> v;
-	/// \brief The spatial acceleration of the bodies
-	std::vector<Math::SpatialVector> a;
-
 	////////////////////////////////////
 	// Joints
 
 	/// \brief All joints
 	
 	std::vector<Joint> mJoints;
+	/// \brief Kernel of the joint type of joint i (used by jcalc())
+	std::vector<JointKernel> mJointKernels;
+	/// \brief Position kernel of the joint type of joint i (used by jcalc_X_lambda_S())
+	std::vector<JointPositionKernel> mJointPositionKernels;
 	/// \brief The joint axis for joint i
 	std::vector<Math::SpatialVector> S;
 
-	// Joint state variables
-	std::vector<Math::SpatialTransform> X_J;
-	std::vector<Math::SpatialVector> v_J;
-	std::vector<Math::SpatialVector> c_J;
-
 	std::vector<unsigned int> mJointUpdateOrder;
 
-	/// \brief Transformations from the parent body to the frame of the joint.
-	// It is expressed in the coordinate frame of the parent.
+	/** \brief Transformations from the parent body to the frame of the joint.
+	 *
+	 * It is expressed in the coordinate frame of the parent.
+	 *
+	 * \note Use SetJointFrame() to change it. After modifying X_T directly
+	 * UpdateJointFrameKinds() has to be called, otherwise the algorithms
+	 * use the outdated X_T_kind.
+	 */
 	std::vector<Math::SpatialTransform> X_T;
+	/// \brief Kind of the rotation of the joint transformation X_J of joint i
+	std::vector<Math::SpatialTransformKind> X_J_kind;
+	/** \brief Kind of the rotation of X_T[i]
+	 *
+	 * \note This is updated by SetJointFrame() and UpdateJointFrameKinds()
+	 * and is not checked by the algorithms.
+	 */
+	std::vector<Math::SpatialTransformKind> X_T_kind;
+	/** \brief Kind of the rotation of X_lambda[i] = X_J[i] * X_T[i]
+	 *
+	 * The algorithms use it to skip the trivial entries of the rotation of
+	 * joints that rotate about a principal axis or only translate.
+	 */
+	std::vector<Math::SpatialTransformKind> X_lambda_kind;
 	/// \brief The number of fixed joints that have been declared before each joint.
 	std::vector<unsigned int> mFixedJointCount;
 
 	////////////////////////////////////
 	// Special variables for joints with 3 degrees of freedom
-	/// \brief Motion subspace for joints with 3 degrees of freedom
-	std::vector<Math::Matrix63> multdof3_S;
-	std::vector<Math::Matrix63> multdof3_U;
-	std::vector<Math::Matrix3d> multdof3_Dinv;
-	std::vector<Math::Vector3d> multdof3_u;
+	/// \brief Index of the w-component of the Quaternion of spherical joints in q
 	std::vector<unsigned int> multdof3_w_index;
 
 	////////////////////////////////////
 	// Dynamics variables
 
-	/// \brief The velocity dependent spatial acceleration
-	std::vector<Math::SpatialVector> c;
-	/// \brief The spatial inertia of the bodies 
-	std::vector<Math::SpatialMatrix> IA;
-	/// \brief The spatial bias force
-	std::vector<Math::SpatialVector> pA;
-	/// \brief Temporary variable U_i (RBDA p. 130)
-	std::vector<Math::SpatialVector> U;
-	/// \brief Temporary variable D_i (RBDA p. 130)
-	Math::VectorNd d;
-	/// \brief Temporary variable u (RBDA p. 130)
-	Math::VectorNd u;
-	/// \brief Internal forces on the body (used only InverseDynamics())
-	std::vector<Math::SpatialVector> f;
-	/// \brief The spatial inertia of body i (used only in CompositeRigidBodyAlgorithm())
+	/// \brief The spatial inertia of body i
 	std::vector<Math::SpatialRigidBodyInertia> I;
-	std::vector<Math::SpatialRigidBodyInertia> Ic;
-	std::vector<Math::SpatialVector> hc;
 
 	////////////////////////////////////
 	// Bodies
 
-	/** \brief Transformation from the parent body to the current body
-	 * \f[
-	 *	X_{\lambda(i)} = {}^{i} X_{\lambda(i)}
-	 * \f]
-	 */
-	std::vector<Math::SpatialTransform> X_lambda;
-	/// \brief Transformation from the base to bodies reference frame
-	std::vector<Math::SpatialTransform> X_base;
-
 	/// \brief All bodies that are attached to a body via a fixed joint.
 	std::vector<FixedBody> mFixedBodies;
 	/** \brief Value that is used to discriminate between fixed and movable
@@ -370,7 +552,7 @@ struct RBDL_DLLAPI Model {
 
 	/** \brief Checks whether the body is rigidly attached to another body.
 	 */
-	bool IsFixedBodyId (unsigned int body_id) {
+	bool IsFixedBodyId (unsigned int body_id) const {
 		if (body_id >= fixed_body_discriminator 
 				&& body_id < std::numeric_limits<unsigned int>::max() 
 				&& body_id - fixed_body_discriminator < mFixedBodies.size()) {
@@ -379,7 +561,7 @@ struct RBDL_DLLAPI Model {
 		return false;
 	}
 
-	bool IsBodyId (unsigned int id) {
+	bool IsBodyId (unsigned int id) const {
 		if (id > 0 && id < mBodies.size())
 			return true;
 		if (id >= fixed_body_discriminator && id < std::numeric_limits<unsigned int>::max()) {
@@ -396,7 +578,7 @@ struct RBDL_DLLAPI Model {
 	 * freedom. This function returns the id of the actual
 	 * non-virtual parent body.
 	 */
-	unsigned int GetParentBodyId (unsigned int id) {
+	unsigned int GetParentBodyId (unsigned int id) const {
 		if (id >= fixed_body_discriminator) {
 			return mFixedBodies[id - fixed_body_discriminator].mMovableParent;
 		}
@@ -412,7 +594,7 @@ struct RBDL_DLLAPI Model {
 
 	/** Returns the joint frame transformtion, i.e. the second argument to Model::AddBody().
 	 */
-	Math::SpatialTransform GetJointFrame (unsigned int id) {
+	Math::SpatialTransform GetJointFrame (unsigned int id) const {
 		if (id >= fixed_body_discriminator) {
 			return mFixedBodies[id - fixed_body_discriminator].mParentTransform;
 		}
@@ -430,6 +612,9 @@ struct RBDL_DLLAPI Model {
 	}
 
 	/** Sets the joint frame transformtion, i.e. the second argument to Model::AddBody().
+	 *
+	 * This is the required way to change X_T as it also updates X_T_kind
+	 * and X_lambda_kind.
 	 */
 	void SetJointFrame (unsigned int id, const Math::SpatialTransform &transform) {
 		if (id >= fixed_body_discriminator) {
@@ -447,6 +632,23 @@ struct RBDL_DLLAPI Model {
 			X_T[child_id] = transform;
 		} else if (id > 0) {
 			X_T[id] = transform;
+		} else {
+			return;
+		}
+
+		X_T_kind[child_id] = Math::CalcSpatialTransformKind (X_T[child_id]);
+		X_lambda_kind[child_id] = Math::CombineSpatialTransformKinds (X_J_kind[child_id], X_T_kind[child_id]);
+	}
+
+	/** \brief Recomputes X_T_kind and X_lambda_kind of all joints
+	 *
+	 * This has to be called after X_T was modified directly instead of with
+	 * SetJointFrame().
+	 */
+	void UpdateJointFrameKinds () {
+		for (unsigned int i = 1; i < X_T.size(); i++) {
+			X_T_kind[i] = Math::CalcSpatialTransformKind (X_T[i]);
+			X_lambda_kind[i] = Math::CombineSpatialTransformKinds (X_J_kind[i], X_T_kind[i]);
 		}
 	}
 
@@ -467,6 +669,71 @@ struct RBDL_DLLAPI Model {
 	}
 };
 
+/** \brief Mapping between a model and its copy with reordered bodies
+ *
+ * \sa ReorderBodiesDepthFirst()
+ */
+struct RBDL_DLLAPI BodyReordering {
+	/// \brief Id in the reordered model of each movable body of the original model
+	std::vector<unsigned int> body_id;
+	/** \brief Index in q of the original model of each entry of q of the
+	 * reordered model
+	 *
+	 * The first qdot_size entries also describe the mapping of qdot, qddot
+	 * and tau.
+	 */
+	std::vector<unsigned int> q_index;
+
+	/// \brief Returns the id in the reordered model of a (movable or fixed) body
+	unsigned int GetReorderedBodyId (const Model &model, unsigned int id) const {
+		if (model.IsFixedBodyId (id))
+			return id;
+
+		return body_id[id];
+	}
+
+	/// \brief Converts q of the original model to q of the reordered model
+	void ReorderQ (const Math::VectorNd &Q, Math::VectorNd &Q_reordered) const;
+	/// \brief Converts qdot, qddot, or tau of the original model to the reordered model
+	void ReorderQDot (const Math::VectorNd &QDot, Math::VectorNd &QDot_reordered) const;
+	/// \brief Converts q of the reordered model to q of the original model
+	void RestoreQ (const Math::VectorNd &Q_reordered, Math::VectorNd &Q) const;
+	/// \brief Converts qdot, qddot, or tau of the reordered model to the original model
+	void RestoreQDot (const Math::VectorNd &QDot_reordered, Math::VectorNd &QDot) const;
+
+	/// \brief Size of qdot of both models
+	unsigned int qdot_size;
+};
+
+/** \brief Creates a copy of the model whose bodies are numbered in
+ * depth-first order
+ *
+ * The ids of the bodies of a model follow the order of the calls to
+ * Model::AddBody(). Models that add the bodies of different branches
+ * alternately (e.g. when loaded from files) therefore store the values of
+ * the bodies of a subtree far apart from each other. This function adds all
+ * bodies again in depth-first order such that every subtree consists of
+ * consecutive ids, which improves the memory locality of the recursive
+ * algorithms. This is best done once after the model is complete.
+ *
+ * The names of the bodies are kept such that Model::GetBodyId() returns
+ * the new ids. Fixed bodies keep their ids. As the degrees of freedom are
+ * numbered like the bodies, q, qdot, qddot, and tau of the reordered model
+ * are permutations of the original ones which can be converted with the
+ * returned BodyReordering.
+ *
+ * \param model the original model
+ * \param reordered the reordered model (output, may be the same as model)
+ * \param reordering mapping between the ids and generalized coordinates
+ * of both models (output, optional)
+ */
+RBDL_DLLAPI
+void ReorderBodiesDepthFirst (
+		const Model &model,
+		Model &reordered,
+		BodyReordering *reordering = NULL
+		);
+
 /** @} */
 }
 
@@ -151,6 +151,40 @@ class Block {
 			return (*mParentMatrix) (j + mParentRowStart, i + mParentColStart);
 		}
 
+		void setZero() {
+			for (unsigned int i = 0; i < rows(); i++) {
+				for (unsigned int j = 0; j < cols(); j++) {
+					(*this)(i,j) = 0.;
+				}
+			}
+		}
+
+		val_type squaredNorm() const {
+			val_type result = 0.;
+			for (unsigned int i = 0; i < rows(); i++) {
+				for (unsigned int j = 0; j < cols(); j++) {
+					result += (*this)(i,j) * (*this)(i,j);
+				}
+			}
+			return result;
+		}
+
+		val_type norm() const {
+			return sqrt (squaredNorm());
+		}
+
+		template <typename other_matrix_type>
+		val_type dot (const other_matrix_type &other) const {
+			assert (rows() * cols() == other.rows() * other.cols());
+			val_type result = 0.;
+			for (unsigned int i = 0; i < rows(); i++) {
+				for (unsigned int j = 0; j < cols(); j++) {
+					result += (*this)(i,j) * (cols() == 1 ? other[i] : other[j]);
+				}
+			}
+			return result;
+		}
+
 		Block transpose() const {
 			Block result (*this);
 			result.mTransposed = mTransposed ^ true;
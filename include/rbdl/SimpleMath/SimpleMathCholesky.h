@@ -13,9 +13,10 @@ namespace SimpleMath {
 		public:
 			typedef typename matrix_type::value_type value_type;	
 
-		private:
-			LLT () {}
+			LLT () :
+				mIsFactorized (false) {}
 
+		private:
 			typedef Dynamic::Matrix<value_type> MatrixXXd;
 			typedef Dynamic::Matrix<value_type> VectorXd;
 			
@@ -276,6 +276,22 @@ class Matrix {
 			zero();
 		}
 
+		void setIdentity() {
+			identity();
+		}
+
+		// there are no expression templates, i.e. nothing to alias
+		matrix_type& noalias() {
+			return *this;
+		}
+
+		void swap (matrix_type &other) {
+			std::swap (nrows, other.nrows);
+			std::swap (ncols, other.ncols);
+			std::swap (mapped_data, other.mapped_data);
+			std::swap (mData, other.mData);
+		}
+
 		val_type norm() const {
 			return sqrt(this->squaredNorm());
 		}
@@ -381,12 +397,30 @@ class Matrix {
 				return Block<matrix_type, val_type>(*this, row_start, col_start, row_count, col_count);
 			}
 
+		const Block<matrix_type, val_type>
+			block (unsigned int row_start, unsigned int col_start, unsigned int row_count, unsigned int col_count) const {
+				return Block<matrix_type, val_type>(*this, row_start, col_start, row_count, col_count);
+			}
+
 		template <unsigned int row_count, unsigned int col_count>
 		Block<matrix_type, val_type>
 			block (unsigned int row_start, unsigned int col_start) {
 				return Block<matrix_type, val_type>(*this, row_start, col_start, row_count, col_count);
 			}
 
+		Block<matrix_type, val_type> row (unsigned int index) {
+			return Block<matrix_type, val_type>(*this, index, 0, 1, ncols);
+		}
+		const Block<matrix_type, val_type> row (unsigned int index) const {
+			return Block<matrix_type, val_type>(*this, index, 0, 1, ncols);
+		}
+		Block<matrix_type, val_type> col (unsigned int index) {
+			return Block<matrix_type, val_type>(*this, 0, index, nrows, 1);
+		}
+		const Block<matrix_type, val_type> col (unsigned int index) const {
+			return Block<matrix_type, val_type>(*this, 0, index, nrows, 1);
+		}
+
 		// Operators with scalars
 		void operator*=(const val_type &scalar) {
 			for (unsigned int i = 0; i < nrows * ncols; i++)
@@ -459,6 +493,9 @@ class Matrix {
 		val_type *data(){
 			return mData;
 		}
+		const val_type *data() const {
+			return mData;
+		}
 
 		// regular transpose of a 6 dimensional matrix
 		Matrix<val_type> transpose() const {
@@ -607,6 +607,19 @@ class Matrix {
 				return Block<matrix_type, val_type>(*this, row_start, col_start, block_row_count, block_col_count);
 			}
 
+		Block<matrix_type, val_type> row (unsigned int index) {
+			return Block<matrix_type, val_type>(*this, index, 0, 1, ncols);
+		}
+		const Block<matrix_type, val_type> row (unsigned int index) const {
+			return Block<matrix_type, val_type>(*this, index, 0, 1, ncols);
+		}
+		Block<matrix_type, val_type> col (unsigned int index) {
+			return Block<matrix_type, val_type>(*this, 0, index, nrows, 1);
+		}
+		const Block<matrix_type, val_type> col (unsigned int index) const {
+			return Block<matrix_type, val_type>(*this, 0, index, nrows, 1);
+		}
+
 		// Operators with scalars
 		void operator*=(const val_type &scalar) {
 			for (unsigned int i = 0; i < nrows * ncols; i++)
@@ -37,7 +37,10 @@ namespace SimpleMath {
 				mR = matrix;
 				mQ = Dynamic::Matrix<value_type>::Identity (mR.rows(), mR.rows());
 
-				for (unsigned int i = 0; i < mR.cols(); i++) {
+				// wide matrices only have as many reflections as rows
+				unsigned int reflection_count = std::min (mR.rows(), mR.cols());
+
+				for (unsigned int i = 0; i < reflection_count; i++) {
 					unsigned int block_rows = mR.rows() - i;
 					unsigned int block_cols = mR.cols() - i;
 
@@ -144,7 +147,9 @@ namespace SimpleMath {
 				mIsFactorized = other.mIsFactorized;
 				mQ = other.mQ;
 				mR = other.mR;
-				mPermutations = new unsigned int[mQ.cols()];
+				mPermutations = new unsigned int[mR.cols()];
+				for (unsigned int i = 0; i < mR.cols(); i++)
+					mPermutations[i] = other.mPermutations[i];
 				mThreshold = other.mThreshold;
 				mRank = other.mRank;
 			}
@@ -155,7 +160,9 @@ namespace SimpleMath {
 					mQ = other.mQ;
 					mR = other.mR;
 					delete[] mPermutations;
-					mPermutations = new unsigned int[mQ.cols()];
+					mPermutations = new unsigned int[mR.cols()];
+					for (unsigned int i = 0; i < mR.cols(); i++)
+						mPermutations[i] = other.mPermutations[i];
 					mThreshold = other.mThreshold;
 					mRank = other.mRank;
 				}
@@ -186,7 +193,10 @@ namespace SimpleMath {
 				mR = matrix;
 				mQ = Dynamic::Matrix<value_type>::Identity (mR.rows(), mR.rows());
 
-				for (unsigned int i = 0; i < mR.cols(); i++) {
+				// wide matrices only have as many reflections as rows
+				unsigned int reflection_count = std::min (mR.rows(), mR.cols());
+
+				for (unsigned int i = 0; i < reflection_count; i++) {
 					unsigned int block_rows = mR.rows() - i;
 					unsigned int block_cols = mR.cols() - i;
 
@@ -48,7 +48,7 @@ struct RBDL_DLLAPI SpatialRigidBodyInertia {
 		Izx (Izx), Izy(Izy), Izz(Izz)
 	{ }
 
-	SpatialVector operator* (const SpatialVector &mv) {
+	SpatialVector operator* (const SpatialVector &mv) const {
 		Vector3d mv_lower (mv[3], mv[4], mv[5]);
 
 		Vector3d res_upper = Vector3d (
@@ -64,7 +64,7 @@ struct RBDL_DLLAPI SpatialRigidBodyInertia {
 				);
 	}
 
-	SpatialRigidBodyInertia operator+ (const SpatialRigidBodyInertia &rbi) {
+	SpatialRigidBodyInertia operator+ (const SpatialRigidBodyInertia &rbi) const {
 		return SpatialRigidBodyInertia (
 				m + rbi.m,
 				h + rbi.h,
@@ -135,6 +135,30 @@ struct RBDL_DLLAPI SpatialRigidBodyInertia {
 	double Ixx, Iyx, Iyy, Izx, Izy, Izz;
 };
 
+/** \brief Structure of the rotation of a SpatialTransform.
+ *
+ * Most joint transformations only rotate about a principal axis (e.g.
+ * joints of type JointTypeRevoluteX) or do not rotate at all (e.g.
+ * translational joint frames). The kind of a transformation allows
+ * SpatialTransform::apply(), SpatialTransform::applyTranspose(), and
+ * SpatialTransform::multiply() to skip the entries of E that are known
+ * to be 0 or 1. The translation r is arbitrary for all kinds.
+ *
+ * \sa CalcSpatialTransformKind(), CombineSpatialTransformKinds()
+ */
+enum SpatialTransformKind {
+	/// \brief Arbitrary rotation E
+	SpatialTransformGeneral = 0,
+	/// \brief E is the identity (pure translation or identity transformation)
+	SpatialTransformTranslation,
+	/// \brief E is a rotation about the x-axis (as in Xrotx())
+	SpatialTransformRotationX,
+	/// \brief E is a rotation about the y-axis (as in Xroty())
+	SpatialTransformRotationY,
+	/// \brief E is a rotation about the z-axis (as in Xrotz())
+	SpatialTransformRotationZ
+};
+
 /** \brief Compact representation of spatial transformations.
  *
  * Instead of using a verbose 6x6 matrix, this structure only stores a 3x3
@@ -156,7 +180,7 @@ struct RBDL_DLLAPI SpatialTransform {
 	 *
 	 * \returns (E * w, - E * rxw + E * v)
 	 */
-	SpatialVector apply (const SpatialVector &v_sp) {
+	SpatialVector apply (const SpatialVector &v_sp) const {
 		Vector3d v_rxw (
 				v_sp[3] - r[1]*v_sp[2] + r[2]*v_sp[1],
 				v_sp[4] - r[2]*v_sp[0] + r[0]*v_sp[2],
@@ -176,7 +200,7 @@ struct RBDL_DLLAPI SpatialTransform {
 	 *
 	 * \returns (E^T * n + rx * E^T * f, E^T * f)
 	 */
-	SpatialVector applyTranspose (const SpatialVector &f_sp) {
+	SpatialVector applyTranspose (const SpatialVector &f_sp) const {
 		Vector3d E_T_f (
 				E(0,0) * f_sp[3] + E(1,0) * f_sp[4] + E(2,0) * f_sp[5],
 				E(0,1) * f_sp[3] + E(1,1) * f_sp[4] + E(2,1) * f_sp[5],
@@ -193,9 +217,154 @@ struct RBDL_DLLAPI SpatialTransform {
 				);
 	}
 
+	/** Same as X * v for a transformation of the given kind.
+	 *
+	 * \returns (E * w, - E * rxw + E * v)
+	 */
+	SpatialVector apply (const SpatialVector &v_sp, SpatialTransformKind kind) const {
+		Vector3d E_w (rotate (Vector3d (v_sp[0], v_sp[1], v_sp[2]), kind));
+		Vector3d E_v_rxw (rotate (Vector3d (
+				v_sp[3] - r[1]*v_sp[2] + r[2]*v_sp[1],
+				v_sp[4] - r[2]*v_sp[0] + r[0]*v_sp[2],
+				v_sp[5] - r[0]*v_sp[1] + r[1]*v_sp[0]
+				), kind));
+
+		return SpatialVector (
+				E_w[0], E_w[1], E_w[2],
+				E_v_rxw[0], E_v_rxw[1], E_v_rxw[2]
+				);
+	}
+
+	/** Same as X^T * f for a transformation of the given kind.
+	 *
+	 * \returns (E^T * n + rx * E^T * f, E^T * f)
+	 */
+	SpatialVector applyTranspose (const SpatialVector &f_sp, SpatialTransformKind kind) const {
+		Vector3d E_T_n (rotateTranspose (Vector3d (f_sp[0], f_sp[1], f_sp[2]), kind));
+		Vector3d E_T_f (rotateTranspose (Vector3d (f_sp[3], f_sp[4], f_sp[5]), kind));
+
+		return SpatialVector (
+				E_T_n[0] - r[2] * E_T_f[1] + r[1] * E_T_f[2],
+				E_T_n[1] + r[2] * E_T_f[0] - r[0] * E_T_f[2],
+				E_T_n[2] - r[1] * E_T_f[0] + r[0] * E_T_f[1],
+				E_T_f [0],
+				E_T_f [1],
+				E_T_f [2]
+				);
+	}
+
+	/** Same as E * v where only the entries of E are used that are not
+	 * fixed by the kind of the transformation.
+	 */
+	Vector3d rotate (const Vector3d &v, SpatialTransformKind kind) const {
+		switch (kind) {
+			case SpatialTransformTranslation:
+				return v;
+			case SpatialTransformRotationX:
+				return Vector3d (
+						v[0],
+						E(1,1) * v[1] + E(1,2) * v[2],
+						E(2,1) * v[1] + E(2,2) * v[2]
+						);
+			case SpatialTransformRotationY:
+				return Vector3d (
+						E(0,0) * v[0] + E(0,2) * v[2],
+						v[1],
+						E(2,0) * v[0] + E(2,2) * v[2]
+						);
+			case SpatialTransformRotationZ:
+				return Vector3d (
+						E(0,0) * v[0] + E(0,1) * v[1],
+						E(1,0) * v[0] + E(1,1) * v[1],
+						v[2]
+						);
+			default:
+				return Vector3d (
+						E(0,0) * v[0] + E(0,1) * v[1] + E(0,2) * v[2],
+						E(1,0) * v[0] + E(1,1) * v[1] + E(1,2) * v[2],
+						E(2,0) * v[0] + E(2,1) * v[1] + E(2,2) * v[2]
+						);
+		}
+	}
+
+	/** Same as E^T * v where only the entries of E are used that are not
+	 * fixed by the kind of the transformation.
+	 */
+	Vector3d rotateTranspose (const Vector3d &v, SpatialTransformKind kind) const {
+		switch (kind) {
+			case SpatialTransformTranslation:
+				return v;
+			case SpatialTransformRotationX:
+				return Vector3d (
+						v[0],
+						E(1,1) * v[1] + E(2,1) * v[2],
+						E(1,2) * v[1] + E(2,2) * v[2]
+						);
+			case SpatialTransformRotationY:
+				return Vector3d (
+						E(0,0) * v[0] + E(2,0) * v[2],
+						v[1],
+						E(0,2) * v[0] + E(2,2) * v[2]
+						);
+			case SpatialTransformRotationZ:
+				return Vector3d (
+						E(0,0) * v[0] + E(1,0) * v[1],
+						E(0,1) * v[0] + E(1,1) * v[1],
+						v[2]
+						);
+			default:
+				return Vector3d (
+						E(0,0) * v[0] + E(1,0) * v[1] + E(2,0) * v[2],
+						E(0,1) * v[0] + E(1,1) * v[1] + E(2,1) * v[2],
+						E(0,2) * v[0] + E(1,2) * v[1] + E(2,2) * v[2]
+						);
+		}
+	}
+
+	/** Same as X * XT for transformations of the given kinds. The result
+	 * is of kind CombineSpatialTransformKinds (kind, XT_kind).
+	 *
+	 * \note result must not refer to this transformation or XT.
+	 */
+	void multiply (
+			SpatialTransformKind kind,
+			const SpatialTransform &XT,
+			SpatialTransformKind XT_kind,
+			SpatialTransform &result) const {
+		if (kind == SpatialTransformTranslation) {
+			result.E = XT.E;
+		} else if (XT_kind == SpatialTransformTranslation) {
+			result.E = E;
+		} else if (kind != SpatialTransformGeneral) {
+			// only the rows of XT.E that are affected by the rotation change
+			unsigned int a = kind == SpatialTransformRotationX ? 1 : 0;
+			unsigned int b = kind == SpatialTransformRotationZ ? 1 : 2;
+			unsigned int c = 3 - a - b;
+			for (unsigned int j = 0; j < 3; j++) {
+				result.E(a,j) = E(a,a) * XT.E(a,j) + E(a,b) * XT.E(b,j);
+				result.E(b,j) = E(b,a) * XT.E(a,j) + E(b,b) * XT.E(b,j);
+				result.E(c,j) = XT.E(c,j);
+			}
+		} else if (XT_kind != SpatialTransformGeneral) {
+			// only the columns of E that are affected by the rotation change
+			unsigned int a = XT_kind == SpatialTransformRotationX ? 1 : 0;
+			unsigned int b = XT_kind == SpatialTransformRotationZ ? 1 : 2;
+			unsigned int c = 3 - a - b;
+			for (unsigned int i = 0; i < 3; i++) {
+				result.E(i,a) = E(i,a) * XT.E(a,a) + E(i,b) * XT.E(b,a);
+				result.E(i,b) = E(i,a) * XT.E(a,b) + E(i,b) * XT.E(b,b);
+				result.E(i,c) = E(i,c);
+			}
+		} else {
+			result.E = E * XT.E;
+		}
+
+		result.r = XT.r + XT.rotateTranspose (r, XT_kind);
+	}
+
 	/** Same as X^* I X^{-1}
 	 */
-	SpatialRigidBodyInertia apply (const SpatialRigidBodyInertia &rbi) {
+	SpatialRigidBodyInertia apply (const SpatialRigidBodyInertia &rbi) const {
 		return SpatialRigidBodyInertia (
 				rbi.m,
 				E * (rbi.h - rbi.m * r),
@@ -215,7 +384,7 @@ struct RBDL_DLLAPI SpatialTransform {
 
 	/** Same as X^T I X
 	 */
-	SpatialRigidBodyInertia applyTranspose (const SpatialRigidBodyInertia &rbi) {
+	SpatialRigidBodyInertia applyTranspose (const SpatialRigidBodyInertia &rbi) const {
 		Vector3d E_T_mr = E.transpose() * rbi.h + rbi.m * r;
 		return SpatialRigidBodyInertia (
 				rbi.m,
@@ -230,7 +399,7 @@ struct RBDL_DLLAPI SpatialTransform {
 					- VectorCrossMatrix (E_T_mr) * VectorCrossMatrix (r));
 	}
 
-	SpatialVector applyAdjoint (const SpatialVector &f_sp) {
+	SpatialVector applyAdjoint (const SpatialVector &f_sp) const {
 		Vector3d En_rxf = E * (Vector3d (f_sp[0], f_sp[1], f_sp[2]) - r.cross(Vector3d (f_sp[3], f_sp[4], f_sp[5])));
 //		Vector3d En_rxf = E * (Vector3d (f_sp[0], f_sp[1], f_sp[2]) - r.cross(Eigen::Map<Vector3d> (&(f_sp[3]))));
 
@@ -400,6 +569,43 @@ inline SpatialTransform Xtrans (const Vector3d &r) {
 			);
 }
 
+/** \brief Determines the kind of the rotation of a transformation.
+ *
+ * Only entries that are exactly 0 or 1 are considered, such that
+ * operations with the returned kind give the same results as the
+ * generic ones.
+ */
+inline SpatialTransformKind CalcSpatialTransformKind (const SpatialTransform &X) {
+	const Matrix3d &E = X.E;
+
+	bool x_fixed = E(0,0) == 1. && E(0,1) == 0. && E(0,2) == 0. && E(1,0) == 0. && E(2,0) == 0.;
+	bool y_fixed = E(1,1) == 1. && E(1,0) == 0. && E(1,2) == 0. && E(0,1) == 0. && E(2,1) == 0.;
+	bool z_fixed = E(2,2) == 1. && E(2,0) == 0. && E(2,1) == 0. && E(0,2) == 0. && E(1,2) == 0.;
+
+	if (x_fixed && y_fixed && z_fixed)
+		return SpatialTransformTranslation;
+	else if (x_fixed)
+		return SpatialTransformRotationX;
+	else if (y_fixed)
+		return SpatialTransformRotationY;
+	else if (z_fixed)
+		return SpatialTransformRotationZ;
+
+	return SpatialTransformGeneral;
+}
+
+/** \brief Kind of the product X1 * X2 of transformations of the kinds
+ * kind1 and kind2.
+ */
+inline SpatialTransformKind CombineSpatialTransformKinds (SpatialTransformKind kind1, SpatialTransformKind kind2) {
+	if (kind1 == SpatialTransformTranslation)
+		return kind2;
+	else if (kind2 == SpatialTransformTranslation || kind1 == kind2)
+		return kind1;
+
+	return SpatialTransformGeneral;
+}
+
 inline SpatialMatrix crossm (const SpatialVector &v) {
 	return SpatialMatrix (
 			0,  -v[2],  v[1],         0,          0,         0,
@@ -0,0 +1,356 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_SPATIALALGEBRASIMD_H
+#define RBDL_SPATIALALGEBRASIMD_H
+
+#include "rbdl/rbdl_math.h"
+
+/** \brief Default number of states that are evaluated in parallel by the
+ * SIMD algorithms.
+ *
+ * The value is chosen from the instruction set the library is compiled
+ * for (8 for AVX-512, 4 for AVX/AVX2, 2 for SSE2 and NEON, 1 otherwise).
+ * It can be overridden by defining RBDL_SIMD_LANES before including this
+ * file, however the library only contains the algorithms for 1, 2, 4, and
+ * 8 lanes.
+ */
+#ifndef RBDL_SIMD_LANES
+	#if defined(__AVX512F__)
+		#define RBDL_SIMD_LANES 8
+	#elif defined(__AVX__)
+		#define RBDL_SIMD_LANES 4
+	#elif defined(__SSE2__) || defined(_M_X64) || defined(__ARM_NEON)
+		#define RBDL_SIMD_LANES 2
+	#else
+		#define RBDL_SIMD_LANES 1
+	#endif
+#endif
+
+namespace RigidBodyDynamics {
+
+namespace Math {
+
+/* Structure-of-arrays types
+ *
+ * The types below store the same quantity for L different states. Each
+ * coefficient is stored as a contiguous array of L values such that all
+ * operations can be performed on all lanes with a single (vector)
+ * instruction. All operations loop over the lanes in the innermost loop
+ * and are therefore vectorized by the compiler when the instruction set
+ * is enabled (e.g. -mavx2 or -march=native).
+ */
+
+/** \brief A scalar value for L states. */
+template <unsigned int L>
+struct SIMDScalar {
+	double data[L];
+
+	void setZero () {
+		for (unsigned int l = 0; l < L; l++)
+			data[l] = 0.;
+	}
+};
+
+/** \brief A 3-d vector for L states. */
+template <unsigned int L>
+struct SIMDVector3d {
+	double data[3][L];
+
+	void setZero () {
+		for (unsigned int k = 0; k < 3; k++)
+			for (unsigned int l = 0; l < L; l++)
+				data[k][l] = 0.;
+	}
+};
+
+/** \brief A 3x3 matrix (row-major) for L states. */
+template <unsigned int L>
+struct SIMDMatrix3d {
+	double data[9][L];
+
+	void setZero () {
+		for (unsigned int k = 0; k < 9; k++)
+			for (unsigned int l = 0; l < L; l++)
+				data[k][l] = 0.;
+	}
+};
+
+/** \brief A 6x3 matrix (row-major) for L states. */
+template <unsigned int L>
+struct SIMDMatrix63 {
+	double data[18][L];
+
+	void setZero () {
+		for (unsigned int k = 0; k < 18; k++)
+			for (unsigned int l = 0; l < L; l++)
+				data[k][l] = 0.;
+	}
+
+	void setLane (unsigned int lane, const Matrix63 &m) {
+		for (unsigned int row = 0; row < 6; row++)
+			for (unsigned int col = 0; col < 3; col++)
+				data[row * 3 + col][lane] = m(row, col);
+	}
+};
+
+/** \brief A spatial vector for L states. */
+template <unsigned int L>
+struct SIMDSpatialVector {
+	double data[6][L];
+
+	void setZero () {
+		for (unsigned int k = 0; k < 6; k++)
+			for (unsigned int l = 0; l < L; l++)
+				data[k][l] = 0.;
+	}
+
+	/// \brief Sets all lanes to the same value
+	void setBroadcast (const SpatialVector &v) {
+		for (unsigned int k = 0; k < 6; k++)
+			for (unsigned int l = 0; l < L; l++)
+				data[k][l] = v[k];
+	}
+
+	void setLane (unsigned int lane, const SpatialVector &v) {
+		for (unsigned int k = 0; k < 6; k++)
+			data[k][lane] = v[k];
+	}
+
+	SpatialVector getLane (unsigned int lane) const {
+		return SpatialVector (
+				data[0][lane], data[1][lane], data[2][lane],
+				data[3][lane], data[4][lane], data[5][lane]
+				);
+	}
+
+	void operator+= (const SIMDSpatialVector &v) {
+		for (unsigned int k = 0; k < 6; k++)
+			for (unsigned int l = 0; l < L; l++)
+				data[k][l] += v.data[k][l];
+	}
+};
+
+/** \brief A spatial matrix (row-major) for L states. */
+template <unsigned int L>
+struct SIMDSpatialMatrix {
+	double data[36][L];
+
+	void setZero () {
+		for (unsigned int k = 0; k < 36; k++)
+			for (unsigned int l = 0; l < L; l++)
+				data[k][l] = 0.;
+	}
+
+	/// \brief Sets all lanes to the same value
+	void setBroadcast (const SpatialMatrix &m) {
+		for (unsigned int row = 0; row < 6; row++)
+			for (unsigned int col = 0; col < 6; col++)
+				for (unsigned int l = 0; l < L; l++)
+					data[row * 6 + col][l] = m(row, col);
+	}
+
+	/// \brief Same as M * v for all lanes
+	void apply (const SIMDSpatialVector<L> &v, SIMDSpatialVector<L> &result) const {
+		for (unsigned int row = 0; row < 6; row++) {
+			for (unsigned int l = 0; l < L; l++) {
+				result.data[row][l] =
+					data[row * 6 + 0][l] * v.data[0][l]
+					+ data[row * 6 + 1][l] * v.data[1][l]
+					+ data[row * 6 + 2][l] * v.data[2][l]
+					+ data[row * 6 + 3][l] * v.data[3][l]
+					+ data[row * 6 + 4][l] * v.data[4][l]
+					+ data[row * 6 + 5][l] * v.data[5][l];
+			}
+		}
+	}
+};
+
+/** \brief A spatial transformation for L states.
+ *
+ * Same as SpatialTransform with E stored row-major.
+ */
+template <unsigned int L>
+struct SIMDSpatialTransform {
+	double E[9][L];
+	double r[3][L];
+
+	void setLane (unsigned int lane, const SpatialTransform &X) {
+		for (unsigned int row = 0; row < 3; row++) {
+			for (unsigned int col = 0; col < 3; col++)
+				E[row * 3 + col][lane] = X.E(row, col);
+			r[row][lane] = X.r[row];
+		}
+	}
+
+	/** Same as X * v for all lanes.
+	 *
+	 * \returns (E * w, - E * rxw + E * v)
+	 */
+	void apply (const SIMDSpatialVector<L> &v_sp, SIMDSpatialVector<L> &result) const {
+		for (unsigned int l = 0; l < L; l++) {
+			double v0 = v_sp.data[0][l], v1 = v_sp.data[1][l], v2 = v_sp.data[2][l];
+			double v3 = v_sp.data[3][l], v4 = v_sp.data[4][l], v5 = v_sp.data[5][l];
+
+			double rxw0 = v3 - r[1][l] * v2 + r[2][l] * v1;
+			double rxw1 = v4 - r[2][l] * v0 + r[0][l] * v2;
+			double rxw2 = v5 - r[0][l] * v1 + r[1][l] * v0;
+
+			result.data[0][l] = E[0][l] * v0 + E[1][l] * v1 + E[2][l] * v2;
+			result.data[1][l] = E[3][l] * v0 + E[4][l] * v1 + E[5][l] * v2;
+			result.data[2][l] = E[6][l] * v0 + E[7][l] * v1 + E[8][l] * v2;
+			result.data[3][l] = E[0][l] * rxw0 + E[1][l] * rxw1 + E[2][l] * rxw2;
+			result.data[4][l] = E[3][l] * rxw0 + E[4][l] * rxw1 + E[5][l] * rxw2;
+			result.data[5][l] = E[6][l] * rxw0 + E[7][l] * rxw1 + E[8][l] * rxw2;
+		}
+	}
+
+	/** Same as X^T * f for all lanes.
+	 *
+	 * \returns (E^T * n + rx * E^T * f, E^T * f)
+	 */
+	void applyTranspose (const SIMDSpatialVector<L> &f_sp, SIMDSpatialVector<L> &result) const {
+		for (unsigned int l = 0; l < L; l++) {
+			double f0 = f_sp.data[0][l], f1 = f_sp.data[1][l], f2 = f_sp.data[2][l];
+			double f3 = f_sp.data[3][l], f4 = f_sp.data[4][l], f5 = f_sp.data[5][l];
+
+			double E_T_f0 = E[0][l] * f3 + E[3][l] * f4 + E[6][l] * f5;
+			double E_T_f1 = E[1][l] * f3 + E[4][l] * f4 + E[7][l] * f5;
+			double E_T_f2 = E[2][l] * f3 + E[5][l] * f4 + E[8][l] * f5;
+
+			result.data[0][l] = E[0][l] * f0 + E[3][l] * f1 + E[6][l] * f2 - r[2][l] * E_T_f1 + r[1][l] * E_T_f2;
+			result.data[1][l] = E[1][l] * f0 + E[4][l] * f1 + E[7][l] * f2 + r[2][l] * E_T_f0 - r[0][l] * E_T_f2;
+			result.data[2][l] = E[2][l] * f0 + E[5][l] * f1 + E[8][l] * f2 - r[1][l] * E_T_f0 + r[0][l] * E_T_f1;
+			result.data[3][l] = E_T_f0;
+			result.data[4][l] = E_T_f1;
+			result.data[5][l] = E_T_f2;
+		}
+	}
+
+	/** Same as I_parent += X^T * I * X for all lanes.
+	 *
+	 * Used to propagate articulated body inertias to the parent body.
+	 */
+	void addTransposeProduct (const SIMDSpatialMatrix<L> &I, SIMDSpatialMatrix<L> &I_parent) const {
+		// X = [E, 0; -E rx, E]. The lane loops are the innermost loops such
+		// that the compiler can vectorize them.
+		double X[36][L];
+		double IX[36][L];
+
+		for (unsigned int row = 0; row < 3; row++) {
+			for (unsigned int l = 0; l < L; l++) {
+				double e0 = E[row * 3 + 0][l];
+				double e1 = E[row * 3 + 1][l];
+				double e2 = E[row * 3 + 2][l];
+
+				X[row * 6 + 0][l] = e0;
+				X[row * 6 + 1][l] = e1;
+				X[row * 6 + 2][l] = e2;
+				X[row * 6 + 3][l] = 0.;
+				X[row * 6 + 4][l] = 0.;
+				X[row * 6 + 5][l] = 0.;
+				X[(row + 3) * 6 + 0][l] = - e1 * r[2][l] + e2 * r[1][l];
+				X[(row + 3) * 6 + 1][l] = e0 * r[2][l] - e2 * r[0][l];
+				X[(row + 3) * 6 + 2][l] = - e0 * r[1][l] + e1 * r[0][l];
+				X[(row + 3) * 6 + 3][l] = e0;
+				X[(row + 3) * 6 + 4][l] = e1;
+				X[(row + 3) * 6 + 5][l] = e2;
+			}
+		}
+
+		// IX = I * X
+		for (unsigned int row = 0; row < 6; row++) {
+			for (unsigned int col = 0; col < 6; col++) {
+				for (unsigned int l = 0; l < L; l++) {
+					IX[row * 6 + col][l] =
+						I.data[row * 6 + 0][l] * X[0 * 6 + col][l]
+						+ I.data[row * 6 + 1][l] * X[1 * 6 + col][l]
+						+ I.data[row * 6 + 2][l] * X[2 * 6 + col][l]
+						+ I.data[row * 6 + 3][l] * X[3 * 6 + col][l]
+						+ I.data[row * 6 + 4][l] * X[4 * 6 + col][l]
+						+ I.data[row * 6 + 5][l] * X[5 * 6 + col][l];
+				}
+			}
+		}
+
+		// I_parent += X^T * IX
+		for (unsigned int row = 0; row < 6; row++) {
+			for (unsigned int col = 0; col < 6; col++) {
+				for (unsigned int l = 0; l < L; l++) {
+					I_parent.data[row * 6 + col][l] +=
+						X[0 * 6 + row][l] * IX[0 * 6 + col][l]
+						+ X[1 * 6 + row][l] * IX[1 * 6 + col][l]
+						+ X[2 * 6 + row][l] * IX[2 * 6 + col][l]
+						+ X[3 * 6 + row][l] * IX[3 * 6 + col][l]
+						+ X[4 * 6 + row][l] * IX[4 * 6 + col][l]
+						+ X[5 * 6 + row][l] * IX[5 * 6 + col][l];
+				}
+			}
+		}
+	}
+};
+
+/** \brief Same as rbi * v for all lanes of v. */
+template <unsigned int L>
+inline void apply (const SpatialRigidBodyInertia &rbi, const SIMDSpatialVector<L> &mv, SIMDSpatialVector<L> &result) {
+	double h0 = rbi.h[0], h1 = rbi.h[1], h2 = rbi.h[2];
+
+	for (unsigned int l = 0; l < L; l++) {
+		double v0 = mv.data[0][l], v1 = mv.data[1][l], v2 = mv.data[2][l];
+		double v3 = mv.data[3][l], v4 = mv.data[4][l], v5 = mv.data[5][l];
+
+		result.data[0][l] = rbi.Ixx * v0 + rbi.Iyx * v1 + rbi.Izx * v2 + h1 * v5 - h2 * v4;
+		result.data[1][l] = rbi.Iyx * v0 + rbi.Iyy * v1 + rbi.Izy * v2 + h2 * v3 - h0 * v5;
+		result.data[2][l] = rbi.Izx * v0 + rbi.Izy * v1 + rbi.Izz * v2 + h0 * v4 - h1 * v3;
+		result.data[3][l] = rbi.m * v3 - (h1 * v2 - h2 * v1);
+		result.data[4][l] = rbi.m * v4 - (h2 * v0 - h0 * v2);
+		result.data[5][l] = rbi.m * v5 - (h0 * v1 - h1 * v0);
+	}
+}
+
+/** \brief Same as crossm (v1, v2) for all lanes. */
+template <unsigned int L>
+inline void crossm (const SIMDSpatialVector<L> &v1, const SIMDSpatialVector<L> &v2, SIMDSpatialVector<L> &result) {
+	for (unsigned int l = 0; l < L; l++) {
+		double a0 = v1.data[0][l], a1 = v1.data[1][l], a2 = v1.data[2][l];
+		double a3 = v1.data[3][l], a4 = v1.data[4][l], a5 = v1.data[5][l];
+		double b0 = v2.data[0][l], b1 = v2.data[1][l], b2 = v2.data[2][l];
+		double b3 = v2.data[3][l], b4 = v2.data[4][l], b5 = v2.data[5][l];
+
+		result.data[0][l] = -a2 * b1 + a1 * b2;
+		result.data[1][l] = a2 * b0 - a0 * b2;
+		result.data[2][l] = -a1 * b0 + a0 * b1;
+		result.data[3][l] = -a5 * b1 + a4 * b2 - a2 * b4 + a1 * b5;
+		result.data[4][l] = a5 * b0 - a3 * b2 + a2 * b3 - a0 * b5;
+		result.data[5][l] = -a4 * b0 + a3 * b1 - a1 * b3 + a0 * b4;
+	}
+}
+
+/** \brief Same as crossf (v1, v2) for all lanes. */
+template <unsigned int L>
+inline void crossf (const SIMDSpatialVector<L> &v1, const SIMDSpatialVector<L> &v2, SIMDSpatialVector<L> &result) {
+	for (unsigned int l = 0; l < L; l++) {
+		double a0 = v1.data[0][l], a1 = v1.data[1][l], a2 = v1.data[2][l];
+		double a3 = v1.data[3][l], a4 = v1.data[4][l], a5 = v1.data[5][l];
+		double b0 = v2.data[0][l], b1 = v2.data[1][l], b2 = v2.data[2][l];
+		double b3 = v2.data[3][l], b4 = v2.data[4][l], b5 = v2.data[5][l];
+
+		result.data[0][l] = -a2 * b1 + a1 * b2 - a5 * b4 + a4 * b5;
+		result.data[1][l] = a2 * b0 - a0 * b2 + a5 * b3 - a3 * b5;
+		result.data[2][l] = -a1 * b0 + a0 * b1 - a4 * b3 + a3 * b4;
+		result.data[3][l] = - a2 * b4 + a1 * b5;
+		result.data[4][l] = + a2 * b3 - a0 * b5;
+		result.data[5][l] = - a1 * b3 + a0 * b4;
+	}
+}
+
+} /* Math */
+
+} /* RigidBodyDynamics */
+
+/* RBDL_SPATIALALGEBRASIMD_H */
+#endif
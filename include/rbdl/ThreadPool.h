@@ -0,0 +1,78 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_THREAD_POOL_H
+#define RBDL_THREAD_POOL_H
+
+#include "rbdl/rbdl_config.h"
+
+namespace RigidBodyDynamics {
+
+/** \brief Interface for work that is distributed by a ThreadPool
+ *
+ * Run() gets called for consecutive ranges of indices. Calls with the same
+ * worker_id are never executed concurrently which allows to use per-worker
+ * temporary values.
+ */
+struct RBDL_DLLAPI ParallelTask {
+	virtual ~ParallelTask() {}
+
+	/// \brief Processes the indices begin, ..., end - 1 on worker worker_id
+	virtual void Run (unsigned int worker_id, unsigned int begin, unsigned int end) = 0;
+};
+
+struct ThreadPoolImpl;
+
+/** \brief A pool of worker threads with work stealing
+ *
+ * The index range of a ParallelFor() is split into chunks that are
+ * distributed evenly onto per-worker queues. Each worker processes the
+ * chunks of its own queue and steals chunks from the other queues once its
+ * own queue is empty. This keeps all workers busy even if the computation
+ * time varies between the indices.
+ *
+ * The thread that calls ParallelFor() acts as worker 0, i.e. a pool with
+ * a thread count of 1 does not start any additional threads.
+ */
+class RBDL_DLLAPI ThreadPool {
+	public:
+		/** \brief Starts the worker threads
+		 *
+		 * \param thread_count total number of workers (optional, defaults
+		 * to 0 which uses the number of hardware threads)
+		 */
+		explicit ThreadPool (unsigned int thread_count = 0);
+		~ThreadPool ();
+
+		/// \brief Returns the number of workers (including the calling thread)
+		unsigned int GetThreadCount () const;
+
+		/** \brief Calls task.Run() for all indices 0, ..., count - 1 and
+		 * returns when all of them are processed
+		 *
+		 * \param count      number of indices
+		 * \param task       the work that should be performed
+		 * \param chunk_size number of indices per chunk (optional, defaults
+		 * to 0 which chooses the size such that each worker receives about 8
+		 * chunks)
+		 *
+		 * \note ParallelFor() must not be called concurrently for the same
+		 * pool.
+		 */
+		void ParallelFor (unsigned int count, ParallelTask &task, unsigned int chunk_size = 0);
+
+	private:
+		ThreadPool (const ThreadPool&);
+		ThreadPool& operator= (const ThreadPool&);
+
+		ThreadPoolImpl *impl;
+};
+
+}
+
+/* RBDL_THREAD_POOL_H */
+#endif
@@ -16,9 +16,13 @@
 #include "rbdl/Body.h"
 #include "rbdl/Model.h"
 #include "rbdl/Dynamics.h"
+#include "rbdl/DynamicsSIMD.h"
 #include "rbdl/Joint.h"
 #include "rbdl/Kinematics.h"
 #include "rbdl/Contacts.h"
+#include "rbdl/DynamicsParallel.h"
+#include "rbdl/DynamicsPacked.h"
+#include "rbdl/FixedTopology.h"
 
 #include "rbdl/rbdl_utils.h"
 
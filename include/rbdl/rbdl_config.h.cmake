@@ -17,6 +17,7 @@
 #cmakedefine RBDL_BUILD_BRANCH "@RBDL_BUILD_BRANCH@"
 #cmakedefine RBDL_BUILD_ADDON_LUAMODEL
 #cmakedefine RBDL_BUILD_ADDON_URDFREADER
+#cmakedefine RBDL_BUILD_ADDON_CODEGEN
 #cmakedefine RBDL_BUILD_STATIC
 
 /* compatibility defines */
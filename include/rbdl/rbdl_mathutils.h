@@ -23,6 +23,11 @@ namespace Math {
  * Please note that these methods are only available when Eigen3 is used.
  * When the math library SimpleMath is used it will always use a slow
  * column pivoting gauss elimination.
+ *
+ * LinearSolverSparseLTL factorizes the joint space inertia matrix with
+ * SparseFactorizeLTL() which exploits the branch induced sparsity of the
+ * model and is also available with SimpleMath. It can only be used by the
+ * functions that have access to the model.
  */
 enum RBDL_DLLAPI LinearSolver {
 	LinearSolverUnknown = 0,
@@ -30,6 +35,7 @@ enum RBDL_DLLAPI LinearSolver {
 	LinearSolverColPivHouseholderQR,
 	LinearSolverHouseholderQR,
 	LinearSolverLLT,
+	LinearSolverSparseLTL,
 	LinearSolverLast,
 };
 
@@ -44,6 +50,17 @@ extern RBDL_DLLAPI SpatialMatrix SpatialMatrixZero;
 /// \brief Solves a linear system using gaussian elimination with pivoting
 RBDL_DLLAPI bool LinSolveGaussElimPivot (MatrixNd A, VectorNd b, VectorNd &x);
 
+#ifndef RBDL_USE_SIMPLE_MATH
+/** \brief Computes b = Q^T b in place where Q is given by the first count
+ * Householder reflections of a QR decomposition
+ *
+ * QR and h_coeffs are the matrixQR() and hCoeffs() of Eigen's
+ * HouseholderQR or ColPivHouseholderQR. Unlike Eigen's HouseholderSequence
+ * this does not create temporaries.
+ */
+RBDL_DLLAPI void HouseholderApplyQTranspose (const MatrixNd &QR, const VectorNd &h_coeffs, unsigned int count, VectorNd &b);
+#endif
+
 // \todo write test 
 RBDL_DLLAPI void SpatialMatrixSetSubmatrix(SpatialMatrix &dest, unsigned int row, unsigned int col, const Matrix3d &matrix);
 
@@ -214,21 +231,36 @@ RBDL_DLLAPI inline Vector3d angular_acceleration_from_angle_rates (const Vector3
 			);
 }
 
+/** \brief Computes the factorization H = L^T L in place
+ *
+ * Only the entries of H that belong to the branch induced sparsity pattern
+ * of the model (see Model::lambda_q) are used, the factorization therefore
+ * needs O(n d^2) operations where d is the depth of the kinematic tree
+ * (RBDA, Table 6.3). Afterwards H contains the lower triangular matrix L.
+ */
 RBDL_DLLAPI
-void SparseFactorizeLTL (Model &model, Math::MatrixNd &H);
+void SparseFactorizeLTL (const Model &model, Math::MatrixNd &H);
 
+/** \brief Computes result = H x for a joint space inertia matrix H
+ *
+ * Uses only the lower triangular part of H (RBDA, Table 6.5).
+ */
 RBDL_DLLAPI
-void SparseMultiplyHx (Model &model, Math::MatrixNd &L);
+void SparseMultiplyHx (const Model &model, const Math::MatrixNd &H, const Math::VectorNd &x, Math::VectorNd &result);
 
+/// \brief Computes result = L x for a factor L of SparseFactorizeLTL()
 RBDL_DLLAPI
-void SparseMultiplyLx (Model &model, Math::MatrixNd &L);
+void SparseMultiplyLx (const Model &model, const Math::MatrixNd &L, const Math::VectorNd &x, Math::VectorNd &result);
+/// \brief Computes result = L^T x for a factor L of SparseFactorizeLTL()
 RBDL_DLLAPI
-void SparseMultiplyLTx (Model &model, Math::MatrixNd &L);
+void SparseMultiplyLTx (const Model &model, const Math::MatrixNd &L, const Math::VectorNd &x, Math::VectorNd &result);
 
+/// \brief Solves L x = b in place (x contains b when called)
 RBDL_DLLAPI
-void SparseSolveLx (Model &model, Math::MatrixNd &L, Math::VectorNd &x);
+void SparseSolveLx (const Model &model, Math::MatrixNd &L, Math::VectorNd &x);
+/// \brief Solves L^T x = b in place (x contains b when called)
 RBDL_DLLAPI
-void SparseSolveLTx (Model &model, Math::MatrixNd &L, Math::VectorNd &x); 
+void SparseSolveLTx (const Model &model, Math::MatrixNd &L, Math::VectorNd &x); 
 
 } /* Math */
 
@@ -7,6 +7,8 @@
 
 #include <iostream>
 #include <limits>
+#include <algorithm>
+#include <cmath>
 #include <assert.h>
 
 #include "rbdl/rbdl_mathutils.h"
@@ -54,11 +56,49 @@ unsigned int ConstraintSet::AddConstraint (
 	v_plus.conservativeResize (n_constr);
 	v_plus[n_constr - 1] = 0.;
 
+	unilateral.push_back (false);
+	friction_normal.push_back (n_constr - 1);
+	friction_coefficient.push_back (0.);
+
 	d_multdof3_u = std::vector<Math::Vector3d> (n_constr, Math::Vector3d::Zero());
 
 	return n_constr - 1;
 }
 
+unsigned int ConstraintSet::AddFrictionContact (
+		unsigned int body_id,
+		const Vector3d &body_point,
+		const Vector3d &world_normal,
+		double friction_coefficient,
+		const char *constraint_name) {
+	assert (bound == false);
+	assert (friction_coefficient >= 0.);
+
+	// tangential directions: orthogonal to the normal and the coordinate
+	// axis that is least aligned with it
+	Vector3d axis (1., 0., 0.);
+	if (fabs (world_normal[1]) < fabs (world_normal[0]) && fabs (world_normal[1]) <= fabs (world_normal[2]))
+		axis = Vector3d (0., 1., 0.);
+	else if (fabs (world_normal[2]) < fabs (world_normal[0]))
+		axis = Vector3d (0., 0., 1.);
+
+	Vector3d tangent_1 = world_normal.cross (axis);
+	tangent_1 = tangent_1 / tangent_1.norm();
+	Vector3d tangent_2 = world_normal.cross (tangent_1);
+
+	unsigned int normal_index = AddConstraint (body_id, body_point, world_normal, constraint_name);
+	AddConstraint (body_id, body_point, tangent_1, constraint_name);
+	AddConstraint (body_id, body_point, tangent_2, constraint_name);
+
+	unilateral[normal_index] = true;
+	for (unsigned int i = normal_index + 1; i <= normal_index + 2; i++) {
+		friction_normal[i] = normal_index;
+		this->friction_coefficient[i] = friction_coefficient;
+	}
+
+	return normal_index;
+}
+
 bool ConstraintSet::Bind (const Model &model) {
 	assert (bound == false);
 
@@ -67,6 +107,9 @@ bool ConstraintSet::Bind (const Model &model) {
 		abort();
 	}
 	unsigned int n_constr = size();
+	// dimension of the null space of G (constraint sets with more
+	// constraints than degrees of freedom are only handled by some methods)
+	unsigned int null_space_size = model.dof_count > n_constr ? model.dof_count - n_constr : 0;
 
 	H.conservativeResize (model.dof_count, model.dof_count);
 	H.setZero();
@@ -82,6 +125,8 @@ bool ConstraintSet::Bind (const Model &model) {
 	b.setZero();
 	x.conservativeResize (model.dof_count + n_constr);
 	x.setZero();
+	c = VectorNd::Zero (model.dof_count);
+	z = VectorNd::Zero (model.dof_count);
 
 #ifdef RBDL_USE_SIMPLE_MATH
 	GT_qr = SimpleMath::HouseholderQR<Math::MatrixNd> (G.transpose());
@@ -89,15 +134,50 @@ bool ConstraintSet::Bind (const Model &model) {
 	GT_qr = Eigen::HouseholderQR<Math::MatrixNd> (G.transpose());
 #endif
 	GT_qr_Q = MatrixNd::Zero (model.dof_count, model.dof_count);
+	GT_qr_work = VectorNd::Zero (model.dof_count);
 	Y = MatrixNd::Zero (model.dof_count, G.rows());
-	Z = MatrixNd::Zero (model.dof_count, model.dof_count - G.rows());
-	qddot_y = VectorNd::Zero (model.dof_count);
-	qddot_z = VectorNd::Zero (model.dof_count);
+	Z = MatrixNd::Zero (model.dof_count, null_space_size);
+	GY = MatrixNd::Zero (G.rows(), G.rows());
+	GYt = MatrixNd::Zero (G.rows(), G.rows());
+	HZ = MatrixNd::Zero (model.dof_count, null_space_size);
+	ZHZ = MatrixNd::Zero (null_space_size, null_space_size);
+	qddot_y = VectorNd::Zero (G.rows());
+	qddot_z = VectorNd::Zero (null_space_size);
+
+	factorization_H = MatrixNd::Zero (model.dof_count, model.dof_count);
+	factorization_solver = linear_solver;
+	A_factorized = false;
+	range_space_factorized = false;
+	range_space_K_factorized = false;
+	null_space_factorized = false;
+	factorization_reuse_count = 0;
+
+	L = MatrixNd::Zero (model.dof_count, model.dof_count);
+
+#ifndef RBDL_USE_SIMPLE_MATH
+	A_lu = Eigen::PartialPivLU<MatrixNd> (model.dof_count + n_constr);
+	A_colpiv_qr = Eigen::ColPivHouseholderQR<MatrixNd> (model.dof_count + n_constr, model.dof_count + n_constr);
+	A_qr = Eigen::HouseholderQR<MatrixNd> (model.dof_count + n_constr, model.dof_count + n_constr);
+	K_llt = Eigen::LLT<MatrixNd> (n_constr);
+	GY_lu = Eigen::PartialPivLU<MatrixNd> (n_constr);
+	GY_colpiv_qr = Eigen::ColPivHouseholderQR<MatrixNd> (n_constr, n_constr);
+	GY_qr = Eigen::HouseholderQR<MatrixNd> (n_constr, n_constr);
+	GYt_lu = Eigen::PartialPivLU<MatrixNd> (n_constr);
+	GYt_colpiv_qr = Eigen::ColPivHouseholderQR<MatrixNd> (n_constr, n_constr);
+	GYt_qr = Eigen::HouseholderQR<MatrixNd> (n_constr, n_constr);
+	ZHZ_llt = Eigen::LLT<MatrixNd> (null_space_size);
+#endif
 
 	K.conservativeResize (n_constr, n_constr);
 	K.setZero();
 	a.conservativeResize (n_constr);
 	a.setZero();
+#ifndef RBDL_USE_SIMPLE_MATH
+	K_lu = Eigen::PartialPivLU<MatrixNd> (n_constr);
+	K_colpiv_qr = Eigen::ColPivHouseholderQR<MatrixNd> (n_constr, n_constr);
+	K_qr = Eigen::HouseholderQR<MatrixNd> (n_constr, n_constr);
+	K_ldlt = Eigen::LDLT<MatrixNd> (n_constr);
+#endif
 	QDDot_t.conservativeResize (model.dof_count);
 	QDDot_t.setZero();
 	QDDot_0.conservativeResize (model.dof_count);
@@ -105,6 +185,48 @@ bool ConstraintSet::Bind (const Model &model) {
 	f_t.resize (n_constr, SpatialVectorZero);
 	f_ext_constraints.resize (model.mBodies.size(), SpatialVectorZero);
 	point_accel_0.resize (n_constr, Vector3d::Zero());
+	f_normal.resize (n_constr, SpatialVectorZero);
+
+	// the union of the support paths of all constrained bodies
+	movable_body.resize (n_constr);
+	std::vector<bool> is_support_body (model.mBodies.size(), false);
+	for (unsigned int ci = 0; ci < n_constr; ci++) {
+		movable_body[ci] = body[ci];
+		if (model.IsFixedBodyId (body[ci])) {
+			unsigned int fbody_id = body[ci] - model.fixed_body_discriminator;
+			movable_body[ci] = model.mFixedBodies[fbody_id].mMovableParent;
+		}
+
+		for (unsigned int i = movable_body[ci]; i != 0; i = model.lambda[i])
+			is_support_body[i] = true;
+	}
+
+	support_bodies.clear();
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		if (is_support_body[i])
+			support_bodies.push_back (i);
+	}
+
+	// the non-zero structure of G: the degrees of freedom of the joints on
+	// the path from the constrained body to the root
+	G_row_start.resize (n_constr + 1);
+	G_column.clear();
+	for (unsigned int ci = 0; ci < n_constr; ci++) {
+		G_row_start[ci] = G_column.size();
+
+		for (unsigned int i = movable_body[ci]; i != 0; i = model.lambda[i]) {
+			unsigned int q_index = model.mJoints[i].q_index;
+			for (unsigned int k = q_index; k < q_index + model.mJoints[i].mDoFCount; k++)
+				G_column.push_back (k);
+		}
+
+		std::sort (G_column.begin() + G_row_start[ci], G_column.end());
+	}
+	G_row_start[n_constr] = G_column.size();
+
+	G_value = VectorNd::Zero (G_column.size());
+	factorization_G_value = VectorNd::Zero (G_column.size());
+	range_space_Y_value = VectorNd::Zero (G_column.size());
 
 	d_pA = std::vector<SpatialVector> (model.mBodies.size(), SpatialVectorZero);
 	d_a = std::vector<SpatialVector> (model.mBodies.size(), SpatialVectorZero);
@@ -130,10 +252,18 @@ void ConstraintSet::clear() {
 	C.setZero();
 	gamma.setZero();
 	G.setZero();
+	G_value.setZero();
 	A.setZero();
 	b.setZero();
 	x.setZero();
 
+	A_factorized = false;
+	range_space_factorized = false;
+	range_space_K_factorized = false;
+	null_space_factorized = false;
+
+	friction_iterations = 0;
+
 	K.setZero();
 	a.setZero();
 	QDDot_t.setZero();
@@ -149,6 +279,9 @@ void ConstraintSet::clear() {
 	for (i = 0; i < point_accel_0.size(); i++)
 		point_accel_0[i].setZero();
 
+	for (i = 0; i < f_normal.size(); i++)
+		f_normal[i].setZero();
+
 	for (i = 0; i < d_pA.size(); i++)
 		d_pA[i].setZero();
 
@@ -211,7 +344,7 @@ void SolveContactSystemDirect (
 
 RBDL_DLLAPI
 void SolveContactSystemRangeSpaceSparse (
-		Model &model, 
+		const Model &model, 
 		Math::MatrixNd &H, 
 		const Math::MatrixNd &G, 
 		const Math::VectorNd &c, 
@@ -246,60 +379,89 @@ void SolveContactSystemRangeSpaceSparse (
 	SparseSolveLx (model, H, qddot);
 }
 
-RBDL_DLLAPI
-void SolveContactSystemNullSpace (
-		Math::MatrixNd &H, 
-		const Math::MatrixNd &G, 
-		const Math::VectorNd &c, 
-		const Math::VectorNd &gamma, 
-		Math::VectorNd &qddot, 
-		Math::VectorNd &lambda,
-		Math::MatrixNd &Y,
-		Math::MatrixNd &Z,
-		Math::VectorNd &qddot_y,
-		Math::VectorNd &qddot_z,
-		Math::LinearSolver &linear_solver
+/* Computes the decomposition that is used for the given linear solver. */
+template <typename LUType, typename ColPivQRType, typename QRType>
+static void FactorizeLinearSystem (
+		const MatrixNd &M,
+		Math::LinearSolver linear_solver,
+		LUType &lu,
+		ColPivQRType &colpiv_qr,
+		QRType &qr
 		) {
 	switch (linear_solver) {
 		case (LinearSolverPartialPivLU) :
+		case (LinearSolverSparseLTL) :
 #ifdef RBDL_USE_SIMPLE_MATH
 			// SimpleMath does not have a LU solver so just use its QR solver
-			qddot_y = (G * Y).householderQr().solve (gamma);
+			lu = LUType (M);
 #else
-			qddot_y = (G * Y).partialPivLu().solve (gamma);
+			lu.compute (M);
 #endif
 			break;
 		case (LinearSolverColPivHouseholderQR) :
-			qddot_y = (G * Y).colPivHouseholderQr().solve (gamma);
+#ifdef RBDL_USE_SIMPLE_MATH
+			colpiv_qr = ColPivQRType (M);
+#else
+			colpiv_qr.compute (M);
+#endif
 			break;
 		case (LinearSolverHouseholderQR) :
-			qddot_y = (G * Y).householderQr().solve (gamma);
+#ifdef RBDL_USE_SIMPLE_MATH
+			qr = QRType (M);
+#else
+			qr.compute (M);
+#endif
 			break;
 		default:
 			LOG << "Error: Invalid linear solver: " << linear_solver << std::endl;
 			assert (0);
 			break;
 	}
+}
 
-	qddot_z = (Z.transpose() * H * Z).llt().solve(Z.transpose() * (c - H * Y * qddot_y));
-
-	qddot = Y * qddot_y + Z * qddot_z;
-
+/* Solves a linear system with a decomposition computed by
+ * FactorizeLinearSystem(). The right-hand-side rhs is overwritten.
+ *
+ * The solve() of Eigen's QR decompositions creates a copy of the right
+ * hand side, therefore Q^T is applied and the triangular system is solved
+ * in place within rhs.
+ */
+template <typename LUType, typename ColPivQRType, typename QRType>
+static void SolveFactorizedLinearSystem (
+		Math::LinearSolver linear_solver,
+		const LUType &lu,
+		const ColPivQRType &colpiv_qr,
+		const QRType &qr,
+		VectorNd &rhs,
+		VectorNd &result
+		) {
 	switch (linear_solver) {
 		case (LinearSolverPartialPivLU) :
-#ifdef RBDL_USE_SIMPLE_MATH
-			// SimpleMath does not have a LU solver so just use its QR solver
-			qddot_y = (G * Y).householderQr().solve (gamma);
-#else
-			lambda = (G * Y).partialPivLu().solve (Y.transpose() * (H * qddot - c));
-#endif
+		case (LinearSolverSparseLTL) :
+			result = lu.solve (rhs);
 			break;
+#ifdef RBDL_USE_SIMPLE_MATH
 		case (LinearSolverColPivHouseholderQR) :
-			lambda = (G * Y).colPivHouseholderQr().solve (Y.transpose() * (H * qddot - c));
+			result = colpiv_qr.solve (rhs);
+			break;
+		case (LinearSolverHouseholderQR) :
+			result = qr.solve (rhs);
+			break;
+#else
+		case (LinearSolverColPivHouseholderQR) : {
+			unsigned int rank = colpiv_qr.nonzeroPivots();
+			HouseholderApplyQTranspose (colpiv_qr.matrixQR(), colpiv_qr.hCoeffs(), rank, rhs);
+			colpiv_qr.matrixQR().topLeftCorner (rank, rank).template triangularView<Eigen::Upper>().solveInPlace (rhs.head (rank));
+			rhs.tail (rhs.size() - rank).setZero();
+			result.noalias() = colpiv_qr.colsPermutation() * rhs;
 			break;
+		}
 		case (LinearSolverHouseholderQR) :
-			lambda = (G * Y).householderQr().solve (Y.transpose() * (H * qddot - c));
+			HouseholderApplyQTranspose (qr.matrixQR(), qr.hCoeffs(), rhs.size(), rhs);
+			qr.matrixQR().template triangularView<Eigen::Upper>().solveInPlace (rhs);
+			result = rhs;
 			break;
+#endif
 		default:
 			LOG << "Error: Invalid linear solver: " << linear_solver << std::endl;
 			assert (0);
@@ -307,62 +469,429 @@ void SolveContactSystemNullSpace (
 	}
 }
 
+template <typename LLTType>
+static void ComputeLLT (const MatrixNd &M, LLTType &llt) {
+#ifdef RBDL_USE_SIMPLE_MATH
+	llt = LLTType (M);
+#else
+	llt.compute (M);
+#endif
+}
+
+/* Solves M x = b in place with the Cholesky factorization of M (x
+ * contains b when called). */
+template <typename LLTType>
+static void SolveLLT (const LLTType &llt, VectorNd &x) {
+#ifdef RBDL_USE_SIMPLE_MATH
+	x = llt.solve (x);
+#else
+	llt.solveInPlace (x);
+#endif
+}
+
+RBDL_DLLAPI
+void SolveContactSystemNullSpace (
+		Math::MatrixNd &H, 
+		const Math::MatrixNd &G, 
+		const Math::VectorNd &c, 
+		const Math::VectorNd &gamma, 
+		Math::VectorNd &qddot, 
+		Math::VectorNd &lambda,
+		Math::MatrixNd &Y,
+		Math::MatrixNd &Z,
+		Math::VectorNd &qddot_y,
+		Math::VectorNd &qddot_z,
+		Math::LinearSolver &linear_solver
+		) {
+#ifdef RBDL_USE_SIMPLE_MATH
+	SimpleMath::HouseholderQR<MatrixNd> GY_lu;
+	SimpleMath::ColPivHouseholderQR<MatrixNd> GY_colpiv_qr;
+	SimpleMath::HouseholderQR<MatrixNd> GY_qr;
+#else
+	Eigen::PartialPivLU<MatrixNd> GY_lu;
+	Eigen::ColPivHouseholderQR<MatrixNd> GY_colpiv_qr;
+	Eigen::HouseholderQR<MatrixNd> GY_qr;
+#endif
+	MatrixNd GY (G * Y);
+	FactorizeLinearSystem (GY, linear_solver, GY_lu, GY_colpiv_qr, GY_qr);
+
+	VectorNd rhs (gamma);
+	SolveFactorizedLinearSystem (linear_solver, GY_lu, GY_colpiv_qr, GY_qr, rhs, qddot_y);
+
+	qddot_z = (Z.transpose() * H * Z).llt().solve(Z.transpose() * (c - H * Y * qddot_y));
+
+	qddot = Y * qddot_y + Z * qddot_z;
+
+	// lambda = (G Y)^-T Y^T (H qddot - c)
+	MatrixNd GYt (GY.transpose());
+	FactorizeLinearSystem (GYt, linear_solver, GY_lu, GY_colpiv_qr, GY_qr);
+
+	rhs = Y.transpose() * (H * qddot - c);
+	SolveFactorizedLinearSystem (linear_solver, GY_lu, GY_colpiv_qr, GY_qr, rhs, lambda);
+}
+
+/* Invalidates the factorizations that are cached in the constraint set if
+ * H, G or the linear solver changed since they were computed. */
+static void UpdateFactorizationCache (ConstraintSet &CS) {
+	if (CS.factorization_solver == CS.linear_solver
+			&& CS.factorization_H == CS.H
+			&& CS.factorization_G_value == CS.G_value) {
+		return;
+	}
+
+	CS.factorization_H = CS.H;
+	CS.factorization_G_value = CS.G_value;
+	CS.factorization_solver = CS.linear_solver;
+	CS.A_factorized = false;
+	CS.range_space_factorized = false;
+	CS.range_space_K_factorized = false;
+	CS.null_space_factorized = false;
+}
+
+/* Same as SolveContactSystemDirect() for CS.H, CS.G and CS.c but reuses
+ * the factorization of CS.A. The solution is stored in CS.x. */
+static void SolveContactSystemDirectCached (
+		ConstraintSet &CS,
+		const VectorNd &gamma
+		) {
+	UpdateFactorizationCache (CS);
+
+	unsigned int dof_count = CS.c.rows();
+
+	if (!CS.A_factorized) {
+		// Build the system: Copy H, G and G^T
+		CS.A.block(0, 0, dof_count, dof_count) = CS.H;
+		CS.A.block(0, dof_count, dof_count, gamma.rows()) = CS.G.transpose();
+		CS.A.block(dof_count, 0, gamma.rows(), dof_count) = CS.G;
+
+		FactorizeLinearSystem (CS.A, CS.linear_solver, CS.A_lu, CS.A_colpiv_qr, CS.A_qr);
+		CS.A_factorized = true;
+	} else {
+		CS.factorization_reuse_count++;
+	}
+
+	// Build the system: Copy -C + \tau
+	CS.b.block(0, 0, dof_count, 1) = CS.c;
+	CS.b.block(dof_count, 0, gamma.rows(), 1) = gamma;
+
+	SolveFactorizedLinearSystem (CS.linear_solver, CS.A_lu, CS.A_colpiv_qr, CS.A_qr, CS.b, CS.x);
+
+	LOG << "x = " << std::endl << CS.x << std::endl;
+}
+
+/* Computes the operator K = G H^-1 G^T and a = gamma - G H^-1 c of the
+ * range-space method for CS.H, CS.G and CS.c (stored in CS.K and CS.a).
+ * The factorization of H and K are reused as long as H and G do not
+ * change. */
+static void UpdateRangeSpaceOperator (
+		const Model &model,
+		ConstraintSet &CS,
+		const VectorNd &gamma
+		) {
+	UpdateFactorizationCache (CS);
+
+	unsigned int n_constr = CS.size();
+
+	if (!CS.range_space_factorized) {
+		CS.L = CS.H;
+		SparseFactorizeLTL (model, CS.L);
+
+		// Column i of Y = L^-T G^T has the same non-zero entries as row i of
+		// G. As these are the degrees of freedom of a single path to the
+		// root every entry is coupled with all entries of lower columns and
+		// L^T y = g is a dense triangular system on the path.
+		CS.range_space_Y_value = CS.G_value;
+		for (unsigned int i = 0; i < n_constr; i++) {
+			unsigned int start = CS.G_row_start[i];
+
+			for (unsigned int p = CS.G_row_start[i + 1]; p > start; p--) {
+				unsigned int k = CS.G_column[p - 1];
+				double y_k = CS.range_space_Y_value[p - 1] / CS.L(k,k);
+				CS.range_space_Y_value[p - 1] = y_k;
+
+				for (unsigned int r = start; r < p - 1; r++)
+					CS.range_space_Y_value[r] -= CS.L(k, CS.G_column[r]) * y_k;
+			}
+		}
+
+		// K = Y^T Y where the non-zero entries of two columns only overlap
+		// on the path from their common ancestor to the root, i.e. on their
+		// common leading columns.
+		for (unsigned int i = 0; i < n_constr; i++) {
+			for (unsigned int j = i; j < n_constr; j++) {
+				unsigned int p = CS.G_row_start[i];
+				unsigned int r = CS.G_row_start[j];
+				double value = 0.;
+
+				while (p < CS.G_row_start[i + 1] && r < CS.G_row_start[j + 1]
+						&& CS.G_column[p] == CS.G_column[r]) {
+					value += CS.range_space_Y_value[p] * CS.range_space_Y_value[r];
+					p++;
+					r++;
+				}
+
+				CS.K(i,j) = value;
+				CS.K(j,i) = value;
+			}
+		}
+
+		CS.range_space_factorized = true;
+	} else {
+		CS.factorization_reuse_count++;
+	}
+
+	CS.z = CS.c;
+	SparseSolveLTx (model, CS.L, CS.z);
+
+	// a = gamma - Y^T z
+	for (unsigned int i = 0; i < n_constr; i++) {
+		CS.a[i] = gamma[i];
+		for (unsigned int p = CS.G_row_start[i]; p < CS.G_row_start[i + 1]; p++)
+			CS.a[i] -= CS.range_space_Y_value[p] * CS.z[CS.G_column[p]];
+	}
+}
+
+/* Computes qddot = H^-1 (c + lambda_sign * G^T lambda) with the
+ * factorization of UpdateRangeSpaceOperator(). */
+static void RangeSpaceAccelerations (
+		const Model &model,
+		ConstraintSet &CS,
+		double lambda_sign,
+		const VectorNd &lambda,
+		VectorNd &qddot
+		) {
+	unsigned int n_constr = CS.size();
+
+	qddot = CS.c;
+	for (unsigned int i = 0; i < n_constr; i++) {
+		double lambda_i = lambda_sign * lambda[i];
+		for (unsigned int p = CS.G_row_start[i]; p < CS.G_row_start[i + 1]; p++)
+			qddot[CS.G_column[p]] += CS.G_value[p] * lambda_i;
+	}
+	SparseSolveLTx (model, CS.L, qddot);
+	SparseSolveLx (model, CS.L, qddot);
+}
+
+/* Same as SolveContactSystemRangeSpaceSparse() for CS.H, CS.G and CS.c
+ * but uses the non-zero structure of G and reuses the factorizations of H
+ * and K.
+ *
+ * lambda_sign selects the sign convention of the returned multipliers:
+ * 1. for H qddot = c + G^T lambda (forces of all methods and impulses of
+ * the RangeSpaceSparse method) and -1. for H qddot = c - G^T lambda
+ * (impulses of the Direct method). */
+static void SolveContactSystemRangeSpaceSparseCached (
+		const Model &model,
+		ConstraintSet &CS,
+		const VectorNd &gamma,
+		double lambda_sign,
+		VectorNd &qddot,
+		VectorNd &lambda
+		) {
+	UpdateRangeSpaceOperator (model, CS, gamma);
+
+	if (!CS.range_space_K_factorized) {
+		ComputeLLT (CS.K, CS.K_llt);
+		CS.range_space_K_factorized = true;
+	}
+
+	// K (lambda_sign * lambda) = lambda_sign * a
+	lambda = CS.a;
+	lambda *= lambda_sign;
+	SolveLLT (CS.K_llt, lambda);
+
+	RangeSpaceAccelerations (model, CS, lambda_sign, lambda, qddot);
+}
+
+/* Same as SolveContactSystemNullSpace() for CS.H, CS.G and CS.c but also
+ * computes and reuses the null-space basis and the factorizations of GY,
+ * GYt and ZHZ. */
+static void SolveContactSystemNullSpaceCached (
+		ConstraintSet &CS,
+		const VectorNd &gamma,
+		VectorNd &qddot,
+		VectorNd &lambda
+		) {
+	UpdateFactorizationCache (CS);
+
+	unsigned int dof_count = CS.H.rows();
+
+	if (!CS.null_space_factorized) {
+		CS.GT_qr.compute (CS.G.transpose());
+#ifdef RBDL_USE_SIMPLE_MATH
+		CS.GT_qr_Q = CS.GT_qr.householderQ();
+#else
+		CS.GT_qr.householderQ().evalTo (CS.GT_qr_Q, CS.GT_qr_work);
+#endif
+
+		CS.Y = CS.GT_qr_Q.block(0,0,dof_count, CS.G.rows());
+		CS.Z = CS.GT_qr_Q.block(0,CS.G.rows(),dof_count, dof_count - CS.G.rows());
+
+		// G * Y only using the non-zero entries of G
+		for (unsigned int i = 0; i < CS.G.rows(); i++) {
+			for (unsigned int j = 0; j < CS.GY.cols(); j++) {
+				CS.GY(i,j) = 0.;
+				for (unsigned int p = CS.G_row_start[i]; p < CS.G_row_start[i + 1]; p++)
+					CS.GY(i,j) += CS.G_value[p] * CS.Y(CS.G_column[p], j);
+			}
+		}
+		FactorizeLinearSystem (CS.GY, CS.linear_solver, CS.GY_lu, CS.GY_colpiv_qr, CS.GY_qr);
+		CS.GYt = CS.GY.transpose();
+		FactorizeLinearSystem (CS.GYt, CS.linear_solver, CS.GYt_lu, CS.GYt_colpiv_qr, CS.GYt_qr);
+
+		CS.HZ.noalias() = CS.H * CS.Z;
+		CS.ZHZ.noalias() = CS.Z.transpose() * CS.HZ;
+		ComputeLLT (CS.ZHZ, CS.ZHZ_llt);
+		CS.null_space_factorized = true;
+	} else {
+		CS.factorization_reuse_count++;
+	}
+
+	// qddot_y = (G Y)^-1 gamma
+	CS.a = gamma;
+	SolveFactorizedLinearSystem (CS.linear_solver, CS.GY_lu, CS.GY_colpiv_qr, CS.GY_qr, CS.a, CS.qddot_y);
+
+	// qddot_z = (Z^T H Z)^-1 Z^T (c - H Y qddot_y)
+	qddot.noalias() = CS.Y * CS.qddot_y;
+	CS.z = CS.c;
+	CS.z.noalias() -= CS.H * qddot;
+	CS.qddot_z.noalias() = CS.Z.transpose() * CS.z;
+	SolveLLT (CS.ZHZ_llt, CS.qddot_z);
+
+	qddot.noalias() += CS.Z * CS.qddot_z;
+
+	// lambda = (G Y)^-T Y^T (H qddot - c)
+	CS.z.noalias() = CS.H * qddot;
+	CS.z -= CS.c;
+	CS.a.noalias() = CS.Y.transpose() * CS.z;
+	SolveFactorizedLinearSystem (CS.linear_solver, CS.GYt_lu, CS.GYt_colpiv_qr, CS.GYt_qr, CS.a, lambda);
+}
+
 RBDL_DLLAPI
 void CalcContactJacobian(
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const Math::VectorNd &Q,
 		const ConstraintSet &CS,
 		Math::MatrixNd &G,
 		bool update_kinematics
 		) {
 	if (update_kinematics)
-		UpdateKinematicsCustom (model, &Q, NULL, NULL);
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
 
-	unsigned int i,j;
+	CalcBaseMotionSubspaces (model, ws);
 
-	// variables to check whether we need to recompute G
+	// variables to check whether we need to recompute the point position
 	unsigned int prev_body_id = 0;
 	Vector3d prev_body_point = Vector3d::Zero();
-	MatrixNd Gi (3, model.dof_count);
+	Vector3d point_base = Vector3d::Zero();
 
-	for (i = 0; i < CS.size(); i++) {
-		// only compute the matrix Gi if actually needed
+	for (unsigned int i = 0; i < CS.size(); i++) {
 		if (prev_body_id != CS.body[i] || prev_body_point != CS.point[i]) {
-			Gi.setZero();
-			CalcPointJacobian (model, Q, CS.body[i], CS.point[i], Gi, false);
+			point_base = CalcBodyToBaseCoordinates (model, ws, Q, CS.body[i], CS.point[i], false);
 			prev_body_id = CS.body[i];
 			prev_body_point = CS.point[i];
 		}
 
-		for (j = 0; j < model.dof_count; j++) {
-			Vector3d gaxis (Gi(0,j), Gi(1,j), Gi(2,j));
-			G(i,j) = gaxis.transpose() * CS.normal[i];
+		// G(i,k) = normal^T (v_k + omega_k x point_base) for the joints
+		// on the path to the root, zero otherwise
+		const Vector3d &normal = CS.normal[i];
+		Vector3d point_cross_normal = point_base.cross (normal);
+
+		for (unsigned int k = 0; k < model.dof_count; k++) {
+			G(i,k) = 0.;
+		}
+
+		unsigned int j = CS.body[i];
+		if (model.IsFixedBodyId(j)) {
+			j = model.mFixedBodies[j - model.fixed_body_discriminator].mMovableParent;
+		}
+
+		while (j != 0) {
+			unsigned int q_index = model.mJoints[j].q_index;
+
+			for (unsigned int k = q_index; k < q_index + model.mJoints[j].mDoFCount; k++) {
+				G(i,k) = point_cross_normal[0] * ws.S_base(0, k)
+					+ point_cross_normal[1] * ws.S_base(1, k)
+					+ point_cross_normal[2] * ws.S_base(2, k)
+					+ normal[0] * ws.S_base(3, k)
+					+ normal[1] * ws.S_base(4, k)
+					+ normal[2] * ws.S_base(5, k);
+			}
+
+			j = model.lambda[j];
+		}
+	}
+}
+
+RBDL_DLLAPI
+void CalcContactJacobianSparse (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const Math::VectorNd &Q,
+		ConstraintSet &CS,
+		bool update_kinematics
+		) {
+	assert (CS.bound);
+	assert (CS.G_row_start.size() == CS.size() + 1);
+
+	if (update_kinematics)
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
+
+	CalcBaseMotionSubspaces (model, ws);
+
+	// variables to check whether we need to recompute the point position
+	unsigned int prev_body_id = 0;
+	Vector3d prev_body_point = Vector3d::Zero();
+	Vector3d point_base = Vector3d::Zero();
+
+	for (unsigned int i = 0; i < CS.size(); i++) {
+		if (prev_body_id != CS.body[i] || prev_body_point != CS.point[i]) {
+			point_base = CalcBodyToBaseCoordinates (model, ws, Q, CS.body[i], CS.point[i], false);
+			prev_body_id = CS.body[i];
+			prev_body_point = CS.point[i];
+		}
+
+		const Vector3d &normal = CS.normal[i];
+		Vector3d point_cross_normal = point_base.cross (normal);
+
+		for (unsigned int p = CS.G_row_start[i]; p < CS.G_row_start[i + 1]; p++) {
+			unsigned int k = CS.G_column[p];
+
+			CS.G_value[p] = point_cross_normal[0] * ws.S_base(0, k)
+				+ point_cross_normal[1] * ws.S_base(1, k)
+				+ point_cross_normal[2] * ws.S_base(2, k)
+				+ normal[0] * ws.S_base(3, k)
+				+ normal[1] * ws.S_base(4, k)
+				+ normal[2] * ws.S_base(5, k);
+			CS.G(i,k) = CS.G_value[p];
 		}
 	}
 }
 
 RBDL_DLLAPI
 void CalcContactSystemVariables (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const Math::VectorNd &Q,
 		const Math::VectorNd &QDot,
 		const Math::VectorNd &Tau,
 		ConstraintSet &CS
 		) {
 	// Compute C
-	NonlinearEffects (model, Q, QDot, CS.C);
+	NonlinearEffects (model, ws, Q, QDot, CS.C);
 	assert (CS.H.cols() == model.dof_count && CS.H.rows() == model.dof_count);
 
 	// Compute H
-	CompositeRigidBodyAlgorithm (model, Q, CS.H, false);
+	CompositeRigidBodyAlgorithm (model, ws, Q, CS.H, false);
 
 	// Compute G
-	// We have to update model.X_base as they are not automatically computed
+	// We have to update ws.X_base as they are not automatically computed
 	// by NonlinearEffects()
 	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
-		model.X_base[i] = model.X_lambda[i] * model.X_base[model.lambda[i]];
+		ws.X_lambda[i].multiply (model.X_lambda_kind[i], ws.X_base[model.lambda[i]], SpatialTransformGeneral, ws.X_base[i]);
 	}
-	CalcContactJacobian (model, Q, CS, CS.G, false);
+	CalcContactJacobianSparse (model, ws, Q, CS, false);
 
 	// Compute gamma
 	unsigned int prev_body_id = 0;
@@ -370,12 +899,12 @@ void CalcContactSystemVariables (
 	Vector3d gamma_i = Vector3d::Zero();
 
 	CS.QDDot_0.setZero();
-	UpdateKinematicsCustom (model, NULL, NULL, &CS.QDDot_0);
+	UpdateKinematicsCustom (model, ws, NULL, NULL, &CS.QDDot_0);
 
 	for (unsigned int i = 0; i < CS.size(); i++) {
 		// only compute point accelerations when necessary
 		if (prev_body_id != CS.body[i] || prev_body_point != CS.point[i]) {
-			gamma_i = CalcPointAcceleration (model, Q, QDot, CS.QDDot_0, CS.body[i], CS.point[i], false);
+			gamma_i = CalcPointAcceleration (model, ws, Q, QDot, CS.QDDot_0, CS.body[i], CS.point[i], false);
 			prev_body_id = CS.body[i];
 			prev_body_point = CS.point[i];
 		}
@@ -388,7 +917,8 @@ void CalcContactSystemVariables (
 
 RBDL_DLLAPI
 void ForwardDynamicsContactsDirect (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		const VectorNd &Tau,
@@ -397,9 +927,17 @@ void ForwardDynamicsContactsDirect (
 		) {
 	LOG << "-------- " << __func__ << " --------" << std::endl;
 
-	CalcContactSystemVariables (model, Q, QDot, Tau, CS);
+	CalcContactSystemVariables (model, ws, Q, QDot, Tau, CS);
 
-	SolveContactSystemDirect (CS.H, CS.G, Tau - CS.C, CS.gamma, QDDot, CS.force, CS.A, CS.b, CS.x, CS.linear_solver);
+	CS.c = Tau;
+	CS.c -= CS.C;
+
+	if (CS.linear_solver == LinearSolverSparseLTL) {
+		SolveContactSystemRangeSpaceSparseCached (model, CS, CS.gamma, 1., QDDot, CS.force);
+		return;
+	}
+
+	SolveContactSystemDirectCached (CS, CS.gamma);
 
 	// Copy back QDDot
 	for (unsigned int i = 0; i < model.dof_count; i++)
@@ -413,21 +951,26 @@ void ForwardDynamicsContactsDirect (
 
 RBDL_DLLAPI
 void ForwardDynamicsContactsRangeSpaceSparse (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const Math::VectorNd &Q,
 		const Math::VectorNd &QDot,
 		const Math::VectorNd &Tau,
 		ConstraintSet &CS,
 		Math::VectorNd &QDDot
 		) {
-	CalcContactSystemVariables (model, Q, QDot, Tau, CS);
+	CalcContactSystemVariables (model, ws, Q, QDot, Tau, CS);
 
-	SolveContactSystemRangeSpaceSparse (model, CS.H, CS.G, Tau - CS.C, CS.gamma, QDDot, CS.force, CS.K, CS.a, CS.linear_solver);
+	CS.c = Tau;
+	CS.c -= CS.C;
+
+	SolveContactSystemRangeSpaceSparseCached (model, CS, CS.gamma, 1., QDDot, CS.force);
 }
 
 RBDL_DLLAPI
 void ForwardDynamicsContactsNullSpace (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		const VectorNd &Tau,
@@ -436,37 +979,101 @@ void ForwardDynamicsContactsNullSpace (
 		) {
 	LOG << "-------- " << __func__ << " --------" << std::endl;
 
-	CalcContactSystemVariables (model, Q, QDot, Tau, CS);
+	CalcContactSystemVariables (model, ws, Q, QDot, Tau, CS);
 
-	CS.GT_qr.compute (CS.G.transpose());
-#ifdef RBDL_USE_SIMPLE_MATH
-	CS.GT_qr_Q = CS.GT_qr.householderQ();
-#else
-	CS.GT_qr.householderQ().evalTo (CS.GT_qr_Q);
-#endif
+	CS.c = Tau;
+	CS.c -= CS.C;
+
+	SolveContactSystemNullSpaceCached (CS, CS.gamma, QDDot, CS.force);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsContactsFriction (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		ConstraintSet &CS,
+		VectorNd &QDDot
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (CS.unilateral.size() == CS.size());
+	assert (CS.friction_normal.size() == CS.size());
+	assert (CS.friction_coefficient.size() == CS.size());
 
-	CS.Y = CS.GT_qr_Q.block(0,0,QDot.rows(), CS.G.rows());
-	CS.Z = CS.GT_qr_Q.block(0,CS.G.rows(),QDot.rows(), QDot.rows() - CS.G.rows());
+	CalcContactSystemVariables (model, ws, Q, QDot, Tau, CS);
+
+	CS.c = Tau;
+	CS.c -= CS.C;
+
+	UpdateRangeSpaceOperator (model, CS, CS.gamma);
+
+	// Projected Gauss-Seidel on w = K lambda - a, starting from the forces
+	// of the previous call. The normal of a contact precedes its
+	// tangential constraints such that the friction bounds use the updated
+	// normal force.
+	unsigned int n_constr = CS.size();
+	VectorNd &lambda = CS.force;
+
+	CS.friction_iterations = 0;
+	while (CS.friction_iterations < CS.friction_max_iterations) {
+		CS.friction_iterations++;
+		double max_change = 0.;
+
+		for (unsigned int i = 0; i < n_constr; i++) {
+			if (CS.K(i,i) <= 0.)
+				continue;
+
+			double w = CS.K.col(i).dot (lambda) - CS.a[i];
+			double value = lambda[i] - w / CS.K(i,i);
+
+			if (CS.unilateral[i]) {
+				value = std::max (value, 0.);
+			} else if (CS.friction_normal[i] != i) {
+				double bound = CS.friction_coefficient[i] * lambda[CS.friction_normal[i]];
+				value = std::min (std::max (value, -bound), bound);
+			}
+
+			max_change = std::max (max_change, fabs (value - lambda[i]));
+			lambda[i] = value;
+		}
+
+		if (max_change <= CS.friction_tolerance)
+			break;
+	}
 
-	SolveContactSystemNullSpace (CS.H, CS.G, Tau - CS.C, CS.gamma, QDDot, CS.force, CS.Y, CS.Z, CS.qddot_y, CS.qddot_z, CS.linear_solver);
+	LOG << "iterations = " << CS.friction_iterations << std::endl;
+	LOG << "lambda = " << lambda.transpose() << std::endl;
+
+	RangeSpaceAccelerations (model, CS, 1., lambda, QDDot);
 }
 
 RBDL_DLLAPI
 void ComputeContactImpulsesDirect (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const Math::VectorNd &Q,
 		const Math::VectorNd &QDotMinus,
 		ConstraintSet &CS,
 		Math::VectorNd &QDotPlus
 		) {
 	// Compute H
-	UpdateKinematicsCustom (model, &Q, NULL, NULL);
-	CompositeRigidBodyAlgorithm (model, Q, CS.H, false);
+	UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
+	CompositeRigidBodyAlgorithm (model, ws, Q, CS.H, false);
 
 	// Compute G
-	CalcContactJacobian (model, Q, CS, CS.G, false);
+	CalcContactJacobianSparse (model, ws, Q, CS, false);
 
-	SolveContactSystemDirect (CS.H, CS.G, CS.H * QDotMinus, CS.v_plus, QDotPlus, CS.impulse, CS.A, CS.b, CS.x, CS.linear_solver);
+	CS.c.noalias() = CS.H * QDotMinus;
+
+	if (CS.linear_solver == LinearSolverSparseLTL) {
+		SolveContactSystemRangeSpaceSparseCached (model, CS, CS.v_plus, -1., QDotPlus, CS.impulse);
+		return;
+	}
+
+	SolveContactSystemDirectCached (CS, CS.v_plus);
 
 	// Copy back QDotPlus
 	for (unsigned int i = 0; i < model.dof_count; i++)
@@ -480,44 +1087,44 @@ void ComputeContactImpulsesDirect (
 
 RBDL_DLLAPI
 void ComputeContactImpulsesRangeSpaceSparse (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const Math::VectorNd &Q,
 		const Math::VectorNd &QDotMinus,
 		ConstraintSet &CS,
 		Math::VectorNd &QDotPlus
 		) {
 	// Compute H
-	UpdateKinematicsCustom (model, &Q, NULL, NULL);
-	CompositeRigidBodyAlgorithm (model, Q, CS.H, false);
+	UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
+	CompositeRigidBodyAlgorithm (model, ws, Q, CS.H, false);
 
 	// Compute G
-	CalcContactJacobian (model, Q, CS, CS.G, false);
+	CalcContactJacobianSparse (model, ws, Q, CS, false);
+
+	CS.c.noalias() = CS.H * QDotMinus;
 
-	SolveContactSystemRangeSpaceSparse (model, CS.H, CS.G, CS.H * QDotMinus, CS.v_plus, QDotPlus, CS.impulse, CS.K, CS.a, CS.linear_solver);
+	SolveContactSystemRangeSpaceSparseCached (model, CS, CS.v_plus, 1., QDotPlus, CS.impulse);
 }
 
 RBDL_DLLAPI
 void ComputeContactImpulsesNullSpace (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const Math::VectorNd &Q,
 		const Math::VectorNd &QDotMinus,
 		ConstraintSet &CS,
 		Math::VectorNd &QDotPlus
 		) {
 	// Compute H
-	UpdateKinematicsCustom (model, &Q, NULL, NULL);
-	CompositeRigidBodyAlgorithm (model, Q, CS.H, false);
+	UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
+	CompositeRigidBodyAlgorithm (model, ws, Q, CS.H, false);
 
 	// Compute G
-	CalcContactJacobian (model, Q, CS, CS.G, false);
-
-	CS.GT_qr.compute (CS.G.transpose());
-	CS.GT_qr_Q = CS.GT_qr.householderQ();
+	CalcContactJacobianSparse (model, ws, Q, CS, false);
 
-	CS.Y = CS.GT_qr_Q.block(0,0,QDotMinus.rows(), CS.G.rows());
-	CS.Z = CS.GT_qr_Q.block(0,CS.G.rows(),QDotMinus.rows(), QDotMinus.rows() - CS.G.rows());
+	CS.c.noalias() = CS.H * QDotMinus;
 
-	SolveContactSystemNullSpace (CS.H, CS.G, CS.H * QDotMinus, CS.v_plus, QDotPlus, CS.impulse, CS.Y, CS.Z, CS.qddot_y, CS.qddot_z, CS.linear_solver);
+	SolveContactSystemNullSpaceCached (CS, CS.v_plus, QDotPlus, CS.impulse);
 }
 
 /** \brief Compute only the effects of external forces on the generalized accelerations
@@ -529,7 +1136,8 @@ void ComputeContactImpulsesNullSpace (
  */
 RBDL_DLLAPI
 void ForwardDynamicsApplyConstraintForces (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Tau,
 		ConstraintSet &CS,
 		VectorNd &QDDot
@@ -540,12 +1148,12 @@ void ForwardDynamicsApplyConstraintForces (
 	unsigned int i = 0;
 
 	for (i = 1; i < model.mBodies.size(); i++) {
-		model.IA[i] = model.I[i].toMatrix();;
-		model.pA[i] = crossf(model.v[i],model.I[i] * model.v[i]);
+		ws.IA[i] = model.I[i].toMatrix();;
+		ws.pA[i] = crossf(ws.v[i],model.I[i] * ws.v[i]);
 
 		if (CS.f_ext_constraints[i] != SpatialVectorZero) {
-			LOG << "External force (" << i << ") = " << model.X_base[i].toMatrixAdjoint() * CS.f_ext_constraints[i] << std::endl;
-			model.pA[i] -= model.X_base[i].toMatrixAdjoint() * CS.f_ext_constraints[i];
+			LOG << "External force (" << i << ") = " << ws.X_base[i].toMatrixAdjoint() * CS.f_ext_constraints[i] << std::endl;
+			ws.pA[i] -= ws.X_base[i].toMatrixAdjoint() * CS.f_ext_constraints[i];
 		}
 	}
 
@@ -559,77 +1167,81 @@ void ForwardDynamicsApplyConstraintForces (
 		if (model.mJoints[i].mDoFCount == 3) {
 			unsigned int lambda = model.lambda[i];
 
-			model.multdof3_u[i] = Vector3d (Tau[q_index], Tau[q_index + 1], Tau[q_index + 2]) - model.multdof3_S[i].transpose() * model.pA[i];
+			ws.multdof3_u[i] = Vector3d (Tau[q_index], Tau[q_index + 1], Tau[q_index + 2]) - ws.multdof3_S[i].transpose() * ws.pA[i];
 
 			if (lambda != 0) {
-				SpatialMatrix Ia = model.IA[i] - model.multdof3_U[i] * model.multdof3_Dinv[i] * model.multdof3_U[i].transpose();
-				SpatialVector pa = model.pA[i] + Ia * model.c[i] + model.multdof3_U[i] * model.multdof3_Dinv[i] * model.multdof3_u[i];
+				SpatialMatrix Ia = ws.IA[i] - ws.multdof3_U[i] * ws.multdof3_Dinv[i] * ws.multdof3_U[i].transpose();
+				SpatialVector pa = ws.pA[i] + Ia * ws.c[i] + ws.multdof3_U[i] * ws.multdof3_Dinv[i] * ws.multdof3_u[i];
 #ifdef EIGEN_CORE_H
-				model.IA[lambda].noalias() += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda].noalias() += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda].noalias() += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda].noalias() += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #else
-				model.IA[lambda] += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda] += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda] += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #endif
-				LOG << "pA[" << lambda << "] = " << model.pA[lambda].transpose() << std::endl;
+				LOG << "pA[" << lambda << "] = " << ws.pA[lambda].transpose() << std::endl;
 			}
 		} else {
-			model.u[i] = Tau[q_index] - model.S[i].dot(model.pA[i]);
+			ws.u[i] = Tau[q_index] - model.S[i].dot(ws.pA[i]);
 
 			unsigned int lambda = model.lambda[i];
 			if (lambda != 0) {
-				SpatialMatrix Ia = model.IA[i] - model.U[i] * (model.U[i] / model.d[i]).transpose();
-				SpatialVector pa = model.pA[i] + Ia * model.c[i] + model.U[i] * model.u[i] / model.d[i];
+				SpatialMatrix Ia = ws.IA[i] - ws.U[i] * (ws.U[i] / ws.d[i]).transpose();
+				SpatialVector pa = ws.pA[i] + Ia * ws.c[i] + ws.U[i] * ws.u[i] / ws.d[i];
 #ifdef EIGEN_CORE_H
-				model.IA[lambda].noalias() += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda].noalias() += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda].noalias() += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda].noalias() += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #else
-				model.IA[lambda] += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda] += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda] += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #endif
-				LOG << "pA[" << lambda << "] = " << model.pA[lambda].transpose() << std::endl;
+				LOG << "pA[" << lambda << "] = " << ws.pA[lambda].transpose() << std::endl;
 			}
 		}
 	}
 	
-	model.a[0] = SpatialVector (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
+	ws.a[0] = SpatialVector (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
 
 	for (i = 1; i < model.mBodies.size(); i++) {
 		unsigned int q_index = model.mJoints[i].q_index;
 		unsigned int lambda = model.lambda[i];
-		SpatialTransform X_lambda = model.X_lambda[i];
+		SpatialTransform X_lambda = ws.X_lambda[i];
 
-		model.a[i] = X_lambda.apply(model.a[lambda]) + model.c[i];
-		LOG << "a'[" << i << "] = " << model.a[i].transpose() << std::endl;
+		ws.a[i] = X_lambda.apply (ws.a[lambda], model.X_lambda_kind[i]) + ws.c[i];
+		LOG << "a'[" << i << "] = " << ws.a[i].transpose() << std::endl;
 
 		if (model.mJoints[i].mDoFCount == 3) {
-			Vector3d qdd_temp = model.multdof3_Dinv[i] * (model.multdof3_u[i] - model.multdof3_U[i].transpose() * model.a[i]);
+			Vector3d qdd_temp = ws.multdof3_Dinv[i] * (ws.multdof3_u[i] - ws.multdof3_U[i].transpose() * ws.a[i]);
 			QDDot[q_index] = qdd_temp[0];
 			QDDot[q_index + 1] = qdd_temp[1];
 			QDDot[q_index + 2] = qdd_temp[2];
-			model.a[i] = model.a[i] + model.multdof3_S[i] * qdd_temp;
+			ws.a[i] = ws.a[i] + ws.multdof3_S[i] * qdd_temp;
 		} else {
-			QDDot[q_index] = (1./model.d[i]) * (model.u[i] - model.U[i].dot(model.a[i]));
-			model.a[i] = model.a[i] + model.S[i] * QDDot[q_index];
+			QDDot[q_index] = (1./ws.d[i]) * (ws.u[i] - ws.U[i].dot(ws.a[i]));
+			ws.a[i] = ws.a[i] + model.S[i] * QDDot[q_index];
 		}
 	}
 
 	LOG << "QDDot = " << QDDot.transpose() << std::endl;
 } 
 
-/** \brief Computes the effect of external forces on the generalized accelerations.
+/** \brief Computes the effect of a test force on the accelerations of the
+ * constrained bodies.
  *
  * This function is essentially similar to ForwardDynamics() except that it
- * tries to only perform computations of variables that change due to
- * external forces defined in f_t.
+ * only computes the changes of the variables that are due to the test
+ * force f_t (in body coordinates) that acts on body_id. The bias forces
+ * only change along the path from body_id to the root and only the
+ * accelerations of the ConstraintSet::support_bodies are computed (as
+ * CS.d_a). CS.d_u and CS.d_multdof3_u have to be zero for all bodies and
+ * are reset to zero before the function returns.
  */
-RBDL_DLLAPI
-void ForwardDynamicsAccelerationDeltas (
-		Model &model,
+static void ForwardDynamicsAccelerationDeltas (
+		const Model &model,
+		DynamicsWorkspace &ws,
 		ConstraintSet &CS,
-		VectorNd &QDDot_t,
 		const unsigned int body_id,
-		const std::vector<SpatialVector> &f_t
+		const SpatialVector &f_t
 		) {
 	LOG << "-------- " << __func__ << " ------" << std::endl;
 
@@ -637,81 +1249,57 @@ void ForwardDynamicsAccelerationDeltas (
 	assert (CS.d_a.size() == model.mBodies.size());
 	assert (CS.d_u.size() == model.mBodies.size());
 
-	// TODO reset all values (debug)
-	for (unsigned int i = 0; i < model.mBodies.size(); i++) {
-		CS.d_pA[i].setZero();
-		CS.d_a[i].setZero();
-		CS.d_u[i] = 0.;
-		CS.d_multdof3_u[i].setZero();
-	}
+	CS.d_pA[body_id] = f_t;
 
-	for (unsigned int i = body_id; i > 0; i--) {
-		if (i == body_id) {
-			CS.d_pA[i] = -model.X_base[i].applyAdjoint(f_t[i]);
-		}
+	for (unsigned int i = body_id; i != 0; i = model.lambda[i]) {
+		unsigned int lambda = model.lambda[i];
 
 		if (model.mJoints[i].mDoFCount == 3) {
-			CS.d_multdof3_u[i] = - model.multdof3_S[i].transpose() * (CS.d_pA[i]);
+			CS.d_multdof3_u[i] = - ws.multdof3_S[i].transpose() * (CS.d_pA[i]);
 
-			unsigned int lambda = model.lambda[i];
 			if (lambda != 0) {
-				CS.d_pA[lambda] = CS.d_pA[lambda] + model.X_lambda[i].applyTranspose (CS.d_pA[i] + model.multdof3_U[i] * model.multdof3_Dinv[i] * CS.d_multdof3_u[i]);
+				CS.d_pA[lambda] = ws.X_lambda[i].applyTranspose (CS.d_pA[i] + ws.multdof3_U[i] * ws.multdof3_Dinv[i] * CS.d_multdof3_u[i], model.X_lambda_kind[i]);
 			}
 		} else {
 			CS.d_u[i] = - model.S[i].dot(CS.d_pA[i]);
 
-			unsigned int lambda = model.lambda[i];
 			if (lambda != 0) {
-				CS.d_pA[lambda] = CS.d_pA[lambda] + model.X_lambda[i].applyTranspose (CS.d_pA[i] + model.U[i] * CS.d_u[i] / model.d[i]);
+				CS.d_pA[lambda] = ws.X_lambda[i].applyTranspose (CS.d_pA[i] + ws.U[i] * CS.d_u[i] / ws.d[i], model.X_lambda_kind[i]);
 			}
 		}
-	}
 
-	for (unsigned int i = 0; i < f_t.size(); i++) {
-		LOG << "f_t[" << i << "] = " << f_t[i].transpose() << std::endl;
-	}
-
-	for (unsigned int i = 0; i < model.mBodies.size(); i++) {
 		LOG << "i = " << i << ": d_pA[i] " << CS.d_pA[i].transpose() << std::endl;
 	}
-	for (unsigned int i = 0; i < model.mBodies.size(); i++) {
-		LOG << "i = " << i << ": d_u[i] = " << CS.d_u[i] << std::endl;
-	}
 
-	QDDot_t[0] = 0.;
-	CS.d_a[0] = model.a[0];
+	CS.d_a[0].setZero();
 
-	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
-		unsigned int q_index = model.mJoints[i].q_index;
+	for (unsigned int k = 0; k < CS.support_bodies.size(); k++) {
+		unsigned int i = CS.support_bodies[k];
 		unsigned int lambda = model.lambda[i];
 
-		SpatialVector Xa = model.X_lambda[i].apply(CS.d_a[lambda]);
+		SpatialVector Xa = ws.X_lambda[i].apply (CS.d_a[lambda], model.X_lambda_kind[i]);
 
 		if (model.mJoints[i].mDoFCount == 3) {
-			Vector3d qdd_temp = model.multdof3_Dinv[i] * (CS.d_multdof3_u[i] - model.multdof3_U[i].transpose() * Xa);
-			QDDot_t[q_index] = qdd_temp[0];
-			QDDot_t[q_index + 1] = qdd_temp[1];
-			QDDot_t[q_index + 2] = qdd_temp[2];
-			model.a[i] = model.a[i] + model.multdof3_S[i] * qdd_temp;
-			CS.d_a[i] = Xa + model.multdof3_S[i] * qdd_temp;
+			Vector3d qdd_temp = ws.multdof3_Dinv[i] * (CS.d_multdof3_u[i] - ws.multdof3_U[i].transpose() * Xa);
+			CS.d_a[i] = Xa + ws.multdof3_S[i] * qdd_temp;
 		} else {
-			QDDot_t[q_index] = (CS.d_u[i] - model.U[i].dot(Xa) ) / model.d[i];
-			CS.d_a[i] = Xa + model.S[i] * QDDot_t[q_index];
+			double qdd_temp = (CS.d_u[i] - ws.U[i].dot(Xa) ) / ws.d[i];
+			CS.d_a[i] = Xa + model.S[i] * qdd_temp;
 		}
-	
-		LOG << "QDDot_t[" << i - 1 << "] = " << QDDot_t[i - 1] << std::endl;
-		LOG << "d_a[i] = " << CS.d_a[i].transpose() << std::endl;
+
+		LOG << "d_a[" << i << "] = " << CS.d_a[i].transpose() << std::endl;
 	}
-}
 
-inline void set_zero (std::vector<SpatialVector> &spatial_values) {
-	for (unsigned int i = 0; i < spatial_values.size(); i++)
-		spatial_values[i].setZero();
+	for (unsigned int i = body_id; i != 0; i = model.lambda[i]) {
+		CS.d_u[i] = 0.;
+		CS.d_multdof3_u[i].setZero();
+	}
 }
 
 RBDL_DLLAPI
 void ForwardDynamicsContactsKokkevis (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		const VectorNd &Tau,
@@ -722,22 +1310,22 @@ void ForwardDynamicsContactsKokkevis (
 
 	assert (CS.f_ext_constraints.size() == model.mBodies.size());
 	assert (CS.QDDot_0.size() == model.dof_count);
-	assert (CS.QDDot_t.size() == model.dof_count);
 	assert (CS.f_t.size() == CS.size());
+	assert (CS.f_normal.size() == CS.size());
+	assert (CS.movable_body.size() == CS.size());
 	assert (CS.point_accel_0.size() == CS.size());
 	assert (CS.K.rows() == CS.size());
 	assert (CS.K.cols() == CS.size());
 	assert (CS.force.size() == CS.size());
 	assert (CS.a.size() == CS.size());
 
-	Vector3d point_accel_t;
-
 	unsigned int ci = 0;
 	
 	// The default acceleration only needs to be computed once
 	{
 		SUPPRESS_LOGGING;
-		ForwardDynamics (model, Q, QDot, Tau, CS.QDDot_0);
+		ForwardDynamics (model, ws, Q, QDot, Tau, CS.QDDot_0);
+		UpdateKinematicsCustom (model, ws, NULL, NULL, &CS.QDDot_0);
 	}
 
 	LOG << "=== Initial Loop Start ===" << std::endl;
@@ -745,6 +1333,7 @@ void ForwardDynamicsContactsKokkevis (
 	// compute the effects of each test force
 	for (ci = 0; ci < CS.size(); ci++) {
 		unsigned int body_id = CS.body[ci];
+		unsigned int movable_body_id = CS.movable_body[ci];
 		Vector3d point = CS.point[ci];
 		Vector3d normal = CS.normal[ci];
 		double acceleration = CS.acceleration[ci];
@@ -755,66 +1344,39 @@ void ForwardDynamicsContactsKokkevis (
 		LOG << "QDDot_0 = " << CS.QDDot_0.transpose() << std::endl;
 		{
 			SUPPRESS_LOGGING;
-			UpdateKinematicsCustom (model, NULL, NULL, &CS.QDDot_0);
-			CS.point_accel_0[ci] = CalcPointAcceleration (model, Q, QDot, CS.QDDot_0, body_id, point, false);
+			CS.point_accel_0[ci] = CalcPointAcceleration (model, ws, Q, QDot, CS.QDDot_0, body_id, point, false);
 
 			CS.a[ci] = - acceleration + normal.dot(CS.point_accel_0[ci]);
 		}
 		LOG << "point_accel_0 = " << CS.point_accel_0[ci].transpose();
-	}
-
-	// Now we can compute and apply the test forces and use their net effect
-	// to compute the inverse articlated inertia to fill K.
-	for (ci = 0; ci < CS.size(); ci++) {
-		LOG << "=== Testforce Loop Start ===" << std::endl;
-		unsigned int body_id = CS.body[ci];
-		Vector3d point = CS.point[ci];
-		Vector3d normal = CS.normal[ci];
-
-		unsigned int movable_body_id = body_id;
-		if (model.IsFixedBodyId(body_id)) {
-			unsigned int fbody_id = body_id - model.fixed_body_discriminator;
-			movable_body_id = model.mFixedBodies[fbody_id].mMovableParent;
-		}
 
 		// assemble the test force
-		LOG << "normal = " << normal.transpose() << std::endl;
-
-		Vector3d point_global = CalcBodyToBaseCoordinates (model, Q, body_id, point, false);
+		Vector3d point_global = CalcBodyToBaseCoordinates (model, ws, Q, body_id, point, false);
 		LOG << "point_global = " << point_global.transpose() << std::endl;
 
 		CS.f_t[ci] = SpatialTransform (Matrix3d::Identity(), -point_global).applyAdjoint (SpatialVector (0., 0., 0., -normal[0], -normal[1], -normal[2]));
-		CS.f_ext_constraints[movable_body_id] = CS.f_t[ci];
-		LOG << "f_t[" << movable_body_id << "] = " << CS.f_t[ci].transpose() << std::endl;
 
-		{
-//			SUPPRESS_LOGGING;
-			ForwardDynamicsAccelerationDeltas (model, CS, CS.QDDot_t, movable_body_id, CS.f_ext_constraints);
-			LOG << "QDDot_0 = " << CS.QDDot_0.transpose() << std::endl;
-			LOG << "QDDot_t = " << (CS.QDDot_t + CS.QDDot_0).transpose() << std::endl;
-			LOG << "QDDot_t - QDDot_0= " << (CS.QDDot_t).transpose() << std::endl;
-		}
+		// As the test force is a unit force along the negative normal, the
+		// change of the point acceleration along the normal is the product
+		// of the body acceleration change with the negated test force in
+		// body coordinates.
+		CS.f_normal[ci] = -ws.X_base[movable_body_id].applyAdjoint (CS.f_t[ci]);
+		LOG << "f_t[" << movable_body_id << "] = " << CS.f_t[ci].transpose() << std::endl;
+	}
 
-		CS.f_ext_constraints[movable_body_id].setZero();
+	CS.d_u.setZero();
+	for (unsigned int i = 0; i < CS.d_multdof3_u.size(); i++)
+		CS.d_multdof3_u[i].setZero();
 
-		CS.QDDot_t += CS.QDDot_0;
+	// Now we can compute and apply the test forces and use their net effect
+	// to compute the inverse articlated inertia to fill K.
+	for (ci = 0; ci < CS.size(); ci++) {
+		LOG << "=== Testforce Loop Start ===" << std::endl;
 
-		// compute the resulting acceleration
-		{
-			SUPPRESS_LOGGING;
-			UpdateKinematicsCustom (model, NULL, NULL, &CS.QDDot_t);
-		}
+		ForwardDynamicsAccelerationDeltas (model, ws, CS, CS.movable_body[ci], CS.f_normal[ci]);
 
 		for (unsigned int cj = 0; cj < CS.size(); cj++) {
-			{
-				SUPPRESS_LOGGING;
-
-				point_accel_t = CalcPointAcceleration (model, Q, QDot, CS.QDDot_t, CS.body[cj], CS.point[cj], false);
-			}
-	
-			LOG << "point_accel_0  = " << CS.point_accel_0[ci].transpose() << std::endl;
-			CS.K(ci,cj) = CS.normal[cj].dot(point_accel_t - CS.point_accel_0[cj]);
-			LOG << "point_accel_t = " << point_accel_t.transpose() << std::endl;
+			CS.K(ci,cj) = CS.f_normal[cj].dot (CS.d_a[CS.movable_body[cj]]);
 		}
 	}
 
@@ -822,20 +1384,13 @@ void ForwardDynamicsContactsKokkevis (
 	LOG << "a = " << std::endl << CS.a << std::endl;
 
 #ifndef RBDL_USE_SIMPLE_MATH
-	switch (CS.linear_solver) {
-		case (LinearSolverPartialPivLU) :
-			CS.force = CS.K.partialPivLu().solve(CS.a);
-			break;
-		case (LinearSolverColPivHouseholderQR) :
-			CS.force = CS.K.colPivHouseholderQr().solve(CS.a);
-			break;
-		case (LinearSolverHouseholderQR) :
-			CS.force = CS.K.householderQr().solve(CS.a);
-			break;
-		default:
-			LOG << "Error: Invalid linear solver: " << CS.linear_solver << std::endl;
-			assert (0);
-			break;
+	if (CS.linear_solver == LinearSolverSparseLTL) {
+		// K is symmetric but not necessarily positive definite
+		CS.K_ldlt.compute (CS.K);
+		CS.force = CS.K_ldlt.solve (CS.a);
+	} else {
+		FactorizeLinearSystem (CS.K, CS.linear_solver, CS.K_lu, CS.K_colpiv_qr, CS.K_qr);
+		SolveFactorizedLinearSystem (CS.linear_solver, CS.K_lu, CS.K_colpiv_qr, CS.K_qr, CS.a, CS.force);
 	}
 #else
 	bool solve_successful = LinSolveGaussElimPivot (CS.K, CS.a, CS.force);
@@ -844,14 +1399,11 @@ void ForwardDynamicsContactsKokkevis (
 
 	LOG << "f = " << CS.force.transpose() << std::endl;
 
-	for (ci = 0; ci < CS.size(); ci++) {
-		unsigned int body_id = CS.body[ci];
-		unsigned int movable_body_id = body_id;
+	for (ci = 0; ci < CS.size(); ci++)
+		CS.f_ext_constraints[CS.movable_body[ci]].setZero();
 
-		if (model.IsFixedBodyId(body_id)) {
-			unsigned int fbody_id = body_id - model.fixed_body_discriminator;
-			movable_body_id = model.mFixedBodies[fbody_id].mMovableParent;
-		}
+	for (ci = 0; ci < CS.size(); ci++) {
+		unsigned int movable_body_id = CS.movable_body[ci];
 
 		CS.f_ext_constraints[movable_body_id] -= CS.f_t[ci] * CS.force[ci]; 
 		LOG << "f_ext[" << movable_body_id << "] = " << CS.f_ext_constraints[movable_body_id].transpose() << std::endl;
@@ -859,10 +1411,135 @@ void ForwardDynamicsContactsKokkevis (
 
 	{
 		SUPPRESS_LOGGING;
-		ForwardDynamicsApplyConstraintForces (model, Tau, CS, QDDot);
+		ForwardDynamicsApplyConstraintForces (model, ws, Tau, CS, QDDot);
 	}
 
 	LOG << "QDDot after applying f_ext: " << QDDot.transpose() << std::endl;
 }
 
+RBDL_DLLAPI
+void CalcContactJacobian (
+		Model &model,
+		const Math::VectorNd &Q,
+		const ConstraintSet &CS,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcContactJacobian (model, model, Q, CS, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcContactJacobianSparse (
+		Model &model,
+		const Math::VectorNd &Q,
+		ConstraintSet &CS,
+		bool update_kinematics
+		) {
+	CalcContactJacobianSparse (model, model, Q, CS, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcContactSystemVariables (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS
+		) {
+	CalcContactSystemVariables (model, model, Q, QDot, Tau, CS);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsContactsDirect (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		) {
+	ForwardDynamicsContactsDirect (model, model, Q, QDot, Tau, CS, QDDot);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsContactsRangeSpaceSparse (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		) {
+	ForwardDynamicsContactsRangeSpaceSparse (model, model, Q, QDot, Tau, CS, QDDot);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsContactsNullSpace (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		) {
+	ForwardDynamicsContactsNullSpace (model, model, Q, QDot, Tau, CS, QDDot);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsContactsFriction (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		) {
+	ForwardDynamicsContactsFriction (model, model, Q, QDot, Tau, CS, QDDot);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsContactsKokkevis (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &Tau,
+		ConstraintSet &CS,
+		Math::VectorNd &QDDot
+		) {
+	ForwardDynamicsContactsKokkevis (model, model, Q, QDot, Tau, CS, QDDot);
+}
+
+RBDL_DLLAPI
+void ComputeContactImpulsesDirect (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDotMinus,
+		ConstraintSet &CS,
+		Math::VectorNd &QDotPlus
+		) {
+	ComputeContactImpulsesDirect (model, model, Q, QDotMinus, CS, QDotPlus);
+}
+
+RBDL_DLLAPI
+void ComputeContactImpulsesRangeSpaceSparse (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDotMinus,
+		ConstraintSet &CS,
+		Math::VectorNd &QDotPlus
+		) {
+	ComputeContactImpulsesRangeSpaceSparse (model, model, Q, QDotMinus, CS, QDotPlus);
+}
+
+RBDL_DLLAPI
+void ComputeContactImpulsesNullSpace (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDotMinus,
+		ConstraintSet &CS,
+		Math::VectorNd &QDotPlus
+		) {
+	ComputeContactImpulsesNullSpace (model, model, Q, QDotMinus, CS, QDotPlus);
+}
+
 } /* namespace RigidBodyDynamics */
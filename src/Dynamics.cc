@@ -25,7 +25,8 @@ using namespace Math;
 
 RBDL_DLLAPI
 void ForwardDynamics (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		const VectorNd &Tau,
@@ -44,37 +45,37 @@ void ForwardDynamics (
 	LOG << "---" << std::endl;
 
 	// Reset the velocity of the root body
-	model.v[0].setZero();
+	ws.v[0].setZero();
 
 	for (i = 1; i < model.mBodies.size(); i++) {
 		unsigned int lambda = model.lambda[i];
 
-		jcalc (model, i, Q, QDot);
+		jcalc (model, ws, i, Q, QDot);
 
 		if (lambda != 0)
-			model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
+			ws.X_lambda[i].multiply (model.X_lambda_kind[i], ws.X_base[lambda], SpatialTransformGeneral, ws.X_base[i]);
 		else
-			model.X_base[i] = model.X_lambda[i];
+			ws.X_base[i] = ws.X_lambda[i];
 
-		model.v[i] = model.X_lambda[i].apply( model.v[lambda]) + model.v_J[i];
+		ws.v[i] = ws.X_lambda[i].apply (ws.v[lambda], model.X_lambda_kind[i]) + ws.v_J[i];
 
 		/*
 		LOG << "X_J (" << i << "):" << std::endl << X_J << std::endl;
 		LOG << "v_J (" << i << "):" << std::endl << v_J << std::endl;
-		LOG << "v_lambda" << i << ":" << std::endl << model.v.at(lambda) << std::endl;
-		LOG << "X_base (" << i << "):" << std::endl << model.X_base[i] << std::endl;
-		LOG << "X_lambda (" << i << "):" << std::endl << model.X_lambda[i] << std::endl;
-		LOG << "SpatialVelocity (" << i << "): " << model.v[i] << std::endl;
+		LOG << "v_lambda" << i << ":" << std::endl << ws.v.at(lambda) << std::endl;
+		LOG << "X_base (" << i << "):" << std::endl << ws.X_base[i] << std::endl;
+		LOG << "X_lambda (" << i << "):" << std::endl << ws.X_lambda[i] << std::endl;
+		LOG << "SpatialVelocity (" << i << "): " << ws.v[i] << std::endl;
 		*/
 
-		model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
-		model.I[i].setSpatialMatrix (model.IA[i]);
+		ws.c[i] = ws.c_J[i] + crossm(ws.v[i],ws.v_J[i]);
+		model.I[i].setSpatialMatrix (ws.IA[i]);
 
-		model.pA[i] = crossf(model.v[i],model.I[i] * model.v[i]);
+		ws.pA[i] = crossf(ws.v[i],model.I[i] * ws.v[i]);
 
 		if (f_ext != NULL && (*f_ext)[i] != SpatialVectorZero) {
-			LOG << "External force (" << i << ") = " << model.X_base[i].toMatrixAdjoint() * (*f_ext)[i] << std::endl;
-			model.pA[i] -= model.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
+			LOG << "External force (" << i << ") = " << ws.X_base[i].toMatrixAdjoint() * (*f_ext)[i] << std::endl;
+			ws.pA[i] -= ws.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
 		}
 	}
 
@@ -86,129 +87,318 @@ void ForwardDynamics (
 		unsigned int q_index = model.mJoints[i].q_index;
 
 		if (model.mJoints[i].mDoFCount == 3) {
-			model.multdof3_U[i] = model.IA[i] * model.multdof3_S[i];
+			ws.multdof3_U[i] = ws.IA[i] * ws.multdof3_S[i];
 #ifdef EIGEN_CORE_H
-			model.multdof3_Dinv[i] = (model.multdof3_S[i].transpose() * model.multdof3_U[i]).inverse().eval();
+			ws.multdof3_Dinv[i] = (ws.multdof3_S[i].transpose() * ws.multdof3_U[i]).inverse().eval();
 #else
-			model.multdof3_Dinv[i] = (model.multdof3_S[i].transpose() * model.multdof3_U[i]).inverse();
+			ws.multdof3_Dinv[i] = (ws.multdof3_S[i].transpose() * ws.multdof3_U[i]).inverse();
 #endif
 			Vector3d tau_temp (Tau[q_index], Tau[q_index + 1], Tau[q_index + 2]);
 
-			model.multdof3_u[i] = tau_temp - model.multdof3_S[i].transpose() * model.pA[i];
+			ws.multdof3_u[i] = tau_temp - ws.multdof3_S[i].transpose() * ws.pA[i];
 
-//			LOG << "multdof3_u[" << i << "] = " << model.multdof3_u[i].transpose() << std::endl;
+//			LOG << "multdof3_u[" << i << "] = " << ws.multdof3_u[i].transpose() << std::endl;
 			unsigned int lambda = model.lambda[i];
 			if (lambda != 0) {
-				SpatialMatrix Ia = model.IA[i] - model.multdof3_U[i] * model.multdof3_Dinv[i] * model.multdof3_U[i].transpose();
-				SpatialVector pa = model.pA[i] + Ia * model.c[i] + model.multdof3_U[i] * model.multdof3_Dinv[i] * model.multdof3_u[i];
+				SpatialMatrix Ia = ws.IA[i] - ws.multdof3_U[i] * ws.multdof3_Dinv[i] * ws.multdof3_U[i].transpose();
+				SpatialVector pa = ws.pA[i] + Ia * ws.c[i] + ws.multdof3_U[i] * ws.multdof3_Dinv[i] * ws.multdof3_u[i];
 #ifdef EIGEN_CORE_H
-				model.IA[lambda].noalias() += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda].noalias() += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda].noalias() += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda].noalias() += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #else
-				model.IA[lambda] += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda] += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda] += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #endif
-				LOG << "pA[" << lambda << "] = " << model.pA[lambda].transpose() << std::endl;
+				LOG << "pA[" << lambda << "] = " << ws.pA[lambda].transpose() << std::endl;
 			}
 		} else {
-			model.U[i] = model.IA[i] * model.S[i];
-			model.d[i] = model.S[i].dot(model.U[i]);
-			model.u[i] = Tau[q_index] - model.S[i].dot(model.pA[i]);
-//			LOG << "u[" << i << "] = " << model.u[i] << std::endl;
+			ws.U[i] = ws.IA[i] * model.S[i];
+			ws.d[i] = model.S[i].dot(ws.U[i]);
+			ws.u[i] = Tau[q_index] - model.S[i].dot(ws.pA[i]);
+//			LOG << "u[" << i << "] = " << ws.u[i] << std::endl;
 
 			unsigned int lambda = model.lambda[i];
 			if (lambda != 0) {
-				SpatialMatrix Ia = model.IA[i] - model.U[i] * (model.U[i] / model.d[i]).transpose();
-				SpatialVector pa = model.pA[i] + Ia * model.c[i] + model.U[i] * model.u[i] / model.d[i];
+				SpatialMatrix Ia = ws.IA[i] - ws.U[i] * (ws.U[i] / ws.d[i]).transpose();
+				SpatialVector pa = ws.pA[i] + Ia * ws.c[i] + ws.U[i] * ws.u[i] / ws.d[i];
 #ifdef EIGEN_CORE_H
-				model.IA[lambda].noalias() += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda].noalias() += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda].noalias() += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda].noalias() += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #else
-				model.IA[lambda] += model.X_lambda[i].toMatrixTranspose() * Ia * model.X_lambda[i].toMatrix();
-				model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+				ws.IA[lambda] += ws.X_lambda[i].toMatrixTranspose() * Ia * ws.X_lambda[i].toMatrix();
+				ws.pA[lambda] += ws.X_lambda[i].applyTranspose (pa, model.X_lambda_kind[i]);
 #endif
-				LOG << "pA[" << lambda << "] = " << model.pA[lambda].transpose() << std::endl;
+				LOG << "pA[" << lambda << "] = " << ws.pA[lambda].transpose() << std::endl;
 			}
 		}
 	}
 
 //	ClearLogOutput();
 
-	model.a[0] = spatial_gravity * -1.;
+	ws.a[0] = spatial_gravity * -1.;
 
 	for (i = 1; i < model.mBodies.size(); i++) {
 		unsigned int q_index = model.mJoints[i].q_index;
 		unsigned int lambda = model.lambda[i];
-		SpatialTransform X_lambda = model.X_lambda[i];
+		SpatialTransform X_lambda = ws.X_lambda[i];
 
-		model.a[i] = X_lambda.apply(model.a[lambda]) + model.c[i];
-		LOG << "a'[" << i << "] = " << model.a[i].transpose() << std::endl;
+		ws.a[i] = X_lambda.apply (ws.a[lambda], model.X_lambda_kind[i]) + ws.c[i];
+		LOG << "a'[" << i << "] = " << ws.a[i].transpose() << std::endl;
 
 		if (model.mJoints[i].mDoFCount == 3) {
-			Vector3d qdd_temp = model.multdof3_Dinv[i] * (model.multdof3_u[i] - model.multdof3_U[i].transpose() * model.a[i]);
+			Vector3d qdd_temp = ws.multdof3_Dinv[i] * (ws.multdof3_u[i] - ws.multdof3_U[i].transpose() * ws.a[i]);
 			QDDot[q_index] = qdd_temp[0];
 			QDDot[q_index + 1] = qdd_temp[1];
 			QDDot[q_index + 2] = qdd_temp[2];
-			model.a[i] = model.a[i] + model.multdof3_S[i] * qdd_temp;
+			ws.a[i] = ws.a[i] + ws.multdof3_S[i] * qdd_temp;
 		} else {
-			QDDot[q_index] = (1./model.d[i]) * (model.u[i] - model.U[i].dot(model.a[i]));
-			model.a[i] = model.a[i] + model.S[i] * QDDot[q_index];
+			QDDot[q_index] = (1./ws.d[i]) * (ws.u[i] - ws.U[i].dot(ws.a[i]));
+			ws.a[i] = ws.a[i] + model.S[i] * QDDot[q_index];
 		}
 	}
 
 	LOG << "QDDot = " << QDDot.transpose() << std::endl;
 }
 
+RBDL_DLLAPI
+void ForwardDynamicsBatch (
+		const Model &model,
+		BatchDynamicsWorkspace &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		const MatrixNd &Tau,
+		MatrixNd &QDDot
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (Q.cols() == QDot.cols());
+	assert (Q.cols() == Tau.cols());
+
+	unsigned int N = Q.cols();
+	unsigned int body_count = model.mBodies.size();
+
+	if (ws.sample_count != N || ws.v.size() != body_count * N)
+		ws.Init (model, N);
+
+	if (QDDot.rows() != model.qdot_size || QDDot.cols() != N)
+		QDDot.resize (model.qdot_size, N);
+
+	SpatialVector spatial_gravity (0., 0., 0., model.gravity[0], model.gravity[1], model.gravity[2]);
+
+	unsigned int i = 0;
+	unsigned int k = 0;
+
+	// Reset the velocity of the root body
+	for (k = 0; k < N; k++) {
+		ws.v[k].setZero();
+	}
+
+	for (i = 1; i < body_count; i++) {
+		unsigned int body_index = i * N;
+		unsigned int lambda_index = model.lambda[i] * N;
+
+		jcalc_batch (model, i, Q, QDot,
+				&ws.X_lambda[body_index],
+				&ws.v_J[0],
+				&ws.c_J[0],
+				model.mJoints[i].mDoFCount == 3 ? &ws.multdof3_S[body_index] : NULL);
+
+		for (k = 0; k < N; k++) {
+			unsigned int ik = body_index + k;
+
+			ws.v[ik] = ws.X_lambda[ik].apply (ws.v[lambda_index + k], model.X_lambda_kind[i]) + ws.v_J[k];
+			ws.c[ik] = ws.c_J[k] + crossm (ws.v[ik], ws.v_J[k]);
+			model.I[i].setSpatialMatrix (ws.IA[ik]);
+			ws.pA[ik] = crossf (ws.v[ik], model.I[i] * ws.v[ik]);
+		}
+	}
+
+	LOG << "--- first loop ---" << std::endl;
+
+	for (i = body_count - 1; i > 0; i--) {
+		unsigned int q_index = model.mJoints[i].q_index;
+		unsigned int lambda = model.lambda[i];
+		unsigned int body_index = i * N;
+		unsigned int lambda_index = lambda * N;
+
+		if (model.mJoints[i].mDoFCount == 3) {
+			for (k = 0; k < N; k++) {
+				unsigned int ik = body_index + k;
+
+				ws.multdof3_U[ik] = ws.IA[ik] * ws.multdof3_S[ik];
+#ifdef EIGEN_CORE_H
+				ws.multdof3_Dinv[ik] = (ws.multdof3_S[ik].transpose() * ws.multdof3_U[ik]).inverse().eval();
+#else
+				ws.multdof3_Dinv[ik] = (ws.multdof3_S[ik].transpose() * ws.multdof3_U[ik]).inverse();
+#endif
+				Vector3d tau_temp (Tau(q_index, k), Tau(q_index + 1, k), Tau(q_index + 2, k));
+
+				ws.multdof3_u[ik] = tau_temp - ws.multdof3_S[ik].transpose() * ws.pA[ik];
+
+				if (lambda != 0) {
+					SpatialMatrix Ia = ws.IA[ik] - ws.multdof3_U[ik] * ws.multdof3_Dinv[ik] * ws.multdof3_U[ik].transpose();
+					SpatialVector pa = ws.pA[ik] + Ia * ws.c[ik] + ws.multdof3_U[ik] * ws.multdof3_Dinv[ik] * ws.multdof3_u[ik];
+#ifdef EIGEN_CORE_H
+					ws.IA[lambda_index + k].noalias() += ws.X_lambda[ik].toMatrixTranspose() * Ia * ws.X_lambda[ik].toMatrix();
+					ws.pA[lambda_index + k].noalias() += ws.X_lambda[ik].applyTranspose (pa, model.X_lambda_kind[i]);
+#else
+					ws.IA[lambda_index + k] += ws.X_lambda[ik].toMatrixTranspose() * Ia * ws.X_lambda[ik].toMatrix();
+					ws.pA[lambda_index + k] += ws.X_lambda[ik].applyTranspose (pa, model.X_lambda_kind[i]);
+#endif
+				}
+			}
+		} else {
+			const SpatialVector &S = model.S[i];
+
+			for (k = 0; k < N; k++) {
+				unsigned int ik = body_index + k;
+
+				ws.U[ik] = ws.IA[ik] * S;
+				ws.d[ik] = S.dot(ws.U[ik]);
+				ws.u[ik] = Tau(q_index, k) - S.dot(ws.pA[ik]);
+
+				if (lambda != 0) {
+					SpatialMatrix Ia = ws.IA[ik] - ws.U[ik] * (ws.U[ik] / ws.d[ik]).transpose();
+					SpatialVector pa = ws.pA[ik] + Ia * ws.c[ik] + ws.U[ik] * ws.u[ik] / ws.d[ik];
+#ifdef EIGEN_CORE_H
+					ws.IA[lambda_index + k].noalias() += ws.X_lambda[ik].toMatrixTranspose() * Ia * ws.X_lambda[ik].toMatrix();
+					ws.pA[lambda_index + k].noalias() += ws.X_lambda[ik].applyTranspose (pa, model.X_lambda_kind[i]);
+#else
+					ws.IA[lambda_index + k] += ws.X_lambda[ik].toMatrixTranspose() * Ia * ws.X_lambda[ik].toMatrix();
+					ws.pA[lambda_index + k] += ws.X_lambda[ik].applyTranspose (pa, model.X_lambda_kind[i]);
+#endif
+				}
+			}
+		}
+	}
+
+	for (k = 0; k < N; k++) {
+		ws.a[k] = spatial_gravity * -1.;
+	}
+
+	for (i = 1; i < body_count; i++) {
+		unsigned int q_index = model.mJoints[i].q_index;
+		unsigned int body_index = i * N;
+		unsigned int lambda_index = model.lambda[i] * N;
+
+		if (model.mJoints[i].mDoFCount == 3) {
+			for (k = 0; k < N; k++) {
+				unsigned int ik = body_index + k;
+
+				ws.a[ik] = ws.X_lambda[ik].apply (ws.a[lambda_index + k], model.X_lambda_kind[i]) + ws.c[ik];
+
+				Vector3d qdd_temp = ws.multdof3_Dinv[ik] * (ws.multdof3_u[ik] - ws.multdof3_U[ik].transpose() * ws.a[ik]);
+				QDDot(q_index, k) = qdd_temp[0];
+				QDDot(q_index + 1, k) = qdd_temp[1];
+				QDDot(q_index + 2, k) = qdd_temp[2];
+				ws.a[ik] = ws.a[ik] + ws.multdof3_S[ik] * qdd_temp;
+			}
+		} else {
+			const SpatialVector &S = model.S[i];
+
+			for (k = 0; k < N; k++) {
+				unsigned int ik = body_index + k;
+
+				ws.a[ik] = ws.X_lambda[ik].apply (ws.a[lambda_index + k], model.X_lambda_kind[i]) + ws.c[ik];
+
+				QDDot(q_index, k) = (1./ws.d[ik]) * (ws.u[ik] - ws.U[ik].dot(ws.a[ik]));
+				ws.a[ik] = ws.a[ik] + S * QDDot(q_index, k);
+			}
+		}
+	}
+
+	LOG << "QDDot = " << std::endl << QDDot << std::endl;
+}
+
+LagrangianWorkspace::LagrangianWorkspace (const Model &model) {
+	Init (model);
+}
+
+void LagrangianWorkspace::Init (const Model &model) {
+	H = MatrixNd::Zero (model.dof_count, model.dof_count);
+	C = VectorNd::Zero (model.dof_count);
+	rhs = VectorNd::Zero (model.dof_count);
+
+#ifndef RBDL_USE_SIMPLE_MATH
+	partial_piv_lu = Eigen::PartialPivLU<MatrixNd> (model.dof_count);
+	col_piv_householder_qr = Eigen::ColPivHouseholderQR<MatrixNd> (model.dof_count, model.dof_count);
+	householder_qr = Eigen::HouseholderQR<MatrixNd> (model.dof_count, model.dof_count);
+	llt = Eigen::LLT<MatrixNd> (model.dof_count);
+#endif
+}
+
 RBDL_DLLAPI
 void ForwardDynamicsLagrangian (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
+		LagrangianWorkspace &lws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		const VectorNd &Tau,
 		VectorNd &QDDot,
 		Math::LinearSolver linear_solver,
-		std::vector<SpatialVector> *f_ext,
-		Math::MatrixNd *H,
-		Math::VectorNd *C
+		std::vector<SpatialVector> *f_ext
 		) {
 	LOG << "-------- " << __func__ << " --------" << std::endl;
 
-	bool free_H = false;
-	bool free_C = false;
+	if (lws.H.rows() != model.dof_count || lws.H.cols() != model.dof_count)
+		lws.H.resize (model.dof_count, model.dof_count);
 
-	if (H == NULL) {
-		H = new MatrixNd (MatrixNd::Zero(model.dof_count, model.dof_count));
-		free_H = true;
-	}
-
-	if (C == NULL) {
-		C = new VectorNd (VectorNd::Zero(model.dof_count));
-		free_C = true;
-	}
+	if (lws.C.size() != model.dof_count)
+		lws.C.resize (model.dof_count);
 
 	// we set QDDot to zero to compute C properly with the InverseDynamics
 	// method.
 	QDDot.setZero();
 
-	InverseDynamics (model, Q, QDot, QDDot, (*C), f_ext);
-	CompositeRigidBodyAlgorithm (model, Q, *H, false);
+	InverseDynamics (model, ws, Q, QDot, QDDot, lws.C, f_ext);
+
+	lws.H.setZero();
+	CompositeRigidBodyAlgorithm (model, ws, Q, lws.H, false);
+
+	lws.rhs = Tau - lws.C;
+
+	LOG << "A = " << std::endl << lws.H << std::endl;
+	LOG << "b = " << std::endl << lws.rhs << std::endl;
 
-	LOG << "A = " << std::endl << *H << std::endl;
-	LOG << "b = " << std::endl << *C * -1. + Tau << std::endl;
+	if (linear_solver == LinearSolverSparseLTL) {
+		SparseFactorizeLTL (model, lws.H);
+
+		QDDot = lws.rhs;
+		SparseSolveLTx (model, lws.H, QDDot);
+		SparseSolveLx (model, lws.H, QDDot);
+
+		LOG << "x = " << QDDot << std::endl;
+		return;
+	}
 
 #ifndef RBDL_USE_SIMPLE_MATH
+	// The solve() of the QR decompositions creates a copy of the right hand
+	// side, therefore Q^T is applied and the triangular system is solved
+	// in place within rhs.
 	switch (linear_solver) {
 		case (LinearSolverPartialPivLU) :
-			QDDot = H->partialPivLu().solve (*C * -1. + Tau);
+			lws.partial_piv_lu.compute (lws.H);
+			QDDot = lws.partial_piv_lu.solve (lws.rhs);
 			break;
-		case (LinearSolverColPivHouseholderQR) :
-			QDDot = H->colPivHouseholderQr().solve (*C * -1. + Tau);
+		case (LinearSolverColPivHouseholderQR) : {
+			lws.col_piv_householder_qr.compute (lws.H);
+			unsigned int rank = lws.col_piv_householder_qr.nonzeroPivots();
+			HouseholderApplyQTranspose (lws.col_piv_householder_qr.matrixQR(), lws.col_piv_householder_qr.hCoeffs(), rank, lws.rhs);
+			lws.col_piv_householder_qr.matrixQR().topLeftCorner (rank, rank).triangularView<Eigen::Upper>().solveInPlace (lws.rhs.head (rank));
+			lws.rhs.tail (model.dof_count - rank).setZero();
+			QDDot.noalias() = lws.col_piv_householder_qr.colsPermutation() * lws.rhs;
 			break;
+		}
 		case (LinearSolverHouseholderQR) :
-			QDDot = H->householderQr().solve (*C * -1. + Tau);
+			lws.householder_qr.compute (lws.H);
+			HouseholderApplyQTranspose (lws.householder_qr.matrixQR(), lws.householder_qr.hCoeffs(), model.dof_count, lws.rhs);
+			lws.householder_qr.matrixQR().triangularView<Eigen::Upper>().solveInPlace (lws.rhs);
+			QDDot = lws.rhs;
 			break;
 		case (LinearSolverLLT) :
-			QDDot = H->llt().solve (*C * -1. + Tau);
+			lws.llt.compute (lws.H);
+			QDDot = lws.llt.solve (lws.rhs);
 			break;
 		default:
 			LOG << "Error: Invalid linear solver: " << linear_solver << std::endl;
@@ -216,25 +406,49 @@ void ForwardDynamicsLagrangian (
 			break;
 	}
 #else
-	bool solve_successful = LinSolveGaussElimPivot (*H, *C * -1. + Tau, QDDot);
+	bool solve_successful = LinSolveGaussElimPivot (lws.H, lws.rhs, QDDot);
 	assert (solve_successful);
 #endif
 
-	if (free_C) {
-		delete C;
-	}
+	LOG << "x = " << QDDot << std::endl;
+}
 
-	if (free_H) {
-		delete H;
-	}
+RBDL_DLLAPI
+void ForwardDynamicsLagrangian (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		VectorNd &QDDot,
+		Math::LinearSolver linear_solver,
+		std::vector<SpatialVector> *f_ext,
+		Math::MatrixNd *H,
+		Math::VectorNd *C
+		) {
+	// The storage of preallocated H and C is lent to the workspace such
+	// that they contain the values of the last evaluation afterwards.
+	LagrangianWorkspace lws;
 
+	if (H != NULL)
+		lws.H.swap (*H);
 
-	LOG << "x = " << QDDot << std::endl;
+	if (C != NULL)
+		lws.C.swap (*C);
+
+	ForwardDynamicsLagrangian (model, ws, lws, Q, QDot, Tau, QDDot, linear_solver, f_ext);
+
+	if (H != NULL)
+		lws.H.swap (*H);
+
+	if (C != NULL)
+		lws.C.swap (*C);
 }
 
 RBDL_DLLAPI
 void NonlinearEffects (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		VectorNd &Tau
@@ -244,46 +458,47 @@ void NonlinearEffects (
 	SpatialVector spatial_gravity (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
 
 	// Reset the velocity of the root body
-	model.v[0].setZero();
-	model.a[0] = spatial_gravity;
+	ws.v[0].setZero();
+	ws.a[0] = spatial_gravity;
 
 	for (unsigned int i = 1; i < model.mJointUpdateOrder.size(); i++) {
-		jcalc (model, model.mJointUpdateOrder[i], Q, QDot);
+		jcalc (model, ws, model.mJointUpdateOrder[i], Q, QDot);
 	}
 
 	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
 		if (model.lambda[i] == 0) {
-			model.v[i] = model.v_J[i];
-			model.a[i] = model.X_lambda[i].apply(spatial_gravity);
+			ws.v[i] = ws.v_J[i];
+			ws.a[i] = ws.X_lambda[i].apply (spatial_gravity, model.X_lambda_kind[i]);
 		}	else {
-			model.v[i] = model.X_lambda[i].apply(model.v[model.lambda[i]]) + model.v_J[i];
-			model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
-			model.a[i] = model.X_lambda[i].apply(model.a[model.lambda[i]]) + model.c[i];
+			ws.v[i] = ws.X_lambda[i].apply (ws.v[model.lambda[i]], model.X_lambda_kind[i]) + ws.v_J[i];
+			ws.c[i] = ws.c_J[i] + crossm(ws.v[i],ws.v_J[i]);
+			ws.a[i] = ws.X_lambda[i].apply (ws.a[model.lambda[i]], model.X_lambda_kind[i]) + ws.c[i];
 		}
 
 		if (!model.mBodies[i].mIsVirtual) {
-			model.f[i] = model.I[i] * model.a[i] + crossf(model.v[i],model.I[i] * model.v[i]);
+			ws.f[i] = model.I[i] * ws.a[i] + crossf(ws.v[i],model.I[i] * ws.v[i]);
 		} else {
-			model.f[i].setZero();
+			ws.f[i].setZero();
 		}
 	}
 
 	for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
 		if (model.mJoints[i].mDoFCount == 3) {
-			Tau.block<3,1>(model.mJoints[i].q_index, 0) = model.multdof3_S[i].transpose() * model.f[i];
+			Tau.block<3,1>(model.mJoints[i].q_index, 0) = ws.multdof3_S[i].transpose() * ws.f[i];
 		} else {
-			Tau[model.mJoints[i].q_index] = model.S[i].dot(model.f[i]);
+			Tau[model.mJoints[i].q_index] = model.S[i].dot(ws.f[i]);
 		}
 
 		if (model.lambda[i] != 0) {
-			model.f[model.lambda[i]] = model.f[model.lambda[i]] + model.X_lambda[i].applyTranspose(model.f[i]);
+			ws.f[model.lambda[i]] = ws.f[model.lambda[i]] + ws.X_lambda[i].applyTranspose (ws.f[i], model.X_lambda_kind[i]);
 		}
 	}
 }
 
 RBDL_DLLAPI
 void InverseDynamics (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		const VectorNd &QDDot,
@@ -293,87 +508,87 @@ void InverseDynamics (
 	LOG << "-------- " << __func__ << " --------" << std::endl;
 
 	// Reset the velocity of the root body
-	model.v[0].setZero();
-	model.a[0].set (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
+	ws.v[0].setZero();
+	ws.a[0].set (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
 
 	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
 		unsigned int q_index = model.mJoints[i].q_index;
 		unsigned int lambda = model.lambda[i];
 
-		jcalc (model, i, Q, QDot);
+		jcalc (model, ws, i, Q, QDot);
 
 		if (lambda != 0) {
-			model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
+			ws.X_lambda[i].multiply (model.X_lambda_kind[i], ws.X_base[lambda], SpatialTransformGeneral, ws.X_base[i]);
 		} else {
-			model.X_base[i] = model.X_lambda[i];
+			ws.X_base[i] = ws.X_lambda[i];
 		}
 
-		model.v[i] = model.X_lambda[i].apply(model.v[lambda]) + model.v_J[i];
-		model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
+		ws.v[i] = ws.X_lambda[i].apply (ws.v[lambda], model.X_lambda_kind[i]) + ws.v_J[i];
+		ws.c[i] = ws.c_J[i] + crossm(ws.v[i],ws.v_J[i]);
 
 		if (model.mJoints[i].mDoFCount == 3) {
-			model.a[i] = model.X_lambda[i].apply(model.a[lambda]) + model.c[i] + model.multdof3_S[i] * Vector3d (QDDot[q_index], QDDot[q_index + 1], QDDot[q_index + 2]);
+			ws.a[i] = ws.X_lambda[i].apply (ws.a[lambda], model.X_lambda_kind[i]) + ws.c[i] + ws.multdof3_S[i] * Vector3d (QDDot[q_index], QDDot[q_index + 1], QDDot[q_index + 2]);
 		} else {
-			model.a[i] = model.X_lambda[i].apply(model.a[lambda]) + model.c[i] + model.S[i] * QDDot[q_index];
+			ws.a[i] = ws.X_lambda[i].apply (ws.a[lambda], model.X_lambda_kind[i]) + ws.c[i] + model.S[i] * QDDot[q_index];
 		}	
 
 		if (!model.mBodies[i].mIsVirtual) {
-			model.f[i] = model.I[i] * model.a[i] + crossf(model.v[i],model.I[i] * model.v[i]);
+			ws.f[i] = model.I[i] * ws.a[i] + crossf(ws.v[i],model.I[i] * ws.v[i]);
 		} else {
-			model.f[i].setZero();
+			ws.f[i].setZero();
 		}
 
 		if (f_ext != NULL && (*f_ext)[i] != SpatialVectorZero)
-			model.f[i] -= model.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
+			ws.f[i] -= ws.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
 	}
 
 	for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
 		if (model.mJoints[i].mDoFCount == 3) {
-			Tau.block<3,1>(model.mJoints[i].q_index, 0) = model.multdof3_S[i].transpose() * model.f[i];
+			Tau.block<3,1>(model.mJoints[i].q_index, 0) = ws.multdof3_S[i].transpose() * ws.f[i];
 		} else {
-			Tau[model.mJoints[i].q_index] = model.S[i].dot(model.f[i]);
+			Tau[model.mJoints[i].q_index] = model.S[i].dot(ws.f[i]);
 		}
 
 		if (model.lambda[i] != 0) {
-			model.f[model.lambda[i]] = model.f[model.lambda[i]] + model.X_lambda[i].applyTranspose(model.f[i]);
+			ws.f[model.lambda[i]] = ws.f[model.lambda[i]] + ws.X_lambda[i].applyTranspose (ws.f[i], model.X_lambda_kind[i]);
 		}
 	}
 }
 
 RBDL_DLLAPI
-void CompositeRigidBodyAlgorithm (Model& model, const VectorNd &Q, MatrixNd &H, bool update_kinematics) {
+void CompositeRigidBodyAlgorithm (const Model& model, DynamicsWorkspace &ws, const VectorNd &Q, MatrixNd &H, bool update_kinematics) {
 	LOG << "-------- " << __func__ << " --------" << std::endl;
 
 	assert (H.rows() == model.dof_count && H.cols() == model.dof_count);
 
 	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
 		if (update_kinematics) {
-			jcalc_X_lambda_S (model, i, Q);
+			jcalc_X_lambda_S (model, ws, i, Q);
 		}
-		model.Ic[i] = model.I[i];
+		ws.Ic[i] = model.I[i];
 	}
 
 	for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
 		if (model.lambda[i] != 0) {
-			model.Ic[model.lambda[i]] = model.Ic[model.lambda[i]] + model.X_lambda[i].applyTranspose(model.Ic[i]);
+			ws.Ic[model.lambda[i]] = ws.Ic[model.lambda[i]] + ws.X_lambda[i].applyTranspose(ws.Ic[i]);
 		}
 
 		unsigned int dof_index_i = model.mJoints[i].q_index;
 
 		if (model.mJoints[i].mDoFCount == 3) {
-			Matrix63 F_63 = model.Ic[i].toMatrix() * model.multdof3_S[i];
-			H.block<3,3>(dof_index_i, dof_index_i) = model.multdof3_S[i].transpose() * F_63;
+			Matrix63 F_63 = ws.Ic[i].toMatrix() * ws.multdof3_S[i];
+			H.block<3,3>(dof_index_i, dof_index_i) = ws.multdof3_S[i].transpose() * F_63;
 
 			unsigned int j = i;
 			unsigned int dof_index_j = dof_index_i;
 
 			while (model.lambda[j] != 0) {
-				F_63 = model.X_lambda[j].toMatrixTranspose() * (F_63);
+				F_63 = ws.X_lambda[j].toMatrixTranspose() * (F_63);
 				j = model.lambda[j];
 				dof_index_j = model.mJoints[j].q_index;
 
 				if (model.mJoints[j].mDoFCount == 3) {
-					Matrix3d H_temp2 = F_63.transpose() * (model.multdof3_S[j]);
+					Matrix3d H_temp2 = F_63.transpose() * (ws.multdof3_S[j]);
 
 					H.block<3,3>(dof_index_i,dof_index_j) = H_temp2;
 					H.block<3,3>(dof_index_j,dof_index_i) = H_temp2.transpose();
@@ -385,21 +600,21 @@ void CompositeRigidBodyAlgorithm (Model& model, const VectorNd &Q, MatrixNd &H,
 				}
 			}
 		} else {
-			SpatialVector F = model.Ic[i] * model.S[i];
+			SpatialVector F = ws.Ic[i] * model.S[i];
 			H(dof_index_i, dof_index_i) = model.S[i].dot(F);
 
 			unsigned int j = i;
 			unsigned int dof_index_j = dof_index_i;
 
 			while (model.lambda[j] != 0) {
-				F = model.X_lambda[j].applyTranspose(F);
+				F = ws.X_lambda[j].applyTranspose (F, model.X_lambda_kind[j]);
 				j = model.lambda[j];
 				dof_index_j = model.mJoints[j].q_index;
 
 				if (model.mJoints[j].mDoFCount == 3) {
-					Vector3d H_temp2 = (F.transpose() * model.multdof3_S[j]).transpose();
+					Vector3d H_temp2 = (F.transpose() * ws.multdof3_S[j]).transpose();
 
-					LOG << F.transpose() << std::endl << model.multdof3_S[j] << std::endl;
+					LOG << F.transpose() << std::endl << ws.multdof3_S[j] << std::endl;
 					LOG << H_temp2.transpose() << std::endl;
 
 					H.block<1,3>(dof_index_i,dof_index_j) = H_temp2.transpose();
@@ -413,4 +628,310 @@ void CompositeRigidBodyAlgorithm (Model& model, const VectorNd &Q, MatrixNd &H,
 	}
 }
 
+/** \brief Returns the matrix M for which M x = crossf (x, h) holds */
+static SpatialMatrix crossf_bar (const SpatialVector &h) {
+	Matrix3d n_cross = VectorCrossMatrix (Vector3d (h[0], h[1], h[2]));
+	Matrix3d f_cross = VectorCrossMatrix (Vector3d (h[3], h[4], h[5]));
+
+	SpatialMatrix result;
+	result.block<3,3>(0,0) = -n_cross;
+	result.block<3,3>(0,3) = -f_cross;
+	result.block<3,3>(3,0) = -f_cross;
+	result.block<3,3>(3,3).setZero();
+
+	return result;
+}
+
+DynamicsDerivativesWorkspace::DynamicsDerivativesWorkspace (const Model &model) {
+	Init (model);
+}
+
+void DynamicsDerivativesWorkspace::Init (const Model &model) {
+	unsigned int body_count = model.mBodies.size();
+
+	v.assign (body_count, SpatialVectorZero);
+	a.assign (body_count, SpatialVectorZero);
+	f.assign (body_count, SpatialVectorZero);
+	Ic.assign (body_count, SpatialMatrixZero);
+	Bc.assign (body_count, SpatialMatrixZero);
+
+	S.assign (model.dof_count, SpatialVectorZero);
+	S_dot.assign (model.dof_count, SpatialVectorZero);
+	Psi_dot.assign (model.dof_count, SpatialVectorZero);
+	Psi_ddot.assign (model.dof_count, SpatialVectorZero);
+
+	H = MatrixNd::Zero (model.dof_count, model.dof_count);
+	tau = VectorNd::Zero (model.dof_count);
+	column = VectorNd::Zero (model.dof_count);
+}
+
+RBDL_DLLAPI
+void InverseDynamicsDerivatives (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		DynamicsDerivativesWorkspace &dws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &QDDot,
+		VectorNd &Tau,
+		MatrixNd &DTauDQ,
+		MatrixNd &DTauDQDot
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (DTauDQ.rows() == model.dof_count && DTauDQ.cols() == model.dof_count);
+	assert (DTauDQDot.rows() == model.dof_count && DTauDQDot.cols() == model.dof_count);
+
+	if (dws.v.size() != model.mBodies.size() || dws.S.size() != model.dof_count)
+		dws.Init (model);
+
+	// computes the kinematics and the velocities and accelerations in body
+	// coordinates
+	InverseDynamics (model, ws, Q, QDot, QDDot, Tau);
+
+	dws.v[0].setZero();
+	dws.a[0] = ws.a[0];
+
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		unsigned int lambda = model.lambda[i];
+		unsigned int q_index = model.mJoints[i].q_index;
+		unsigned int dof_count = model.mJoints[i].mDoFCount;
+		SpatialTransform X_base_inv = ws.X_base[i].inverse();
+
+		dws.v[i] = X_base_inv.apply (ws.v[i]);
+		dws.a[i] = X_base_inv.apply (ws.a[i]);
+
+		if (!model.mBodies[i].mIsVirtual) {
+			SpatialMatrix I = ws.X_base[i].applyTranspose (model.I[i]).toMatrix();
+			SpatialVector h = I * dws.v[i];
+
+			dws.f[i] = I * dws.a[i] + crossf (dws.v[i], h);
+			dws.Ic[i] = I;
+			dws.Bc[i] = crossf (dws.v[i]) * I + crossf_bar (h) - I * crossm (dws.v[i]);
+		} else {
+			dws.f[i].setZero();
+			dws.Ic[i].setZero();
+			dws.Bc[i].setZero();
+		}
+
+		// The columns of all multi degree of freedom joints except the
+		// spherical joint behave like a chain of single degree of freedom
+		// joints. v_parent and a_parent are the velocity and acceleration
+		// of the (virtual) body before each column.
+		bool is_chain = model.mJoints[i].mJointType != JointTypeSpherical;
+		SpatialVector v_parent = dws.v[lambda];
+		SpatialVector a_parent = dws.a[lambda];
+
+		for (unsigned int c = 0; c < dof_count; c++) {
+			unsigned int k = q_index + c;
+
+			if (dof_count == 3) {
+				dws.S[k] = X_base_inv.apply (ws.multdof3_S[i].col(c));
+			} else {
+				dws.S[k] = X_base_inv.apply (model.S[i]);
+			}
+
+			dws.Psi_dot[k] = crossm (v_parent, dws.S[k]);
+			dws.Psi_ddot[k] = crossm (a_parent, dws.S[k]) + crossm (v_parent, dws.Psi_dot[k]);
+
+			if (is_chain) {
+				v_parent = v_parent + dws.S[k] * QDot[k];
+				a_parent = a_parent + dws.S[k] * QDDot[k] + crossm (v_parent, dws.S[k]) * QDot[k];
+				dws.S_dot[k] = dws.Psi_dot[k];
+			} else {
+				dws.S_dot[k] = crossm (dws.v[i], dws.S[k]);
+			}
+		}
+	}
+
+	DTauDQ.setZero();
+	DTauDQDot.setZero();
+
+	for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
+		unsigned int lambda = model.lambda[i];
+		unsigned int q_index = model.mJoints[i].q_index;
+		unsigned int dof_count = model.mJoints[i].mDoFCount;
+		bool is_chain = model.mJoints[i].mJointType != JointTypeSpherical;
+
+		for (unsigned int c = 0; c < dof_count; c++) {
+			unsigned int k = q_index + c;
+
+			// derivatives of the force transmitted by joint i in a frame
+			// that moves with the subtree and, for the joints above, in
+			// base coordinates
+			SpatialVector df_dq = dws.Ic[i] * dws.Psi_ddot[k] + dws.Bc[i] * dws.Psi_dot[k];
+			SpatialVector df_dq_parent = df_dq + crossf (dws.S[k], dws.f[i]);
+			SpatialVector df_dqdot = dws.Bc[i] * dws.S[k] + dws.Ic[i] * (dws.Psi_dot[k] + dws.S_dot[k]);
+
+			for (unsigned int d = 0; d < dof_count; d++) {
+				unsigned int l = q_index + d;
+
+				if (is_chain && d < c) {
+					DTauDQ(l, k) = dws.S[l].dot (df_dq_parent);
+				} else {
+					DTauDQ(l, k) = dws.S[l].dot (df_dq);
+				}
+				DTauDQDot(l, k) = dws.S[l].dot (df_dqdot);
+			}
+
+			SpatialVector Ic_S = dws.Ic[i] * dws.S[k];
+			SpatialVector BcT_S = dws.Bc[i].transpose() * dws.S[k];
+
+			unsigned int j = lambda;
+			while (j != 0) {
+				for (unsigned int d = 0; d < model.mJoints[j].mDoFCount; d++) {
+					unsigned int l = model.mJoints[j].q_index + d;
+
+					DTauDQ(l, k) = dws.S[l].dot (df_dq_parent);
+					DTauDQ(k, l) = Ic_S.dot (dws.Psi_ddot[l]) + BcT_S.dot (dws.Psi_dot[l]);
+					DTauDQDot(l, k) = dws.S[l].dot (df_dqdot);
+					DTauDQDot(k, l) = BcT_S.dot (dws.S[l]) + Ic_S.dot (dws.Psi_dot[l] + dws.S_dot[l]);
+				}
+				j = model.lambda[j];
+			}
+		}
+
+		if (lambda != 0) {
+			dws.f[lambda] = dws.f[lambda] + dws.f[i];
+			dws.Ic[lambda] = dws.Ic[lambda] + dws.Ic[i];
+			dws.Bc[lambda] = dws.Bc[lambda] + dws.Bc[i];
+		}
+	}
+}
+
+/** \brief Computes column c of M as scale * H^-1 M.col(c) where
+ * dws.H contains the factor of SparseFactorizeLTL() */
+static void solve_sparse_column (
+		const Model &model,
+		DynamicsDerivativesWorkspace &dws,
+		MatrixNd &M,
+		unsigned int c,
+		double scale) {
+	dws.column = M.col(c);
+	SparseSolveLTx (model, dws.H, dws.column);
+	SparseSolveLx (model, dws.H, dws.column);
+	M.col(c) = dws.column * scale;
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsDerivatives (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		DynamicsDerivativesWorkspace &dws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		VectorNd &QDDot,
+		MatrixNd &DQDDotDQ,
+		MatrixNd &DQDDotDQDot,
+		MatrixNd &DQDDotDTau
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (DQDDotDTau.rows() == model.dof_count && DQDDotDTau.cols() == model.dof_count);
+
+	if (dws.v.size() != model.mBodies.size() || dws.S.size() != model.dof_count)
+		dws.Init (model);
+
+	ForwardDynamics (model, ws, Q, QDot, Tau, QDDot);
+
+	InverseDynamicsDerivatives (model, ws, dws, Q, QDot, QDDot, dws.tau, DQDDotDQ, DQDDotDQDot);
+
+	// the kinematics were updated by InverseDynamicsDerivatives()
+	dws.H.setZero();
+	CompositeRigidBodyAlgorithm (model, ws, Q, dws.H, false);
+	SparseFactorizeLTL (model, dws.H);
+
+	DQDDotDTau.setIdentity();
+
+	for (unsigned int c = 0; c < model.dof_count; c++) {
+		solve_sparse_column (model, dws, DQDDotDQ, c, -1.);
+		solve_sparse_column (model, dws, DQDDotDQDot, c, -1.);
+		solve_sparse_column (model, dws, DQDDotDTau, c, 1.);
+	}
+}
+
+RBDL_DLLAPI
+void ForwardDynamics (
+		Model &model,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		VectorNd &QDDot,
+		std::vector<SpatialVector> *f_ext
+		) {
+	ForwardDynamics (model, model, Q, QDot, Tau, QDDot, f_ext);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsLagrangian (
+		Model &model,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		VectorNd &QDDot,
+		Math::LinearSolver linear_solver,
+		std::vector<SpatialVector> *f_ext,
+		Math::MatrixNd *H,
+		Math::VectorNd *C
+		) {
+	ForwardDynamicsLagrangian (model, model, Q, QDot, Tau, QDDot, linear_solver, f_ext, H, C);
+}
+
+RBDL_DLLAPI
+void NonlinearEffects (
+		Model &model,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		VectorNd &Tau
+		) {
+	NonlinearEffects (model, model, Q, QDot, Tau);
+}
+
+RBDL_DLLAPI
+void InverseDynamics (
+		Model &model,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &QDDot,
+		VectorNd &Tau,
+		std::vector<SpatialVector> *f_ext
+		) {
+	InverseDynamics (model, model, Q, QDot, QDDot, Tau, f_ext);
+}
+
+RBDL_DLLAPI
+void CompositeRigidBodyAlgorithm (Model& model, const VectorNd &Q, MatrixNd &H, bool update_kinematics) {
+	CompositeRigidBodyAlgorithm (model, model, Q, H, update_kinematics);
+}
+
+RBDL_DLLAPI
+void InverseDynamicsDerivatives (
+		Model &model,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &QDDot,
+		VectorNd &Tau,
+		MatrixNd &DTauDQ,
+		MatrixNd &DTauDQDot
+		) {
+	DynamicsDerivativesWorkspace dws (model);
+	InverseDynamicsDerivatives (model, model, dws, Q, QDot, QDDot, Tau, DTauDQ, DTauDQDot);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsDerivatives (
+		Model &model,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		VectorNd &QDDot,
+		MatrixNd &DQDDotDQ,
+		MatrixNd &DQDDotDQDot,
+		MatrixNd &DQDDotDTau
+		) {
+	DynamicsDerivativesWorkspace dws (model);
+	ForwardDynamicsDerivatives (model, model, dws, Q, QDot, Tau, QDDot, DQDDotDQ, DQDDotDQDot, DQDDotDTau);
+}
+
 } /* namespace RigidBodyDynamics */
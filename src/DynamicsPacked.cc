@@ -0,0 +1,311 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include <iostream>
+#include <new>
+#include <assert.h>
+#include <string.h>
+
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Joint.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/DynamicsPacked.h"
+
+namespace RigidBodyDynamics {
+
+using namespace Math;
+
+static const size_t packed_cache_line_size = 64;
+
+static size_t packed_align (size_t offset, size_t alignment) {
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+// alignment of a value in the arena: the fixed size Eigen types are
+// accessed with aligned loads whose width depends on the instruction set
+// (e.g. 32 bytes when compiled with AVX)
+template <typename T>
+static size_t packed_alignment () {
+	size_t alignment = alignof (T);
+#ifdef EIGEN_MAX_STATIC_ALIGN_BYTES
+	if (alignment < EIGEN_MAX_STATIC_ALIGN_BYTES)
+		alignment = EIGEN_MAX_STATIC_ALIGN_BYTES;
+#endif
+	if (alignment < 16)
+		alignment = 16;
+	assert (alignment <= packed_cache_line_size);
+	return alignment;
+}
+
+template <typename T>
+static void packed_construct (char *arena, size_t offset, size_t stride, unsigned int count) {
+	for (unsigned int s = 0; s < count; s++)
+		new (arena + offset + s * stride) T();
+}
+
+PackedDynamicsWorkspace::PackedDynamicsWorkspace() :
+	layout (PackedLayoutAoS),
+	body_count (0),
+	arena_size (0),
+	arena (NULL),
+	arena_allocation (NULL)
+{
+	for (unsigned int f = 0; f < FieldCount; f++) {
+		field_offset[f] = 0;
+		field_stride[f] = 0;
+	}
+}
+
+PackedDynamicsWorkspace::PackedDynamicsWorkspace (const Model &model, PackedLayout layout) :
+	arena_size (0),
+	arena (NULL),
+	arena_allocation (NULL)
+{
+	Init (model, layout);
+}
+
+PackedDynamicsWorkspace::~PackedDynamicsWorkspace() {
+	delete[] arena_allocation;
+}
+
+void PackedDynamicsWorkspace::Init (const Model &model, PackedLayout layout) {
+	this->layout = layout;
+	body_count = model.mBodies.size();
+
+	// depth-first order of the bodies such that every subtree is stored
+	// contiguously (and every parent before its children)
+	order.clear();
+	slot.assign (body_count, 0);
+	parent_slot.assign (body_count, 0);
+
+	std::vector<unsigned int> stack (1, 0);
+	while (stack.size() > 0) {
+		unsigned int i = stack.back();
+		stack.pop_back();
+
+		slot[i] = order.size();
+		order.push_back (i);
+
+		for (unsigned int j = model.mu[i].size(); j > 0; j--)
+			stack.push_back (model.mu[i][j - 1]);
+	}
+	assert (order.size() == body_count);
+
+	for (unsigned int s = 1; s < body_count; s++)
+		parent_slot[s] = slot[model.lambda[order[s]]];
+
+	bool has_multdof3 = false;
+	for (unsigned int i = 1; i < model.mJoints.size(); i++) {
+		if (model.mJoints[i].mDoFCount == 3)
+			has_multdof3 = true;
+	}
+
+	size_t field_size[FieldCount];
+	field_size[FieldXLambda] = sizeof (SpatialTransform);
+	field_size[FieldV] = sizeof (SpatialVector);
+	field_size[FieldC] = sizeof (SpatialVector);
+	field_size[FieldPA] = sizeof (SpatialVector);
+	field_size[FieldIA] = sizeof (SpatialMatrix);
+	field_size[FieldU] = sizeof (SpatialVector);
+	field_size[FieldD] = sizeof (double);
+	field_size[FieldUScalar] = sizeof (double);
+	field_size[FieldA] = sizeof (SpatialVector);
+	field_size[FieldMultdof3S] = has_multdof3 ? sizeof (Matrix63) : 0;
+	field_size[FieldMultdof3U] = has_multdof3 ? sizeof (Matrix63) : 0;
+	field_size[FieldMultdof3Dinv] = has_multdof3 ? sizeof (Matrix3d) : 0;
+	field_size[FieldMultdof3UVector] = has_multdof3 ? sizeof (Vector3d) : 0;
+
+	size_t field_alignment[FieldCount];
+	field_alignment[FieldXLambda] = packed_alignment<SpatialTransform>();
+	field_alignment[FieldV] = packed_alignment<SpatialVector>();
+	field_alignment[FieldC] = packed_alignment<SpatialVector>();
+	field_alignment[FieldPA] = packed_alignment<SpatialVector>();
+	field_alignment[FieldIA] = packed_alignment<SpatialMatrix>();
+	field_alignment[FieldU] = packed_alignment<SpatialVector>();
+	field_alignment[FieldD] = packed_alignment<double>();
+	field_alignment[FieldUScalar] = packed_alignment<double>();
+	field_alignment[FieldA] = packed_alignment<SpatialVector>();
+	field_alignment[FieldMultdof3S] = packed_alignment<Matrix63>();
+	field_alignment[FieldMultdof3U] = packed_alignment<Matrix63>();
+	field_alignment[FieldMultdof3Dinv] = packed_alignment<Matrix3d>();
+	field_alignment[FieldMultdof3UVector] = packed_alignment<Vector3d>();
+
+	if (layout == PackedLayoutAoS) {
+		// the values of a body are stored in the order in which the sweeps
+		// access them, each block starts at a cache line
+		size_t block_size = 0;
+		for (unsigned int f = 0; f < FieldCount; f++) {
+			field_offset[f] = packed_align (block_size, field_alignment[f]);
+			block_size = field_offset[f] + field_size[f];
+		}
+		block_size = packed_align (block_size, packed_cache_line_size);
+
+		for (unsigned int f = 0; f < FieldCount; f++)
+			field_stride[f] = block_size;
+
+		arena_size = block_size * body_count;
+	} else {
+		// each value is stored in an array that starts at a cache line
+		arena_size = 0;
+		for (unsigned int f = 0; f < FieldCount; f++) {
+			field_offset[f] = arena_size;
+			field_stride[f] = field_size[f];
+			arena_size = packed_align (arena_size + field_size[f] * body_count, packed_cache_line_size);
+		}
+	}
+
+	delete[] arena_allocation;
+	arena_allocation = new char[arena_size + packed_cache_line_size];
+	arena = arena_allocation + (packed_cache_line_size - reinterpret_cast<size_t>(arena_allocation) % packed_cache_line_size) % packed_cache_line_size;
+
+	// the joint kernels only write the non-zero entries of multdof3_S
+	memset (arena, 0, arena_size);
+
+	packed_construct<SpatialTransform> (arena, field_offset[FieldXLambda], field_stride[FieldXLambda], body_count);
+	packed_construct<SpatialVector> (arena, field_offset[FieldV], field_stride[FieldV], body_count);
+	packed_construct<SpatialVector> (arena, field_offset[FieldC], field_stride[FieldC], body_count);
+	packed_construct<SpatialVector> (arena, field_offset[FieldPA], field_stride[FieldPA], body_count);
+	packed_construct<SpatialMatrix> (arena, field_offset[FieldIA], field_stride[FieldIA], body_count);
+	packed_construct<SpatialVector> (arena, field_offset[FieldU], field_stride[FieldU], body_count);
+	packed_construct<double> (arena, field_offset[FieldD], field_stride[FieldD], body_count);
+	packed_construct<double> (arena, field_offset[FieldUScalar], field_stride[FieldUScalar], body_count);
+	packed_construct<SpatialVector> (arena, field_offset[FieldA], field_stride[FieldA], body_count);
+
+	if (has_multdof3) {
+		packed_construct<Matrix63> (arena, field_offset[FieldMultdof3S], field_stride[FieldMultdof3S], body_count);
+		packed_construct<Matrix63> (arena, field_offset[FieldMultdof3U], field_stride[FieldMultdof3U], body_count);
+		packed_construct<Matrix3d> (arena, field_offset[FieldMultdof3Dinv], field_stride[FieldMultdof3Dinv], body_count);
+		packed_construct<Vector3d> (arena, field_offset[FieldMultdof3UVector], field_stride[FieldMultdof3UVector], body_count);
+	}
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsPacked (
+		const Model &model,
+		PackedDynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		VectorNd &QDDot
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	if (ws.body_count != model.mBodies.size())
+		ws.Init (model, ws.layout);
+
+	unsigned int body_count = ws.body_count;
+	SpatialVector spatial_gravity (0., 0., 0., model.gravity[0], model.gravity[1], model.gravity[2]);
+
+	SpatialTransform X_J;
+	SpatialVector v_J;
+	SpatialVector c_J;
+	Matrix63 S_dummy;
+
+	// Reset the velocity of the root body
+	ws.v(0).setZero();
+
+	for (unsigned int s = 1; s < body_count; s++) {
+		unsigned int i = ws.order[s];
+		unsigned int lambda = ws.parent_slot[s];
+		SpatialTransformKind kind = model.X_lambda_kind[i];
+
+		model.mJointKernels[i] (model, i, Q.data(), QDot.data(), X_J, v_J, c_J,
+				model.mJoints[i].mDoFCount == 3 ? ws.multdof3_S(s) : S_dummy);
+		X_J.multiply (model.X_J_kind[i], model.X_T[i], model.X_T_kind[i], ws.X_lambda(s));
+
+		SpatialVector &v = ws.v(s);
+		v = ws.X_lambda(s).apply (ws.v(lambda), kind) + v_J;
+		ws.c(s) = c_J + crossm (v, v_J);
+
+		model.I[i].setSpatialMatrix (ws.IA(s));
+		ws.pA(s) = crossf (v, model.I[i] * v);
+	}
+
+	for (unsigned int s = body_count - 1; s > 0; s--) {
+		unsigned int i = ws.order[s];
+		unsigned int q_index = model.mJoints[i].q_index;
+		unsigned int lambda = ws.parent_slot[s];
+		SpatialMatrix &IA = ws.IA(s);
+		SpatialVector &pA = ws.pA(s);
+
+		if (model.mJoints[i].mDoFCount == 3) {
+			Matrix63 &S = ws.multdof3_S(s);
+			Matrix63 &U = ws.multdof3_U(s);
+			Matrix3d &Dinv = ws.multdof3_Dinv(s);
+			Vector3d &u = ws.multdof3_u(s);
+
+			U = IA * S;
+#ifdef EIGEN_CORE_H
+			Dinv = (S.transpose() * U).inverse().eval();
+#else
+			Dinv = (S.transpose() * U).inverse();
+#endif
+			u = Vector3d (Tau[q_index], Tau[q_index + 1], Tau[q_index + 2]) - S.transpose() * pA;
+
+			if (lambda != 0) {
+				SpatialMatrix Ia = IA - U * Dinv * U.transpose();
+				SpatialVector pa = pA + Ia * ws.c(s) + U * Dinv * u;
+				const SpatialTransform &X_lambda = ws.X_lambda(s);
+#ifdef EIGEN_CORE_H
+				ws.IA(lambda).noalias() += X_lambda.toMatrixTranspose() * Ia * X_lambda.toMatrix();
+				ws.pA(lambda).noalias() += X_lambda.applyTranspose (pa, model.X_lambda_kind[i]);
+#else
+				ws.IA(lambda) += X_lambda.toMatrixTranspose() * Ia * X_lambda.toMatrix();
+				ws.pA(lambda) += X_lambda.applyTranspose (pa, model.X_lambda_kind[i]);
+#endif
+			}
+		} else {
+			SpatialVector &U = ws.U(s);
+
+			U = IA * model.S[i];
+			ws.d(s) = model.S[i].dot (U);
+			ws.u(s) = Tau[q_index] - model.S[i].dot (pA);
+
+			if (lambda != 0) {
+				SpatialMatrix Ia = IA - U * (U / ws.d(s)).transpose();
+				SpatialVector pa = pA + Ia * ws.c(s) + U * ws.u(s) / ws.d(s);
+				const SpatialTransform &X_lambda = ws.X_lambda(s);
+#ifdef EIGEN_CORE_H
+				ws.IA(lambda).noalias() += X_lambda.toMatrixTranspose() * Ia * X_lambda.toMatrix();
+				ws.pA(lambda).noalias() += X_lambda.applyTranspose (pa, model.X_lambda_kind[i]);
+#else
+				ws.IA(lambda) += X_lambda.toMatrixTranspose() * Ia * X_lambda.toMatrix();
+				ws.pA(lambda) += X_lambda.applyTranspose (pa, model.X_lambda_kind[i]);
+#endif
+			}
+		}
+	}
+
+	ws.a(0) = spatial_gravity * -1.;
+
+	for (unsigned int s = 1; s < body_count; s++) {
+		unsigned int i = ws.order[s];
+		unsigned int q_index = model.mJoints[i].q_index;
+		unsigned int lambda = ws.parent_slot[s];
+		SpatialVector &a = ws.a(s);
+
+		a = ws.X_lambda(s).apply (ws.a(lambda), model.X_lambda_kind[i]) + ws.c(s);
+
+		if (model.mJoints[i].mDoFCount == 3) {
+			Vector3d qdd_temp = ws.multdof3_Dinv(s) * (ws.multdof3_u(s) - ws.multdof3_U(s).transpose() * a);
+			QDDot[q_index] = qdd_temp[0];
+			QDDot[q_index + 1] = qdd_temp[1];
+			QDDot[q_index + 2] = qdd_temp[2];
+			a = a + ws.multdof3_S(s) * qdd_temp;
+		} else {
+			QDDot[q_index] = (1. / ws.d(s)) * (ws.u(s) - ws.U(s).dot (a));
+			a = a + model.S[i] * QDDot[q_index];
+		}
+	}
+
+	LOG << "QDDot = " << QDDot.transpose() << std::endl;
+}
+
+} /* namespace RigidBodyDynamics */
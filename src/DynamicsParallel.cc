@@ -0,0 +1,508 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include <iostream>
+#include <limits>
+#include <assert.h>
+
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Kinematics.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/Contacts.h"
+#include "rbdl/DynamicsParallel.h"
+
+namespace RigidBodyDynamics {
+
+using namespace Math;
+
+ParallelDynamicsWorkspace::ParallelDynamicsWorkspace() :
+	pool (NULL),
+	chunk_size (0)
+{}
+
+ParallelDynamicsWorkspace::ParallelDynamicsWorkspace (const Model &model, unsigned int thread_count) :
+	pool (NULL),
+	chunk_size (0) {
+	Init (model, thread_count);
+}
+
+ParallelDynamicsWorkspace::~ParallelDynamicsWorkspace() {
+	delete pool;
+}
+
+void ParallelDynamicsWorkspace::Init (const Model &model, unsigned int thread_count) {
+	delete pool;
+	pool = new ThreadPool (thread_count);
+
+	unsigned int worker_count = pool->GetThreadCount();
+
+	worker_ws.assign (worker_count, DynamicsWorkspace (model));
+	worker_CS.clear();
+	worker_ik_CS.clear();
+
+	worker_q.assign (worker_count, VectorNd::Zero (model.q_size));
+	worker_qdot.assign (worker_count, VectorNd::Zero (model.qdot_size));
+	worker_qddot.assign (worker_count, VectorNd::Zero (model.qdot_size));
+	worker_tau.assign (worker_count, VectorNd::Zero (model.qdot_size));
+}
+
+unsigned int ParallelDynamicsWorkspace::GetThreadCount () const {
+	if (pool == NULL)
+		return 0;
+
+	return pool->GetThreadCount();
+}
+
+/** \brief Initializes the workspace if required and resizes the output */
+static void parallel_prepare (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		MatrixNd &result,
+		unsigned int rows,
+		unsigned int cols) {
+	if (ws.pool == NULL || ws.worker_ws[0].v.size() != model.mBodies.size())
+		ws.Init (model, ws.GetThreadCount());
+
+	if (result.rows() != rows || result.cols() != cols)
+		result.resize (rows, cols);
+}
+
+struct ForwardDynamicsTask : public ParallelTask {
+	ForwardDynamicsTask (const Model &model, ParallelDynamicsWorkspace &ws,
+			const MatrixNd &Q, const MatrixNd &QDot, const MatrixNd &Tau, MatrixNd &QDDot) :
+		model (model), ws (ws), Q (Q), QDot (QDot), Tau (Tau), QDDot (QDDot)
+	{}
+
+	void Run (unsigned int worker_id, unsigned int begin, unsigned int end) {
+		VectorNd &q = ws.worker_q[worker_id];
+		VectorNd &qdot = ws.worker_qdot[worker_id];
+		VectorNd &tau = ws.worker_tau[worker_id];
+		VectorNd &qddot = ws.worker_qddot[worker_id];
+
+		for (unsigned int k = begin; k < end; k++) {
+			q = Q.col(k);
+			qdot = QDot.col(k);
+			tau = Tau.col(k);
+
+			ForwardDynamics (model, ws.worker_ws[worker_id], q, qdot, tau, qddot);
+
+			QDDot.col(k) = qddot;
+		}
+	}
+
+	const Model &model;
+	ParallelDynamicsWorkspace &ws;
+	const MatrixNd &Q;
+	const MatrixNd &QDot;
+	const MatrixNd &Tau;
+	MatrixNd &QDDot;
+};
+
+RBDL_DLLAPI
+void ForwardDynamicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		const MatrixNd &Tau,
+		MatrixNd &QDDot
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (Q.cols() == QDot.cols() && Q.cols() == Tau.cols());
+
+	parallel_prepare (model, ws, QDDot, model.qdot_size, Q.cols());
+
+	ForwardDynamicsTask task (model, ws, Q, QDot, Tau, QDDot);
+	ws.pool->ParallelFor (Q.cols(), task, ws.chunk_size);
+}
+
+struct InverseDynamicsTask : public ParallelTask {
+	InverseDynamicsTask (const Model &model, ParallelDynamicsWorkspace &ws,
+			const MatrixNd &Q, const MatrixNd &QDot, const MatrixNd &QDDot, MatrixNd &Tau) :
+		model (model), ws (ws), Q (Q), QDot (QDot), QDDot (QDDot), Tau (Tau)
+	{}
+
+	void Run (unsigned int worker_id, unsigned int begin, unsigned int end) {
+		VectorNd &q = ws.worker_q[worker_id];
+		VectorNd &qdot = ws.worker_qdot[worker_id];
+		VectorNd &qddot = ws.worker_qddot[worker_id];
+		VectorNd &tau = ws.worker_tau[worker_id];
+
+		for (unsigned int k = begin; k < end; k++) {
+			q = Q.col(k);
+			qdot = QDot.col(k);
+			qddot = QDDot.col(k);
+
+			InverseDynamics (model, ws.worker_ws[worker_id], q, qdot, qddot, tau);
+
+			Tau.col(k) = tau;
+		}
+	}
+
+	const Model &model;
+	ParallelDynamicsWorkspace &ws;
+	const MatrixNd &Q;
+	const MatrixNd &QDot;
+	const MatrixNd &QDDot;
+	MatrixNd &Tau;
+};
+
+RBDL_DLLAPI
+void InverseDynamicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		const MatrixNd &QDDot,
+		MatrixNd &Tau
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (Q.cols() == QDot.cols() && Q.cols() == QDDot.cols());
+
+	parallel_prepare (model, ws, Tau, model.qdot_size, Q.cols());
+
+	InverseDynamicsTask task (model, ws, Q, QDot, QDDot, Tau);
+	ws.pool->ParallelFor (Q.cols(), task, ws.chunk_size);
+}
+
+struct CompositeRigidBodyAlgorithmTask : public ParallelTask {
+	CompositeRigidBodyAlgorithmTask (const Model &model, ParallelDynamicsWorkspace &ws,
+			const MatrixNd &Q, std::vector<MatrixNd> &H) :
+		model (model), ws (ws), Q (Q), H (H)
+	{}
+
+	void Run (unsigned int worker_id, unsigned int begin, unsigned int end) {
+		VectorNd &q = ws.worker_q[worker_id];
+
+		for (unsigned int k = begin; k < end; k++) {
+			q = Q.col(k);
+
+			H[k].setZero();
+			CompositeRigidBodyAlgorithm (model, ws.worker_ws[worker_id], q, H[k], true);
+		}
+	}
+
+	const Model &model;
+	ParallelDynamicsWorkspace &ws;
+	const MatrixNd &Q;
+	std::vector<MatrixNd> &H;
+};
+
+RBDL_DLLAPI
+void CompositeRigidBodyAlgorithmParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const MatrixNd &Q,
+		std::vector<MatrixNd> &H
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	if (ws.pool == NULL || ws.worker_ws[0].v.size() != model.mBodies.size())
+		ws.Init (model, ws.GetThreadCount());
+
+	H.resize (Q.cols());
+	for (unsigned int k = 0; k < H.size(); k++) {
+		if (H[k].rows() != model.qdot_size || H[k].cols() != model.qdot_size)
+			H[k].resize (model.qdot_size, model.qdot_size);
+	}
+
+	CompositeRigidBodyAlgorithmTask task (model, ws, Q, H);
+	ws.pool->ParallelFor (Q.cols(), task, ws.chunk_size);
+}
+
+struct ForwardDynamicsContactsTask : public ParallelTask {
+	ForwardDynamicsContactsTask (const Model &model, ParallelDynamicsWorkspace &ws,
+			const MatrixNd &Q, const MatrixNd &QDot, const MatrixNd &Tau,
+			const ConstraintSet &CS, MatrixNd &QDDot,
+			ForwardDynamicsContactsFunction method, MatrixNd *Forces) :
+		model (model), ws (ws), Q (Q), QDot (QDot), Tau (Tau), CS (CS), QDDot (QDDot),
+		method (method), Forces (Forces)
+	{}
+
+	void Run (unsigned int worker_id, unsigned int begin, unsigned int end) {
+		VectorNd &q = ws.worker_q[worker_id];
+		VectorNd &qdot = ws.worker_qdot[worker_id];
+		VectorNd &tau = ws.worker_tau[worker_id];
+		VectorNd &qddot = ws.worker_qddot[worker_id];
+		ConstraintSet &worker_CS = ws.worker_CS[worker_id];
+
+		for (unsigned int k = begin; k < end; k++) {
+			q = Q.col(k);
+			qdot = QDot.col(k);
+			tau = Tau.col(k);
+
+			// every state starts from the forces of CS, as the friction
+			// solver is warm started from them
+			worker_CS.force = CS.force;
+
+			method (model, ws.worker_ws[worker_id], q, qdot, tau, worker_CS, qddot);
+
+			QDDot.col(k) = qddot;
+
+			if (Forces)
+				Forces->col(k) = worker_CS.force;
+		}
+	}
+
+	const Model &model;
+	ParallelDynamicsWorkspace &ws;
+	const MatrixNd &Q;
+	const MatrixNd &QDot;
+	const MatrixNd &Tau;
+	const ConstraintSet &CS;
+	MatrixNd &QDDot;
+	ForwardDynamicsContactsFunction method;
+	MatrixNd *Forces;
+};
+
+/** \brief Copies the constraint definitions of source into the worker copy
+ *
+ * The copy is only bound again if the bodies or the number of constraints
+ * changed, as these determine its workspace. All other definitions are
+ * copied on every call since the source may have been modified in place.
+ */
+static void copy_worker_constraints (
+		const Model &model,
+		const ConstraintSet &source,
+		ConstraintSet &dest
+		) {
+	if (!dest.bound || dest.body != source.body) {
+		dest = source;
+		dest.bound = false;
+		dest.Bind (model);
+		return;
+	}
+
+	dest.linear_solver = source.linear_solver;
+	dest.name = source.name;
+	dest.point = source.point;
+	dest.normal = source.normal;
+	dest.acceleration = source.acceleration;
+	dest.v_plus = source.v_plus;
+	dest.unilateral = source.unilateral;
+	dest.friction_normal = source.friction_normal;
+	dest.friction_coefficient = source.friction_coefficient;
+	dest.friction_max_iterations = source.friction_max_iterations;
+	dest.friction_tolerance = source.friction_tolerance;
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsContactsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		const MatrixNd &Tau,
+		const ConstraintSet &CS,
+		MatrixNd &QDDot,
+		ForwardDynamicsContactsFunction method,
+		MatrixNd *Forces
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (Q.cols() == QDot.cols() && Q.cols() == Tau.cols());
+
+	parallel_prepare (model, ws, QDDot, model.qdot_size, Q.cols());
+
+	if (Forces && (Forces->rows() != (unsigned int) CS.size() || Forces->cols() != Q.cols()))
+		Forces->resize (CS.size(), Q.cols());
+
+	unsigned int worker_count = ws.GetThreadCount();
+
+	if (ws.worker_CS.size() != worker_count)
+		ws.worker_CS.resize (worker_count);
+
+	for (unsigned int i = 0; i < worker_count; i++) {
+		copy_worker_constraints (model, CS, ws.worker_CS[i]);
+	}
+
+	ForwardDynamicsContactsTask task (model, ws, Q, QDot, Tau, CS, QDDot, method, Forces);
+	ws.pool->ParallelFor (Q.cols(), task, ws.chunk_size);
+}
+
+/// \brief Number of frames per chunk of InverseKinematicsParallel() if
+/// ws.chunk_size is 0, independent of the number of workers
+static const unsigned int ik_default_chunk_size = 16;
+
+struct InverseKinematicsTask : public ParallelTask {
+	InverseKinematicsTask (const Model &model, ParallelDynamicsWorkspace &ws,
+			unsigned int chunk_size, const VectorNd &Qinit,
+			const std::vector<std::vector<Vector3d> > &target_positions,
+			const std::vector<std::vector<Matrix3d> > &target_orientations,
+			MatrixNd &QRes, std::vector<unsigned int> *num_steps, VectorNd *error_norms) :
+		model (model), ws (ws), chunk_size (chunk_size), Qinit (Qinit),
+		target_positions (target_positions), target_orientations (target_orientations),
+		QRes (QRes), num_steps (num_steps), error_norms (error_norms),
+		converged (ws.GetThreadCount(), 1)
+	{}
+
+	void Run (unsigned int worker_id, unsigned int begin, unsigned int end) {
+		VectorNd &q = ws.worker_q[worker_id];
+		InverseKinematicsConstraintSet &CS = ws.worker_ik_CS[worker_id];
+
+		for (unsigned int k = begin; k < end; k++) {
+			// each chunk starts from the initial guess and the initial damping
+			// (a single worker processes all frames at once)
+			if (k % chunk_size == 0) {
+				q = Qinit;
+				CS.lambda_last = 0.;
+			}
+
+			for (unsigned int c = 0; c < CS.size(); c++) {
+				if (CS.constraint_type[c] != InverseKinematicsConstraintSet::ConstraintTypeOrientation)
+					CS.target_positions[c] = target_positions[k][c];
+				if (CS.constraint_type[c] != InverseKinematicsConstraintSet::ConstraintTypePosition)
+					CS.target_orientations[c] = target_orientations[k][c];
+			}
+
+			if (!InverseKinematics (model, ws.worker_ws[worker_id], q, CS, q))
+				converged[worker_id] = 0;
+
+			QRes.col(k) = q;
+
+			if (num_steps)
+				(*num_steps)[k] = CS.num_steps;
+			if (error_norms)
+				(*error_norms)[k] = CS.error_norm;
+		}
+	}
+
+	const Model &model;
+	ParallelDynamicsWorkspace &ws;
+	unsigned int chunk_size;
+	const VectorNd &Qinit;
+	const std::vector<std::vector<Vector3d> > &target_positions;
+	const std::vector<std::vector<Matrix3d> > &target_orientations;
+	MatrixNd &QRes;
+	std::vector<unsigned int> *num_steps;
+	VectorNd *error_norms;
+	/// \brief Whether all frames of a worker converged
+	std::vector<unsigned char> converged;
+};
+
+/** \brief Copies the inverse kinematics constraints of source into the
+ * worker copy
+ *
+ * The copy is only bound again if the constraint types changed, as these
+ * determine its workspace. All other definitions are copied on every call
+ * since the source may have been modified in place. The targets are set
+ * for each frame by the task.
+ */
+static void copy_worker_ik_constraints (
+		const Model &model,
+		const InverseKinematicsConstraintSet &source,
+		InverseKinematicsConstraintSet &dest
+		) {
+	if (!dest.bound || dest.constraint_type != source.constraint_type) {
+		dest = source;
+		dest.bound = false;
+		dest.Bind (model);
+	} else {
+		dest.body_ids = source.body_ids;
+		dest.body_points = source.body_points;
+		dest.q_min = source.q_min;
+		dest.q_max = source.q_max;
+		dest.lambda = source.lambda;
+		dest.lambda_min = source.lambda_min;
+		dest.lambda_max = source.lambda_max;
+		dest.lambda_increase = source.lambda_increase;
+		dest.lambda_decrease = source.lambda_decrease;
+		dest.step_tol = source.step_tol;
+		dest.constraint_tol = source.constraint_tol;
+		dest.max_steps = source.max_steps;
+	}
+
+	dest.warm_start = true;
+}
+
+RBDL_DLLAPI
+bool InverseKinematicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const VectorNd &Qinit,
+		const InverseKinematicsConstraintSet &CS,
+		const std::vector<std::vector<Vector3d> > &target_positions,
+		const std::vector<std::vector<Matrix3d> > &target_orientations,
+		MatrixNd &QRes,
+		std::vector<unsigned int> *num_steps,
+		VectorNd *error_norms
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	unsigned int frame_count = target_positions.size() > target_orientations.size() ? target_positions.size() : target_orientations.size();
+
+	assert (Qinit.size() == model.q_size);
+	assert (target_positions.size() == 0 || target_positions.size() == frame_count);
+	assert (target_orientations.size() == 0 || target_orientations.size() == frame_count);
+
+	parallel_prepare (model, ws, QRes, model.q_size, frame_count);
+
+	if (num_steps && num_steps->size() != frame_count)
+		num_steps->resize (frame_count);
+
+	if (error_norms && error_norms->size() != frame_count)
+		error_norms->resize (frame_count);
+
+	unsigned int worker_count = ws.GetThreadCount();
+
+	if (ws.worker_ik_CS.size() != worker_count)
+		ws.worker_ik_CS.resize (worker_count);
+
+	for (unsigned int i = 0; i < worker_count; i++) {
+		copy_worker_ik_constraints (model, CS, ws.worker_ik_CS[i]);
+	}
+
+	unsigned int chunk_size = ws.chunk_size != 0 ? ws.chunk_size : ik_default_chunk_size;
+
+	InverseKinematicsTask task (model, ws, chunk_size, Qinit, target_positions, target_orientations, QRes, num_steps, error_norms);
+	ws.pool->ParallelFor (frame_count, task, chunk_size);
+
+	for (unsigned int i = 0; i < worker_count; i++) {
+		if (!task.converged[i])
+			return false;
+	}
+
+	return true;
+}
+
+RBDL_DLLAPI
+bool InverseKinematicsParallel (
+		const Model &model,
+		ParallelDynamicsWorkspace &ws,
+		const VectorNd &Qinit,
+		const std::vector<unsigned int>& body_id,
+		const std::vector<Vector3d>& body_point,
+		const std::vector<std::vector<Vector3d> > &target_pos,
+		MatrixNd &QRes,
+		double step_tol,
+		double lambda,
+		unsigned int max_iter,
+		std::vector<unsigned int> *num_steps,
+		VectorNd *error_norms
+		) {
+	assert (body_id.size() == body_point.size());
+
+	InverseKinematicsConstraintSet CS;
+
+	for (unsigned int i = 0; i < body_id.size(); i++) {
+		CS.AddPointConstraint (body_id[i], body_point[i], Vector3d::Zero());
+	}
+
+	CS.step_tol = step_tol;
+	CS.constraint_tol = step_tol;
+	CS.lambda = lambda;
+	CS.max_steps = max_iter;
+
+	return InverseKinematicsParallel (model, ws, Qinit, CS, target_pos, std::vector<std::vector<Matrix3d> >(), QRes, num_steps, error_norms);
+}
+
+} /* namespace RigidBodyDynamics */
@@ -0,0 +1,646 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include <iostream>
+#include <limits>
+#include <assert.h>
+
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Joint.h"
+#include "rbdl/Body.h"
+#include "rbdl/DynamicsSIMD.h"
+
+namespace RigidBodyDynamics {
+
+using namespace Math;
+
+template <unsigned int L>
+SIMDDynamicsWorkspace<L>::SIMDDynamicsWorkspace (const Model &model) {
+	Init (model);
+}
+
+template <unsigned int L>
+void SIMDDynamicsWorkspace<L>::Init (const Model &model) {
+	unsigned int body_count = model.mBodies.size();
+
+	X_lambda.resize (body_count);
+	v.resize (body_count);
+	a.resize (body_count);
+	c.resize (body_count);
+	IA.resize (body_count);
+	pA.resize (body_count);
+	U.resize (body_count);
+	d.resize (body_count);
+	u.resize (body_count);
+	f.resize (body_count);
+
+	for (unsigned int i = 0; i < body_count; i++) {
+		v[i].setZero();
+		a[i].setZero();
+		c[i].setZero();
+		IA[i].setZero();
+		pA[i].setZero();
+		U[i].setZero();
+		d[i].setZero();
+		u[i].setZero();
+		f[i].setZero();
+	}
+
+	bool has_multdof3 = false;
+	for (unsigned int i = 1; i < model.mJoints.size(); i++) {
+		if (model.mJoints[i].mDoFCount == 3)
+			has_multdof3 = true;
+	}
+
+	if (has_multdof3) {
+		multdof3_S.resize (body_count);
+		multdof3_U.resize (body_count);
+		multdof3_Dinv.resize (body_count);
+		multdof3_u.resize (body_count);
+
+		for (unsigned int i = 0; i < body_count; i++) {
+			multdof3_S[i].setZero();
+			multdof3_U[i].setZero();
+			multdof3_Dinv[i].setZero();
+			multdof3_u[i].setZero();
+		}
+	} else {
+		multdof3_S.clear();
+		multdof3_U.clear();
+		multdof3_Dinv.clear();
+		multdof3_u.clear();
+	}
+
+	v_J.setZero();
+	c_J.setZero();
+
+	Q = MatrixNd::Zero (model.q_size, L);
+	QDot = MatrixNd::Zero (model.qdot_size, L);
+
+	lane_X_lambda.assign (L, SpatialTransform());
+	lane_v_J.assign (L, SpatialVector::Zero());
+	lane_c_J.assign (L, SpatialVector::Zero());
+	lane_S.assign (L, Matrix63::Zero());
+}
+
+/** \brief Copies the columns [first_col, first_col + L) of the states
+ * into the chunk of the workspace.
+ *
+ * If fewer than L columns are available, the last column is repeated in
+ * the remaining lanes. The column index of every lane is stored in cols.
+ *
+ * \returns the number of lanes that contain valid states
+ */
+template <unsigned int L>
+static unsigned int simd_load_chunk (
+		SIMDDynamicsWorkspace<L> &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		unsigned int first_col,
+		unsigned int *cols
+		) {
+	unsigned int lane_count = Q.cols() - first_col;
+	if (lane_count > L)
+		lane_count = L;
+
+	for (unsigned int l = 0; l < L; l++) {
+		cols[l] = first_col + (l < lane_count ? l : lane_count - 1);
+
+		for (unsigned int row = 0; row < Q.rows(); row++)
+			ws.Q(row, l) = Q(row, cols[l]);
+		for (unsigned int row = 0; row < QDot.rows(); row++)
+			ws.QDot(row, l) = QDot(row, cols[l]);
+	}
+
+	return lane_count;
+}
+
+/** \brief Computes the joint variables of body i for all lanes of the chunk
+ */
+template <unsigned int L>
+static void simd_jcalc (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		unsigned int i
+		) {
+	bool multdof3 = model.mJoints[i].mDoFCount == 3;
+
+	if (multdof3) {
+		// the joint kernels only write the non-zero entries of S
+		for (unsigned int l = 0; l < L; l++)
+			ws.lane_S[l].setZero();
+	}
+
+	jcalc_batch (model, i, ws.Q, ws.QDot,
+			&ws.lane_X_lambda[0],
+			&ws.lane_v_J[0],
+			&ws.lane_c_J[0],
+			multdof3 ? &ws.lane_S[0] : NULL);
+
+	for (unsigned int l = 0; l < L; l++) {
+		ws.X_lambda[i].setLane (l, ws.lane_X_lambda[l]);
+		ws.v_J.setLane (l, ws.lane_v_J[l]);
+		ws.c_J.setLane (l, ws.lane_c_J[l]);
+
+		if (multdof3)
+			ws.multdof3_S[i].setLane (l, ws.lane_S[l]);
+	}
+}
+
+template <unsigned int L>
+RBDL_DLLAPI
+void ForwardDynamicsSIMD (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		const MatrixNd &Tau,
+		MatrixNd &QDDot
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (Q.cols() == QDot.cols());
+	assert (Q.cols() == Tau.cols());
+
+	unsigned int N = Q.cols();
+	unsigned int body_count = model.mBodies.size();
+
+	if (ws.v.size() != body_count)
+		ws.Init (model);
+
+	if (QDDot.rows() != model.qdot_size || QDDot.cols() != N)
+		QDDot.resize (model.qdot_size, N);
+
+	SpatialVector spatial_gravity (0., 0., 0., model.gravity[0], model.gravity[1], model.gravity[2]);
+
+	SpatialMatrix I_matrix;
+	SIMDSpatialVector<L> temp;
+	SIMDSpatialVector<L> pa;
+	SIMDSpatialMatrix<L> Ia;
+	SIMDVector3d<L> tau_3;
+	SIMDScalar<L> tau_1;
+	SIMDVector3d<L> qdd_3;
+	SIMDScalar<L> qdd_1;
+	SIMDVector3d<L> u_3;
+	SIMDScalar<L> d_inv;
+	SIMDMatrix3d<L> D;
+	SIMDMatrix63<L> UDinv;
+
+	unsigned int cols[L];
+
+	for (unsigned int first_col = 0; first_col < N; first_col += L) {
+		unsigned int lane_count = simd_load_chunk (ws, Q, QDot, first_col, cols);
+
+		// Reset the velocity of the root body
+		ws.v[0].setZero();
+
+		for (unsigned int i = 1; i < body_count; i++) {
+			unsigned int lambda = model.lambda[i];
+
+			simd_jcalc (model, ws, i);
+
+			ws.X_lambda[i].apply (ws.v[lambda], ws.v[i]);
+			ws.v[i] += ws.v_J;
+
+			crossm (ws.v[i], ws.v_J, ws.c[i]);
+			ws.c[i] += ws.c_J;
+
+			model.I[i].setSpatialMatrix (I_matrix);
+			ws.IA[i].setBroadcast (I_matrix);
+
+			apply (model.I[i], ws.v[i], temp);
+			crossf (ws.v[i], temp, ws.pA[i]);
+		}
+
+		for (unsigned int i = body_count - 1; i > 0; i--) {
+			unsigned int q_index = model.mJoints[i].q_index;
+			unsigned int lambda = model.lambda[i];
+			const SIMDSpatialMatrix<L> &IA = ws.IA[i];
+			const SIMDSpatialVector<L> &pA = ws.pA[i];
+
+			if (model.mJoints[i].mDoFCount == 3) {
+				const SIMDMatrix63<L> &S = ws.multdof3_S[i];
+				SIMDMatrix63<L> &U = ws.multdof3_U[i];
+				SIMDMatrix3d<L> &Dinv = ws.multdof3_Dinv[i];
+				SIMDVector3d<L> &u = ws.multdof3_u[i];
+
+				for (unsigned int j = 0; j < 3; j++)
+					for (unsigned int l = 0; l < L; l++)
+						tau_3.data[j][l] = Tau(q_index + j, cols[l]);
+
+				// U = IA * S
+				for (unsigned int row = 0; row < 6; row++) {
+					for (unsigned int j = 0; j < 3; j++) {
+						for (unsigned int l = 0; l < L; l++) {
+							U.data[row * 3 + j][l] =
+								IA.data[row * 6 + 0][l] * S.data[0 * 3 + j][l]
+								+ IA.data[row * 6 + 1][l] * S.data[1 * 3 + j][l]
+								+ IA.data[row * 6 + 2][l] * S.data[2 * 3 + j][l]
+								+ IA.data[row * 6 + 3][l] * S.data[3 * 3 + j][l]
+								+ IA.data[row * 6 + 4][l] * S.data[4 * 3 + j][l]
+								+ IA.data[row * 6 + 5][l] * S.data[5 * 3 + j][l];
+						}
+					}
+				}
+
+				// D = S^T * U
+				for (unsigned int j = 0; j < 3; j++) {
+					for (unsigned int k = 0; k < 3; k++) {
+						for (unsigned int l = 0; l < L; l++) {
+							D.data[j * 3 + k][l] =
+								S.data[0 * 3 + j][l] * U.data[0 * 3 + k][l]
+								+ S.data[1 * 3 + j][l] * U.data[1 * 3 + k][l]
+								+ S.data[2 * 3 + j][l] * U.data[2 * 3 + k][l]
+								+ S.data[3 * 3 + j][l] * U.data[3 * 3 + k][l]
+								+ S.data[4 * 3 + j][l] * U.data[4 * 3 + k][l]
+								+ S.data[5 * 3 + j][l] * U.data[5 * 3 + k][l];
+						}
+					}
+				}
+
+				// Dinv = D^-1
+				for (unsigned int l = 0; l < L; l++) {
+					double d0 = D.data[0][l], d1 = D.data[1][l], d2 = D.data[2][l];
+					double d3 = D.data[3][l], d4 = D.data[4][l], d5 = D.data[5][l];
+					double d6 = D.data[6][l], d7 = D.data[7][l], d8 = D.data[8][l];
+
+					double C0 = d4 * d8 - d5 * d7;
+					double C1 = d5 * d6 - d3 * d8;
+					double C2 = d3 * d7 - d4 * d6;
+					double det_inv = 1. / (d0 * C0 + d1 * C1 + d2 * C2);
+
+					Dinv.data[0][l] = C0 * det_inv;
+					Dinv.data[1][l] = (d2 * d7 - d1 * d8) * det_inv;
+					Dinv.data[2][l] = (d1 * d5 - d2 * d4) * det_inv;
+					Dinv.data[3][l] = C1 * det_inv;
+					Dinv.data[4][l] = (d0 * d8 - d2 * d6) * det_inv;
+					Dinv.data[5][l] = (d2 * d3 - d0 * d5) * det_inv;
+					Dinv.data[6][l] = C2 * det_inv;
+					Dinv.data[7][l] = (d1 * d6 - d0 * d7) * det_inv;
+					Dinv.data[8][l] = (d0 * d4 - d1 * d3) * det_inv;
+				}
+
+				// u = tau - S^T * pA
+				for (unsigned int j = 0; j < 3; j++) {
+					for (unsigned int l = 0; l < L; l++) {
+						u.data[j][l] = tau_3.data[j][l]
+							- (S.data[0 * 3 + j][l] * pA.data[0][l]
+									+ S.data[1 * 3 + j][l] * pA.data[1][l]
+									+ S.data[2 * 3 + j][l] * pA.data[2][l]
+									+ S.data[3 * 3 + j][l] * pA.data[3][l]
+									+ S.data[4 * 3 + j][l] * pA.data[4][l]
+									+ S.data[5 * 3 + j][l] * pA.data[5][l]);
+					}
+				}
+
+				if (lambda != 0) {
+					// UDinv = U * Dinv
+					for (unsigned int row = 0; row < 6; row++) {
+						for (unsigned int j = 0; j < 3; j++) {
+							for (unsigned int l = 0; l < L; l++) {
+								UDinv.data[row * 3 + j][l] =
+									U.data[row * 3 + 0][l] * Dinv.data[0 * 3 + j][l]
+									+ U.data[row * 3 + 1][l] * Dinv.data[1 * 3 + j][l]
+									+ U.data[row * 3 + 2][l] * Dinv.data[2 * 3 + j][l];
+							}
+						}
+					}
+
+					// Ia = IA - U * Dinv * U^T
+					for (unsigned int row = 0; row < 6; row++) {
+						for (unsigned int col = 0; col < 6; col++) {
+							for (unsigned int l = 0; l < L; l++) {
+								Ia.data[row * 6 + col][l] = IA.data[row * 6 + col][l]
+									- UDinv.data[row * 3 + 0][l] * U.data[col * 3 + 0][l]
+									- UDinv.data[row * 3 + 1][l] * U.data[col * 3 + 1][l]
+									- UDinv.data[row * 3 + 2][l] * U.data[col * 3 + 2][l];
+							}
+						}
+					}
+
+					// pa = pA + U * Dinv * u (Ia * c is added below)
+					for (unsigned int row = 0; row < 6; row++) {
+						for (unsigned int l = 0; l < L; l++) {
+							pa.data[row][l] = pA.data[row][l]
+								+ UDinv.data[row * 3 + 0][l] * u.data[0][l]
+								+ UDinv.data[row * 3 + 1][l] * u.data[1][l]
+								+ UDinv.data[row * 3 + 2][l] * u.data[2][l];
+						}
+					}
+				}
+			} else {
+				const SpatialVector &S = model.S[i];
+				SIMDSpatialVector<L> &U = ws.U[i];
+				SIMDScalar<L> &d = ws.d[i];
+				SIMDScalar<L> &u = ws.u[i];
+
+				for (unsigned int l = 0; l < L; l++)
+					tau_1.data[l] = Tau(q_index, cols[l]);
+
+				// U = IA * S
+				for (unsigned int row = 0; row < 6; row++) {
+					for (unsigned int l = 0; l < L; l++) {
+						U.data[row][l] =
+							IA.data[row * 6 + 0][l] * S[0]
+							+ IA.data[row * 6 + 1][l] * S[1]
+							+ IA.data[row * 6 + 2][l] * S[2]
+							+ IA.data[row * 6 + 3][l] * S[3]
+							+ IA.data[row * 6 + 4][l] * S[4]
+							+ IA.data[row * 6 + 5][l] * S[5];
+					}
+				}
+
+				for (unsigned int l = 0; l < L; l++) {
+					d.data[l] = S[0] * U.data[0][l] + S[1] * U.data[1][l] + S[2] * U.data[2][l]
+						+ S[3] * U.data[3][l] + S[4] * U.data[4][l] + S[5] * U.data[5][l];
+					u.data[l] = tau_1.data[l]
+						- (S[0] * pA.data[0][l] + S[1] * pA.data[1][l] + S[2] * pA.data[2][l]
+							+ S[3] * pA.data[3][l] + S[4] * pA.data[4][l] + S[5] * pA.data[5][l]);
+					d_inv.data[l] = 1. / d.data[l];
+				}
+
+				if (lambda != 0) {
+					// Ia = IA - U * U^T / d
+					for (unsigned int row = 0; row < 6; row++) {
+						for (unsigned int col = 0; col < 6; col++) {
+							for (unsigned int l = 0; l < L; l++) {
+								Ia.data[row * 6 + col][l] = IA.data[row * 6 + col][l]
+									- U.data[row][l] * U.data[col][l] * d_inv.data[l];
+							}
+						}
+					}
+
+					// pa = pA + U * u / d (Ia * c is added below)
+					for (unsigned int row = 0; row < 6; row++) {
+						for (unsigned int l = 0; l < L; l++) {
+							pa.data[row][l] = pA.data[row][l] + U.data[row][l] * u.data[l] * d_inv.data[l];
+						}
+					}
+				}
+			}
+
+			if (lambda != 0) {
+				Ia.apply (ws.c[i], temp);
+				pa += temp;
+
+				ws.X_lambda[i].addTransposeProduct (Ia, ws.IA[lambda]);
+				ws.X_lambda[i].applyTranspose (pa, temp);
+				ws.pA[lambda] += temp;
+			}
+		}
+
+		ws.a[0].setBroadcast (spatial_gravity * -1.);
+
+		for (unsigned int i = 1; i < body_count; i++) {
+			unsigned int q_index = model.mJoints[i].q_index;
+			unsigned int lambda = model.lambda[i];
+			SIMDSpatialVector<L> &a = ws.a[i];
+
+			ws.X_lambda[i].apply (ws.a[lambda], a);
+			a += ws.c[i];
+
+			if (model.mJoints[i].mDoFCount == 3) {
+				const SIMDMatrix63<L> &S = ws.multdof3_S[i];
+				const SIMDMatrix63<L> &U = ws.multdof3_U[i];
+				const SIMDMatrix3d<L> &Dinv = ws.multdof3_Dinv[i];
+				const SIMDVector3d<L> &u = ws.multdof3_u[i];
+
+				// qdd = Dinv * (u - U^T * a)
+				for (unsigned int j = 0; j < 3; j++) {
+					for (unsigned int l = 0; l < L; l++) {
+						u_3.data[j][l] = u.data[j][l]
+							- (U.data[0 * 3 + j][l] * a.data[0][l]
+									+ U.data[1 * 3 + j][l] * a.data[1][l]
+									+ U.data[2 * 3 + j][l] * a.data[2][l]
+									+ U.data[3 * 3 + j][l] * a.data[3][l]
+									+ U.data[4 * 3 + j][l] * a.data[4][l]
+									+ U.data[5 * 3 + j][l] * a.data[5][l]);
+					}
+				}
+
+				for (unsigned int j = 0; j < 3; j++) {
+					for (unsigned int l = 0; l < L; l++) {
+						qdd_3.data[j][l] = Dinv.data[j * 3 + 0][l] * u_3.data[0][l]
+							+ Dinv.data[j * 3 + 1][l] * u_3.data[1][l]
+							+ Dinv.data[j * 3 + 2][l] * u_3.data[2][l];
+					}
+				}
+
+				// a = a + S * qdd
+				for (unsigned int row = 0; row < 6; row++) {
+					for (unsigned int l = 0; l < L; l++) {
+						a.data[row][l] += S.data[row * 3 + 0][l] * qdd_3.data[0][l]
+							+ S.data[row * 3 + 1][l] * qdd_3.data[1][l]
+							+ S.data[row * 3 + 2][l] * qdd_3.data[2][l];
+					}
+				}
+
+				for (unsigned int l = 0; l < lane_count; l++) {
+					QDDot(q_index, cols[l]) = qdd_3.data[0][l];
+					QDDot(q_index + 1, cols[l]) = qdd_3.data[1][l];
+					QDDot(q_index + 2, cols[l]) = qdd_3.data[2][l];
+				}
+			} else {
+				const SpatialVector &S = model.S[i];
+				const SIMDSpatialVector<L> &U = ws.U[i];
+				const SIMDScalar<L> &d = ws.d[i];
+				const SIMDScalar<L> &u = ws.u[i];
+
+				for (unsigned int l = 0; l < L; l++) {
+					double U_a = U.data[0][l] * a.data[0][l] + U.data[1][l] * a.data[1][l]
+						+ U.data[2][l] * a.data[2][l] + U.data[3][l] * a.data[3][l]
+						+ U.data[4][l] * a.data[4][l] + U.data[5][l] * a.data[5][l];
+					qdd_1.data[l] = (1. / d.data[l]) * (u.data[l] - U_a);
+				}
+
+				for (unsigned int row = 0; row < 6; row++) {
+					for (unsigned int l = 0; l < L; l++)
+						a.data[row][l] += S[row] * qdd_1.data[l];
+				}
+
+				for (unsigned int l = 0; l < lane_count; l++)
+					QDDot(q_index, cols[l]) = qdd_1.data[l];
+			}
+		}
+	}
+}
+
+/** \brief Recursive Newton-Euler Algorithm for all chunks of the states
+ *
+ * If QDDot is NULL the accelerations are assumed to be zero which yields
+ * the nonlinear effects.
+ */
+template <unsigned int L>
+static void simd_rnea (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		const MatrixNd *QDDot,
+		MatrixNd &Tau
+		) {
+	assert (Q.cols() == QDot.cols());
+	assert (QDDot == NULL || Q.cols() == QDDot->cols());
+
+	unsigned int N = Q.cols();
+	unsigned int body_count = model.mBodies.size();
+
+	if (ws.v.size() != body_count)
+		ws.Init (model);
+
+	if (Tau.rows() != model.qdot_size || Tau.cols() != N)
+		Tau.resize (model.qdot_size, N);
+
+	SpatialVector spatial_gravity (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
+
+	SIMDSpatialVector<L> temp;
+	SIMDSpatialVector<L> temp_f;
+
+	unsigned int cols[L];
+
+	for (unsigned int first_col = 0; first_col < N; first_col += L) {
+		unsigned int lane_count = simd_load_chunk (ws, Q, QDot, first_col, cols);
+
+		// Reset the velocity of the root body
+		ws.v[0].setZero();
+		ws.a[0].setBroadcast (spatial_gravity);
+
+		for (unsigned int i = 1; i < body_count; i++) {
+			unsigned int q_index = model.mJoints[i].q_index;
+			unsigned int lambda = model.lambda[i];
+			SIMDSpatialVector<L> &v = ws.v[i];
+			SIMDSpatialVector<L> &a = ws.a[i];
+
+			simd_jcalc (model, ws, i);
+
+			ws.X_lambda[i].apply (ws.v[lambda], v);
+			v += ws.v_J;
+
+			crossm (v, ws.v_J, ws.c[i]);
+			ws.c[i] += ws.c_J;
+
+			ws.X_lambda[i].apply (ws.a[lambda], a);
+			a += ws.c[i];
+
+			if (QDDot != NULL) {
+				if (model.mJoints[i].mDoFCount == 3) {
+					const SIMDMatrix63<L> &S = ws.multdof3_S[i];
+
+					for (unsigned int l = 0; l < L; l++) {
+						double qdd0 = (*QDDot)(q_index, cols[l]);
+						double qdd1 = (*QDDot)(q_index + 1, cols[l]);
+						double qdd2 = (*QDDot)(q_index + 2, cols[l]);
+
+						for (unsigned int row = 0; row < 6; row++) {
+							a.data[row][l] += S.data[row * 3 + 0][l] * qdd0
+								+ S.data[row * 3 + 1][l] * qdd1
+								+ S.data[row * 3 + 2][l] * qdd2;
+						}
+					}
+				} else {
+					const SpatialVector &S = model.S[i];
+
+					for (unsigned int l = 0; l < L; l++) {
+						double qdd = (*QDDot)(q_index, cols[l]);
+
+						for (unsigned int row = 0; row < 6; row++)
+							a.data[row][l] += S[row] * qdd;
+					}
+				}
+			}
+
+			if (!model.mBodies[i].mIsVirtual) {
+				apply (model.I[i], a, ws.f[i]);
+				apply (model.I[i], v, temp);
+				crossf (v, temp, temp_f);
+				ws.f[i] += temp_f;
+			} else {
+				ws.f[i].setZero();
+			}
+		}
+
+		for (unsigned int i = body_count - 1; i > 0; i--) {
+			unsigned int q_index = model.mJoints[i].q_index;
+			const SIMDSpatialVector<L> &f = ws.f[i];
+
+			if (model.mJoints[i].mDoFCount == 3) {
+				const SIMDMatrix63<L> &S = ws.multdof3_S[i];
+
+				for (unsigned int l = 0; l < lane_count; l++) {
+					for (unsigned int j = 0; j < 3; j++) {
+						double sum = 0.;
+						for (unsigned int row = 0; row < 6; row++)
+							sum += S.data[row * 3 + j][l] * f.data[row][l];
+						Tau(q_index + j, cols[l]) = sum;
+					}
+				}
+			} else {
+				const SpatialVector &S = model.S[i];
+
+				for (unsigned int l = 0; l < lane_count; l++) {
+					Tau(q_index, cols[l]) = S[0] * f.data[0][l] + S[1] * f.data[1][l]
+						+ S[2] * f.data[2][l] + S[3] * f.data[3][l]
+						+ S[4] * f.data[4][l] + S[5] * f.data[5][l];
+				}
+			}
+
+			if (model.lambda[i] != 0) {
+				ws.X_lambda[i].applyTranspose (f, temp);
+				ws.f[model.lambda[i]] += temp;
+			}
+		}
+	}
+}
+
+template <unsigned int L>
+RBDL_DLLAPI
+void InverseDynamicsSIMD (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		const MatrixNd &QDDot,
+		MatrixNd &Tau
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	simd_rnea (model, ws, Q, QDot, &QDDot, Tau);
+}
+
+template <unsigned int L>
+RBDL_DLLAPI
+void NonlinearEffectsSIMD (
+		const Model &model,
+		SIMDDynamicsWorkspace<L> &ws,
+		const MatrixNd &Q,
+		const MatrixNd &QDot,
+		MatrixNd &Tau
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	simd_rnea<L> (model, ws, Q, QDot, NULL, Tau);
+}
+
+// Explicit instantiations for the supported lane counts (L = 1 is the
+// scalar fallback).
+#define RBDL_INSTANTIATE_SIMD_DYNAMICS(L) \
+	template struct SIMDDynamicsWorkspace<L>; \
+	template RBDL_DLLAPI void ForwardDynamicsSIMD<L> (const Model &, SIMDDynamicsWorkspace<L> &, const MatrixNd &, const MatrixNd &, const MatrixNd &, MatrixNd &); \
+	template RBDL_DLLAPI void InverseDynamicsSIMD<L> (const Model &, SIMDDynamicsWorkspace<L> &, const MatrixNd &, const MatrixNd &, const MatrixNd &, MatrixNd &); \
+	template RBDL_DLLAPI void NonlinearEffectsSIMD<L> (const Model &, SIMDDynamicsWorkspace<L> &, const MatrixNd &, const MatrixNd &, MatrixNd &);
+
+RBDL_INSTANTIATE_SIMD_DYNAMICS(1)
+RBDL_INSTANTIATE_SIMD_DYNAMICS(2)
+RBDL_INSTANTIATE_SIMD_DYNAMICS(4)
+RBDL_INSTANTIATE_SIMD_DYNAMICS(8)
+
+#undef RBDL_INSTANTIATE_SIMD_DYNAMICS
+
+} /* namespace RigidBodyDynamics */
@@ -0,0 +1,57 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Joint.h"
+#include "rbdl/FixedTopology.h"
+
+namespace RigidBodyDynamics {
+
+static const char *fixed_topology_joint_type_name (JointType joint_type) {
+	switch (joint_type) {
+		case JointTypeRevolute: return "JointTypeRevolute";
+		case JointTypePrismatic: return "JointTypePrismatic";
+		case JointTypeRevoluteX: return "JointTypeRevoluteX";
+		case JointTypeRevoluteY: return "JointTypeRevoluteY";
+		case JointTypeRevoluteZ: return "JointTypeRevoluteZ";
+		default: return NULL;
+	}
+}
+
+RBDL_DLLAPI
+bool WriteFixedTopology (const Model &model, const std::string &name, std::ostream &out) {
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		if (model.mJoints[i].mDoFCount != 1
+				|| fixed_topology_joint_type_name (model.mJoints[i].mJointType) == NULL) {
+			LOG << "Joint of body " << i << " is not supported by FixedModel" << std::endl;
+			return false;
+		}
+	}
+
+	out << "struct " << name << " {" << std::endl
+		<< "\tenum { body_count = " << model.mBodies.size()
+		<< ", dof_count = " << model.dof_count << " };" << std::endl
+		<< "\ttemplate <unsigned int body_id> struct Body;" << std::endl
+		<< "};" << std::endl;
+
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		out << "template <> struct " << name << "::Body<" << i << "> { enum { "
+			<< "parent = " << model.lambda[i]
+			<< ", joint_type = RigidBodyDynamics::" << fixed_topology_joint_type_name (model.mJoints[i].mJointType)
+			<< ", q_index = " << model.mJoints[i].q_index
+			<< " }; };" << std::endl;
+	}
+
+	return true;
+}
+
+}
@@ -18,9 +18,432 @@ namespace RigidBodyDynamics {
 
 	using namespace Math;
 
+	/* Joint kernels
+	 *
+	 * Each kernel computes the joint transformation X_J, the joint velocity
+	 * v_J, the velocity product acceleration c_J and (for joints with three
+	 * degrees of freedom) the motion subspace of a single joint type. The
+	 * values of q and qdot are passed as raw pointers so that the same
+	 * kernels can be used for single states and for the columns of the
+	 * batched state matrices.
+	 */
+
+	static inline void jcalc_revolute_x (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+		X_J = Xrotx (q[q_index]);
+		v_J.set (qdot[q_index], 0., 0., 0., 0., 0.);
+		c_J.setZero();
+	}
+
+	static inline void jcalc_revolute_y (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+		X_J = Xroty (q[q_index]);
+		v_J.set (0., qdot[q_index], 0., 0., 0., 0.);
+		c_J.setZero();
+	}
+
+	static inline void jcalc_revolute_z (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+		X_J = Xrotz (q[q_index]);
+		v_J.set (0., 0., qdot[q_index], 0., 0., 0.);
+		c_J.setZero();
+	}
+
+	static inline void jcalc_revolute (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &) {
+		const Joint &joint = model.mJoints[joint_id];
+		X_J = Xrot (q[joint.q_index], Vector3d (
+					joint.mJointAxes[0][0],
+					joint.mJointAxes[0][1],
+					joint.mJointAxes[0][2]
+					));
+		v_J = model.S[joint_id] * qdot[joint.q_index];
+		c_J.setZero();
+	}
+
+	static inline void jcalc_prismatic (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &) {
+		const Joint &joint = model.mJoints[joint_id];
+		X_J = Xtrans (Vector3d (
+					joint.mJointAxes[0][3] * q[joint.q_index],
+					joint.mJointAxes[0][4] * q[joint.q_index],
+					joint.mJointAxes[0][5] * q[joint.q_index]
+					)
+				);
+		v_J = model.S[joint_id] * qdot[joint.q_index];
+		c_J.setZero();
+	}
+
+	static inline void jcalc_spherical (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+		Quaternion quat (q[q_index], q[q_index + 1], q[q_index + 2], q[model.multdof3_w_index[joint_id]]);
+
+		X_J = SpatialTransform (quat.toMatrix(), Vector3d (0., 0., 0.));
+
+		S(0,0) = 1.;
+		S(1,1) = 1.;
+		S(2,2) = 1.;
+
+		v_J.set (qdot[q_index], qdot[q_index + 1], qdot[q_index + 2], 0., 0., 0.);
+		c_J.setZero();
+	}
+
+	static inline void jcalc_euler_zyx (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		double q0 = q[q_index];
+		double q1 = q[q_index + 1];
+		double q2 = q[q_index + 2];
+
+		double s0 = sin (q0);
+		double c0 = cos (q0);
+		double s1 = sin (q1);
+		double c1 = cos (q1);
+		double s2 = sin (q2);
+		double c2 = cos (q2);
+
+		X_J.E = Matrix3d(
+				c0 * c1, s0 * c1, -s1,
+				c0 * s1 * s2 - s0 * c2, s0 * s1 * s2 + c0 * c2, c1 * s2,
+				c0 * s1 * c2 + s0 * s2, s0 * s1 * c2 - c0 * s2, c1 * c2
+				);
+		X_J.r.setZero();
+
+		S(0,0) = -s1;
+		S(0,2) = 1.;
+
+		S(1,0) = c1 * s2;
+		S(1,1) = c2;
+
+		S(2,0) = c1 * c2;
+		S(2,1) = - s2;
+
+		double qdot0 = qdot[q_index];
+		double qdot1 = qdot[q_index + 1];
+		double qdot2 = qdot[q_index + 2];
+
+		v_J = S * Vector3d (qdot0, qdot1, qdot2);
+
+		c_J.set(
+				- c1 * qdot0 * qdot1,
+				-s1 * s2 * qdot0 * qdot1 + c1 * c2 * qdot0 * qdot2 - s2 * qdot1 * qdot2,
+				-s1 * c2 * qdot0 * qdot1 - c1 * s2 * qdot0 * qdot2 - c2 * qdot1 * qdot2,
+				0., 0., 0.
+				);
+	}
+
+	static inline void jcalc_euler_xyz (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		double q0 = q[q_index];
+		double q1 = q[q_index + 1];
+		double q2 = q[q_index + 2];
+
+		double s0 = sin (q0);
+		double c0 = cos (q0);
+		double s1 = sin (q1);
+		double c1 = cos (q1);
+		double s2 = sin (q2);
+		double c2 = cos (q2);
+
+		X_J.E = Matrix3d(
+				c2 * c1, s2 * c0 + c2 * s1 * s0, s2 * s0 - c2 * s1 * c0,
+				-s2 * c1, c2 * c0 - s2 * s1 * s0, c2 * s0 + s2 * s1 * c0,
+				s1, -c1 * s0, c1 * c0
+				);
+		X_J.r.setZero();
+
+		S(0,0) = c2 * c1;
+		S(0,1) = s2;
+
+		S(1,0) = -s2 * c1;
+		S(1,1) = c2;
+
+		S(2,0) = s1;
+		S(2,2) = 1.;
+
+		double qdot0 = qdot[q_index];
+		double qdot1 = qdot[q_index + 1];
+		double qdot2 = qdot[q_index + 2];
+
+		v_J = S * Vector3d (qdot0, qdot1, qdot2);
+
+		c_J.set(
+				-s2 * c1 * qdot2 * qdot0 - c2 * s1 * qdot1 * qdot0 + c2 * qdot2 * qdot1,
+				-c2 * c1 * qdot2 * qdot0 + s2 * s1 * qdot1 * qdot0 - s2 * qdot2 * qdot1,
+				c1 * qdot1 * qdot0,
+				0., 0., 0.
+				);
+	}
+
+	static inline void jcalc_euler_yxz (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		double q0 = q[q_index];
+		double q1 = q[q_index + 1];
+		double q2 = q[q_index + 2];
+
+		double s0 = sin (q0);
+		double c0 = cos (q0);
+		double s1 = sin (q1);
+		double c1 = cos (q1);
+		double s2 = sin (q2);
+		double c2 = cos (q2);
+
+		X_J.E = Matrix3d(
+				c2 * c0 + s2 * s1 * s0, s2 * c1, -c2 * s0 + s2 * s1 * c0,
+				-s2 * c0 + c2 * s1 * s0, c2 * c1, s2 * s0 + c2 * s1 * c0,
+				c1 * s0, - s1, c1 * c0
+				);
+		X_J.r.setZero();
+
+		S(0,0) = s2 * c1;
+		S(0,1) = c2;
+
+		S(1,0) = c2 * c1;
+		S(1,1) = -s2;
+
+		S(2,0) = -s1;
+		S(2,2) = 1.;
+
+		double qdot0 = qdot[q_index];
+		double qdot1 = qdot[q_index + 1];
+		double qdot2 = qdot[q_index + 2];
+
+		v_J = S * Vector3d (qdot0, qdot1, qdot2);
+
+		c_J.set(
+				c2 * c1 * qdot2 * qdot0 - s2 * s1 * qdot1 * qdot0 - s2 * qdot2 * qdot1,
+				-s2 * c1 * qdot2 * qdot0 - c2 * s1 * qdot1 * qdot0 - c2 * qdot2 * qdot1,
+				-c1 * qdot1 * qdot0,
+				0., 0., 0.
+				);
+	}
+
+	static inline void jcalc_translation_xyz (const Model &model, unsigned int joint_id, const double *q, const double *qdot, SpatialTransform &X_J, SpatialVector &v_J, SpatialVector &c_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		X_J.E = Matrix3d::Identity();
+		X_J.r = Vector3d (q[q_index], q[q_index + 1], q[q_index + 2]);
+
+		S(3,0) = 1.;
+		S(4,1) = 1.;
+		S(5,2) = 1.;
+
+		v_J.set (0., 0., 0., qdot[q_index], qdot[q_index + 1], qdot[q_index + 2]);
+		c_J.setZero();
+	}
+
+	static void jcalc_invalid (const Model &model, unsigned int joint_id, const double *, const double *, SpatialTransform &, SpatialVector &, SpatialVector &, Matrix63 &) {
+		std::cerr << "Error: invalid joint type " << model.mJoints[joint_id].mJointType << " at id " << joint_id << std::endl;
+		abort();
+	}
+
+	/* Position kernels
+	 *
+	 * Same as the joint kernels but only compute the joint transformation
+	 * X_J and the motion subspace of joints with three degrees of freedom.
+	 */
+
+	static inline void jcalc_position_revolute_x (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &) {
+		X_J = Xrotx (q[model.mJoints[joint_id].q_index]);
+	}
+
+	static inline void jcalc_position_revolute_y (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &) {
+		X_J = Xroty (q[model.mJoints[joint_id].q_index]);
+	}
+
+	static inline void jcalc_position_revolute_z (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &) {
+		X_J = Xrotz (q[model.mJoints[joint_id].q_index]);
+	}
+
+	static inline void jcalc_position_revolute (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &) {
+		const Joint &joint = model.mJoints[joint_id];
+		X_J = Xrot (q[joint.q_index], Vector3d (
+					joint.mJointAxes[0][0],
+					joint.mJointAxes[0][1],
+					joint.mJointAxes[0][2]
+					));
+	}
+
+	static inline void jcalc_position_prismatic (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &) {
+		const Joint &joint = model.mJoints[joint_id];
+		X_J = Xtrans (Vector3d (
+					joint.mJointAxes[0][3] * q[joint.q_index],
+					joint.mJointAxes[0][4] * q[joint.q_index],
+					joint.mJointAxes[0][5] * q[joint.q_index]
+					)
+				);
+	}
+
+	static inline void jcalc_position_spherical (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+		Quaternion quat (q[q_index], q[q_index + 1], q[q_index + 2], q[model.multdof3_w_index[joint_id]]);
+
+		X_J = SpatialTransform (quat.toMatrix(), Vector3d (0., 0., 0.));
+
+		S(0,0) = 1.;
+		S(1,1) = 1.;
+		S(2,2) = 1.;
+	}
+
+	static inline void jcalc_position_euler_zyx (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		double s0 = sin (q[q_index]);
+		double c0 = cos (q[q_index]);
+		double s1 = sin (q[q_index + 1]);
+		double c1 = cos (q[q_index + 1]);
+		double s2 = sin (q[q_index + 2]);
+		double c2 = cos (q[q_index + 2]);
+
+		X_J.E = Matrix3d(
+				c0 * c1, s0 * c1, -s1,
+				c0 * s1 * s2 - s0 * c2, s0 * s1 * s2 + c0 * c2, c1 * s2,
+				c0 * s1 * c2 + s0 * s2, s0 * s1 * c2 - c0 * s2, c1 * c2
+				);
+		X_J.r.setZero();
+
+		S(0,0) = -s1;
+		S(0,2) = 1.;
+
+		S(1,0) = c1 * s2;
+		S(1,1) = c2;
+
+		S(2,0) = c1 * c2;
+		S(2,1) = - s2;
+	}
+
+	static inline void jcalc_position_euler_xyz (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		double s0 = sin (q[q_index]);
+		double c0 = cos (q[q_index]);
+		double s1 = sin (q[q_index + 1]);
+		double c1 = cos (q[q_index + 1]);
+		double s2 = sin (q[q_index + 2]);
+		double c2 = cos (q[q_index + 2]);
+
+		X_J.E = Matrix3d(
+				c2 * c1, s2 * c0 + c2 * s1 * s0, s2 * s0 - c2 * s1 * c0,
+				-s2 * c1, c2 * c0 - s2 * s1 * s0, c2 * s0 + s2 * s1 * c0,
+				s1, -c1 * s0, c1 * c0
+				);
+		X_J.r.setZero();
+
+		S(0,0) = c2 * c1;
+		S(0,1) = s2;
+
+		S(1,0) = -s2 * c1;
+		S(1,1) = c2;
+
+		S(2,0) = s1;
+		S(2,2) = 1.;
+	}
+
+	static inline void jcalc_position_euler_yxz (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		double s0 = sin (q[q_index]);
+		double c0 = cos (q[q_index]);
+		double s1 = sin (q[q_index + 1]);
+		double c1 = cos (q[q_index + 1]);
+		double s2 = sin (q[q_index + 2]);
+		double c2 = cos (q[q_index + 2]);
+
+		X_J.E = Matrix3d(
+				c2 * c0 + s2 * s1 * s0, s2 * c1, -c2 * s0 + s2 * s1 * c0,
+				-s2 * c0 + c2 * s1 * s0, c2 * c1, s2 * s0 + c2 * s1 * c0,
+				c1 * s0, - s1, c1 * c0
+				);
+		X_J.r.setZero();
+
+		S(0,0) = s2 * c1;
+		S(0,1) = c2;
+
+		S(1,0) = c2 * c1;
+		S(1,1) = -s2;
+
+		S(2,0) = -s1;
+		S(2,2) = 1.;
+	}
+
+	static inline void jcalc_position_translation_xyz (const Model &model, unsigned int joint_id, const double *q, SpatialTransform &X_J, Matrix63 &S) {
+		unsigned int q_index = model.mJoints[joint_id].q_index;
+
+		X_J.E = Matrix3d::Identity();
+		X_J.r = Vector3d (q[q_index], q[q_index + 1], q[q_index + 2]);
+
+		S(3,0) = 1.;
+		S(4,1) = 1.;
+		S(5,2) = 1.;
+	}
+
+	static void jcalc_position_invalid (const Model &model, unsigned int joint_id, const double *, SpatialTransform &, Matrix63 &) {
+		std::cerr << "Error: invalid joint type " << model.mJoints[joint_id].mJointType << " at id " << joint_id << std::endl;
+		abort();
+	}
+
+	// X_T must only be modified by Model::SetJointFrame() (or be followed by
+	// Model::UpdateJointFrameKinds()) as the kind of the joint frame would
+	// otherwise be outdated
+	static inline bool jcalc_joint_frame_kind_valid (const Model &model, unsigned int joint_id) {
+		SpatialTransformKind kind = model.X_T_kind[joint_id];
+		SpatialTransformKind actual_kind = CalcSpatialTransformKind (model.X_T[joint_id]);
+
+		return kind == SpatialTransformGeneral
+			|| actual_kind == SpatialTransformTranslation
+			|| actual_kind == kind;
+	}
+
+	RBDL_DLLAPI
+		JointKernel jcalc_select_kernel (JointType joint_type) {
+			switch (joint_type) {
+				case JointTypeRevoluteX: return jcalc_revolute_x;
+				case JointTypeRevoluteY: return jcalc_revolute_y;
+				case JointTypeRevoluteZ: return jcalc_revolute_z;
+				case JointTypeRevolute: return jcalc_revolute;
+				case JointTypePrismatic: return jcalc_prismatic;
+				case JointTypeSpherical: return jcalc_spherical;
+				case JointTypeEulerZYX: return jcalc_euler_zyx;
+				case JointTypeEulerXYZ: return jcalc_euler_xyz;
+				case JointTypeEulerYXZ: return jcalc_euler_yxz;
+				case JointTypeTranslationXYZ: return jcalc_translation_xyz;
+				default: return jcalc_invalid;
+			}
+		}
+
+	RBDL_DLLAPI
+		JointPositionKernel jcalc_select_position_kernel (JointType joint_type) {
+			switch (joint_type) {
+				case JointTypeRevoluteX: return jcalc_position_revolute_x;
+				case JointTypeRevoluteY: return jcalc_position_revolute_y;
+				case JointTypeRevoluteZ: return jcalc_position_revolute_z;
+				case JointTypeRevolute: return jcalc_position_revolute;
+				case JointTypePrismatic: return jcalc_position_prismatic;
+				case JointTypeSpherical: return jcalc_position_spherical;
+				case JointTypeEulerZYX: return jcalc_position_euler_zyx;
+				case JointTypeEulerXYZ: return jcalc_position_euler_xyz;
+				case JointTypeEulerYXZ: return jcalc_position_euler_yxz;
+				case JointTypeTranslationXYZ: return jcalc_position_translation_xyz;
+				default: return jcalc_position_invalid;
+			}
+		}
+
+	RBDL_DLLAPI
+		SpatialTransformKind jcalc_transform_kind (JointType joint_type) {
+			switch (joint_type) {
+				case JointTypeRevoluteX: return SpatialTransformRotationX;
+				case JointTypeRevoluteY: return SpatialTransformRotationY;
+				case JointTypeRevoluteZ: return SpatialTransformRotationZ;
+				case JointTypePrismatic: return SpatialTransformTranslation;
+				case JointTypeTranslationXYZ: return SpatialTransformTranslation;
+				default: return SpatialTransformGeneral;
+			}
+		}
+
 	RBDL_DLLAPI
 		void jcalc (
-				Model &model,
+				const Model &model,
+				DynamicsWorkspace &ws,
 				unsigned int joint_id,
 				const VectorNd &q,
 				const VectorNd &qdot
@@ -28,179 +451,75 @@ namespace RigidBodyDynamics {
 			// exception if we calculate it for the root body
 			assert (joint_id > 0);
 
-			if (model.mJoints[joint_id].mJointType == JointTypeRevoluteX) {
-				model.X_J[joint_id] = Xrotx (q[model.mJoints[joint_id].q_index]);
-				model.v_J[joint_id][0] = qdot[model.mJoints[joint_id].q_index];
-			} else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteY) {
-				model.X_J[joint_id] = Xroty (q[model.mJoints[joint_id].q_index]);
-				model.v_J[joint_id][1] = qdot[model.mJoints[joint_id].q_index];
-			} else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteZ) {
-				model.X_J[joint_id] = Xrotz (q[model.mJoints[joint_id].q_index]);
-				model.v_J[joint_id][2] = qdot[model.mJoints[joint_id].q_index];
-			} else if (model.mJoints[joint_id].mDoFCount == 1) {
-				model.X_J[joint_id] = jcalc_XJ (model, joint_id, q);
-				
-				model.v_J[joint_id] = model.S[joint_id] * qdot[model.mJoints[joint_id].q_index];
-			} else if (model.mJoints[joint_id].mJointType == JointTypeSpherical) {
-				model.X_J[joint_id] = SpatialTransform ( model.GetQuaternion (joint_id, q).toMatrix(), Vector3d (0., 0., 0.));
-
-				model.multdof3_S[joint_id](0,0) = 1.;
-				model.multdof3_S[joint_id](1,1) = 1.;
-				model.multdof3_S[joint_id](2,2) = 1.;
-
-				Vector3d omega (qdot[model.mJoints[joint_id].q_index],
-						qdot[model.mJoints[joint_id].q_index+1],
-						qdot[model.mJoints[joint_id].q_index+2]);
-
-				model.v_J[joint_id] = SpatialVector (
-						omega[0], omega[1], omega[2],
-						0., 0., 0.);
-			} else if (model.mJoints[joint_id].mJointType == JointTypeEulerZYX) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				double s0 = sin (q0);
-				double c0 = cos (q0);
-				double s1 = sin (q1);
-				double c1 = cos (q1);
-				double s2 = sin (q2);
-				double c2 = cos (q2);
-
-				model.X_J[joint_id].E = Matrix3d(
-						c0 * c1, s0 * c1, -s1,
-						c0 * s1 * s2 - s0 * c2, s0 * s1 * s2 + c0 * c2, c1 * s2,
-						c0 * s1 * c2 + s0 * s2, s0 * s1 * c2 - c0 * s2, c1 * c2
-						);
-
-				model.multdof3_S[joint_id](0,0) = -s1;
-				model.multdof3_S[joint_id](0,2) = 1.;
-
-				model.multdof3_S[joint_id](1,0) = c1 * s2;
-				model.multdof3_S[joint_id](1,1) = c2;
-
-				model.multdof3_S[joint_id](2,0) = c1 * c2;
-				model.multdof3_S[joint_id](2,1) = - s2;
-
-				double qdot0 = qdot[model.mJoints[joint_id].q_index];
-				double qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
-				double qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
-
-				model.v_J[joint_id] = model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
-
-				model.c_J[joint_id].set(
-						- c1 * qdot0 * qdot1,
-						-s1 * s2 * qdot0 * qdot1 + c1 * c2 * qdot0 * qdot2 - s2 * qdot1 * qdot2,
-						-s1 * c2 * qdot0 * qdot1 - c1 * s2 * qdot0 * qdot2 - c2 * qdot1 * qdot2,
-						0., 0., 0.
-						);
-			} else if (model.mJoints[joint_id].mJointType == JointTypeEulerXYZ) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				double s0 = sin (q0);
-				double c0 = cos (q0);
-				double s1 = sin (q1);
-				double c1 = cos (q1);
-				double s2 = sin (q2);
-				double c2 = cos (q2);
-
-				model.X_J[joint_id].E = Matrix3d(
-						c2 * c1, s2 * c0 + c2 * s1 * s0, s2 * s0 - c2 * s1 * c0,
-						-s2 * c1, c2 * c0 - s2 * s1 * s0, c2 * s0 + s2 * s1 * c0,
-						s1, -c1 * s0, c1 * c0
-						);
-
-				model.multdof3_S[joint_id](0,0) = c2 * c1;
-				model.multdof3_S[joint_id](0,1) = s2;
-
-				model.multdof3_S[joint_id](1,0) = -s2 * c1;
-				model.multdof3_S[joint_id](1,1) = c2;
-
-				model.multdof3_S[joint_id](2,0) = s1;
-				model.multdof3_S[joint_id](2,2) = 1.;
-
-				double qdot0 = qdot[model.mJoints[joint_id].q_index];
-				double qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
-				double qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
-
-				model.v_J[joint_id] = model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
-
-				model.c_J[joint_id].set(
-						-s2 * c1 * qdot2 * qdot0 - c2 * s1 * qdot1 * qdot0 + c2 * qdot2 * qdot1,
-						-c2 * c1 * qdot2 * qdot0 + s2 * s1 * qdot1 * qdot0 - s2 * qdot2 * qdot1,
-						c1 * qdot1 * qdot0,
-						0., 0., 0.
-						);
-			} else if (model.mJoints[joint_id].mJointType == JointTypeEulerYXZ) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				double s0 = sin (q0);
-				double c0 = cos (q0);
-				double s1 = sin (q1);
-				double c1 = cos (q1);
-				double s2 = sin (q2);
-				double c2 = cos (q2);
-
-				model.X_J[joint_id].E = Matrix3d(
-						c2 * c0 + s2 * s1 * s0, s2 * c1, -c2 * s0 + s2 * s1 * c0,
-						-s2 * c0 + c2 * s1 * s0, c2 * c1, s2 * s0 + c2 * s1 * c0,
-						c1 * s0, - s1, c1 * c0
-						);
-				model.multdof3_S[joint_id](0,0) = s2 * c1;
-				model.multdof3_S[joint_id](0,1) = c2;
-
-				model.multdof3_S[joint_id](1,0) = c2 * c1;
-				model.multdof3_S[joint_id](1,1) = -s2;
-
-				model.multdof3_S[joint_id](2,0) = -s1;
-				model.multdof3_S[joint_id](2,2) = 1.;
-
-				double qdot0 = qdot[model.mJoints[joint_id].q_index];
-				double qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
-				double qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
-
-				model.v_J[joint_id] = model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
-
-				model.c_J[joint_id].set(
-						 c2 * c1 * qdot2 * qdot0 - s2 * s1 * qdot1 * qdot0 - s2 * qdot2 * qdot1,
-						-s2 * c1 * qdot2 * qdot0 - c2 * s1 * qdot1 * qdot0 - c2 * qdot2 * qdot1,
-						-c1 * qdot1 * qdot0,
-						0., 0., 0.
-						);
-			} else if (model.mJoints[joint_id].mJointType == JointTypeTranslationXYZ) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				model.X_J[joint_id].E = Matrix3d::Identity();
-				model.X_J[joint_id].r = Vector3d (q0, q1, q2);
-
-				model.multdof3_S[joint_id](3,0) = 1.;
-				model.multdof3_S[joint_id](4,1) = 1.;
-				model.multdof3_S[joint_id](5,2) = 1.;
-
-				double qdot0 = qdot[model.mJoints[joint_id].q_index];
-				double qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
-				double qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
-
-				model.v_J[joint_id] = model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
-
-				model.c_J[joint_id].set(0., 0., 0., 0., 0., 0.);
-			} else {
-				std::cerr << "Error: invalid joint type " << model.mJoints[joint_id].mJointType << " at id " << joint_id << std::endl;
-				abort();
-			}
+			SpatialTransform &X_J = ws.X_J[joint_id];
+			SpatialVector &v_J = ws.v_J[joint_id];
+			SpatialVector &c_J = ws.c_J[joint_id];
+			Matrix63 &S = ws.multdof3_S[joint_id];
+
+			model.mJointKernels[joint_id] (model, joint_id, q.data(), qdot.data(), X_J, v_J, c_J, S);
 
-			model.X_lambda[joint_id] = model.X_J[joint_id] * model.X_T[joint_id];
+			assert (jcalc_joint_frame_kind_valid (model, joint_id));
+			X_J.multiply (model.X_J_kind[joint_id], model.X_T[joint_id], model.X_T_kind[joint_id], ws.X_lambda[joint_id]);
+			ws.incremental_q_valid = false;
+			ws.S_base_valid = false;
+			ws.S_dot_base_valid = false;
+		}
+
+	RBDL_DLLAPI
+		void jcalc_batch (
+				const Model &model,
+				unsigned int joint_id,
+				const MatrixNd &Q,
+				const MatrixNd &QDot,
+				SpatialTransform *X_lambda,
+				SpatialVector *v_J,
+				SpatialVector *c_J,
+				Matrix63 *multdof3_S
+				) {
+			assert (joint_id > 0);
+			assert (Q.cols() == QDot.cols());
+
+			assert (jcalc_joint_frame_kind_valid (model, joint_id));
+
+			JointKernel kernel = model.mJointKernels[joint_id];
+			const SpatialTransform &X_T = model.X_T[joint_id];
+			SpatialTransformKind X_J_kind = model.X_J_kind[joint_id];
+			SpatialTransformKind X_T_kind = model.X_T_kind[joint_id];
+
+			SpatialTransform X_J;
+			Matrix63 S_dummy;
+
+#ifdef EIGEN_CORE_H
+			// the columns of the column-major state matrices are contiguous
+			unsigned int q_rows = Q.rows();
+			unsigned int qdot_rows = QDot.rows();
+			const double *q_data = Q.data();
+			const double *qdot_data = QDot.data();
+#else
+			// SimpleMath stores row-major, copy out each column
+			VectorNd q_k (Q.rows());
+			VectorNd qdot_k (QDot.rows());
+#endif
+
+			for (unsigned int k = 0; k < Q.cols(); k++) {
+#ifdef EIGEN_CORE_H
+				const double *q_col = q_data + k * q_rows;
+				const double *qdot_col = qdot_data + k * qdot_rows;
+#else
+				q_k = Q.col(k);
+				qdot_k = QDot.col(k);
+				const double *q_col = q_k.data();
+				const double *qdot_col = qdot_k.data();
+#endif
+				kernel (model, joint_id, q_col, qdot_col,
+						X_J, v_J[k], c_J[k], multdof3_S != NULL ? multdof3_S[k] : S_dummy);
+				X_J.multiply (X_J_kind, X_T, X_T_kind, X_lambda[k]);
+			}
 		}
 
 	RBDL_DLLAPI
 		Math::SpatialTransform jcalc_XJ (
-				Model &model,
+				const Model &model,
 				unsigned int joint_id,
 				const Math::VectorNd &q) {
 			// exception if we calculate it for the root body
@@ -229,149 +548,40 @@ namespace RigidBodyDynamics {
 
 	RBDL_DLLAPI
 		void jcalc_X_lambda_S (
-				Model &model,
+				const Model &model,
+				DynamicsWorkspace &ws,
 				unsigned int joint_id,
 				const VectorNd &q
 				) {
 			// exception if we calculate it for the root body
 			assert (joint_id > 0);
 
-			if (model.mJoints[joint_id].mJointType == JointTypeRevoluteX) {
-				model.X_lambda[joint_id] = Xrotx (q[model.mJoints[joint_id].q_index]) * model.X_T[joint_id];
-				model.S[joint_id] = model.mJoints[joint_id].mJointAxes[0];
-			} else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteY) {
-				model.X_lambda[joint_id] = Xroty (q[model.mJoints[joint_id].q_index]) * model.X_T[joint_id];
-				model.S[joint_id] = model.mJoints[joint_id].mJointAxes[0];
-			} else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteZ) {
-				model.X_lambda[joint_id] = Xrotz (q[model.mJoints[joint_id].q_index]) * model.X_T[joint_id];
-				model.S[joint_id] = model.mJoints[joint_id].mJointAxes[0];
-			} else if (model.mJoints[joint_id].mDoFCount == 1) {
-				model.X_lambda[joint_id] = jcalc_XJ (model, joint_id, q) * model.X_T[joint_id];
-
-				// Set the joint axis
-				model.S[joint_id] = model.mJoints[joint_id].mJointAxes[0];
-			} else if (model.mJoints[joint_id].mJointType == JointTypeSpherical) {
-				model.X_lambda[joint_id] = SpatialTransform (
-						model.GetQuaternion (joint_id, q).toMatrix(),
-						Vector3d (0., 0., 0.))
-						* model.X_T[joint_id];
-				
-				model.multdof3_S[joint_id].setZero();
-
-				model.multdof3_S[joint_id](0,0) = 1.;
-				model.multdof3_S[joint_id](1,1) = 1.;
-				model.multdof3_S[joint_id](2,2) = 1.;
-			} else if (model.mJoints[joint_id].mJointType == JointTypeEulerZYX) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				double s0 = sin (q0);
-				double c0 = cos (q0);
-				double s1 = sin (q1);
-				double c1 = cos (q1);
-				double s2 = sin (q2);
-				double c2 = cos (q2);
-
-				model.X_lambda[joint_id] = SpatialTransform ( 
-						Matrix3d(
-							c0 * c1, s0 * c1, -s1,
-							c0 * s1 * s2 - s0 * c2, s0 * s1 * s2 + c0 * c2, c1 * s2,
-							c0 * s1 * c2 + s0 * s2, s0 * s1 * c2 - c0 * s2, c1 * c2
-							),
-						Vector3d (0., 0., 0.))
-					* model.X_T[joint_id];
-
-				model.multdof3_S[joint_id].setZero();
-
-				model.multdof3_S[joint_id](0,0) = -s1;
-				model.multdof3_S[joint_id](0,2) = 1.;
-
-				model.multdof3_S[joint_id](1,0) = c1 * s2;
-				model.multdof3_S[joint_id](1,1) = c2;
-
-				model.multdof3_S[joint_id](2,0) = c1 * c2;
-				model.multdof3_S[joint_id](2,1) = - s2;
-			} else if (model.mJoints[joint_id].mJointType == JointTypeEulerXYZ) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				double s0 = sin (q0);
-				double c0 = cos (q0);
-				double s1 = sin (q1);
-				double c1 = cos (q1);
-				double s2 = sin (q2);
-				double c2 = cos (q2);
-
-				model.X_lambda[joint_id] = SpatialTransform (
-						Matrix3d(
-							c2 * c1, s2 * c0 + c2 * s1 * s0, s2 * s0 - c2 * s1 * c0,
-							-s2 * c1, c2 * c0 - s2 * s1 * s0, c2 * s0 + s2 * s1 * c0,
-							s1, -c1 * s0, c1 * c0
-							),
-						Vector3d (0., 0., 0.))
-					* model.X_T[joint_id];
-
-				model.multdof3_S[joint_id].setZero();
-
-				model.multdof3_S[joint_id](0,0) = c2 * c1;
-				model.multdof3_S[joint_id](0,1) = s2;
-
-				model.multdof3_S[joint_id](1,0) = -s2 * c1;
-				model.multdof3_S[joint_id](1,1) = c2;
-
-				model.multdof3_S[joint_id](2,0) = s1;
-				model.multdof3_S[joint_id](2,2) = 1.;
- 			} else if (model.mJoints[joint_id].mJointType == JointTypeEulerYXZ ) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				double s0 = sin (q0);
-				double c0 = cos (q0);
-				double s1 = sin (q1);
-				double c1 = cos (q1);
-				double s2 = sin (q2);
-				double c2 = cos (q2);
-
-				model.X_lambda[joint_id] = SpatialTransform (
-						Matrix3d(
-						c2 * c0 + s2 * s1 * s0, s2 * c1, -c2 * s0 + s2 * s1 * c0,
-						-s2 * c0 + c2 * s1 * s0, c2 * c1, s2 * s0 + c2 * s1 * c0,
-						c1 * s0, - s1, c1 * c0
-							),
-						Vector3d (0., 0., 0.))
-					* model.X_T[joint_id];
-
-				model.multdof3_S[joint_id].setZero();
-
-				model.multdof3_S[joint_id](0,0) = s2 * c1;
-				model.multdof3_S[joint_id](0,1) = c2;
-
-				model.multdof3_S[joint_id](1,0) = c2 * c1;
-				model.multdof3_S[joint_id](1,1) = -s2;
-
-				model.multdof3_S[joint_id](2,0) = -s1;
-				model.multdof3_S[joint_id](2,2) = 1.;
-			} else if (model.mJoints[joint_id].mJointType == JointTypeTranslationXYZ ) {
-				double q0 = q[model.mJoints[joint_id].q_index];
-				double q1 = q[model.mJoints[joint_id].q_index + 1];
-				double q2 = q[model.mJoints[joint_id].q_index + 2];
-
-				model.X_lambda[joint_id] = SpatialTransform (
-						Matrix3d::Identity (3,3),
-						Vector3d (q0, q1, q2))
-					* model.X_T[joint_id];
-
-				model.multdof3_S[joint_id].setZero();
-
-				model.multdof3_S[joint_id](3,0) = 1.;
-				model.multdof3_S[joint_id](4,1) = 1.;
-				model.multdof3_S[joint_id](5,2) = 1.;
-			} else {
-				std::cerr << "Error: invalid joint type!" << std::endl;
-				abort();
-			}
+			SpatialTransform &X_J = ws.X_J[joint_id];
+			model.mJointPositionKernels[joint_id] (model, joint_id, q.data(), X_J, ws.multdof3_S[joint_id]);
+
+			assert (jcalc_joint_frame_kind_valid (model, joint_id));
+			X_J.multiply (model.X_J_kind[joint_id], model.X_T[joint_id], model.X_T_kind[joint_id], ws.X_lambda[joint_id]);
+			ws.incremental_q_valid = false;
+			ws.S_base_valid = false;
+			ws.S_dot_base_valid = false;
+		}
+
+	RBDL_DLLAPI
+		void jcalc (
+				Model &model,
+				unsigned int joint_id,
+				const VectorNd &q,
+				const VectorNd &qdot
+				) {
+			jcalc (model, model, joint_id, q, qdot);
+		}
+
+	RBDL_DLLAPI
+		void jcalc_X_lambda_S (
+				Model &model,
+				unsigned int joint_id,
+				const VectorNd &q
+				) {
+			jcalc_X_lambda_S (model, model, joint_id, q);
 		}
 }
@@ -21,7 +21,8 @@ namespace RigidBodyDynamics {
 using namespace Math;
 
 RBDL_DLLAPI
-void UpdateKinematics (Model &model,
+void UpdateKinematics (const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const VectorNd &QDot,
 		const VectorNd &QDDot
@@ -32,45 +33,42 @@ void UpdateKinematics (Model &model,
 
 	SpatialVector spatial_gravity (0., 0., 0., model.gravity[0], model.gravity[1], model.gravity[2]);
 
-	model.a[0].setZero();
-	//model.a[0] = spatial_gravity;
+	ws.a[0].setZero();
+	//ws.a[0] = spatial_gravity;
 
 	for (i = 1; i < model.mBodies.size(); i++) {
 		unsigned int q_index = model.mJoints[i].q_index;
-
-		Joint joint = model.mJoints[i];
 		unsigned int lambda = model.lambda[i];
 
-		jcalc (model, i, Q, QDot);
-
-		model.X_lambda[i] = model.X_J[i] * model.X_T[i];
+		jcalc (model, ws, i, Q, QDot);
 
 		if (lambda != 0) {
-			model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
-			model.v[i] = model.X_lambda[i].apply(model.v[lambda]) + model.v_J[i];
+			ws.X_lambda[i].multiply (model.X_lambda_kind[i], ws.X_base[lambda], SpatialTransformGeneral, ws.X_base[i]);
+			ws.v[i] = ws.X_lambda[i].apply (ws.v[lambda], model.X_lambda_kind[i]) + ws.v_J[i];
 		}	else {
-			model.X_base[i] = model.X_lambda[i];
-			model.v[i] = model.v_J[i];
+			ws.X_base[i] = ws.X_lambda[i];
+			ws.v[i] = ws.v_J[i];
 		}
 		
-		model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
-		model.a[i] = model.X_lambda[i].apply(model.a[lambda]) + model.c[i];
+		ws.c[i] = ws.c_J[i] + crossm(ws.v[i],ws.v_J[i]);
+		ws.a[i] = ws.X_lambda[i].apply (ws.a[lambda], model.X_lambda_kind[i]) + ws.c[i];
 
 		if (model.mJoints[i].mDoFCount == 3) {
 			Vector3d omegadot_temp (QDDot[q_index], QDDot[q_index + 1], QDDot[q_index + 2]);
-			model.a[i] = model.a[i] + model.multdof3_S[i] * omegadot_temp;
+			ws.a[i] = ws.a[i] + ws.multdof3_S[i] * omegadot_temp;
 		} else {
-			model.a[i] = model.a[i] + model.S[i] * QDDot[q_index];
+			ws.a[i] = ws.a[i] + model.S[i] * QDDot[q_index];
 		}	
 	}
 
 	for (i = 1; i < model.mBodies.size(); i++) {
-		LOG << "a[" << i << "] = " << model.a[i].transpose() << std::endl;
+		LOG << "a[" << i << "] = " << ws.a[i].transpose() << std::endl;
 	}
 }
 
 RBDL_DLLAPI
-void UpdateKinematicsCustom (Model &model,
+void UpdateKinematicsCustom (const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd *Q,
 		const VectorNd *QDot,
 		const VectorNd *QDDot
@@ -83,16 +81,12 @@ void UpdateKinematicsCustom (Model &model,
 		for (i = 1; i < model.mBodies.size(); i++) {
 			unsigned int lambda = model.lambda[i];
 
-			VectorNd QDot_zero (VectorNd::Zero (model.q_size));
-
-			jcalc (model, i, (*Q), QDot_zero);
-
-			model.X_lambda[i] = model.X_J[i] * model.X_T[i];
+			jcalc_X_lambda_S (model, ws, i, *Q);
 
 			if (lambda != 0) {
-				model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
+				ws.X_lambda[i].multiply (model.X_lambda_kind[i], ws.X_base[lambda], SpatialTransformGeneral, ws.X_base[i]);
 			}	else {
-				model.X_base[i] = model.X_lambda[i];
+				ws.X_base[i] = ws.X_lambda[i];
 			}
 		}
 	}
@@ -101,51 +95,226 @@ void UpdateKinematicsCustom (Model &model,
 		for (i = 1; i < model.mBodies.size(); i++) {
 			unsigned int lambda = model.lambda[i];
 
-			jcalc (model, i, *Q, *QDot);
+			jcalc (model, ws, i, *Q, *QDot);
 
 			if (lambda != 0) {
-				model.v[i] = model.X_lambda[i].apply(model.v[lambda]) + model.v_J[i];
-				model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
+				ws.v[i] = ws.X_lambda[i].apply (ws.v[lambda], model.X_lambda_kind[i]) + ws.v_J[i];
+				ws.c[i] = ws.c_J[i] + crossm(ws.v[i],ws.v_J[i]);
 			}	else {
-				model.v[i] = model.v_J[i];
-				model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
+				ws.v[i] = ws.v_J[i];
+				ws.c[i] = ws.c_J[i] + crossm(ws.v[i],ws.v_J[i]);
 			}
-			// LOG << "v[" << i << "] = " << model.v[i].transpose() << std::endl;
+			// LOG << "v[" << i << "] = " << ws.v[i].transpose() << std::endl;
 		}
 	}
 
 	if (QDDot) {
+		ws.incremental_qddot_valid = false;
+
 		for (i = 1; i < model.mBodies.size(); i++) {
 			unsigned int q_index = model.mJoints[i].q_index;
 
 			unsigned int lambda = model.lambda[i];
 
 			if (lambda != 0) {
-				model.a[i] = model.X_lambda[i].apply(model.a[lambda]) + model.c[i];
+				ws.a[i] = ws.X_lambda[i].apply (ws.a[lambda], model.X_lambda_kind[i]) + ws.c[i];
 			}	else {
-				model.a[i] = model.c[i];
+				ws.a[i] = ws.c[i];
+			}
+
+			if (model.mJoints[i].mDoFCount == 3) {
+				Vector3d omegadot_temp ((*QDDot)[q_index], (*QDDot)[q_index + 1], (*QDDot)[q_index + 2]);
+				ws.a[i] = ws.a[i] + ws.multdof3_S[i] * omegadot_temp;
+			} else {
+				ws.a[i] = ws.a[i] + model.S[i] * (*QDDot)[q_index];
+			}
+		}
+	}
+}
+
+/// \brief Levels of UpdateKinematicsIncremental() that have to be recomputed
+enum IncrementalLevel {
+	IncrementalClean = 0,
+	IncrementalAcceleration,
+	IncrementalVelocity,
+	IncrementalPosition
+};
+
+/** \brief Marks the body and all its descendants for recomputation of at
+ * least the given level */
+static void incremental_mark_subtree (
+		const Model &model,
+		std::vector<unsigned char> &dirty,
+		unsigned int body_id,
+		unsigned char level) {
+	if (dirty[body_id] >= level)
+		return;
+
+	dirty[body_id] = level;
+
+	for (unsigned int j = 0; j < model.mu[body_id].size(); j++) {
+		incremental_mark_subtree (model, dirty, model.mu[body_id][j], level);
+	}
+}
+
+/// \brief Returns whether the values of joint i differ in a and b
+static bool incremental_joint_changed (
+		const Model &model,
+		unsigned int i,
+		const VectorNd &a,
+		const VectorNd &b,
+		bool use_w_index) {
+	unsigned int q_index = model.mJoints[i].q_index;
+
+	for (unsigned int k = 0; k < model.mJoints[i].mDoFCount; k++) {
+		if (a[q_index + k] != b[q_index + k])
+			return true;
+	}
+
+	if (use_w_index && model.mJoints[i].mJointType == JointTypeSpherical) {
+		unsigned int w_index = model.multdof3_w_index[i];
+		return a[w_index] != b[w_index];
+	}
+
+	return false;
+}
+
+RBDL_DLLAPI
+void UpdateKinematicsIncremental (const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd *QDot,
+		const VectorNd *QDDot
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (QDDot == NULL || QDot != NULL);
+
+	unsigned int i;
+	unsigned int body_count = model.mBodies.size();
+
+	if (ws.incremental_dirty.size() != body_count
+			|| ws.incremental_q.size() != model.q_size
+			|| ws.incremental_qdot.size() != model.qdot_size) {
+		ws.incremental_q = VectorNd::Zero (model.q_size);
+		ws.incremental_qdot = VectorNd::Zero (model.qdot_size);
+		ws.incremental_qddot = VectorNd::Zero (model.qdot_size);
+		ws.incremental_dirty.assign (body_count, IncrementalClean);
+		ws.incremental_q_valid = false;
+	}
+
+	if (!ws.incremental_q_valid) {
+		ws.incremental_qdot_valid = false;
+		ws.incremental_qddot_valid = false;
+		ws.a[0].setZero();
+	}
+
+	// find the joints that changed and mark their subtrees
+	for (i = 1; i < body_count; i++) {
+		ws.incremental_dirty[i] = IncrementalClean;
+	}
+
+	for (i = 1; i < body_count; i++) {
+		unsigned char level = IncrementalClean;
+
+		if (!ws.incremental_q_valid
+				|| incremental_joint_changed (model, i, Q, ws.incremental_q, true)) {
+			level = IncrementalPosition;
+		} else if (QDot && (!ws.incremental_qdot_valid
+					|| incremental_joint_changed (model, i, *QDot, ws.incremental_qdot, false))) {
+			level = IncrementalVelocity;
+		} else if (QDDot && (!ws.incremental_qddot_valid
+					|| incremental_joint_changed (model, i, *QDDot, ws.incremental_qddot, false))) {
+			level = IncrementalAcceleration;
+		}
+
+		if (level != IncrementalClean) {
+			incremental_mark_subtree (model, ws.incremental_dirty, i, level);
+		}
+	}
+
+	// recompute the marked bodies (parents always have lower ids than
+	// their children)
+	ws.incremental_update_count = 0;
+
+	for (i = 1; i < body_count; i++) {
+		unsigned char level = ws.incremental_dirty[i];
+
+		if (level == IncrementalClean)
+			continue;
+
+		ws.incremental_update_count++;
+
+		unsigned int lambda = model.lambda[i];
+
+		if (QDot && level >= IncrementalVelocity) {
+			jcalc (model, ws, i, Q, *QDot);
+		} else if (level == IncrementalPosition) {
+			jcalc_X_lambda_S (model, ws, i, Q);
+		}
+
+		if (level == IncrementalPosition) {
+			if (lambda != 0) {
+				ws.X_lambda[i].multiply (model.X_lambda_kind[i], ws.X_base[lambda], SpatialTransformGeneral, ws.X_base[i]);
+			} else {
+				ws.X_base[i] = ws.X_lambda[i];
+			}
+		}
+
+		if (QDot && level >= IncrementalVelocity) {
+			if (lambda != 0) {
+				ws.v[i] = ws.X_lambda[i].apply (ws.v[lambda], model.X_lambda_kind[i]) + ws.v_J[i];
+			} else {
+				ws.v[i] = ws.v_J[i];
+			}
+			ws.c[i] = ws.c_J[i] + crossm(ws.v[i],ws.v_J[i]);
+		}
+
+		if (QDDot) {
+			unsigned int q_index = model.mJoints[i].q_index;
+
+			if (lambda != 0) {
+				ws.a[i] = ws.X_lambda[i].apply (ws.a[lambda], model.X_lambda_kind[i]) + ws.c[i];
+			} else {
+				ws.a[i] = ws.c[i];
 			}
 
 			if (model.mJoints[i].mDoFCount == 3) {
 				Vector3d omegadot_temp ((*QDDot)[q_index], (*QDDot)[q_index + 1], (*QDDot)[q_index + 2]);
-				model.a[i] = model.a[i] + model.multdof3_S[i] * omegadot_temp;
+				ws.a[i] = ws.a[i] + ws.multdof3_S[i] * omegadot_temp;
 			} else {
-				model.a[i] = model.a[i] + model.S[i] * (*QDDot)[q_index];
+				ws.a[i] = ws.a[i] + model.S[i] * (*QDDot)[q_index];
 			}
 		}
 	}
+
+	LOG << "recomputed " << ws.incremental_update_count << " of " << body_count - 1 << " bodies" << std::endl;
+
+	ws.incremental_q = Q;
+	ws.incremental_q_valid = true;
+
+	if (QDot) {
+		ws.incremental_qdot = *QDot;
+	}
+	ws.incremental_qdot_valid = (QDot != NULL);
+
+	if (QDDot) {
+		ws.incremental_qddot = *QDDot;
+	}
+	ws.incremental_qddot_valid = (QDDot != NULL);
 }
 
 RBDL_DLLAPI
 Vector3d CalcBodyToBaseCoordinates (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		unsigned int body_id,
 		const Vector3d &point_body_coordinates,
 		bool update_kinematics) {
 	// update the Kinematics if necessary
 	if (update_kinematics) {
-		UpdateKinematicsCustom (model, &Q, NULL, NULL);
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
 	}
 
 	if (body_id >= model.fixed_body_discriminator) {
@@ -155,26 +324,27 @@ Vector3d CalcBodyToBaseCoordinates (
 		Matrix3d fixed_rotation = model.mFixedBodies[fbody_id].mParentTransform.E.transpose();
 		Vector3d fixed_position = model.mFixedBodies[fbody_id].mParentTransform.r;
 
-		Matrix3d parent_body_rotation = model.X_base[parent_id].E.transpose();
-		Vector3d parent_body_position = model.X_base[parent_id].r;
+		Matrix3d parent_body_rotation = ws.X_base[parent_id].E.transpose();
+		Vector3d parent_body_position = ws.X_base[parent_id].r;
 		return parent_body_position + parent_body_rotation * (fixed_position + fixed_rotation * (point_body_coordinates));
 	}
 
-	Matrix3d body_rotation = model.X_base[body_id].E.transpose();
-	Vector3d body_position = model.X_base[body_id].r;
+	Matrix3d body_rotation = ws.X_base[body_id].E.transpose();
+	Vector3d body_position = ws.X_base[body_id].r;
 
 	return body_position + body_rotation * point_body_coordinates;
 }
 
 RBDL_DLLAPI
 Vector3d CalcBaseToBodyCoordinates (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		unsigned int body_id,
 		const Vector3d &point_base_coordinates,
 		bool update_kinematics) {
 	if (update_kinematics) {
-		UpdateKinematicsCustom (model, &Q, NULL, NULL);
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
 	}
 
 	if (body_id >= model.fixed_body_discriminator) {
@@ -184,100 +354,119 @@ Vector3d CalcBaseToBodyCoordinates (
 		Matrix3d fixed_rotation = model.mFixedBodies[fbody_id].mParentTransform.E;
 		Vector3d fixed_position = model.mFixedBodies[fbody_id].mParentTransform.r;
 
-		Matrix3d parent_body_rotation = model.X_base[parent_id].E;
-		Vector3d parent_body_position = model.X_base[parent_id].r;
+		Matrix3d parent_body_rotation = ws.X_base[parent_id].E;
+		Vector3d parent_body_position = ws.X_base[parent_id].r;
 
 		return fixed_rotation * ( - fixed_position - parent_body_rotation * (parent_body_position - point_base_coordinates));
 	}
 
-	Matrix3d body_rotation = model.X_base[body_id].E;
-	Vector3d body_position = model.X_base[body_id].r;
+	Matrix3d body_rotation = ws.X_base[body_id].E;
+	Vector3d body_position = ws.X_base[body_id].r;
 
 	return body_rotation * (point_base_coordinates - body_position);
 }
 
 RBDL_DLLAPI
 Matrix3d CalcBodyWorldOrientation (
-		Model &model,
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
 		const unsigned int body_id,
 		bool update_kinematics) {
 	// update the Kinematics if necessary
 	if (update_kinematics) {
-		UpdateKinematicsCustom (model, &Q, NULL, NULL);
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
 	}
 
 	if (body_id >= model.fixed_body_discriminator) {
 		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
-		model.mFixedBodies[fbody_id].mBaseTransform = model.mFixedBodies[fbody_id].mParentTransform * model.X_base[model.mFixedBodies[fbody_id].mMovableParent];
+		SpatialTransform base_transform = model.mFixedBodies[fbody_id].mParentTransform * ws.X_base[model.mFixedBodies[fbody_id].mMovableParent];
 
-		return model.mFixedBodies[fbody_id].mBaseTransform.E;
+		return base_transform.E;
 	}
 
-	return model.X_base[body_id].E;
+	return ws.X_base[body_id].E;
 }
 
 RBDL_DLLAPI
-void CalcPointJacobian (
-		Model &model,
-		const VectorNd &Q,
-		unsigned int body_id,
-		const Vector3d &point_position,
-		MatrixNd &G,
-		bool update_kinematics
-	) {
-	LOG << "-------- " << __func__ << " --------" << std::endl;
+void CalcBaseMotionSubspaces (const Model &model, DynamicsWorkspace &ws) {
+	if (ws.S_base_valid && ws.S_base.cols() == model.qdot_size)
+		return;
 
-	// update the Kinematics if necessary
-	if (update_kinematics) {
-		UpdateKinematicsCustom (model, &Q, NULL, NULL);
-	}
+	if (ws.S_base.rows() != 6 || ws.S_base.cols() != model.qdot_size)
+		ws.S_base.resize (6, model.qdot_size);
 
-	SpatialTransform point_trans = SpatialTransform (Matrix3d::Identity(), CalcBodyToBaseCoordinates (model, Q, body_id, point_position, false));
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		unsigned int q_index = model.mJoints[i].q_index;
+		const Matrix3d &E = ws.X_base[i].E;
+		const Vector3d &r = ws.X_base[i].r;
 
-	assert (G.rows() == 3 && G.cols() == model.qdot_size );
+		for (unsigned int k = 0; k < model.mJoints[i].mDoFCount; k++) {
+			SpatialVector S_i;
+			if (model.mJoints[i].mDoFCount == 3) {
+				S_i = ws.multdof3_S[i].block(0, k, 6, 1);
+			} else {
+				S_i = model.S[i];
+			}
 
-	unsigned int reference_body_id = body_id;
+			// X_base^-1 applied to S_i
+			Vector3d omega = E.transpose() * Vector3d (S_i[0], S_i[1], S_i[2]);
+			Vector3d v = E.transpose() * Vector3d (S_i[3], S_i[4], S_i[5]) + r.cross (omega);
+
+			ws.S_base.block(0, q_index + k, 3, 1) = omega;
+			ws.S_base.block(3, q_index + k, 3, 1) = v;
+		}
+	}
+
+	ws.S_base_valid = true;
+}
+
+/** \brief Writes the non-zero columns of the jacobian of a point (given in
+ * base coordinates) into the rows row, ..., row + 2 of G
+ *
+ * Requires that DynamicsWorkspace::S_base is up to date.
+ */
+static void point_jacobian_rows (
+		const Model &model,
+		const DynamicsWorkspace &ws,
+		unsigned int body_id,
+		const Vector3d &point_base,
+		MatrixNd &G,
+		unsigned int row) {
+	unsigned int j = body_id;
 
 	if (model.IsFixedBodyId(body_id)) {
 		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
-		reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
+		j = model.mFixedBodies[fbody_id].mMovableParent;
 	}
 
-	unsigned int j = reference_body_id;
-
-	// e[j] is set to 1 if joint j contributes to the jacobian that we are
-	// computing. For all other joints the column will be zero.
+	// Only the joints on the path to the root contribute to the jacobian.
+	// For all other joints the column will be zero.
 	while (j != 0) {
 		unsigned int q_index = model.mJoints[j].q_index;
 
-		if (model.mJoints[j].mDoFCount == 3) {
-			G.block(0, q_index, 3, 3) = ((point_trans * model.X_base[j].inverse()).toMatrix() * model.multdof3_S[j]).block(3,0,3,3);
-		} else {
-			G.block(0,q_index, 3, 1) = point_trans.apply(model.X_base[j].inverse().apply(model.S[j])).block(3,0,3,1);
+		for (unsigned int k = q_index; k < q_index + model.mJoints[j].mDoFCount; k++) {
+			Vector3d omega (ws.S_base(0, k), ws.S_base(1, k), ws.S_base(2, k));
+			Vector3d v (ws.S_base(3, k), ws.S_base(4, k), ws.S_base(5, k));
+
+			G.block(row, k, 3, 1) = v + omega.cross (point_base);
 		}
 
 		j = model.lambda[j];
 	}
 }
 
-RBDL_DLLAPI
-void CalcBodySpatialJacobian (
-		Model &model,
-		const VectorNd &Q,
+/** \brief Writes the non-zero columns of the spatial jacobian of a body
+ * into the rows row, ..., row + 5 of G
+ *
+ * Requires that DynamicsWorkspace::S_base is up to date.
+ */
+static void body_spatial_jacobian_rows (
+		const Model &model,
+		const DynamicsWorkspace &ws,
 		unsigned int body_id,
 		MatrixNd &G,
-		bool update_kinematics
-	) {
-	LOG << "-------- " << __func__ << " --------" << std::endl;
-
-	// update the Kinematics if necessary
-	if (update_kinematics) {
-		UpdateKinematicsCustom (model, &Q, NULL, NULL);
-	}
-
-	assert (G.rows() == 6 && G.cols() == model.qdot_size );
-
+		unsigned int row) {
 	unsigned int reference_body_id = body_id;
 
 	SpatialTransform base_to_body;
@@ -285,20 +474,25 @@ void CalcBodySpatialJacobian (
 	if (model.IsFixedBodyId(body_id)) {
 		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
 		reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
-		base_to_body = model.mFixedBodies[fbody_id].mParentTransform * model.X_base[reference_body_id];
+		base_to_body = model.mFixedBodies[fbody_id].mParentTransform * ws.X_base[reference_body_id];
 	} else {
-		base_to_body = model.X_base[reference_body_id];
+		base_to_body = ws.X_base[reference_body_id];
 	}
 
+	const Matrix3d &E = base_to_body.E;
+	const Vector3d &r = base_to_body.r;
+
 	unsigned int j = reference_body_id;
 
 	while (j != 0) {
 		unsigned int q_index = model.mJoints[j].q_index;
 
-		if (model.mJoints[j].mDoFCount == 3) {
-			G.block(0,q_index,6,3) = (base_to_body * model.X_base[j].inverse()).toMatrix() * model.multdof3_S[j];
-		} else {
-			G.block(0,q_index,6,1) = base_to_body.apply(model.X_base[j].inverse().apply(model.S[j]));
+		for (unsigned int k = q_index; k < q_index + model.mJoints[j].mDoFCount; k++) {
+			Vector3d omega (ws.S_base(0, k), ws.S_base(1, k), ws.S_base(2, k));
+			Vector3d v (ws.S_base(3, k), ws.S_base(4, k), ws.S_base(5, k));
+
+			G.block(row, k, 3, 1) = E * omega;
+			G.block(row + 3, k, 3, 1) = E * (v - r.cross (omega));
 		}
 	
 		j = model.lambda[j];
@@ -306,187 +500,1268 @@ void CalcBodySpatialJacobian (
 }
 
 RBDL_DLLAPI
-Vector3d CalcPointVelocity (
-		Model &model,
+void CalcPointJacobian (
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
-		const VectorNd &QDot,
 		unsigned int body_id,
 		const Vector3d &point_position,
+		MatrixNd &G,
 		bool update_kinematics
 	) {
 	LOG << "-------- " << __func__ << " --------" << std::endl;
-	assert (model.IsBodyId(body_id));
-	assert (model.q_size == Q.size());
-	assert (model.qdot_size == QDot.size());
-
-	// Reset the velocity of the root body
-	model.v[0].setZero();
 
-	// update the Kinematics with zero acceleration
+	// update the Kinematics if necessary
 	if (update_kinematics) {
-		UpdateKinematicsCustom (model, &Q, &QDot, NULL);
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
 	}
 
-	unsigned int reference_body_id = body_id;
-	Vector3d reference_point = point_position;
+	assert (G.rows() == 3 && G.cols() == model.qdot_size );
 
-	if (model.IsFixedBodyId(body_id)) {
-		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
-		reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
-		Vector3d base_coords = CalcBodyToBaseCoordinates (model, Q, body_id, point_position, false);
-		reference_point = CalcBaseToBodyCoordinates (model, Q, reference_body_id, base_coords, false);
+	Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, body_id, point_position, false);
+
+	CalcBaseMotionSubspaces (model, ws);
+	point_jacobian_rows (model, ws, body_id, point_base, G, 0);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobians (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Vector3d> &point_positions,
+		MatrixNd &G,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (body_ids.size() == point_positions.size());
+	assert (G.rows() == 3 * (unsigned int) body_ids.size() && G.cols() == model.qdot_size );
 
+	// update the Kinematics if necessary
+	if (update_kinematics) {
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
 	}
 
-	SpatialVector point_spatial_velocity = SpatialTransform (CalcBodyWorldOrientation (model, Q, reference_body_id, false).transpose(), reference_point).apply(model.v[reference_body_id]);
+	CalcBaseMotionSubspaces (model, ws);
 
-	return Vector3d (
-			point_spatial_velocity[3],
-			point_spatial_velocity[4],
-			point_spatial_velocity[5]
-			);
+	for (unsigned int i = 0; i < body_ids.size(); i++) {
+		Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, body_ids[i], point_positions[i], false);
+		point_jacobian_rows (model, ws, body_ids[i], point_base, G, 3 * i);
+	}
 }
 
 RBDL_DLLAPI
-Vector3d CalcPointAcceleration (
-		Model &model,
+void CalcBodySpatialJacobian (
+		const Model &model,
+		DynamicsWorkspace &ws,
 		const VectorNd &Q,
-		const VectorNd &QDot,
-		const VectorNd &QDDot,
 		unsigned int body_id,
-		const Vector3d &point_position,
+		MatrixNd &G,
 		bool update_kinematics
-	)
-{
+	) {
 	LOG << "-------- " << __func__ << " --------" << std::endl;
 
-	// Reset the velocity of the root body
-	model.v[0].setZero();
-	model.a[0].setZero();
+	// update the Kinematics if necessary
+	if (update_kinematics) {
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
+	}
 
-	if (update_kinematics)
-		UpdateKinematics (model, Q, QDot, QDDot);
+	assert (G.rows() == 6 && G.cols() == model.qdot_size );
 
-	LOG << std::endl;
+	CalcBaseMotionSubspaces (model, ws);
+	body_spatial_jacobian_rows (model, ws, body_id, G, 0);
+}
 
-	unsigned int reference_body_id = body_id;
-	Vector3d reference_point = point_position;
+RBDL_DLLAPI
+void CalcBodySpatialJacobians (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		MatrixNd &G,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
 
-	if (model.IsFixedBodyId(body_id)) {
-		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
-		reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
-		Vector3d base_coords = CalcBodyToBaseCoordinates (model, Q, body_id, point_position, false);
-		reference_point = CalcBaseToBodyCoordinates (model, Q, reference_body_id, base_coords, false);
+	assert (G.rows() == 6 * (unsigned int) body_ids.size() && G.cols() == model.qdot_size );
+
+	// update the Kinematics if necessary
+	if (update_kinematics) {
+		UpdateKinematicsCustom (model, ws, &Q, NULL, NULL);
 	}
 
-	SpatialTransform p_X_i (CalcBodyWorldOrientation (model, Q, reference_body_id, false).transpose(), reference_point);
+	CalcBaseMotionSubspaces (model, ws);
 
-	SpatialVector p_v_i = p_X_i.apply(model.v[reference_body_id]);
-	Vector3d a_dash = Vector3d (p_v_i[0], p_v_i[1], p_v_i[2]).cross(Vector3d (p_v_i[3], p_v_i[4], p_v_i[5]));
-	SpatialVector p_a_i = p_X_i.apply(model.a[reference_body_id]);
+	for (unsigned int i = 0; i < body_ids.size(); i++) {
+		body_spatial_jacobian_rows (model, ws, body_ids[i], G, 6 * i);
+	}
+}
 
-	return Vector3d (
-			p_a_i[3] + a_dash[0],
-			p_a_i[4] + a_dash[1],
-			p_a_i[5] + a_dash[2]
-			);
+/** \brief Transforms a motion vector from body coordinates into base
+ * coordinates (i.e. applies the inverse of base_to_body) */
+static SpatialVector motion_to_base (const SpatialTransform &base_to_body, const SpatialVector &m) {
+	Vector3d omega = base_to_body.E.transpose() * Vector3d (m[0], m[1], m[2]);
+	Vector3d v = base_to_body.E.transpose() * Vector3d (m[3], m[4], m[5]) + base_to_body.r.cross (omega);
+
+	return SpatialVector (omega[0], omega[1], omega[2], v[0], v[1], v[2]);
 }
 
-RBDL_DLLAPI 
-bool InverseKinematics (
-		Model &model,
-		const VectorNd &Qinit,
-		const std::vector<unsigned int>& body_id,
-		const std::vector<Vector3d>& body_point,
-		const std::vector<Vector3d>& target_pos,
-		VectorNd &Qres,
-		double step_tol,
-		double lambda,
-		unsigned int max_iter
-		) {
+/** \brief Computes the time derivatives of DynamicsWorkspace::S_base
+ *
+ * Requires that S_base and the velocities v are up to date. A joint
+ * column moves with the velocity of the part of the joint that lies
+ * between the parent and the column itself, i.e. the velocity of the
+ * parent plus the contributions of the preceding columns of the same
+ * joint. Spherical joints are the exception as their motion subspace is
+ * fixed in the child body.
+ */
+static void update_base_motion_subspace_derivatives (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &QDot) {
+	if (ws.S_dot_base_valid && ws.S_dot_base.cols() == model.qdot_size)
+		return;
 
-	assert (Qinit.size() == model.q_size);
-	assert (body_id.size() == body_point.size());
-	assert (body_id.size() == target_pos.size());
+	if (ws.S_dot_base.rows() != 6 || ws.S_dot_base.cols() != model.qdot_size)
+		ws.S_dot_base.resize (6, model.qdot_size);
 
-	MatrixNd J = MatrixNd::Zero(3 * body_id.size(), model.qdot_size);
-	VectorNd e = VectorNd::Zero(3 * body_id.size());
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		unsigned int q_index = model.mJoints[i].q_index;
+		unsigned int lambda = model.lambda[i];
 
-	Qres = Qinit;
+		SpatialVector v_joint (SpatialVector::Zero());
+		if (model.mJoints[i].mJointType == JointTypeSpherical) {
+			v_joint = motion_to_base (ws.X_base[i], ws.v[i]);
+		} else if (lambda != 0) {
+			v_joint = motion_to_base (ws.X_base[lambda], ws.v[lambda]);
+		}
 
-	for (unsigned int ik_iter = 0; ik_iter < max_iter; ik_iter++) {
-		UpdateKinematicsCustom (model, &Qres, NULL, NULL);
+		for (unsigned int k = q_index; k < q_index + model.mJoints[i].mDoFCount; k++) {
+			SpatialVector S_k (ws.S_base.col(k));
+			ws.S_dot_base.col(k) = crossm (v_joint, S_k);
 
-		for (unsigned int k = 0; k < body_id.size(); k++) {
-			MatrixNd G (MatrixNd::Zero(3, model.qdot_size));
-			CalcPointJacobian (model, Qres, body_id[k], body_point[k], G, false);
-			Vector3d point_base = CalcBodyToBaseCoordinates (model, Qres, body_id[k], body_point[k], false);
-			LOG << "current_pos = " << point_base.transpose() << std::endl;
+			if (model.mJoints[i].mJointType != JointTypeSpherical)
+				v_joint += S_k * QDot[k];
+		}
+	}
 
-			for (unsigned int i = 0; i < 3; i++) {
-				for (unsigned int j = 0; j < model.qdot_size; j++) {
-					unsigned int row = k * 3 + i;
-					LOG << "i = " << i << " j = " << j << " k = " << k << " row = " << row << " col = " << j << std::endl;
-					J(row, j) = G (i,j);
-				}
+	ws.S_dot_base_valid = true;
+}
 
-				e[k * 3 + i] = target_pos[k][i] - point_base[i];
-			}
+/** \brief Updates the kinematics if requested and makes sure S_base and
+ * S_dot_base are up to date
+ */
+static void prepare_jacobian_derivatives (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		bool update_kinematics) {
+	assert (model.q_size == Q.size());
+	assert (model.qdot_size == QDot.size());
 
-			LOG << J << std::endl;
+	if (update_kinematics) {
+		UpdateKinematicsCustom (model, ws, &Q, &QDot, NULL);
+	}
 
-			// abort if we are getting "close"
-			if (e.norm() < step_tol) {
-				LOG << "Reached target close enough after " << ik_iter << " steps" << std::endl;
-				return true;
-			}
-		}
+	CalcBaseMotionSubspaces (model, ws);
+	update_base_motion_subspace_derivatives (model, ws, QDot);
+}
 
-		LOG << "J = " << J << std::endl;
-		LOG << "e = " << e.transpose() << std::endl;
+/** \brief Returns the movable body that a (possibly fixed) body is
+ * attached to */
+static unsigned int movable_body_id (const Model &model, unsigned int body_id) {
+	if (model.IsFixedBodyId(body_id)) {
+		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
+		return model.mFixedBodies[fbody_id].mMovableParent;
+	}
 
-		MatrixNd JJTe_lambda2_I = J * J.transpose() + lambda*lambda * MatrixNd::Identity(e.size(), e.size());
+	return body_id;
+}
 
-		VectorNd z (body_id.size() * 3);
+/** \brief Writes the non-zero columns of the time derivative of the
+ * jacobian of a point (given in base coordinates) into the rows row, ...,
+ * row + 2 of G
+ *
+ * Requires that S_base and S_dot_base are up to date.
+ */
+static void point_jacobian_dot_rows (
+		const Model &model,
+		const DynamicsWorkspace &ws,
+		unsigned int body_id,
+		const Vector3d &point_base,
+		MatrixNd &G,
+		unsigned int row) {
+	unsigned int j = movable_body_id (model, body_id);
+
+	SpatialVector v_body = motion_to_base (ws.X_base[j], ws.v[j]);
+	Vector3d point_velocity = Vector3d (v_body[3], v_body[4], v_body[5])
+		+ Vector3d (v_body[0], v_body[1], v_body[2]).cross (point_base);
+
+	while (j != 0) {
+		unsigned int q_index = model.mJoints[j].q_index;
+
+		for (unsigned int k = q_index; k < q_index + model.mJoints[j].mDoFCount; k++) {
+			Vector3d omega (ws.S_base(0, k), ws.S_base(1, k), ws.S_base(2, k));
+			Vector3d omega_dot (ws.S_dot_base(0, k), ws.S_dot_base(1, k), ws.S_dot_base(2, k));
+			Vector3d v_dot (ws.S_dot_base(3, k), ws.S_dot_base(4, k), ws.S_dot_base(5, k));
+
+			G.block(row, k, 3, 1) = v_dot + omega_dot.cross (point_base) + omega.cross (point_velocity);
+		}
+
+		j = model.lambda[j];
+	}
+}
+
+/** \brief Computes the bias acceleration of a point (given in base
+ * coordinates) from the columns of S_dot_base
+ *
+ * Requires that S_base and S_dot_base are up to date.
+ */
+static Vector3d point_jacobian_dot_qdot (
+		const Model &model,
+		const DynamicsWorkspace &ws,
+		const VectorNd &QDot,
+		unsigned int body_id,
+		const Vector3d &point_base) {
+	unsigned int j = movable_body_id (model, body_id);
+
+	SpatialVector v_body = motion_to_base (ws.X_base[j], ws.v[j]);
+	Vector3d omega_body (v_body[0], v_body[1], v_body[2]);
+	Vector3d point_velocity = Vector3d (v_body[3], v_body[4], v_body[5]) + omega_body.cross (point_base);
+
+	// sum of the columns of S_dot_base weighted with the joint velocities
+	SpatialVector a_bias (SpatialVector::Zero());
+
+	while (j != 0) {
+		unsigned int q_index = model.mJoints[j].q_index;
+
+		for (unsigned int k = q_index; k < q_index + model.mJoints[j].mDoFCount; k++) {
+			a_bias += SpatialVector (ws.S_dot_base.col(k)) * QDot[k];
+		}
+
+		j = model.lambda[j];
+	}
+
+	return Vector3d (a_bias[3], a_bias[4], a_bias[5])
+		+ Vector3d (a_bias[0], a_bias[1], a_bias[2]).cross (point_base)
+		+ omega_body.cross (point_velocity);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobianDot (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		unsigned int body_id,
+		const Vector3d &point_position,
+		MatrixNd &G,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (G.rows() == 3 && G.cols() == model.qdot_size );
+
+	prepare_jacobian_derivatives (model, ws, Q, QDot, update_kinematics);
+
+	Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, body_id, point_position, false);
+	point_jacobian_dot_rows (model, ws, body_id, point_base, G, 0);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobiansDot (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Vector3d> &point_positions,
+		MatrixNd &G,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (body_ids.size() == point_positions.size());
+	assert (G.rows() == 3 * (unsigned int) body_ids.size() && G.cols() == model.qdot_size );
+
+	prepare_jacobian_derivatives (model, ws, Q, QDot, update_kinematics);
+
+	for (unsigned int i = 0; i < body_ids.size(); i++) {
+		Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, body_ids[i], point_positions[i], false);
+		point_jacobian_dot_rows (model, ws, body_ids[i], point_base, G, 3 * i);
+	}
+}
+
+RBDL_DLLAPI
+Vector3d CalcPointJacobianDotQDot (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		unsigned int body_id,
+		const Vector3d &point_position,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	prepare_jacobian_derivatives (model, ws, Q, QDot, update_kinematics);
+
+	Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, body_id, point_position, false);
+	return point_jacobian_dot_qdot (model, ws, QDot, body_id, point_base);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobiansDotQDot (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Vector3d> &point_positions,
+		VectorNd &result,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (body_ids.size() == point_positions.size());
+
+	if (result.size() != 3 * (unsigned int) body_ids.size())
+		result.resize (3 * body_ids.size());
+
+	prepare_jacobian_derivatives (model, ws, Q, QDot, update_kinematics);
+
+	for (unsigned int i = 0; i < body_ids.size(); i++) {
+		Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, body_ids[i], point_positions[i], false);
+		result.block(3 * i, 0, 3, 1) = point_jacobian_dot_qdot (model, ws, QDot, body_ids[i], point_base);
+	}
+}
+
+RBDL_DLLAPI
+void CalcBodySpatialJacobianDot (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		unsigned int body_id,
+		MatrixNd &G,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (G.rows() == 6 && G.cols() == model.qdot_size );
+
+	prepare_jacobian_derivatives (model, ws, Q, QDot, update_kinematics);
+
+	unsigned int j = movable_body_id (model, body_id);
+
+	SpatialTransform base_to_body;
+	if (model.IsFixedBodyId(body_id)) {
+		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
+		base_to_body = model.mFixedBodies[fbody_id].mParentTransform * ws.X_base[j];
+	} else {
+		base_to_body = ws.X_base[j];
+	}
+
+	const Matrix3d &E = base_to_body.E;
+	const Vector3d &r = base_to_body.r;
+
+	// The columns are S_base transformed into the moving body frame, hence
+	// their derivative also contains the motion of the body frame itself.
+	SpatialVector v_body = motion_to_base (ws.X_base[j], ws.v[j]);
+
+	while (j != 0) {
+		unsigned int q_index = model.mJoints[j].q_index;
+
+		for (unsigned int k = q_index; k < q_index + model.mJoints[j].mDoFCount; k++) {
+			SpatialVector S_k (ws.S_base.col(k));
+			SpatialVector S_dot_k = SpatialVector (ws.S_dot_base.col(k)) - crossm (v_body, S_k);
+
+			Vector3d omega (S_dot_k[0], S_dot_k[1], S_dot_k[2]);
+			Vector3d v (S_dot_k[3], S_dot_k[4], S_dot_k[5]);
+
+			G.block(0, k, 3, 1) = E * omega;
+			G.block(3, k, 3, 1) = E * (v - r.cross (omega));
+		}
+
+		j = model.lambda[j];
+	}
+}
+
+RBDL_DLLAPI
+Vector3d CalcPointVelocity (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		unsigned int body_id,
+		const Vector3d &point_position,
+		bool update_kinematics
+	) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+	assert (model.IsBodyId(body_id));
+	assert (model.q_size == Q.size());
+	assert (model.qdot_size == QDot.size());
+
+	// Reset the velocity of the root body
+	ws.v[0].setZero();
+
+	// update the Kinematics with zero acceleration
+	if (update_kinematics) {
+		UpdateKinematicsCustom (model, ws, &Q, &QDot, NULL);
+	}
+
+	unsigned int reference_body_id = body_id;
+	Vector3d reference_point = point_position;
+
+	if (model.IsFixedBodyId(body_id)) {
+		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
+		reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
+		Vector3d base_coords = CalcBodyToBaseCoordinates (model, ws, Q, body_id, point_position, false);
+		reference_point = CalcBaseToBodyCoordinates (model, ws, Q, reference_body_id, base_coords, false);
+
+	}
+
+	SpatialVector point_spatial_velocity = SpatialTransform (CalcBodyWorldOrientation (model, ws, Q, reference_body_id, false).transpose(), reference_point).apply(ws.v[reference_body_id]);
+
+	return Vector3d (
+			point_spatial_velocity[3],
+			point_spatial_velocity[4],
+			point_spatial_velocity[5]
+			);
+}
+
+RBDL_DLLAPI
+Vector3d CalcPointAcceleration (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &QDDot,
+		unsigned int body_id,
+		const Vector3d &point_position,
+		bool update_kinematics
+	)
+{
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	// Reset the velocity of the root body
+	ws.v[0].setZero();
+	ws.a[0].setZero();
+
+	if (update_kinematics)
+		UpdateKinematics (model, ws, Q, QDot, QDDot);
+
+	LOG << std::endl;
+
+	unsigned int reference_body_id = body_id;
+	Vector3d reference_point = point_position;
+
+	if (model.IsFixedBodyId(body_id)) {
+		unsigned int fbody_id = body_id - model.fixed_body_discriminator;
+		reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
+		Vector3d base_coords = CalcBodyToBaseCoordinates (model, ws, Q, body_id, point_position, false);
+		reference_point = CalcBaseToBodyCoordinates (model, ws, Q, reference_body_id, base_coords, false);
+	}
+
+	SpatialTransform p_X_i (CalcBodyWorldOrientation (model, ws, Q, reference_body_id, false).transpose(), reference_point);
+
+	SpatialVector p_v_i = p_X_i.apply(ws.v[reference_body_id]);
+	Vector3d a_dash = Vector3d (p_v_i[0], p_v_i[1], p_v_i[2]).cross(Vector3d (p_v_i[3], p_v_i[4], p_v_i[5]));
+	SpatialVector p_a_i = p_X_i.apply(ws.a[reference_body_id]);
+
+	return Vector3d (
+			p_a_i[3] + a_dash[0],
+			p_a_i[4] + a_dash[1],
+			p_a_i[5] + a_dash[2]
+			);
+}
+
+RBDL_DLLAPI 
+bool InverseKinematics (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Qinit,
+		const std::vector<unsigned int>& body_id,
+		const std::vector<Vector3d>& body_point,
+		const std::vector<Vector3d>& target_pos,
+		VectorNd &Qres,
+		double step_tol,
+		double lambda,
+		unsigned int max_iter
+		) {
+
+	assert (Qinit.size() == model.q_size);
+	assert (body_id.size() == body_point.size());
+	assert (body_id.size() == target_pos.size());
+
+	unsigned int num_rows = 3 * body_id.size();
+	// the damped least squares step is computed from the smaller of the
+	// normal equations J J^T and J^T J
+	bool row_space = num_rows <= model.qdot_size;
+	unsigned int num_sys = row_space ? num_rows : model.qdot_size;
+
+	MatrixNd J = MatrixNd::Zero(num_rows, model.qdot_size);
+	VectorNd e = VectorNd::Zero(num_rows);
+	MatrixNd JJTe_lambda2_I (num_sys, num_sys);
+	VectorNd rhs (num_sys);
+	VectorNd z (num_sys);
+	VectorNd delta_theta (model.qdot_size);
 #ifndef RBDL_USE_SIMPLE_MATH
-		z = JJTe_lambda2_I.colPivHouseholderQr().solve (e);
+	Eigen::LLT<MatrixNd> llt (num_sys);
+#endif
+
+	Qres = Qinit;
+
+	for (unsigned int ik_iter = 0; ik_iter < max_iter; ik_iter++) {
+		J.setZero();
+		CalcPointJacobians (model, ws, Qres, body_id, body_point, J, true);
+
+		for (unsigned int k = 0; k < body_id.size(); k++) {
+			Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Qres, body_id[k], body_point[k], false);
+			LOG << "current_pos = " << point_base.transpose() << std::endl;
+
+			e.block(k * 3, 0, 3, 1) = target_pos[k] - point_base;
+		}
+
+		// abort if we are getting "close"
+		if (e.norm() < step_tol) {
+			LOG << "Reached target close enough after " << ik_iter << " steps" << std::endl;
+			return true;
+		}
+
+		LOG << "J = " << J << std::endl;
+		LOG << "e = " << e.transpose() << std::endl;
+
+		if (row_space) {
+			JJTe_lambda2_I.noalias() = J * J.transpose();
+			rhs = e;
+		} else {
+			JJTe_lambda2_I.noalias() = J.transpose() * J;
+			rhs.noalias() = J.transpose() * e;
+		}
+		for (unsigned int i = 0; i < num_sys; i++)
+			JJTe_lambda2_I(i, i) += lambda * lambda;
+
+#ifndef RBDL_USE_SIMPLE_MATH
+		// the system is positive definite unless lambda == 0 and J does not
+		// have full rank (e.g. at singular poses)
+		llt.compute (JJTe_lambda2_I);
+		if (llt.info() == Eigen::Success) {
+			z = rhs;
+			llt.solveInPlace (z);
+		} else {
+			z = JJTe_lambda2_I.colPivHouseholderQr().solve (rhs);
+		}
 #else
-		bool solve_successful = LinSolveGaussElimPivot (JJTe_lambda2_I, e, z);
+		bool solve_successful = LinSolveGaussElimPivot (JJTe_lambda2_I, rhs, z);
 		assert (solve_successful);
 #endif
 
 		LOG << "z = " << z << std::endl;
 
-		VectorNd delta_theta = J.transpose() * z;
+		if (row_space) {
+			delta_theta.noalias() = J.transpose() * z;
+		} else {
+			delta_theta = z;
+		}
 		LOG << "change = " << delta_theta << std::endl;
 
-		Qres = Qres + delta_theta;
+		Qres += delta_theta;
 		LOG << "Qres = " << Qres.transpose() << std::endl;
 
 		if (delta_theta.norm() < step_tol) {
 			LOG << "reached convergence after " << ik_iter << " steps" << std::endl;
 			return true;
 		}
+	}
+
+	return false;
+}
+
+InverseKinematicsConstraintSet::InverseKinematicsConstraintSet() :
+	num_rows (0),
+	lambda (1.0e-2),
+	lambda_min (1.0e-9),
+	lambda_max (1.0e6),
+	lambda_increase (10.),
+	lambda_decrease (0.3),
+	step_tol (1.0e-12),
+	constraint_tol (1.0e-12),
+	max_steps (100),
+	warm_start (false),
+	num_steps (0),
+	num_rejected_steps (0),
+	error_norm (0.),
+	delta_q_norm (0.),
+	lambda_last (0.),
+	converged (false),
+	solve_count (0),
+	total_steps (0),
+	bound (false)
+{}
+
+unsigned int InverseKinematicsConstraintSet::AddPointConstraint (
+		unsigned int body_id,
+		const Vector3d &body_point,
+		const Vector3d &target_pos) {
+	constraint_type.push_back (ConstraintTypePosition);
+	body_ids.push_back (body_id);
+	body_points.push_back (body_point);
+	target_positions.push_back (target_pos);
+	target_orientations.push_back (Matrix3d::Identity());
+	constraint_row_index.push_back (num_rows);
+	num_rows += 3;
+
+	bound = false;
+
+	return body_ids.size() - 1;
+}
+
+unsigned int InverseKinematicsConstraintSet::AddOrientationConstraint (
+		unsigned int body_id,
+		const Matrix3d &target_orientation) {
+	constraint_type.push_back (ConstraintTypeOrientation);
+	body_ids.push_back (body_id);
+	body_points.push_back (Vector3d::Zero());
+	target_positions.push_back (Vector3d::Zero());
+	target_orientations.push_back (target_orientation);
+	constraint_row_index.push_back (num_rows);
+	num_rows += 3;
+
+	bound = false;
+
+	return body_ids.size() - 1;
+}
+
+unsigned int InverseKinematicsConstraintSet::AddFullConstraint (
+		unsigned int body_id,
+		const Vector3d &body_point,
+		const Vector3d &target_pos,
+		const Matrix3d &target_orientation) {
+	constraint_type.push_back (ConstraintTypeFull);
+	body_ids.push_back (body_id);
+	body_points.push_back (body_point);
+	target_positions.push_back (target_pos);
+	target_orientations.push_back (target_orientation);
+	constraint_row_index.push_back (num_rows);
+	num_rows += 6;
+
+	bound = false;
+
+	return body_ids.size() - 1;
+}
+
+void InverseKinematicsConstraintSet::ClearConstraints () {
+	constraint_type.clear();
+	body_ids.clear();
+	body_points.clear();
+	target_positions.clear();
+	target_orientations.clear();
+	constraint_row_index.clear();
+	num_rows = 0;
+
+	bound = false;
+}
+
+void InverseKinematicsConstraintSet::SetJointLimits (const VectorNd &q_min, const VectorNd &q_max) {
+	assert (q_min.size() == q_max.size());
+
+	this->q_min = q_min;
+	this->q_max = q_max;
+}
+
+void InverseKinematicsConstraintSet::ResetStatistics () {
+	num_steps = 0;
+	num_rejected_steps = 0;
+	error_norm = 0.;
+	delta_q_norm = 0.;
+	lambda_last = 0.;
+	converged = false;
+	solve_count = 0;
+	total_steps = 0;
+}
+
+bool InverseKinematicsConstraintSet::Bind (const Model &model) {
+	assert (q_min.size() == 0 || q_min.size() == model.q_size);
+	assert (q_max.size() == q_min.size());
+
+	unsigned int n = model.qdot_size;
+	// size of the normal equations
+	unsigned int m = num_rows < n ? num_rows : n;
+
+	J = MatrixNd::Zero (num_rows, n);
+	e = VectorNd::Zero (num_rows);
+	e_trial = VectorNd::Zero (num_rows);
+	JJt = MatrixNd::Zero (m, m);
+	A = MatrixNd::Zero (m, m);
+	z = VectorNd::Zero (m);
+	delta_q = VectorNd::Zero (n);
+	Q_trial = VectorNd::Zero (model.q_size);
+
+#ifndef RBDL_USE_SIMPLE_MATH
+	llt = Eigen::LLT<MatrixNd> (m);
+#endif
+
+	lambda_last = 0.;
+	bound = true;
+
+	return bound;
+}
+
+/** \brief Returns the rotation vector of a rotation matrix, i.e. the axis
+ * scaled by the angle of the rotation
+ */
+static Vector3d rotation_vector (const Matrix3d &R) {
+	Vector3d v (
+			0.5 * (R(2,1) - R(1,2)),
+			0.5 * (R(0,2) - R(2,0)),
+			0.5 * (R(1,0) - R(0,1))
+			);
+
+	double cos_angle = 0.5 * (R(0,0) + R(1,1) + R(2,2) - 1.);
+	double sin_angle = v.norm();
+
+	// unlike acos() this is accurate for small angles
+	double angle = std::atan2 (sin_angle, cos_angle);
+
+	if (cos_angle > 0.) {
+		if (sin_angle < 1.0e-12)
+			return v;
+
+		return v * (angle / sin_angle);
+	}
+
+	if (sin_angle > 1.0e-6)
+		return v * (angle / sin_angle);
+
+	// rotations by (almost) pi: the axis is the largest column of R + I
+	Matrix3d R_sym = R + Matrix3d::Identity();
+	unsigned int col = 0;
+	for (unsigned int i = 1; i < 3; i++) {
+		if (R_sym.block(0, i, 3, 1).squaredNorm() > R_sym.block(0, col, 3, 1).squaredNorm())
+			col = i;
+	}
+
+	Vector3d axis = R_sym.block(0, col, 3, 1);
+	return axis * (angle / axis.norm());
+}
+
+/** \brief Writes the non-zero columns of the jacobian of the angular
+ * velocity of a body in base coordinates into the rows row, ..., row + 2
+ * of G
+ *
+ * Requires that DynamicsWorkspace::S_base is up to date.
+ */
+static void orientation_jacobian_rows (
+		const Model &model,
+		const DynamicsWorkspace &ws,
+		unsigned int body_id,
+		MatrixNd &G,
+		unsigned int row) {
+	unsigned int j = movable_body_id (model, body_id);
+
+	while (j != 0) {
+		unsigned int q_index = model.mJoints[j].q_index;
+
+		for (unsigned int k = q_index; k < q_index + model.mJoints[j].mDoFCount; k++) {
+			G.block(row, k, 3, 1) = ws.S_base.block(0, k, 3, 1);
+		}
 
-		VectorNd test_1 (z.size());
-		VectorNd test_res (z.size());
+		j = model.lambda[j];
+	}
+}
+
+/** \brief Computes the stacked error of the inverse kinematics constraints
+ * at the current kinematic state
+ *
+ * The orientation error is the rotation vector (in base coordinates) that
+ * rotates the body onto its target orientation.
+ */
+static void ik_constraint_error (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const InverseKinematicsConstraintSet &CS,
+		const VectorNd &Q,
+		VectorNd &e) {
+	for (unsigned int k = 0; k < CS.size(); k++) {
+		unsigned int row = CS.constraint_row_index[k];
+
+		if (CS.constraint_type[k] != InverseKinematicsConstraintSet::ConstraintTypeOrientation) {
+			Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, CS.body_ids[k], CS.body_points[k], false);
+			e.block(row, 0, 3, 1) = CS.target_positions[k] - point_base;
+			row += 3;
+		}
 
-		test_1.setZero();
+		if (CS.constraint_type[k] != InverseKinematicsConstraintSet::ConstraintTypePosition) {
+			Matrix3d E = CalcBodyWorldOrientation (model, ws, Q, CS.body_ids[k], false);
+			e.block(row, 0, 3, 1) = rotation_vector (CS.target_orientations[k].transpose() * E);
+		}
+	}
+}
 
-		for (unsigned int i = 0; i < z.size(); i++) {
-			test_1[i] = 1.;
+/** \brief Computes the stacked jacobian of the inverse kinematics
+ * constraints at the current kinematic state */
+static void ik_constraint_jacobian (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const InverseKinematicsConstraintSet &CS,
+		const VectorNd &Q,
+		MatrixNd &J) {
+	CalcBaseMotionSubspaces (model, ws);
 
-			VectorNd test_delta = J.transpose() * test_1;
+	J.setZero();
 
-			test_res[i] = test_delta.squaredNorm();
+	for (unsigned int k = 0; k < CS.size(); k++) {
+		unsigned int row = CS.constraint_row_index[k];
 
-			test_1[i] = 0.;
+		if (CS.constraint_type[k] != InverseKinematicsConstraintSet::ConstraintTypeOrientation) {
+			Vector3d point_base = CalcBodyToBaseCoordinates (model, ws, Q, CS.body_ids[k], CS.body_points[k], false);
+			point_jacobian_rows (model, ws, CS.body_ids[k], point_base, J, row);
+			row += 3;
 		}
 
-		LOG << "test_res = " << test_res.transpose() << std::endl;
+		if (CS.constraint_type[k] != InverseKinematicsConstraintSet::ConstraintTypePosition) {
+			orientation_jacobian_rows (model, ws, CS.body_ids[k], J, row);
+		}
 	}
+}
 
-	return false;
+/** \brief Applies a step in the space of the generalized velocities to Q
+ * and projects the result onto the joint limits
+ *
+ * Spherical joints are rotated about the step in body coordinates.
+ */
+static void ik_apply_step (
+		const Model &model,
+		const InverseKinematicsConstraintSet &CS,
+		const VectorNd &Q,
+		const VectorNd &delta_q,
+		VectorNd &Q_result) {
+	Q_result = Q;
+
+	bool has_limits = CS.q_min.size() == model.q_size;
+
+	for (unsigned int i = 1; i < model.mJoints.size(); i++) {
+		unsigned int q_index = model.mJoints[i].q_index;
+
+		if (model.mJoints[i].mJointType == JointTypeSpherical) {
+			Vector3d omega = delta_q.block(q_index, 0, 3, 1);
+			double angle = omega.norm();
+
+			if (angle > 0.) {
+				Quaternion quat = Quaternion::fromAxisAngle (omega, angle) * model.GetQuaternion (i, Q);
+				model.SetQuaternion (i, quat, Q_result);
+			}
+
+			continue;
+		}
+
+		for (unsigned int k = q_index; k < q_index + model.mJoints[i].mDoFCount; k++) {
+			Q_result[k] += delta_q[k];
+
+			if (has_limits) {
+				if (Q_result[k] < CS.q_min[k])
+					Q_result[k] = CS.q_min[k];
+				else if (Q_result[k] > CS.q_max[k])
+					Q_result[k] = CS.q_max[k];
+			}
+		}
+	}
+}
+
+/** \brief Computes the damped least squares step for the current J and e
+ *
+ * Depending on the shape of J either
+ *   \f$ \Delta q = J^T (J J^T + \lambda^2 I)^{-1} e \f$ or
+ *   \f$ \Delta q = (J^T J + \lambda^2 I)^{-1} J^T e \f$
+ * is computed. CS.JJt has to contain the undamped normal matrix.
+ *
+ * \returns false if the damped normal matrix is numerically singular (e.g.
+ * for a small lambda and a rank deficient J), CS.delta_q is then invalid
+ */
+static bool ik_damped_step (InverseKinematicsConstraintSet &CS, double lambda) {
+	unsigned int m = CS.JJt.rows();
+	bool row_space = CS.num_rows <= CS.J.cols();
+
+	CS.A = CS.JJt;
+	for (unsigned int i = 0; i < m; i++)
+		CS.A(i, i) += lambda * lambda;
+
+	if (row_space) {
+		CS.z = CS.e;
+	} else {
+		CS.z.noalias() = CS.J.transpose() * CS.e;
+	}
+
+#ifndef RBDL_USE_SIMPLE_MATH
+	CS.llt.compute (CS.A);
+	if (CS.llt.info() != Eigen::Success)
+		return false;
+
+	CS.llt.solveInPlace (CS.z);
+#else
+	VectorNd rhs (CS.z);
+	if (!LinSolveGaussElimPivot (CS.A, rhs, CS.z))
+		return false;
+#endif
+
+	if (row_space) {
+		CS.delta_q.noalias() = CS.J.transpose() * CS.z;
+	} else {
+		CS.delta_q = CS.z;
+	}
+
+	return true;
+}
+
+RBDL_DLLAPI
+bool InverseKinematics (
+		const Model &model,
+		DynamicsWorkspace &ws,
+		const VectorNd &Qinit,
+		InverseKinematicsConstraintSet &CS,
+		VectorNd &Qres
+		) {
+	LOG << "-------- " << __func__ << " --------" << std::endl;
+
+	assert (Qinit.size() == model.q_size);
+
+	if (!CS.bound || CS.J.cols() != model.qdot_size || CS.J.rows() != CS.num_rows) {
+		CS.Bind (model);
+	}
+
+	double lambda = CS.lambda;
+	if (CS.warm_start && CS.lambda_last > 0.)
+		lambda = CS.lambda_last;
+
+	CS.num_steps = 0;
+	CS.num_rejected_steps = 0;
+	CS.delta_q_norm = 0.;
+	CS.converged = false;
+	CS.solve_count++;
+
+	// Qinit and Qres may be the same vector
+	if (&Qres != &Qinit)
+		Qres = Qinit;
+
+	// project the initial guess onto the limits
+	CS.delta_q.setZero();
+	ik_apply_step (model, CS, Qres, CS.delta_q, CS.Q_trial);
+	Qres = CS.Q_trial;
+
+	UpdateKinematicsCustom (model, ws, &Qres, NULL, NULL);
+	ik_constraint_error (model, ws, CS, Qres, CS.e);
+	CS.error_norm = CS.e.norm();
+
+	// whether J and JJt belong to Qres
+	bool jacobian_valid = false;
+
+	while (CS.num_steps < CS.max_steps) {
+		if (CS.error_norm < CS.constraint_tol) {
+			CS.converged = true;
+			break;
+		}
+
+		if (!jacobian_valid) {
+			ik_constraint_jacobian (model, ws, CS, Qres, CS.J);
+
+			if (CS.num_rows <= CS.J.cols()) {
+				CS.JJt.noalias() = CS.J * CS.J.transpose();
+			} else {
+				CS.JJt.noalias() = CS.J.transpose() * CS.J;
+			}
+			jacobian_valid = true;
+		}
+
+		if (!ik_damped_step (CS, lambda)) {
+			// discard the step without evaluating it and retry with more
+			// damping, which makes the system positive definite again
+			CS.num_steps++;
+			CS.num_rejected_steps++;
+
+			if (lambda < CS.lambda_min)
+				lambda = CS.lambda_min;
+			lambda *= CS.lambda_increase;
+			if (lambda > CS.lambda_max) {
+				LOG << "singular system after " << CS.num_steps << " steps" << std::endl;
+				break;
+			}
+			continue;
+		}
+
+		ik_apply_step (model, CS, Qres, CS.delta_q, CS.Q_trial);
+		CS.num_steps++;
+
+		UpdateKinematicsCustom (model, ws, &CS.Q_trial, NULL, NULL);
+		ik_constraint_error (model, ws, CS, CS.Q_trial, CS.e_trial);
+		double error_norm_trial = CS.e_trial.norm();
+
+		LOG << "step " << CS.num_steps << " lambda = " << lambda << " error = " << error_norm_trial << std::endl;
+
+		if (error_norm_trial < CS.error_norm) {
+			// the kinematic state now belongs to Q_trial
+			Qres = CS.Q_trial;
+			CS.e = CS.e_trial;
+			CS.error_norm = error_norm_trial;
+			CS.delta_q_norm = CS.delta_q.norm();
+			jacobian_valid = false;
+
+			lambda *= CS.lambda_decrease;
+			if (lambda < CS.lambda_min)
+				lambda = CS.lambda_min;
+
+			if (CS.delta_q_norm < CS.step_tol) {
+				CS.converged = true;
+				break;
+			}
+		} else {
+			CS.num_rejected_steps++;
+
+			lambda *= CS.lambda_increase;
+			if (lambda > CS.lambda_max) {
+				LOG << "no further progress after " << CS.num_steps << " steps" << std::endl;
+				break;
+			}
+		}
+	}
+
+	// discarded steps leave the kinematics at the trial state
+	if (CS.num_steps > 0 && jacobian_valid)
+		UpdateKinematicsCustom (model, ws, &Qres, NULL, NULL);
+
+	if (CS.error_norm < CS.constraint_tol)
+		CS.converged = true;
+
+	CS.lambda_last = lambda;
+	CS.total_steps += CS.num_steps;
+
+	LOG << "converged = " << CS.converged << " after " << CS.num_steps << " steps" << std::endl;
+
+	return CS.converged;
+}
+
+RBDL_DLLAPI
+void UpdateKinematics (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &QDDot
+		) {
+	UpdateKinematics (model, model, Q, QDot, QDDot);
+}
+
+RBDL_DLLAPI
+void UpdateKinematicsCustom (
+		Model &model,
+		const Math::VectorNd *Q,
+		const Math::VectorNd *QDot,
+		const Math::VectorNd *QDDot
+		) {
+	UpdateKinematicsCustom (model, model, Q, QDot, QDDot);
+}
+
+RBDL_DLLAPI
+void UpdateKinematicsIncremental (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd *QDot,
+		const Math::VectorNd *QDDot
+		) {
+	UpdateKinematicsIncremental (model, model, Q, QDot, QDDot);
+}
+
+RBDL_DLLAPI
+Math::Vector3d CalcBodyToBaseCoordinates (
+		Model &model,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		const Math::Vector3d &body_point_position,
+		bool update_kinematics
+		) {
+	return CalcBodyToBaseCoordinates (model, model, Q, body_id, body_point_position, update_kinematics);
+}
+
+RBDL_DLLAPI
+Math::Vector3d CalcBaseToBodyCoordinates (
+		Model &model,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		const Math::Vector3d &base_point_position,
+		bool update_kinematics
+		) {
+	return CalcBaseToBodyCoordinates (model, model, Q, body_id, base_point_position, update_kinematics);
+}
+
+RBDL_DLLAPI
+Math::Matrix3d CalcBodyWorldOrientation (
+		Model &model,
+		const Math::VectorNd &Q,
+		const unsigned int body_id,
+		bool update_kinematics
+		) {
+	return CalcBodyWorldOrientation (model, model, Q, body_id, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobian (
+		Model &model,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcPointJacobian (model, model, Q, body_id, point_position, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcBodySpatialJacobian (
+		Model &model,
+		const Math::VectorNd &Q,
+		unsigned int body_id,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcBodySpatialJacobian (model, model, Q, body_id, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobians (
+		Model &model,
+		const Math::VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcPointJacobians (model, model, Q, body_ids, point_positions, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcBodySpatialJacobians (
+		Model &model,
+		const Math::VectorNd &Q,
+		const std::vector<unsigned int> &body_ids,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcBodySpatialJacobians (model, model, Q, body_ids, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobianDot (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcPointJacobianDot (model, model, Q, QDot, body_id, point_position, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobiansDot (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcPointJacobiansDot (model, model, Q, QDot, body_ids, point_positions, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+Math::Vector3d CalcPointJacobianDotQDot (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		bool update_kinematics
+		) {
+	return CalcPointJacobianDotQDot (model, model, Q, QDot, body_id, point_position, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcPointJacobiansDotQDot (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const std::vector<unsigned int> &body_ids,
+		const std::vector<Math::Vector3d> &point_positions,
+		Math::VectorNd &result,
+		bool update_kinematics
+		) {
+	CalcPointJacobiansDotQDot (model, model, Q, QDot, body_ids, point_positions, result, update_kinematics);
+}
+
+RBDL_DLLAPI
+void CalcBodySpatialJacobianDot (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		Math::MatrixNd &G,
+		bool update_kinematics
+		) {
+	CalcBodySpatialJacobianDot (model, model, Q, QDot, body_id, G, update_kinematics);
+}
+
+RBDL_DLLAPI
+Math::Vector3d CalcPointVelocity (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		bool update_kinematics
+		) {
+	return CalcPointVelocity (model, model, Q, QDot, body_id, point_position, update_kinematics);
+}
+
+RBDL_DLLAPI
+Math::Vector3d CalcPointAcceleration (
+		Model &model,
+		const Math::VectorNd &Q,
+		const Math::VectorNd &QDot,
+		const Math::VectorNd &QDDot,
+		unsigned int body_id,
+		const Math::Vector3d &point_position,
+		bool update_kinematics
+		) {
+	return CalcPointAcceleration (model, model, Q, QDot, QDDot, body_id, point_position, update_kinematics);
+}
+
+RBDL_DLLAPI
+bool InverseKinematics (
+		Model &model,
+		const Math::VectorNd &Qinit,
+		const std::vector<unsigned int>& body_id,
+		const std::vector<Math::Vector3d>& body_point,
+		const std::vector<Math::Vector3d>& target_pos,
+		Math::VectorNd &Qres,
+		double step_tol,
+		double lambda,
+		unsigned int max_iter
+		) {
+	return InverseKinematics (model, model, Qinit, body_id, body_point, target_pos, Qres, step_tol, lambda, max_iter);
+}
+
+RBDL_DLLAPI
+bool InverseKinematics (
+		Model &model,
+		const Math::VectorNd &Qinit,
+		InverseKinematicsConstraintSet &CS,
+		Math::VectorNd &Qres
+		) {
+	return InverseKinematics (model, model, Qinit, CS, Qres);
 }
 
 }
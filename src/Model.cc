@@ -20,6 +20,116 @@
 using namespace RigidBodyDynamics;
 using namespace RigidBodyDynamics::Math;
 
+DynamicsWorkspace::DynamicsWorkspace (const Model &model) :
+	incremental_q_valid (false),
+	incremental_qdot_valid (false),
+	incremental_qddot_valid (false),
+	incremental_update_count (0),
+	S_base_valid (false),
+	S_dot_base_valid (false) {
+	Init (model);
+}
+
+void DynamicsWorkspace::Init (const Model &model) {
+	unsigned int body_count = model.mBodies.size();
+	SpatialVector zero_spatial (0., 0., 0., 0., 0., 0.);
+
+	// state information
+	v.assign (body_count, zero_spatial);
+	a.assign (body_count, zero_spatial);
+
+	// Joint state variables
+	X_J.assign (body_count, SpatialTransform());
+	v_J.resize (body_count);
+	for (unsigned int i = 0; i < body_count; i++) {
+		v_J[i] = model.S[i];
+	}
+	c_J.assign (body_count, zero_spatial);
+
+	// workspace for joints with 3 dof
+	multdof3_S.assign (body_count, Matrix63::Zero());
+	multdof3_U.assign (body_count, Matrix63::Zero());
+	multdof3_Dinv.assign (body_count, Matrix3d::Zero());
+	multdof3_u.assign (body_count, Vector3d::Zero());
+
+	// Dynamic variables
+	c.assign (body_count, zero_spatial);
+	IA.assign (body_count, SpatialMatrix::Zero(6,6));
+	IA[0] = SpatialMatrixIdentity;
+	pA.assign (body_count, zero_spatial);
+	U.assign (body_count, zero_spatial);
+
+	d = VectorNd::Zero (body_count);
+	u = VectorNd::Zero (body_count);
+
+	f.assign (body_count, zero_spatial);
+	Ic = model.I;
+	hc.assign (body_count, zero_spatial);
+
+	// Bodies
+	X_lambda.assign (body_count, SpatialTransform());
+	X_base.assign (body_count, SpatialTransform());
+
+	// Incremental kinematics
+	incremental_q = VectorNd::Zero (model.q_size);
+	incremental_qdot = VectorNd::Zero (model.qdot_size);
+	incremental_qddot = VectorNd::Zero (model.qdot_size);
+	incremental_q_valid = false;
+	incremental_qdot_valid = false;
+	incremental_qddot_valid = false;
+	incremental_dirty.assign (body_count, 0);
+	incremental_update_count = 0;
+
+	// Jacobians
+	S_base = MatrixNd::Zero (6, model.qdot_size);
+	S_base_valid = false;
+	S_dot_base = MatrixNd::Zero (6, model.qdot_size);
+	S_dot_base_valid = false;
+}
+
+BatchDynamicsWorkspace::BatchDynamicsWorkspace (const Model &model, unsigned int sample_count) {
+	Init (model, sample_count);
+}
+
+void BatchDynamicsWorkspace::Init (const Model &model, unsigned int sample_count) {
+	this->sample_count = sample_count;
+
+	unsigned int size = model.mBodies.size() * sample_count;
+	SpatialVector zero_spatial (0., 0., 0., 0., 0., 0.);
+
+	X_lambda.assign (size, SpatialTransform());
+	v.assign (size, zero_spatial);
+	a.assign (size, zero_spatial);
+	c.assign (size, zero_spatial);
+	IA.assign (size, SpatialMatrix::Zero(6,6));
+	pA.assign (size, zero_spatial);
+	U.assign (size, zero_spatial);
+
+	d = VectorNd::Zero (size);
+	u = VectorNd::Zero (size);
+
+	bool has_multdof3 = false;
+	for (unsigned int i = 1; i < model.mJoints.size(); i++) {
+		if (model.mJoints[i].mDoFCount == 3)
+			has_multdof3 = true;
+	}
+
+	if (has_multdof3) {
+		multdof3_S.assign (size, Matrix63::Zero());
+		multdof3_U.assign (size, Matrix63::Zero());
+		multdof3_Dinv.assign (size, Matrix3d::Zero());
+		multdof3_u.assign (size, Vector3d::Zero());
+	} else {
+		multdof3_S.clear();
+		multdof3_U.clear();
+		multdof3_Dinv.clear();
+		multdof3_u.clear();
+	}
+
+	v_J.assign (sample_count, zero_spatial);
+	c_J.assign (sample_count, zero_spatial);
+}
+
 Model::Model() {
 	Body root_body;
 	Joint root_joint;
@@ -44,8 +154,13 @@ Model::Model() {
 
 	// Joints
 	mJoints.push_back(root_joint);
+	mJointKernels.push_back (NULL);
+	mJointPositionKernels.push_back (NULL);
 	S.push_back (zero_spatial);
 	X_T.push_back(SpatialTransform());
+	X_J_kind.push_back (SpatialTransformTranslation);
+	X_T_kind.push_back (SpatialTransformTranslation);
+	X_lambda_kind.push_back (SpatialTransformTranslation);
 
 	X_J.push_back (SpatialTransform());
 	v_J.push_back (zero_spatial);
@@ -249,11 +364,17 @@ unsigned int Model::AddBody (const unsigned int parent_id,
 
 	// structural information
 	lambda.push_back(movable_parent_id);
-	unsigned int lambda_q_last = mJoints[mJoints.size() - 1].q_index;
-	if (mJoints[mJoints.size() - 1].mDoFCount > 0)
-		lambda_q_last = lambda_q_last + mJoints[mJoints.size() - 1].mDoFCount;
+	// the first degree of freedom of the joint depends on the last degree
+	// of freedom of the movable parent (and not of the previously added
+	// body), all others on the preceding one of the same joint
+	unsigned int lambda_q_last = mJoints[movable_parent_id].q_index;
+	if (mJoints[movable_parent_id].mDoFCount > 0)
+		lambda_q_last = lambda_q_last + mJoints[movable_parent_id].mDoFCount;
 	for (unsigned int i = 0; i < joint.mDoFCount; i++) {
-		lambda_q.push_back(lambda_q_last + i);
+		if (i == 0)
+			lambda_q.push_back(lambda_q_last);
+		else
+			lambda_q.push_back(dof_count + i);
 	}
 	mu.push_back(std::vector<unsigned int>());
 	mu.at(movable_parent_id).push_back(mBodies.size());
@@ -281,6 +402,11 @@ unsigned int Model::AddBody (const unsigned int parent_id,
 	mJoints.push_back(joint);
 	mJoints[mJoints.size() - 1].q_index = mJoints[last_q_index].q_index + mJoints[last_q_index].mDoFCount; 
 
+	// select the joint kernels once such that the algorithms do not have to
+	// dispatch on the joint type
+	mJointKernels.push_back (jcalc_select_kernel (joint.mJointType));
+	mJointPositionKernels.push_back (jcalc_select_position_kernel (joint.mJointType));
+
 	S.push_back (joint.mJointAxes[0]);
 
 	// Joint state variables
@@ -313,6 +439,9 @@ unsigned int Model::AddBody (const unsigned int parent_id,
 	// we have to invert the transformation as it is later always used from the
 	// child bodies perspective.
 	X_T.push_back(joint_frame * movable_parent_transform);
+	X_J_kind.push_back (jcalc_transform_kind (joint.mJointType));
+	X_T_kind.push_back (CalcSpatialTransformKind (X_T.back()));
+	X_lambda_kind.push_back (CombineSpatialTransformKinds (X_J_kind.back(), X_T_kind.back()));
 
 	// Dynamic variables
 	c.push_back(SpatialVector(0., 0., 0., 0., 0., 0.));
@@ -403,3 +532,123 @@ unsigned int Model::SetFloatingBaseBody (const Body &body) {
 
 	return body_id;
 }
+
+namespace RigidBodyDynamics {
+
+RBDL_DLLAPI
+void ReorderBodiesDepthFirst (
+		const Model &model,
+		Model &reordered,
+		BodyReordering *reordering
+		) {
+	unsigned int body_count = model.mBodies.size();
+
+	std::vector<std::string> body_names (body_count);
+	std::map<std::string, unsigned int>::const_iterator name_iter;
+	for (name_iter = model.mBodyNameMap.begin(); name_iter != model.mBodyNameMap.end(); name_iter++) {
+		if (!model.IsFixedBodyId (name_iter->second))
+			body_names[name_iter->second] = name_iter->first;
+	}
+
+	Model result;
+	result.gravity = model.gravity;
+	result.fixed_body_discriminator = model.fixed_body_discriminator;
+
+	// fixed bodies may be merged into the root body
+	result.mBodies[0] = model.mBodies[0];
+	result.I[0] = model.I[0];
+	result.Ic[0] = model.Ic[0];
+
+	// the bodies are added again in depth-first order, as all bodies are
+	// attached to movable parents X_T is the original joint frame
+	std::vector<unsigned int> body_id (body_count, 0);
+	std::vector<unsigned int> stack (model.mu[0].rbegin(), model.mu[0].rend());
+
+	while (stack.size() > 0) {
+		unsigned int i = stack.back();
+		stack.pop_back();
+
+		body_id[i] = result.AddBody (body_id[model.lambda[i]], model.X_T[i], model.mJoints[i], model.mBodies[i], body_names[i]);
+
+		for (unsigned int j = model.mu[i].size(); j > 0; j--)
+			stack.push_back (model.mu[i][j - 1]);
+	}
+
+	// the masses of the fixed bodies are already merged into their movable
+	// parents such that they are not added again
+	for (unsigned int k = 0; k < model.mFixedBodies.size(); k++) {
+		FixedBody fbody = model.mFixedBodies[k];
+		fbody.mMovableParent = body_id[fbody.mMovableParent];
+		result.mFixedBodies.push_back (fbody);
+	}
+
+	for (name_iter = model.mBodyNameMap.begin(); name_iter != model.mBodyNameMap.end(); name_iter++) {
+		if (model.IsFixedBodyId (name_iter->second))
+			result.mBodyNameMap[name_iter->first] = name_iter->second;
+	}
+
+	if (model.IsFixedBodyId (model.previously_added_body_id))
+		result.previously_added_body_id = model.previously_added_body_id;
+	else
+		result.previously_added_body_id = body_id[model.previously_added_body_id];
+
+	if (reordering != NULL) {
+		reordering->body_id = body_id;
+		reordering->q_index.assign (model.q_size, 0);
+		reordering->qdot_size = model.qdot_size;
+
+		for (unsigned int i = 1; i < body_count; i++) {
+			unsigned int j = body_id[i];
+
+			for (unsigned int k = 0; k < model.mJoints[i].mDoFCount; k++)
+				reordering->q_index[result.mJoints[j].q_index + k] = model.mJoints[i].q_index + k;
+
+			if (model.mJoints[i].mJointType == JointTypeSpherical)
+				reordering->q_index[result.multdof3_w_index[j]] = model.multdof3_w_index[i];
+		}
+	}
+
+	reordered = result;
+}
+
+void BodyReordering::ReorderQ (const VectorNd &Q, VectorNd &Q_reordered) const {
+	assert (Q.size() == (unsigned int) q_index.size());
+
+	if (Q_reordered.size() != Q.size())
+		Q_reordered = VectorNd::Zero (Q.size());
+
+	for (unsigned int k = 0; k < q_index.size(); k++)
+		Q_reordered[k] = Q[q_index[k]];
+}
+
+void BodyReordering::ReorderQDot (const VectorNd &QDot, VectorNd &QDot_reordered) const {
+	assert (QDot.size() == qdot_size);
+
+	if (QDot_reordered.size() != QDot.size())
+		QDot_reordered = VectorNd::Zero (QDot.size());
+
+	for (unsigned int k = 0; k < qdot_size; k++)
+		QDot_reordered[k] = QDot[q_index[k]];
+}
+
+void BodyReordering::RestoreQ (const VectorNd &Q_reordered, VectorNd &Q) const {
+	assert (Q_reordered.size() == (unsigned int) q_index.size());
+
+	if (Q.size() != Q_reordered.size())
+		Q = VectorNd::Zero (Q_reordered.size());
+
+	for (unsigned int k = 0; k < q_index.size(); k++)
+		Q[q_index[k]] = Q_reordered[k];
+}
+
+void BodyReordering::RestoreQDot (const VectorNd &QDot_reordered, VectorNd &QDot) const {
+	assert (QDot_reordered.size() == qdot_size);
+
+	if (QDot.size() != QDot_reordered.size())
+		QDot = VectorNd::Zero (QDot_reordered.size());
+
+	for (unsigned int k = 0; k < qdot_size; k++)
+		QDot[q_index[k]] = QDot_reordered[k];
+}
+
+} /* namespace RigidBodyDynamics */
@@ -0,0 +1,199 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2015 Martin Felis <martin.felis@iwr.uni-heidelberg.de>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "rbdl/ThreadPool.h"
+
+namespace RigidBodyDynamics {
+
+/// \brief Chunks [front, back) that are still to be processed by a worker
+struct WorkerQueue {
+	WorkerQueue() :
+		front (0),
+		back (0)
+	{}
+
+	std::mutex mutex;
+	unsigned int front;
+	unsigned int back;
+};
+
+struct ThreadPoolImpl {
+	ThreadPoolImpl (unsigned int thread_count) :
+		queues (thread_count),
+		generation (0),
+		shutdown (false),
+		task (NULL),
+		count (0),
+		chunk_size (1),
+		busy_workers (0)
+	{}
+
+	std::vector<std::thread> threads;
+	std::vector<WorkerQueue> queues;
+
+	std::mutex mutex;
+	std::condition_variable job_condition;
+	std::condition_variable done_condition;
+	/// \brief Incremented for every job that is handed to the workers
+	unsigned long generation;
+	bool shutdown;
+
+	// Description of the current job
+	ParallelTask *task;
+	unsigned int count;
+	unsigned int chunk_size;
+	/// \brief Number of worker threads that did not finish the current job
+	unsigned int busy_workers;
+
+	bool PopChunk (unsigned int worker_id, unsigned int &chunk) {
+		WorkerQueue &queue = queues[worker_id];
+		std::lock_guard<std::mutex> lock (queue.mutex);
+
+		if (queue.front == queue.back)
+			return false;
+
+		chunk = queue.front++;
+		return true;
+	}
+
+	bool StealChunk (unsigned int worker_id, unsigned int &chunk) {
+		unsigned int worker_count = queues.size();
+
+		for (unsigned int k = 1; k < worker_count; k++) {
+			WorkerQueue &queue = queues[(worker_id + k) % worker_count];
+			std::lock_guard<std::mutex> lock (queue.mutex);
+
+			if (queue.front != queue.back) {
+				chunk = --queue.back;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void ProcessChunks (unsigned int worker_id) {
+		unsigned int chunk;
+
+		while (PopChunk (worker_id, chunk) || StealChunk (worker_id, chunk)) {
+			unsigned int begin = chunk * chunk_size;
+			unsigned int end = std::min (begin + chunk_size, count);
+
+			task->Run (worker_id, begin, end);
+		}
+	}
+
+	void WorkerMain (unsigned int worker_id) {
+		unsigned long last_generation = 0;
+
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock (mutex);
+				while (!shutdown && generation == last_generation)
+					job_condition.wait (lock);
+
+				if (shutdown)
+					return;
+
+				last_generation = generation;
+			}
+
+			ProcessChunks (worker_id);
+
+			{
+				std::lock_guard<std::mutex> lock (mutex);
+				busy_workers--;
+				if (busy_workers == 0)
+					done_condition.notify_one();
+			}
+		}
+	}
+};
+
+ThreadPool::ThreadPool (unsigned int thread_count) {
+	if (thread_count == 0)
+		thread_count = std::thread::hardware_concurrency();
+
+	if (thread_count == 0)
+		thread_count = 1;
+
+	impl = new ThreadPoolImpl (thread_count);
+
+	// worker 0 is the thread that calls ParallelFor()
+	for (unsigned int i = 1; i < thread_count; i++) {
+		impl->threads.push_back (std::thread (&ThreadPoolImpl::WorkerMain, impl, i));
+	}
+}
+
+ThreadPool::~ThreadPool () {
+	{
+		std::lock_guard<std::mutex> lock (impl->mutex);
+		impl->shutdown = true;
+	}
+	impl->job_condition.notify_all();
+
+	for (unsigned int i = 0; i < impl->threads.size(); i++)
+		impl->threads[i].join();
+
+	delete impl;
+}
+
+unsigned int ThreadPool::GetThreadCount () const {
+	return impl->queues.size();
+}
+
+void ThreadPool::ParallelFor (unsigned int count, ParallelTask &task, unsigned int chunk_size) {
+	if (count == 0)
+		return;
+
+	unsigned int worker_count = impl->queues.size();
+
+	if (worker_count == 1) {
+		task.Run (0, 0, count);
+		return;
+	}
+
+	if (chunk_size == 0) {
+		chunk_size = (count + 8 * worker_count - 1) / (8 * worker_count);
+	}
+
+	unsigned int chunk_count = (count + chunk_size - 1) / chunk_size;
+
+	// distribute the chunks evenly such that each worker starts with a
+	// contiguous range of states
+	for (unsigned int i = 0; i < worker_count; i++) {
+		WorkerQueue &queue = impl->queues[i];
+		std::lock_guard<std::mutex> lock (queue.mutex);
+
+		queue.front = (i * chunk_count) / worker_count;
+		queue.back = ((i + 1) * chunk_count) / worker_count;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock (impl->mutex);
+		impl->task = &task;
+		impl->count = count;
+		impl->chunk_size = chunk_size;
+		impl->busy_workers = worker_count - 1;
+		impl->generation++;
+	}
+	impl->job_condition.notify_all();
+
+	impl->ProcessChunks (0);
+
+	std::unique_lock<std::mutex> lock (impl->mutex);
+	while (impl->busy_workers != 0)
+		impl->done_condition.wait (lock);
+}
+
+}
@@ -139,6 +139,25 @@ RBDL_DLLAPI bool LinSolveGaussElimPivot (MatrixNd A, VectorNd b, VectorNd &x) {
 	return true;
 }
 
+#ifndef RBDL_USE_SIMPLE_MATH
+RBDL_DLLAPI
+void HouseholderApplyQTranspose (
+		const MatrixNd &QR,
+		const VectorNd &h_coeffs,
+		unsigned int count,
+		VectorNd &b) {
+	unsigned int n = b.size();
+
+	for (unsigned int k = 0; k < count; k++) {
+		unsigned int tail_size = n - k - 1;
+		double w = h_coeffs[k] * (b[k] + QR.col(k).tail(tail_size).dot(b.tail(tail_size)));
+
+		b[k] -= w;
+		b.tail(tail_size) -= w * QR.col(k).tail(tail_size);
+	}
+}
+#endif
+
 RBDL_DLLAPI 
 void SpatialMatrixSetSubmatrix(SpatialMatrix &dest, unsigned int row, unsigned int col, const Matrix3d &matrix) {
 	assert (row < 2 && col < 2);
@@ -267,7 +286,7 @@ SpatialMatrix XtransRotZYXEuler (const Vector3d &displacement, const Vector3d &z
 }
 
 RBDL_DLLAPI
-void SparseFactorizeLTL (Model &model, Math::MatrixNd &H) {
+void SparseFactorizeLTL (const Model &model, Math::MatrixNd &H) {
 	for (unsigned int i = 0; i < model.qdot_size; i++) {
 		for (unsigned int j = i + 1; j < model.qdot_size; j++) {
 			H(i,j) = 0.;
@@ -295,22 +314,56 @@ void SparseFactorizeLTL (Model &model, Math::MatrixNd &H) {
 }
 
 RBDL_DLLAPI
-void SparseMultiplyHx (Model &model, Math::MatrixNd &L) {
-	assert (0 && !"Not yet implemented!");
+void SparseMultiplyHx (const Model &model, const Math::MatrixNd &H, const Math::VectorNd &x, Math::VectorNd &result) {
+	assert (&x != &result);
+
+	for (unsigned int i = 1; i <= model.qdot_size; i++) {
+		result[i - 1] = H(i - 1,i - 1) * x[i - 1];
+	}
+
+	for (unsigned int i = model.qdot_size; i > 0; i--) {
+		unsigned int j = model.lambda_q[i];
+		while (j != 0) {
+			result[i - 1] += H(i - 1,j - 1) * x[j - 1];
+			result[j - 1] += H(i - 1,j - 1) * x[i - 1];
+			j = model.lambda_q[j];
+		}
+	}
 }
 
 RBDL_DLLAPI
-void SparseMultiplyLx (Model &model, Math::MatrixNd &L) {
-	assert (0 && !"Not yet implemented!");
+void SparseMultiplyLx (const Model &model, const Math::MatrixNd &L, const Math::VectorNd &x, Math::VectorNd &result) {
+	assert (&x != &result);
+
+	for (unsigned int i = model.qdot_size; i > 0; i--) {
+		result[i - 1] = L(i - 1,i - 1) * x[i - 1];
+		unsigned int j = model.lambda_q[i];
+		while (j != 0) {
+			result[i - 1] += L(i - 1,j - 1) * x[j - 1];
+			j = model.lambda_q[j];
+		}
+	}
 }
 
 RBDL_DLLAPI
-void SparseMultiplyLTx (Model &model, Math::MatrixNd &L) {
-	assert (0 && !"Not yet implemented!");
+void SparseMultiplyLTx (const Model &model, const Math::MatrixNd &L, const Math::VectorNd &x, Math::VectorNd &result) {
+	assert (&x != &result);
+
+	for (unsigned int i = 1; i <= model.qdot_size; i++) {
+		result[i - 1] = L(i - 1,i - 1) * x[i - 1];
+	}
+
+	for (unsigned int i = model.qdot_size; i > 0; i--) {
+		unsigned int j = model.lambda_q[i];
+		while (j != 0) {
+			result[j - 1] += L(i - 1,j - 1) * x[i - 1];
+			j = model.lambda_q[j];
+		}
+	}
 }
 
 RBDL_DLLAPI
-void SparseSolveLx (Model &model, Math::MatrixNd &L, Math::VectorNd &x) {
+void SparseSolveLx (const Model &model, Math::MatrixNd &L, Math::VectorNd &x) {
 	for (unsigned int i = 1; i <= model.qdot_size; i++) {
 		unsigned int j = model.lambda_q[i];
 		while (j != 0) {
@@ -322,7 +375,7 @@ void SparseSolveLx (Model &model, Math::MatrixNd &L, Math::VectorNd &x) {
 }
 
 RBDL_DLLAPI
-void SparseSolveLTx (Model &model, Math::MatrixNd &L, Math::VectorNd &x) {
+void SparseSolveLTx (const Model &model, Math::MatrixNd &L, Math::VectorNd &x) {
 	for (int i = model.qdot_size; i > 0; i--) {
 		x[i - 1] = x[i - 1] / L(i - 1,i - 1);
 		unsigned int j = model.lambda_q[i];
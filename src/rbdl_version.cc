@@ -83,6 +83,11 @@ RBDL_DLLAPI void rbdl_print_version() {
 #else
 	std::cout << "  URDFReader   : off" << std::endl;
 #endif
+#ifdef RBDL_BUILD_ADDON_CODEGEN
+	std::cout << "  Codegen      : on" << std::endl;
+#else
+	std::cout << "  Codegen      : off" << std::endl;
+#endif
 
 	std::string build_revision (RBDL_BUILD_REVISION);
 	if (build_revision == "unknown") {
@@ -0,0 +1,70 @@
+#include <cstdlib>
+#include <cstddef>
+
+#include "rbdl/rbdl_config.h"
+
+#include "AllocationCounter.h"
+
+static bool allocation_counting = false;
+static unsigned long allocation_count = 0;
+
+#ifdef __GLIBC__
+
+extern "C" {
+
+void *__libc_malloc (size_t size);
+void *__libc_calloc (size_t count, size_t size);
+void *__libc_realloc (void *ptr, size_t size);
+
+void *malloc (size_t size) {
+	if (allocation_counting)
+		allocation_count++;
+
+	return __libc_malloc (size);
+}
+
+void *calloc (size_t count, size_t size) {
+	if (allocation_counting)
+		allocation_count++;
+
+	return __libc_calloc (count, size);
+}
+
+void *realloc (void *ptr, size_t size) {
+	if (allocation_counting)
+		allocation_count++;
+
+	return __libc_realloc (ptr, size);
+}
+
+}
+
+bool AllocationCounter::IsSupported () {
+#ifdef RBDL_USE_SIMPLE_MATH
+	// SimpleMath creates temporaries on the heap for every expression
+	return false;
+#else
+	return true;
+#endif
+}
+
+#else
+
+bool AllocationCounter::IsSupported () {
+	return false;
+}
+
+#endif
+
+AllocationCounter::AllocationCounter () {
+	allocation_count = 0;
+	allocation_counting = true;
+}
+
+AllocationCounter::~AllocationCounter () {
+	allocation_counting = false;
+}
+
+unsigned long AllocationCounter::GetCount () const {
+	return allocation_count;
+}
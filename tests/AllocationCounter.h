@@ -0,0 +1,21 @@
+#ifndef RBDL_TESTS_ALLOCATION_COUNTER_H
+#define RBDL_TESTS_ALLOCATION_COUNTER_H
+
+/** \brief Counts the heap allocations of the process while it is alive
+ *
+ * The counter replaces malloc(), calloc() and realloc() which also
+ * catches operator new and the allocations of Eigen. This is only
+ * supported when using the GNU C library and Eigen, otherwise
+ * IsSupported() returns false and the count is always 0.
+ */
+struct AllocationCounter {
+	AllocationCounter ();
+	~AllocationCounter ();
+
+	/// \brief Number of allocations since the counter was created
+	unsigned long GetCount () const;
+
+	static bool IsSupported ();
+};
+
+#endif
@@ -0,0 +1,279 @@
+#include <UnitTest++.h>
+
+#include <iostream>
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+#include "AllocationCounter.h"
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Kinematics.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/Contacts.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+// All checks call the functions once before counting such that lazily
+// allocated temporaries do not affect the count.
+
+TEST_FIXTURE (Human36, TestAllocationFreeKinematics) {
+	if (!AllocationCounter::IsSupported())
+		return;
+
+	Model *models[2] = { model_emulated, model_3dof };
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+		unsigned int body_id = model.mBodies.size() - 1;
+		Vector3d point (0.1, 0.2, -0.3);
+		MatrixNd G (MatrixNd::Zero (3, model.qdot_size));
+		MatrixNd G_spatial (MatrixNd::Zero (6, model.qdot_size));
+
+		UpdateKinematics (model, q, qdot, qddot);
+		UpdateKinematicsCustom (model, &q, &qdot, &qddot);
+		CalcPointJacobian (model, q, body_id, point, G);
+		CalcBodySpatialJacobian (model, q, body_id, G_spatial);
+		CalcPointVelocity (model, q, qdot, body_id, point);
+		CalcPointAcceleration (model, q, qdot, qddot, body_id, point);
+		UpdateKinematicsIncremental (model, q, &qdot, &qddot);
+
+		unsigned long count;
+		{
+			AllocationCounter counter;
+			UpdateKinematics (model, q, qdot, qddot);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		{
+			AllocationCounter counter;
+			UpdateKinematicsCustom (model, &q, NULL, NULL);
+			UpdateKinematicsCustom (model, &q, &qdot, NULL);
+			UpdateKinematicsCustom (model, &q, &qdot, &qddot);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		{
+			AllocationCounter counter;
+			UpdateKinematicsIncremental (model, q, &qdot, &qddot);
+			q[q.size() - 1] += 0.1;
+			UpdateKinematicsIncremental (model, q, &qdot, &qddot);
+			q[q.size() - 1] -= 0.1;
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		{
+			AllocationCounter counter;
+			CalcBodyToBaseCoordinates (model, q, body_id, point, true);
+			CalcBaseToBodyCoordinates (model, q, body_id, point, true);
+			CalcBodyWorldOrientation (model, q, body_id, true);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		std::vector<unsigned int> body_ids (2, body_id);
+		std::vector<Vector3d> points (2, point);
+		MatrixNd G_stacked (MatrixNd::Zero (6, model.qdot_size));
+		MatrixNd G_spatial_stacked (MatrixNd::Zero (12, model.qdot_size));
+
+		{
+			AllocationCounter counter;
+			CalcPointJacobian (model, q, body_id, point, G, true);
+			CalcBodySpatialJacobian (model, q, body_id, G_spatial, true);
+			CalcPointJacobians (model, q, body_ids, points, G_stacked, true);
+			CalcBodySpatialJacobians (model, q, body_ids, G_spatial_stacked, true);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		{
+			AllocationCounter counter;
+			CalcPointVelocity (model, q, qdot, body_id, point, true);
+			CalcPointAcceleration (model, q, qdot, qddot, body_id, point, true);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		InverseKinematicsConstraintSet ik_set;
+		ik_set.AddPointConstraint (body_id, point, CalcBodyToBaseCoordinates (model, q, body_id, point) + Vector3d (0.01, 0., 0.));
+		ik_set.AddOrientationConstraint (body_id, CalcBodyWorldOrientation (model, q, body_id, false));
+		ik_set.max_steps = 5;
+
+		VectorNd q_ik (q);
+		InverseKinematics (model, q, ik_set, q_ik);
+
+		{
+			AllocationCounter counter;
+			InverseKinematics (model, q, ik_set, q_ik);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+	}
+}
+
+TEST_FIXTURE (Human36, TestAllocationFreeDynamics) {
+	if (!AllocationCounter::IsSupported())
+		return;
+
+	Model *models[2] = { model_emulated, model_3dof };
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+		MatrixNd H (MatrixNd::Zero (model.qdot_size, model.qdot_size));
+		VectorNd nle (VectorNd::Zero (model.qdot_size));
+
+		ForwardDynamics (model, q, qdot, tau, qddot);
+		InverseDynamics (model, q, qdot, qddot, tau);
+		NonlinearEffects (model, q, qdot, nle);
+		CompositeRigidBodyAlgorithm (model, q, H);
+
+		unsigned long count;
+		{
+			AllocationCounter counter;
+			ForwardDynamics (model, q, qdot, tau, qddot);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		{
+			AllocationCounter counter;
+			InverseDynamics (model, q, qdot, qddot, tau);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		{
+			AllocationCounter counter;
+			NonlinearEffects (model, q, qdot, nle);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+
+		{
+			AllocationCounter counter;
+			CompositeRigidBodyAlgorithm (model, q, H);
+			count = counter.GetCount();
+		}
+		CHECK_EQUAL (0u, count);
+	}
+}
+
+TEST_FIXTURE (Human36, TestAllocationFreeForwardDynamicsLagrangian) {
+	if (!AllocationCounter::IsSupported())
+		return;
+
+	Model *models[2] = { model_emulated, model_3dof };
+	Math::LinearSolver solvers[4] = {
+		Math::LinearSolverPartialPivLU,
+		Math::LinearSolverColPivHouseholderQR,
+		Math::LinearSolverHouseholderQR,
+		Math::LinearSolverLLT
+	};
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+		LagrangianWorkspace lws (model);
+
+		for (unsigned int s = 0; s < 4; s++) {
+			ForwardDynamicsLagrangian (model, model, lws, q, qdot, tau, qddot, solvers[s]);
+
+			unsigned long count;
+			{
+				AllocationCounter counter;
+				ForwardDynamicsLagrangian (model, model, lws, q, qdot, tau, qddot, solvers[s]);
+				count = counter.GetCount();
+			}
+			CHECK_EQUAL (0u, count);
+		}
+	}
+}
+
+typedef void (*ContactsForwardDynamicsFunction) (Model&, const VectorNd&, const VectorNd&, const VectorNd&, ConstraintSet&, VectorNd&);
+typedef void (*ContactImpulsesFunction) (Model&, const VectorNd&, const VectorNd&, ConstraintSet&, VectorNd&);
+
+TEST_FIXTURE (Human36, TestAllocationFreeContacts) {
+	if (!AllocationCounter::IsSupported())
+		return;
+
+	Model *models[2] = { model_emulated, model_3dof };
+	ConstraintSet *constraint_sets[2] = { &constraints_4B4C_emulated, &constraints_4B4C_3dof };
+	Math::LinearSolver solvers[4] = {
+		Math::LinearSolverPartialPivLU,
+		Math::LinearSolverColPivHouseholderQR,
+		Math::LinearSolverHouseholderQR,
+		Math::LinearSolverSparseLTL
+	};
+
+	ContactsForwardDynamicsFunction forward_dynamics[4] = {
+		ForwardDynamicsContactsDirect,
+		ForwardDynamicsContactsRangeSpaceSparse,
+		ForwardDynamicsContactsNullSpace,
+		ForwardDynamicsContactsKokkevis
+	};
+	ContactImpulsesFunction impulses[3] = {
+		ComputeContactImpulsesDirect,
+		ComputeContactImpulsesRangeSpaceSparse,
+		ComputeContactImpulsesNullSpace
+	};
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+		VectorNd qdot_plus (VectorNd::Zero (model.qdot_size));
+		VectorNd q_other (q);
+		q_other[0] += 0.1;
+
+		for (unsigned int s = 0; s < 4; s++) {
+			ConstraintSet constraint_set = constraint_sets[m]->Copy();
+			constraint_set.linear_solver = solvers[s];
+			constraint_set.Bind (model);
+
+			for (unsigned int f = 0; f < 4; f++) {
+				forward_dynamics[f] (model, q, qdot, tau, constraint_set, qddot);
+
+				// a new state (requires new factorizations) and the same
+				// state (reuses the factorizations)
+				unsigned long count;
+				{
+					AllocationCounter counter;
+					forward_dynamics[f] (model, q_other, qdot, tau, constraint_set, qddot);
+					forward_dynamics[f] (model, q_other, qdot, tau, constraint_set, qddot);
+					count = counter.GetCount();
+				}
+				CHECK_EQUAL (0u, count);
+			}
+
+			for (unsigned int f = 0; f < 3; f++) {
+				impulses[f] (model, q, qdot, constraint_set, qdot_plus);
+
+				unsigned long count;
+				{
+					AllocationCounter counter;
+					impulses[f] (model, q_other, qdot, constraint_set, qdot_plus);
+					forward_dynamics[f] (model, q_other, qdot_plus, tau, constraint_set, qddot);
+					count = counter.GetCount();
+				}
+				CHECK_EQUAL (0u, count);
+			}
+		}
+	}
+}
+
+TEST_FIXTURE (Human36, TestAllocationCounterCountsAllocations) {
+	if (!AllocationCounter::IsSupported())
+		return;
+
+	unsigned long count;
+	{
+		AllocationCounter counter;
+		VectorNd v (VectorNd::Zero (model_emulated->qdot_size));
+		std::vector<double> values (10);
+		count = counter.GetCount();
+	}
+	CHECK_EQUAL (2u, count);
+}
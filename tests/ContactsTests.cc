@@ -677,6 +677,146 @@ TEST_FIXTURE (Human36, ForwardDynamicsContactsFixedBody) {
 	CHECK_ARRAY_CLOSE (qddot_lagrangian.data(), qddot_sparse.data(), qddot_lagrangian.size(), TEST_PREC * qddot_lagrangian.norm());
 }
 
+TEST_FIXTURE (Human36, ForwardDynamicsContactsKokkevisSupportBodies) {
+	VectorNd qddot_lagrangian (VectorNd::Zero(qddot.size()));
+
+	randomizeStates();
+
+	ConstraintSet constraint_set;
+	constraint_set.AddConstraint (body_id_3dof[BodyFootLeft], Vector3d (0.1, 0., -0.05), Vector3d (0., 0., 1.));
+	constraint_set.AddConstraint (body_id_3dof[BodyFootRight], Vector3d (0.1, 0., -0.05), Vector3d (1., 0., 0.));
+	constraint_set.AddConstraint (body_id_3dof[BodyUpperTrunk], Vector3d (1.1, 2.2, 3.3), Vector3d (0., 1., 0.));
+	constraint_set.Bind (*model_3dof);
+
+	CHECK_EQUAL (body_id_3dof[BodyMiddleTrunk], constraint_set.movable_body[2]);
+
+	// only the legs and the trunk are on the support paths of the constraints
+	for (unsigned int i = 1; i < model_3dof->mBodies.size(); i++) {
+		bool is_support_body = false;
+		for (unsigned int k = 0; k < constraint_set.support_bodies.size(); k++) {
+			if (constraint_set.support_bodies[k] == i)
+				is_support_body = true;
+		}
+
+		bool is_arm = i >= body_id_3dof[BodyUpperArmRight];
+		CHECK_EQUAL (!is_arm, is_support_body);
+	}
+
+	ForwardDynamicsContactsDirect (*model_3dof, q, qdot, tau, constraint_set, qddot_lagrangian);
+	ForwardDynamicsContactsKokkevis (*model_3dof, q, qdot, tau, constraint_set, qddot);
+	ForwardDynamicsContactsKokkevis (*model_3dof, q, qdot, tau, constraint_set, qddot);
+
+	CHECK_ARRAY_CLOSE (qddot_lagrangian.data(), qddot.data(), qddot_lagrangian.size(), TEST_PREC * qddot_lagrangian.norm());
+}
+
+TEST_FIXTURE (Human36, ForwardDynamicsContactsSparseJacobian) {
+	randomizeStates();
+
+	ConstraintSet constraint_set = constraints_4B4C_3dof.Copy();
+	constraint_set.AddConstraint (body_id_3dof[BodyUpperTrunk], Vector3d (1.1, 2.2, 3.3), Vector3d (0., 1., 0.));
+	constraint_set.Bind (*model_3dof);
+
+	MatrixNd G (MatrixNd::Zero (constraint_set.size(), model_3dof->qdot_size));
+	CalcContactJacobian (*model_3dof, q, constraint_set, G);
+	CalcContactJacobianSparse (*model_3dof, q, constraint_set);
+
+	CHECK_ARRAY_CLOSE (G.data(), constraint_set.G.data(), G.size(), TEST_PREC);
+
+	// the stored entries are the non-zero entries of the rows of G
+	CHECK_EQUAL (constraint_set.size() + 1, constraint_set.G_row_start.size());
+	for (unsigned int i = 0; i < constraint_set.size(); i++) {
+		VectorNd row (VectorNd::Zero (model_3dof->qdot_size));
+		for (unsigned int p = constraint_set.G_row_start[i]; p < constraint_set.G_row_start[i + 1]; p++) {
+			if (p > constraint_set.G_row_start[i])
+				CHECK (constraint_set.G_column[p - 1] < constraint_set.G_column[p]);
+			row[constraint_set.G_column[p]] = constraint_set.G_value[p];
+		}
+
+		for (unsigned int k = 0; k < row.size(); k++)
+			CHECK_CLOSE (G(i,k), row[k], TEST_PREC);
+	}
+
+	// the legs do not support the trunk
+	unsigned int trunk_row = constraint_set.size() - 1;
+	CHECK (constraint_set.G_row_start[trunk_row + 1] - constraint_set.G_row_start[trunk_row] < constraint_set.G_row_start[1] - constraint_set.G_row_start[0]);
+
+	VectorNd qddot_direct (VectorNd::Zero (qddot.size()));
+	VectorNd qddot_sparse (VectorNd::Zero (qddot.size()));
+	VectorNd qddot_null_space (VectorNd::Zero (qddot.size()));
+
+	ConstraintSet constraint_set_sparse = constraint_set.Copy();
+	constraint_set_sparse.Bind (*model_3dof);
+	ConstraintSet constraint_set_null_space = constraint_set.Copy();
+	constraint_set_null_space.Bind (*model_3dof);
+
+	ForwardDynamicsContactsDirect (*model_3dof, q, qdot, tau, constraint_set, qddot_direct);
+	ForwardDynamicsContactsRangeSpaceSparse (*model_3dof, q, qdot, tau, constraint_set_sparse, qddot_sparse);
+	ForwardDynamicsContactsNullSpace (*model_3dof, q, qdot, tau, constraint_set_null_space, qddot_null_space);
+
+	CHECK_ARRAY_CLOSE (qddot_direct.data(), qddot_sparse.data(), qddot.size(), TEST_PREC * qddot_direct.norm());
+	CHECK_ARRAY_CLOSE (qddot_direct.data(), qddot_null_space.data(), qddot.size(), TEST_PREC * qddot_direct.norm());
+	CHECK_ARRAY_CLOSE (constraint_set.force.data(), constraint_set_sparse.force.data(), constraint_set.size(), TEST_PREC * constraint_set.force.norm());
+	CHECK_ARRAY_CLOSE (constraint_set.force.data(), constraint_set_null_space.force.data(), constraint_set.size(), TEST_PREC * constraint_set.force.norm());
+}
+
+TEST_FIXTURE (Human36, ForwardDynamicsContactsFactorizationCache) {
+	randomizeStates();
+
+	enum { MethodDirect = 0, MethodDirectSparse, MethodRangeSpaceSparse, MethodNullSpace, MethodLast };
+	LinearSolver solvers[MethodLast] = { LinearSolverColPivHouseholderQR, LinearSolverSparseLTL, LinearSolverPartialPivLU, LinearSolverPartialPivLU };
+
+	for (unsigned int method = 0; method < MethodLast; method++) {
+		ConstraintSet constraint_set = constraints_4B4C_3dof.Copy();
+		constraint_set.linear_solver = solvers[method];
+		constraint_set.Bind (*model_3dof);
+
+		ConstraintSet constraint_set_reference = constraint_set.Copy();
+		constraint_set_reference.Bind (*model_3dof);
+
+		VectorNd qdot_plus (VectorNd::Zero (qdot.size()));
+		VectorNd qddot_reference (VectorNd::Zero (qddot.size()));
+
+		// the impulses and the forces of the same state share the
+		// factorization
+		if (method == MethodDirect || method == MethodDirectSparse) {
+			ComputeContactImpulsesDirect (*model_3dof, q, qdot, constraint_set, qdot_plus);
+			ForwardDynamicsContactsDirect (*model_3dof, q, qdot_plus, tau, constraint_set, qddot);
+			ForwardDynamicsContactsDirect (*model_3dof, q, qdot_plus, tau, constraint_set_reference, qddot_reference);
+		} else if (method == MethodRangeSpaceSparse) {
+			ComputeContactImpulsesRangeSpaceSparse (*model_3dof, q, qdot, constraint_set, qdot_plus);
+			ForwardDynamicsContactsRangeSpaceSparse (*model_3dof, q, qdot_plus, tau, constraint_set, qddot);
+			ForwardDynamicsContactsRangeSpaceSparse (*model_3dof, q, qdot_plus, tau, constraint_set_reference, qddot_reference);
+		} else {
+			ComputeContactImpulsesNullSpace (*model_3dof, q, qdot, constraint_set, qdot_plus);
+			ForwardDynamicsContactsNullSpace (*model_3dof, q, qdot_plus, tau, constraint_set, qddot);
+			ForwardDynamicsContactsNullSpace (*model_3dof, q, qdot_plus, tau, constraint_set_reference, qddot_reference);
+		}
+
+		CHECK_EQUAL (1u, constraint_set.factorization_reuse_count);
+		CHECK_EQUAL (0u, constraint_set_reference.factorization_reuse_count);
+		CHECK_ARRAY_CLOSE (qddot_reference.data(), qddot.data(), qddot.size(), TEST_PREC);
+		CHECK_ARRAY_CLOSE (constraint_set_reference.force.data(), constraint_set.force.data(), constraint_set.size(), TEST_PREC);
+
+		// a different state requires a new factorization
+		VectorNd q_new (q);
+		q_new[5] += 0.1;
+
+		if (method == MethodDirect || method == MethodDirectSparse) {
+			ForwardDynamicsContactsDirect (*model_3dof, q_new, qdot_plus, tau, constraint_set, qddot);
+			ForwardDynamicsContactsDirect (*model_3dof, q_new, qdot_plus, tau, constraint_set_reference, qddot_reference);
+		} else if (method == MethodRangeSpaceSparse) {
+			ForwardDynamicsContactsRangeSpaceSparse (*model_3dof, q_new, qdot_plus, tau, constraint_set, qddot);
+			ForwardDynamicsContactsRangeSpaceSparse (*model_3dof, q_new, qdot_plus, tau, constraint_set_reference, qddot_reference);
+		} else {
+			ForwardDynamicsContactsNullSpace (*model_3dof, q_new, qdot_plus, tau, constraint_set, qddot);
+			ForwardDynamicsContactsNullSpace (*model_3dof, q_new, qdot_plus, tau, constraint_set_reference, qddot_reference);
+		}
+
+		CHECK_EQUAL (1u, constraint_set.factorization_reuse_count);
+		CHECK_ARRAY_CLOSE (qddot_reference.data(), qddot.data(), qddot.size(), TEST_PREC);
+	}
+}
+
 TEST_FIXTURE (Human36, ForwardDynamicsContactsImpulses) {
 	VectorNd qddot_lagrangian (VectorNd::Zero(qddot.size()));
 
@@ -708,3 +848,119 @@ TEST_FIXTURE (Human36, ForwardDynamicsContactsImpulses) {
 	CHECK_ARRAY_CLOSE (Vector3d(0., 0., 0.).data(), heel_left_velocity.data(), 3, TEST_PREC);
 	CHECK_ARRAY_CLOSE (Vector3d(0., 0., 0.).data(), heel_right_velocity.data(), 3, TEST_PREC);
 }
+
+struct FloatingBoxFriction {
+	FloatingBoxFriction () {
+		ClearLogOutput();
+		model = new Model;
+
+		model->gravity = Vector3d (0., 0., -9.81);
+
+		/* A box of mass 1 that stands with its four bottom corners on the
+		 * ground (normal: z axis).
+		 */
+		Joint joint_floating (
+				SpatialVector (0., 0., 0., 1., 0., 0.),
+				SpatialVector (0., 0., 0., 0., 1., 0.),
+				SpatialVector (0., 0., 0., 0., 0., 1.),
+				SpatialVector (0., 0., 1., 0., 0., 0.),
+				SpatialVector (0., 1., 0., 0., 0., 0.),
+				SpatialVector (1., 0., 0., 0., 0., 0.)
+				);
+		box_id = model->AddBody (0, Xtrans (Vector3d (0., 0., 0.)), joint_floating, Body (1., Vector3d (0., 0., 0.), Vector3d (0.5, 0.5, 0.5)));
+
+		Q = VectorNd::Zero (model->q_size);
+		QDot = VectorNd::Zero (model->qdot_size);
+		QDDot = VectorNd::Zero (model->qdot_size);
+		Tau = VectorNd::Zero (model->qdot_size);
+
+		friction_coefficient = 0.5;
+		for (int sx = -1; sx <= 1; sx += 2) {
+			for (int sy = -1; sy <= 1; sy += 2) {
+				constraint_set.AddFrictionContact (box_id, Vector3d (0.5 * sx, 0.5 * sy, -0.5), Vector3d (0., 0., 1.), friction_coefficient);
+			}
+		}
+		constraint_set.friction_max_iterations = 1000;
+		constraint_set.Bind (*model);
+
+		ClearLogOutput();
+	}
+
+	~FloatingBoxFriction () {
+		delete model;
+	}
+
+	Model *model;
+	unsigned int box_id;
+	double friction_coefficient;
+
+	VectorNd Q;
+	VectorNd QDot;
+	VectorNd QDDot;
+	VectorNd Tau;
+
+	ConstraintSet constraint_set;
+};
+
+TEST_FIXTURE (FloatingBoxFriction, ForwardDynamicsContactsFrictionSticking) {
+	CHECK_EQUAL (12u, constraint_set.size());
+	CHECK (constraint_set.unilateral[0]);
+	CHECK (!constraint_set.unilateral[1]);
+	CHECK_EQUAL (0u, constraint_set.friction_normal[2]);
+	CHECK_EQUAL (3u, constraint_set.friction_normal[3]);
+	CHECK_CLOSE (0., constraint_set.normal[1].dot (constraint_set.normal[0]), TEST_PREC);
+	CHECK_CLOSE (0., constraint_set.normal[2].dot (constraint_set.normal[1]), TEST_PREC);
+
+	// a small horizontal push is compensated by the friction forces
+	Tau[0] = 2.;
+	Tau[1] = -1.;
+
+	ForwardDynamicsContactsFriction (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+	CHECK (constraint_set.friction_iterations < constraint_set.friction_max_iterations);
+	VectorNd qddot_zero (VectorNd::Zero (QDDot.size()));
+	CHECK_ARRAY_CLOSE (qddot_zero.data(), QDDot.data(), QDDot.size(), 1.0e-6);
+
+	double normal_force = 0.;
+	for (unsigned int i = 0; i < constraint_set.size(); i += 3) {
+		CHECK (constraint_set.force[i] >= 0.);
+		CHECK (fabs (constraint_set.force[i + 1]) <= friction_coefficient * constraint_set.force[i] + TEST_PREC);
+		CHECK (fabs (constraint_set.force[i + 2]) <= friction_coefficient * constraint_set.force[i] + TEST_PREC);
+		normal_force += constraint_set.force[i];
+	}
+	CHECK_CLOSE (9.81, normal_force, 1.0e-6);
+
+	// starting from the previous forces the solver converges immediately
+	unsigned int cold_start_iterations = constraint_set.friction_iterations;
+	ForwardDynamicsContactsFriction (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+	CHECK (constraint_set.friction_iterations < cold_start_iterations);
+}
+
+TEST_FIXTURE (FloatingBoxFriction, ForwardDynamicsContactsFrictionSliding) {
+	// the push exceeds the friction forces
+	Tau[0] = 10.;
+
+	ForwardDynamicsContactsFriction (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+	CHECK (constraint_set.friction_iterations < constraint_set.friction_max_iterations);
+	CHECK_CLOSE (10. - friction_coefficient * 9.81, QDDot[0], 1.0e-6);
+	CHECK_CLOSE (0., QDDot[2], 1.0e-6);
+
+	for (unsigned int i = 0; i < constraint_set.size(); i += 3) {
+		CHECK (constraint_set.force[i] >= 0.);
+	}
+}
+
+TEST_FIXTURE (FloatingBoxFriction, ForwardDynamicsContactsFrictionSeparating) {
+	// the box is lifted off the ground
+	Tau[2] = 20.;
+
+	VectorNd qddot_free (VectorNd::Zero (QDDot.size()));
+	ForwardDynamics (*model, Q, QDot, Tau, qddot_free);
+	ForwardDynamicsContactsFriction (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+	VectorNd force_zero (VectorNd::Zero (constraint_set.size()));
+	CHECK_ARRAY_CLOSE (force_zero.data(), constraint_set.force.data(), constraint_set.size(), TEST_PREC);
+	CHECK_ARRAY_CLOSE (qddot_free.data(), QDDot.data(), QDDot.size(), 1.0e-9);
+}
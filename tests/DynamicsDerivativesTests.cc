@@ -0,0 +1,170 @@
+#include <UnitTest++.h>
+
+#include <iostream>
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double TEST_PREC = 1.0e-6;
+const double FD_STEP = 1.0e-6;
+
+/** \brief Perturbs the k-th degree of freedom. Spherical joints are
+ * rotated about the k-th axis of the body frame, i.e. in the tangent space
+ * of their quaternion (note: Quaternion::operator* composes in reverse
+ * order). */
+static VectorNd perturb_q (const Model &model, const VectorNd &q, unsigned int k, double h) {
+	VectorNd result (q);
+
+	for (unsigned int i = 1; i < model.mJoints.size(); i++) {
+		unsigned int q_index = model.mJoints[i].q_index;
+
+		if (model.mJoints[i].mJointType == JointTypeSpherical
+				&& k >= q_index && k < q_index + 3) {
+			Vector3d axis (0., 0., 0.);
+			axis[k - q_index] = 1.;
+
+			Quaternion quat = Quaternion::fromAxisAngle (axis, h) * model.GetQuaternion (i, q);
+			model.SetQuaternion (i, quat, result);
+			return result;
+		}
+	}
+
+	result[k] += h;
+	return result;
+}
+
+static void check_inverse_dynamics_derivatives (Model &model, const VectorNd &q, const VectorNd &qdot, const VectorNd &qddot) {
+	unsigned int n = model.qdot_size;
+
+	VectorNd tau (VectorNd::Zero (n));
+	MatrixNd dtau_dq (MatrixNd::Zero (n, n));
+	MatrixNd dtau_dqdot (MatrixNd::Zero (n, n));
+
+	InverseDynamicsDerivatives (model, q, qdot, qddot, tau, dtau_dq, dtau_dqdot);
+
+	VectorNd tau_ref (VectorNd::Zero (n));
+	InverseDynamics (model, q, qdot, qddot, tau_ref);
+	CHECK_ARRAY_CLOSE (tau_ref.data(), tau.data(), n, 1.0e-12 * tau_ref.norm());
+
+	MatrixNd dtau_dq_fd (n, n);
+	MatrixNd dtau_dqdot_fd (n, n);
+	VectorNd tau_plus (VectorNd::Zero (n));
+	VectorNd tau_minus (VectorNd::Zero (n));
+
+	for (unsigned int k = 0; k < n; k++) {
+		InverseDynamics (model, perturb_q (model, q, k, FD_STEP), qdot, qddot, tau_plus);
+		InverseDynamics (model, perturb_q (model, q, k, -FD_STEP), qdot, qddot, tau_minus);
+		dtau_dq_fd.col(k) = (tau_plus - tau_minus) / (2. * FD_STEP);
+
+		VectorNd qdot_plus (qdot);
+		VectorNd qdot_minus (qdot);
+		qdot_plus[k] += FD_STEP;
+		qdot_minus[k] -= FD_STEP;
+		InverseDynamics (model, q, qdot_plus, qddot, tau_plus);
+		InverseDynamics (model, q, qdot_minus, qddot, tau_minus);
+		dtau_dqdot_fd.col(k) = (tau_plus - tau_minus) / (2. * FD_STEP);
+	}
+
+	CHECK_ARRAY_CLOSE (dtau_dq_fd.data(), dtau_dq.data(), n * n, TEST_PREC * dtau_dq_fd.norm());
+	CHECK_ARRAY_CLOSE (dtau_dqdot_fd.data(), dtau_dqdot.data(), n * n, TEST_PREC * dtau_dqdot_fd.norm());
+}
+
+static void check_forward_dynamics_derivatives (Model &model, const VectorNd &q, const VectorNd &qdot, const VectorNd &tau) {
+	unsigned int n = model.qdot_size;
+
+	VectorNd qddot (VectorNd::Zero (n));
+	MatrixNd dqddot_dq (MatrixNd::Zero (n, n));
+	MatrixNd dqddot_dqdot (MatrixNd::Zero (n, n));
+	MatrixNd dqddot_dtau (MatrixNd::Zero (n, n));
+
+	ForwardDynamicsDerivatives (model, q, qdot, tau, qddot, dqddot_dq, dqddot_dqdot, dqddot_dtau);
+
+	VectorNd qddot_ref (VectorNd::Zero (n));
+	ForwardDynamics (model, q, qdot, tau, qddot_ref);
+	CHECK_ARRAY_CLOSE (qddot_ref.data(), qddot.data(), n, 1.0e-10 * qddot_ref.norm());
+
+	MatrixNd dqddot_dq_fd (n, n);
+	MatrixNd dqddot_dqdot_fd (n, n);
+	MatrixNd dqddot_dtau_fd (n, n);
+	VectorNd qddot_plus (VectorNd::Zero (n));
+	VectorNd qddot_minus (VectorNd::Zero (n));
+
+	for (unsigned int k = 0; k < n; k++) {
+		ForwardDynamics (model, perturb_q (model, q, k, FD_STEP), qdot, tau, qddot_plus);
+		ForwardDynamics (model, perturb_q (model, q, k, -FD_STEP), qdot, tau, qddot_minus);
+		dqddot_dq_fd.col(k) = (qddot_plus - qddot_minus) / (2. * FD_STEP);
+
+		VectorNd qdot_plus (qdot);
+		VectorNd qdot_minus (qdot);
+		qdot_plus[k] += FD_STEP;
+		qdot_minus[k] -= FD_STEP;
+		ForwardDynamics (model, q, qdot_plus, tau, qddot_plus);
+		ForwardDynamics (model, q, qdot_minus, tau, qddot_minus);
+		dqddot_dqdot_fd.col(k) = (qddot_plus - qddot_minus) / (2. * FD_STEP);
+
+		VectorNd tau_plus (tau);
+		VectorNd tau_minus (tau);
+		tau_plus[k] += FD_STEP;
+		tau_minus[k] -= FD_STEP;
+		ForwardDynamics (model, q, qdot, tau_plus, qddot_plus);
+		ForwardDynamics (model, q, qdot, tau_minus, qddot_minus);
+		dqddot_dtau_fd.col(k) = (qddot_plus - qddot_minus) / (2. * FD_STEP);
+	}
+
+	CHECK_ARRAY_CLOSE (dqddot_dq_fd.data(), dqddot_dq.data(), n * n, TEST_PREC * dqddot_dq_fd.norm());
+	CHECK_ARRAY_CLOSE (dqddot_dqdot_fd.data(), dqddot_dqdot.data(), n * n, TEST_PREC * dqddot_dqdot_fd.norm());
+	CHECK_ARRAY_CLOSE (dqddot_dtau_fd.data(), dqddot_dtau.data(), n * n, TEST_PREC * dqddot_dtau_fd.norm());
+}
+
+TEST_FIXTURE (Human36, TestInverseDynamicsDerivativesHuman36) {
+	randomizeStates();
+
+	check_inverse_dynamics_derivatives (*model_emulated, q, qdot, qddot);
+	check_inverse_dynamics_derivatives (*model_3dof, q, qdot, qddot);
+}
+
+TEST_FIXTURE (Human36, TestForwardDynamicsDerivativesHuman36) {
+	randomizeStates();
+
+	check_forward_dynamics_derivatives (*model_emulated, q, qdot, tau);
+	check_forward_dynamics_derivatives (*model_3dof, q, qdot, tau);
+}
+
+TEST (TestDynamicsDerivativesMultiDof) {
+	Model model;
+	model.gravity = Vector3d (0., -9.81, 0.);
+
+	Body body (1.3, Vector3d (0.4, 0.1, -0.2), Vector3d (0.7, 1.1, 0.9));
+	Joint joint_rot_y (SpatialVector (0., 1., 0., 0., 0., 0.));
+
+	unsigned int base_id = model.AppendBody (Xtrans (Vector3d (0., 0., 0.)), Joint (JointTypeTranslationXYZ), body);
+	unsigned int sph_id = model.AddBody (base_id, Xtrans (Vector3d (0.5, 0., 0.)), Joint (JointTypeSpherical), body);
+	model.AddBody (sph_id, Xtrans (Vector3d (1., 0., 0.)), joint_rot_y, body);
+	unsigned int euler_id = model.AddBody (base_id, Xtrans (Vector3d (0., 0.3, 0.)), Joint (JointTypeEulerZYX), body);
+	model.AddBody (euler_id, Xtrans (Vector3d (0., 0., 1.)), Joint (JointTypeEulerXYZ), body);
+
+	VectorNd q (VectorNd::Zero (model.q_size));
+	VectorNd qdot (VectorNd::Zero (model.qdot_size));
+	VectorNd qddot (VectorNd::Zero (model.qdot_size));
+	VectorNd tau (VectorNd::Zero (model.qdot_size));
+
+	for (unsigned int i = 0; i < model.qdot_size; i++) {
+		q[i] = 0.1 * i - 0.4;
+		qdot[i] = 0.3 - 0.07 * i;
+		qddot[i] = 0.05 * i * i - 0.5;
+		tau[i] = 0.2 * i - 1.;
+	}
+	model.SetQuaternion (sph_id, Quaternion::fromZYXAngles (Vector3d (0.3, 1.1, -0.4)), q);
+
+	check_inverse_dynamics_derivatives (model, q, qdot, qddot);
+	check_forward_dynamics_derivatives (model, q, qdot, tau);
+}
@@ -0,0 +1,118 @@
+#include <UnitTest++.h>
+
+#include <iostream>
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+#include "AllocationCounter.h"
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/DynamicsPacked.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double TEST_PREC = 1.0e-11;
+
+TEST_FIXTURE (Human36, TestForwardDynamicsPackedHuman36) {
+	Model *models[2] = { model_emulated, model_3dof };
+	PackedLayout layouts[2] = { PackedLayoutAoS, PackedLayoutSoA };
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+
+		for (unsigned int l = 0; l < 2; l++) {
+			PackedDynamicsWorkspace ws (model, layouts[l]);
+
+			for (unsigned int k = 0; k < 3; k++) {
+				randomizeStates();
+
+				VectorNd qddot_packed (VectorNd::Zero (model.qdot_size));
+				ForwardDynamics (model, q, qdot, tau, qddot);
+				ForwardDynamicsPacked (model, ws, q, qdot, tau, qddot_packed);
+
+				CHECK_ARRAY_CLOSE (qddot.data(), qddot_packed.data(), qddot.size(), TEST_PREC);
+			}
+		}
+	}
+}
+
+TEST (TestPackedDynamicsWorkspaceDepthFirstOrder) {
+	Model model;
+	Body body (1., Vector3d (0.1, 0.2, 0.3), Vector3d (1., 2., 3.));
+	Joint joint_rot_y (SpatialVector (0., 1., 0., 0., 0., 0.));
+
+	// the bodies of the two branches are added alternately
+	unsigned int a1 = model.AddBody (0, Xtrans (Vector3d (1., 0., 0.)), joint_rot_y, body);
+	unsigned int b1 = model.AddBody (0, Xtrans (Vector3d (-1., 0., 0.)), joint_rot_y, body);
+	unsigned int a2 = model.AddBody (a1, Xtrans (Vector3d (0., -1., 0.)), joint_rot_y, body);
+	unsigned int b2 = model.AddBody (b1, Xtrans (Vector3d (0., -1., 0.)), joint_rot_y, body);
+	unsigned int a3 = model.AddBody (a2, Xroty (0.3) * Xtrans (Vector3d (0., -1., 0.)), joint_rot_y, body);
+
+	PackedDynamicsWorkspace ws (model, PackedLayoutSoA);
+
+	unsigned int expected_order[6] = { 0, a1, a2, a3, b1, b2 };
+	CHECK_ARRAY_EQUAL (expected_order, &ws.order[0], 6);
+
+	for (unsigned int s = 1; s < ws.body_count; s++) {
+		CHECK_EQUAL (s, ws.slot[ws.order[s]]);
+		CHECK_EQUAL (ws.slot[model.lambda[ws.order[s]]], ws.parent_slot[s]);
+		CHECK (ws.parent_slot[s] < s);
+	}
+
+	VectorNd q (VectorNd::Zero (model.q_size));
+	VectorNd qdot (VectorNd::Zero (model.qdot_size));
+	VectorNd tau (VectorNd::Zero (model.qdot_size));
+	VectorNd qddot (VectorNd::Zero (model.qdot_size));
+	VectorNd qddot_packed (VectorNd::Zero (model.qdot_size));
+
+	for (unsigned int i = 0; i < model.q_size; i++) {
+		q[i] = 0.3 * i - 0.5;
+		qdot[i] = 0.2 * i + 0.1;
+		tau[i] = -0.4 * i + 0.7;
+	}
+
+	ForwardDynamics (model, q, qdot, tau, qddot);
+	ForwardDynamicsPacked (model, ws, q, qdot, tau, qddot_packed);
+
+	CHECK_ARRAY_CLOSE (qddot.data(), qddot_packed.data(), qddot.size(), TEST_PREC);
+}
+
+TEST_FIXTURE (Human36, TestPackedDynamicsWorkspaceAlignment) {
+	PackedDynamicsWorkspace ws_aos (*model_3dof, PackedLayoutAoS);
+	PackedDynamicsWorkspace ws_soa (*model_3dof, PackedLayoutSoA);
+
+	// every block of the AoS layout starts at a cache line
+	for (unsigned int s = 0; s < ws_aos.body_count; s++) {
+		CHECK_EQUAL (0u, reinterpret_cast<size_t>(&ws_aos.X_lambda(s)) % 64);
+		CHECK_EQUAL (0u, reinterpret_cast<size_t>(&ws_aos.v(s)) % alignof (SpatialVector));
+		CHECK_EQUAL (0u, reinterpret_cast<size_t>(&ws_aos.IA(s)) % alignof (SpatialMatrix));
+	}
+
+	// every array of the SoA layout starts at a cache line
+	CHECK_EQUAL (0u, reinterpret_cast<size_t>(&ws_soa.X_lambda(0)) % 64);
+	CHECK_EQUAL (0u, reinterpret_cast<size_t>(&ws_soa.v(0)) % 64);
+	CHECK_EQUAL (0u, reinterpret_cast<size_t>(&ws_soa.IA(0)) % 64);
+	CHECK_EQUAL (0u, reinterpret_cast<size_t>(&ws_soa.multdof3_S(0)) % 64);
+	CHECK_EQUAL (sizeof (SpatialVector), reinterpret_cast<size_t>(&ws_soa.v(1)) - reinterpret_cast<size_t>(&ws_soa.v(0)));
+}
+
+TEST_FIXTURE (Human36, TestForwardDynamicsPackedAllocationFree) {
+	if (!AllocationCounter::IsSupported())
+		return;
+
+	PackedDynamicsWorkspace ws (*model_3dof, PackedLayoutAoS);
+	ForwardDynamicsPacked (*model_3dof, ws, q, qdot, tau, qddot);
+
+	unsigned long count;
+	{
+		AllocationCounter counter;
+		ForwardDynamicsPacked (*model_3dof, ws, q, qdot, tau, qddot);
+		count = counter.GetCount();
+	}
+	CHECK_EQUAL (0u, count);
+}
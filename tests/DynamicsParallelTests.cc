@@ -0,0 +1,436 @@
+#include <UnitTest++.h>
+
+#include <iostream>
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/Contacts.h"
+#include "rbdl/DynamicsParallel.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double TEST_PREC = 1.0e-11;
+
+struct Human36Parallel : public Human36 {
+	Human36Parallel () {
+		sample_count = 23;
+
+		Q = MatrixNd (q.size(), sample_count);
+		QDot = MatrixNd (qdot.size(), sample_count);
+		QDDot = MatrixNd (qddot.size(), sample_count);
+		Tau = MatrixNd (tau.size(), sample_count);
+
+		for (unsigned int k = 0; k < sample_count; k++) {
+			randomizeStates();
+			Q.col(k) = q;
+			QDot.col(k) = qdot;
+			QDDot.col(k) = qddot;
+			Tau.col(k) = tau;
+		}
+	}
+
+	unsigned int sample_count;
+	MatrixNd Q;
+	MatrixNd QDot;
+	MatrixNd QDDot;
+	MatrixNd Tau;
+};
+
+struct CountingTask : public ParallelTask {
+	CountingTask (unsigned int count) :
+		calls (count, 0),
+		worker_ids (count, 0)
+	{}
+
+	void Run (unsigned int worker_id, unsigned int begin, unsigned int end) {
+		for (unsigned int k = begin; k < end; k++) {
+			calls[k]++;
+			worker_ids[k] = worker_id;
+		}
+	}
+
+	std::vector<int> calls;
+	std::vector<unsigned int> worker_ids;
+};
+
+TEST (TestThreadPoolParallelFor) {
+	ThreadPool pool (3);
+	CHECK_EQUAL (3u, pool.GetThreadCount());
+
+	for (unsigned int chunk_size = 0; chunk_size < 9; chunk_size += 4) {
+		CountingTask task (1000);
+		pool.ParallelFor (1000, task, chunk_size);
+
+		for (unsigned int k = 0; k < 1000; k++) {
+			CHECK_EQUAL (1, task.calls[k]);
+			CHECK (task.worker_ids[k] < 3);
+		}
+	}
+
+	// fewer indices than workers
+	CountingTask task (2);
+	pool.ParallelFor (2, task);
+	CHECK_EQUAL (1, task.calls[0]);
+	CHECK_EQUAL (1, task.calls[1]);
+}
+
+TEST_FIXTURE (Human36Parallel, TestForwardDynamicsParallel) {
+	ParallelDynamicsWorkspace ws (*model_3dof, 3);
+	ws.chunk_size = 1;
+
+	MatrixNd QDDot_parallel;
+	ForwardDynamicsParallel (*model_3dof, ws, Q, QDot, Tau, QDDot_parallel);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (Q.col(k));
+		VectorNd qdot_k (QDot.col(k));
+		VectorNd tau_k (Tau.col(k));
+		VectorNd qddot_k (VectorNd::Zero (model_3dof->qdot_size));
+
+		ForwardDynamics (*model_3dof, q_k, qdot_k, tau_k, qddot_k);
+
+		VectorNd qddot_parallel (QDDot_parallel.col(k));
+		CHECK_ARRAY_CLOSE (qddot_k.data(), qddot_parallel.data(), qddot_k.size(), TEST_PREC * qddot_k.norm());
+	}
+}
+
+TEST_FIXTURE (Human36Parallel, TestInverseDynamicsParallel) {
+	ParallelDynamicsWorkspace ws (*model_emulated, 2);
+
+	MatrixNd Tau_parallel;
+	InverseDynamicsParallel (*model_emulated, ws, Q, QDot, QDDot, Tau_parallel);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (Q.col(k));
+		VectorNd qdot_k (QDot.col(k));
+		VectorNd qddot_k (QDDot.col(k));
+		VectorNd tau_k (VectorNd::Zero (model_emulated->qdot_size));
+
+		InverseDynamics (*model_emulated, q_k, qdot_k, qddot_k, tau_k);
+
+		VectorNd tau_parallel (Tau_parallel.col(k));
+		CHECK_ARRAY_CLOSE (tau_k.data(), tau_parallel.data(), tau_k.size(), TEST_PREC * tau_k.norm());
+	}
+}
+
+TEST_FIXTURE (Human36Parallel, TestCompositeRigidBodyAlgorithmParallel) {
+	ParallelDynamicsWorkspace ws (*model_3dof, 2);
+
+	std::vector<MatrixNd> H_parallel;
+	CompositeRigidBodyAlgorithmParallel (*model_3dof, ws, Q, H_parallel);
+
+	CHECK_EQUAL (sample_count, H_parallel.size());
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (Q.col(k));
+		MatrixNd H (MatrixNd::Zero (model_3dof->qdot_size, model_3dof->qdot_size));
+
+		CompositeRigidBodyAlgorithm (*model_3dof, q_k, H);
+
+		CHECK_ARRAY_CLOSE (H.data(), H_parallel[k].data(), H.size(), TEST_PREC);
+	}
+}
+
+TEST_FIXTURE (Human36Parallel, TestForwardDynamicsContactsParallel) {
+	ParallelDynamicsWorkspace ws (*model_emulated, 3);
+
+	MatrixNd QDDot_parallel;
+	MatrixNd Forces_parallel;
+
+	ForwardDynamicsContactsParallel (*model_emulated, ws, Q, QDot, Tau, constraints_4B4C_emulated, QDDot_parallel, ForwardDynamicsContactsDirect, &Forces_parallel);
+
+	CHECK_EQUAL (constraints_4B4C_emulated.size(), Forces_parallel.rows());
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (Q.col(k));
+		VectorNd qdot_k (QDot.col(k));
+		VectorNd tau_k (Tau.col(k));
+		VectorNd qddot_k (VectorNd::Zero (model_emulated->qdot_size));
+
+		ForwardDynamicsContactsDirect (*model_emulated, q_k, qdot_k, tau_k, constraints_4B4C_emulated, qddot_k);
+
+		VectorNd qddot_parallel (QDDot_parallel.col(k));
+		VectorNd force_parallel (Forces_parallel.col(k));
+		CHECK_ARRAY_CLOSE (qddot_k.data(), qddot_parallel.data(), qddot_k.size(), TEST_PREC * qddot_k.norm());
+		CHECK_ARRAY_CLOSE (constraints_4B4C_emulated.force.data(), force_parallel.data(), force_parallel.size(), TEST_PREC * constraints_4B4C_emulated.force.norm());
+	}
+
+	// a different contact method with the same (already bound) worker copies
+	ForwardDynamicsContactsParallel (*model_emulated, ws, Q, QDot, Tau, constraints_4B4C_emulated, QDDot_parallel, ForwardDynamicsContactsKokkevis);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (Q.col(k));
+		VectorNd qdot_k (QDot.col(k));
+		VectorNd tau_k (Tau.col(k));
+		VectorNd qddot_k (VectorNd::Zero (model_emulated->qdot_size));
+
+		ForwardDynamicsContactsKokkevis (*model_emulated, q_k, qdot_k, tau_k, constraints_4B4C_emulated, qddot_k);
+
+		VectorNd qddot_parallel (QDDot_parallel.col(k));
+		CHECK_ARRAY_CLOSE (qddot_k.data(), qddot_parallel.data(), qddot_k.size(), 1.0e-9 * qddot_k.norm());
+	}
+
+	ConstraintSet CS = constraints_4B4C_emulated;
+
+	for (unsigned int run = 0; run < 2; run++) {
+		if (run == 0) {
+			// modify the constraint set in place after the copies were bound
+			CS.point[0] = Vector3d (0.2, 0.1, -0.05);
+			CS.normal[1] = Vector3d (0., 0.6, 0.8);
+			CS.acceleration[2] = 0.3;
+		} else {
+			// different constrained bodies at the same address
+			CS = constraints_1B4C_emulated;
+		}
+
+		ForwardDynamicsContactsParallel (*model_emulated, ws, Q, QDot, Tau, CS, QDDot_parallel, ForwardDynamicsContactsDirect, &Forces_parallel);
+
+		CHECK_EQUAL (CS.size(), Forces_parallel.rows());
+
+		for (unsigned int k = 0; k < sample_count; k++) {
+			VectorNd q_k (Q.col(k));
+			VectorNd qdot_k (QDot.col(k));
+			VectorNd tau_k (Tau.col(k));
+			VectorNd qddot_k (VectorNd::Zero (model_emulated->qdot_size));
+
+			ForwardDynamicsContactsDirect (*model_emulated, q_k, qdot_k, tau_k, CS, qddot_k);
+
+			VectorNd qddot_parallel (QDDot_parallel.col(k));
+			VectorNd force_parallel (Forces_parallel.col(k));
+			CHECK_ARRAY_CLOSE (qddot_k.data(), qddot_parallel.data(), qddot_k.size(), TEST_PREC * qddot_k.norm());
+			CHECK_ARRAY_CLOSE (CS.force.data(), force_parallel.data(), force_parallel.size(), TEST_PREC * CS.force.norm());
+		}
+	}
+}
+
+TEST (TestForwardDynamicsContactsParallelFriction) {
+	// a box that stands with its four bottom corners on the ground, the
+	// friction forces of the four contacts are not unique
+	Model model;
+	model.gravity = Vector3d (0., 0., -9.81);
+
+	Joint joint_floating (
+			SpatialVector (0., 0., 0., 1., 0., 0.),
+			SpatialVector (0., 0., 0., 0., 1., 0.),
+			SpatialVector (0., 0., 0., 0., 0., 1.),
+			SpatialVector (0., 0., 1., 0., 0., 0.),
+			SpatialVector (0., 1., 0., 0., 0., 0.),
+			SpatialVector (1., 0., 0., 0., 0., 0.)
+			);
+	unsigned int box_id = model.AddBody (0, Xtrans (Vector3d (0., 0., 0.)), joint_floating, Body (1., Vector3d (0., 0., 0.), Vector3d (0.5, 0.5, 0.5)));
+
+	ConstraintSet CS;
+	for (int sx = -1; sx <= 1; sx += 2) {
+		for (int sy = -1; sy <= 1; sy += 2) {
+			CS.AddFrictionContact (box_id, Vector3d (0.5 * sx, 0.5 * sy, -0.5), Vector3d (0., 0., 1.), 0.5);
+		}
+	}
+	CS.friction_max_iterations = 1000;
+	CS.Bind (model);
+
+	// horizontal pushes and twists, some of them make the box slide
+	unsigned int sample_count = 12;
+	MatrixNd Q (MatrixNd::Zero (model.q_size, sample_count));
+	MatrixNd QDot (MatrixNd::Zero (model.qdot_size, sample_count));
+	MatrixNd Tau (MatrixNd::Zero (model.qdot_size, sample_count));
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		Tau(0, k) = 4. * sin (0.9 * k);
+		Tau(1, k) = 3. * cos (1.3 * k);
+		Tau(3, k) = 2. * sin (0.4 * k + 1.);
+	}
+
+	ParallelDynamicsWorkspace ws_single (model, 1);
+	ParallelDynamicsWorkspace ws (model, 3);
+	ws.chunk_size = 1;
+
+	MatrixNd QDDot_single, Forces_single;
+	MatrixNd QDDot_parallel, Forces_parallel;
+	ForwardDynamicsContactsParallel (model, ws_single, Q, QDot, Tau, CS, QDDot_single, ForwardDynamicsContactsFriction, &Forces_single);
+	ForwardDynamicsContactsParallel (model, ws, Q, QDot, Tau, CS, QDDot_parallel, ForwardDynamicsContactsFriction, &Forces_parallel);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		// every state is solved starting from the forces of CS
+		ConstraintSet CS_serial = CS;
+		VectorNd q_k (Q.col(k));
+		VectorNd qdot_k (QDot.col(k));
+		VectorNd tau_k (Tau.col(k));
+		VectorNd qddot_k (VectorNd::Zero (model.qdot_size));
+
+		ForwardDynamicsContactsFriction (model, q_k, qdot_k, tau_k, CS_serial, qddot_k);
+
+		VectorNd qddot_single (QDDot_single.col(k));
+		VectorNd force_single (Forces_single.col(k));
+		VectorNd qddot_parallel (QDDot_parallel.col(k));
+		VectorNd force_parallel (Forces_parallel.col(k));
+		CHECK_ARRAY_CLOSE (qddot_k.data(), qddot_single.data(), qddot_k.size(), TEST_PREC);
+		CHECK_ARRAY_CLOSE (CS_serial.force.data(), force_single.data(), CS.size(), TEST_PREC);
+		CHECK_ARRAY_CLOSE (qddot_k.data(), qddot_parallel.data(), qddot_k.size(), TEST_PREC);
+		CHECK_ARRAY_CLOSE (CS_serial.force.data(), force_parallel.data(), CS.size(), TEST_PREC);
+	}
+}
+
+TEST_FIXTURE (Human36Parallel, TestInverseKinematicsParallel) {
+	Model &model = *model_3dof;
+
+	unsigned int hand_id = model.GetBodyId ("hand_r");
+	unsigned int foot_id = model.GetBodyId ("foot_l");
+	Vector3d hand_point (0.1, 0.05, -0.1);
+
+	InverseKinematicsConstraintSet CS;
+	CS.AddFullConstraint (hand_id, hand_point, Vector3d::Zero(), Matrix3d::Identity());
+	CS.AddOrientationConstraint (foot_id, Matrix3d::Identity());
+	CS.AddPointConstraint (foot_id, Vector3d::Zero(), Vector3d::Zero());
+	CS.constraint_tol = 1.0e-10;
+
+	// targets along a smooth motion
+	unsigned int frame_count = 17;
+	std::vector<std::vector<Vector3d> > target_positions (frame_count, std::vector<Vector3d> (CS.size()));
+	std::vector<std::vector<Matrix3d> > target_orientations (frame_count, std::vector<Matrix3d> (CS.size(), Matrix3d::Identity()));
+
+	VectorNd q_motion (VectorNd::Zero (model.q_size));
+	for (unsigned int k = 0; k < frame_count; k++) {
+		for (unsigned int i = 0; i < model.q_size; i++)
+			q_motion[i] = 0.3 * sin (0.1 * k + 0.7 * i);
+
+		UpdateKinematicsCustom (model, &q_motion, NULL, NULL);
+		target_positions[k][0] = CalcBodyToBaseCoordinates (model, q_motion, hand_id, hand_point, false);
+		target_orientations[k][0] = CalcBodyWorldOrientation (model, q_motion, hand_id, false);
+		target_orientations[k][1] = CalcBodyWorldOrientation (model, q_motion, foot_id, false);
+		target_positions[k][2] = CalcBodyToBaseCoordinates (model, q_motion, foot_id, Vector3d::Zero(), false);
+	}
+
+	VectorNd q_init (VectorNd::Zero (model.q_size));
+
+	ParallelDynamicsWorkspace ws (model, 3);
+	ws.chunk_size = 4;
+
+	MatrixNd QRes;
+	std::vector<unsigned int> num_steps;
+	VectorNd error_norms;
+
+	CHECK (InverseKinematicsParallel (model, ws, q_init, CS, target_positions, target_orientations, QRes, &num_steps, &error_norms));
+	CHECK_EQUAL (frame_count, num_steps.size());
+	CHECK_EQUAL (frame_count, error_norms.size());
+
+	for (unsigned int k = 0; k < frame_count; k++) {
+		CHECK (error_norms[k] < 1.0e-10);
+
+		// warm started frames need fewer steps than the first frame of a chunk
+		if (k % ws.chunk_size != 0)
+			CHECK (num_steps[k] < num_steps[k - k % ws.chunk_size]);
+
+		VectorNd q_k (QRes.col(k));
+		Vector3d hand_pos = CalcBodyToBaseCoordinates (model, q_k, hand_id, hand_point);
+		Matrix3d E_foot = CalcBodyWorldOrientation (model, q_k, foot_id, false);
+		CHECK_ARRAY_CLOSE (target_positions[k][0].data(), hand_pos.data(), 3, 1.0e-9);
+		CHECK_ARRAY_CLOSE (target_orientations[k][1].data(), E_foot.data(), 9, 1.0e-9);
+	}
+
+	// a single chunk is the same as warm starting sequentially
+	ws.chunk_size = frame_count;
+	CHECK (InverseKinematicsParallel (model, ws, q_init, CS, target_positions, target_orientations, QRes));
+
+	InverseKinematicsConstraintSet CS_serial (CS);
+	CS_serial.warm_start = true;
+	VectorNd q (q_init);
+
+	for (unsigned int k = 0; k < frame_count; k++) {
+		for (unsigned int c = 0; c < CS.size(); c++) {
+			CS_serial.target_positions[c] = target_positions[k][c];
+			CS_serial.target_orientations[c] = target_orientations[k][c];
+		}
+
+		InverseKinematics (model, q, CS_serial, q);
+
+		VectorNd q_parallel (QRes.col(k));
+		CHECK_ARRAY_CLOSE (q.data(), q_parallel.data(), q.size(), TEST_PREC);
+	}
+
+	// in place modifications of CS are used by the next call
+	Vector3d hand_point_moved (0., 0.1, 0.);
+	CS.body_points[0] = hand_point_moved;
+
+	for (unsigned int k = 0; k < frame_count; k++) {
+		VectorNd q_k (QRes.col(k));
+		target_positions[k][0] = CalcBodyToBaseCoordinates (model, q_k, hand_id, hand_point_moved);
+	}
+
+	// the default chunk size does not depend on the number of workers
+	ws.chunk_size = 0;
+	CHECK (InverseKinematicsParallel (model, ws, q_init, CS, target_positions, target_orientations, QRes));
+
+	ParallelDynamicsWorkspace ws_single (model, 1);
+	MatrixNd QRes_single;
+	CHECK (InverseKinematicsParallel (model, ws_single, q_init, CS, target_positions, target_orientations, QRes_single));
+
+	for (unsigned int k = 0; k < frame_count; k++) {
+		VectorNd q_k (QRes.col(k));
+		Vector3d hand_pos = CalcBodyToBaseCoordinates (model, q_k, hand_id, hand_point_moved);
+		CHECK_ARRAY_CLOSE (target_positions[k][0].data(), hand_pos.data(), 3, 1.0e-9);
+
+		VectorNd q_single (QRes_single.col(k));
+		CHECK_ARRAY_CLOSE (q_single.data(), q_k.data(), q_k.size(), TEST_PREC);
+	}
+}
+
+TEST_FIXTURE (Human36Parallel, TestInverseKinematicsParallelPoints) {
+	Model &model = *model_emulated;
+
+	std::vector<unsigned int> body_ids;
+	std::vector<Vector3d> body_points;
+	body_ids.push_back (model.GetBodyId ("hand_l"));
+	body_points.push_back (Vector3d (0., 0.1, 0.));
+	body_ids.push_back (model.GetBodyId ("foot_r"));
+	body_points.push_back (Vector3d (0.1, 0., -0.05));
+
+	std::vector<std::vector<Vector3d> > target_pos (sample_count, std::vector<Vector3d> (body_ids.size()));
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (Q.col(k));
+		for (unsigned int i = 0; i < body_ids.size(); i++)
+			target_pos[k][i] = CalcBodyToBaseCoordinates (model, q_k, body_ids[i], body_points[i]);
+	}
+
+	ParallelDynamicsWorkspace ws (model, 2);
+
+	MatrixNd QRes;
+	VectorNd error_norms;
+	CHECK (InverseKinematicsParallel (model, ws, Q.col(0), body_ids, body_points, target_pos, QRes, 1.0e-12, 0.01, 50, NULL, &error_norms));
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (QRes.col(k));
+
+		for (unsigned int i = 0; i < body_ids.size(); i++) {
+			Vector3d point = CalcBodyToBaseCoordinates (model, q_k, body_ids[i], body_points[i]);
+			CHECK_ARRAY_CLOSE (target_pos[k][i].data(), point.data(), 3, 1.0e-10);
+		}
+	}
+
+	// the first frame is solved by the constraint set solver with the
+	// mapped parameters
+	InverseKinematicsConstraintSet CS;
+	for (unsigned int i = 0; i < body_ids.size(); i++)
+		CS.AddPointConstraint (body_ids[i], body_points[i], target_pos[0][i]);
+	CS.step_tol = 1.0e-12;
+	CS.constraint_tol = 1.0e-12;
+	CS.lambda = 0.01;
+	CS.max_steps = 50;
+
+	std::vector<unsigned int> num_steps;
+	CHECK (InverseKinematicsParallel (model, ws, Q.col(0), body_ids, body_points, target_pos, QRes, 1.0e-12, 0.01, 50, &num_steps, &error_norms));
+
+	VectorNd q_serial;
+	DynamicsWorkspace ws_serial (model);
+	CHECK (InverseKinematics (model, ws_serial, Q.col(0), CS, q_serial));
+
+	CHECK_EQUAL (CS.num_steps, num_steps[0]);
+	CHECK_ARRAY_CLOSE (q_serial.data(), QRes.col(0).data(), model.q_size, TEST_PREC);
+}
@@ -0,0 +1,156 @@
+#include <UnitTest++.h>
+
+#include <iostream>
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/DynamicsSIMD.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+// the random states of the Human36 model can be close to singular
+// configurations of the Euler joints, therefore the relative errors of the
+// forward dynamics are checked with a reduced precision
+const double TEST_PREC = 1.0e-9;
+
+struct Human36SIMD : public Human36 {
+	Human36SIMD () {
+		// not a multiple of the lane counts so that partially filled
+		// chunks are tested too
+		sample_count = 11;
+
+		Q = MatrixNd (q.size(), sample_count);
+		QDot = MatrixNd (qdot.size(), sample_count);
+		QDDot = MatrixNd (qddot.size(), sample_count);
+		Tau = MatrixNd (tau.size(), sample_count);
+
+		for (unsigned int k = 0; k < sample_count; k++) {
+			randomizeStates();
+			Q.col(k) = q;
+			QDot.col(k) = qdot;
+			QDDot.col(k) = qddot;
+			Tau.col(k) = tau;
+		}
+	}
+
+	/// Maximum deviation of the SIMD algorithms from the scalar algorithms
+	template <unsigned int L>
+	double computeMaxError (Model &model) {
+		SIMDDynamicsWorkspace<L> ws (model);
+		MatrixNd QDDot_simd;
+		MatrixNd Tau_simd;
+		MatrixNd NLE_simd;
+
+		ForwardDynamicsSIMD (model, ws, Q, QDot, Tau, QDDot_simd);
+		InverseDynamicsSIMD (model, ws, Q, QDot, QDDot, Tau_simd);
+		NonlinearEffectsSIMD (model, ws, Q, QDot, NLE_simd);
+
+		double max_error = 0.;
+
+		for (unsigned int k = 0; k < sample_count; k++) {
+			VectorNd q_k (Q.col(k));
+			VectorNd qdot_k (QDot.col(k));
+			VectorNd qddot_k (QDDot.col(k));
+			VectorNd tau_k (Tau.col(k));
+			VectorNd qddot_zero (VectorNd::Zero (model.qdot_size));
+
+			VectorNd qddot_ref (VectorNd::Zero (model.qdot_size));
+			VectorNd tau_ref (VectorNd::Zero (model.qdot_size));
+			VectorNd nle_ref (VectorNd::Zero (model.qdot_size));
+
+			ForwardDynamics (model, q_k, qdot_k, tau_k, qddot_ref);
+			InverseDynamics (model, q_k, qdot_k, qddot_k, tau_ref);
+			InverseDynamics (model, q_k, qdot_k, qddot_zero, nle_ref);
+
+			max_error = std::max (max_error, (qddot_ref - QDDot_simd.col(k)).norm() / qddot_ref.norm());
+			max_error = std::max (max_error, (tau_ref - Tau_simd.col(k)).norm() / tau_ref.norm());
+			max_error = std::max (max_error, (nle_ref - NLE_simd.col(k)).norm() / nle_ref.norm());
+		}
+
+		return max_error;
+	}
+
+	unsigned int sample_count;
+	MatrixNd Q;
+	MatrixNd QDot;
+	MatrixNd QDDot;
+	MatrixNd Tau;
+};
+
+TEST_FIXTURE (Human36SIMD, TestSIMDDynamicsScalarFallback) {
+	CHECK_CLOSE (0., computeMaxError<1> (*model_emulated), TEST_PREC);
+	CHECK_CLOSE (0., computeMaxError<1> (*model_3dof), TEST_PREC);
+}
+
+TEST_FIXTURE (Human36SIMD, TestSIMDDynamicsLanes) {
+	CHECK_CLOSE (0., computeMaxError<2> (*model_emulated), TEST_PREC);
+	CHECK_CLOSE (0., computeMaxError<2> (*model_3dof), TEST_PREC);
+	CHECK_CLOSE (0., computeMaxError<4> (*model_emulated), TEST_PREC);
+	CHECK_CLOSE (0., computeMaxError<4> (*model_3dof), TEST_PREC);
+	CHECK_CLOSE (0., computeMaxError<8> (*model_emulated), TEST_PREC);
+	CHECK_CLOSE (0., computeMaxError<8> (*model_3dof), TEST_PREC);
+}
+
+TEST_FIXTURE (Human36SIMD, TestSIMDDynamicsDefaultLanes) {
+	SIMDDynamicsWorkspace<RBDL_SIMD_LANES> ws (*model_3dof);
+	MatrixNd QDDot_simd;
+
+	ForwardDynamicsSIMD (*model_3dof, ws, Q, QDot, Tau, QDDot_simd);
+
+	BatchDynamicsWorkspace batch_ws (*model_3dof, sample_count);
+	MatrixNd QDDot_batch;
+
+	ForwardDynamicsBatch (*model_3dof, batch_ws, Q, QDot, Tau, QDDot_batch);
+
+	CHECK_ARRAY_CLOSE (QDDot_batch.data(), QDDot_simd.data(), QDDot_batch.size(), TEST_PREC * QDDot_batch.norm());
+}
+
+TEST (TestSIMDDynamicsSpherical) {
+	Model model;
+	model.gravity = Vector3d (0., 0., -9.81);
+
+	Body body (1., Vector3d (1., 0., 0.), Vector3d (1., 1., 1.));
+	Joint joint_rot_y (SpatialVector (0., 1., 0., 0., 0., 0.));
+	Joint joint_spherical (JointTypeSpherical);
+
+	model.AppendBody (Xtrans (Vector3d (0., 0., 0.)), joint_rot_y, body);
+	unsigned int sph_body_id = model.AppendBody (Xtrans (Vector3d (1., 0., 0.)), joint_spherical, body);
+	model.AppendBody (Xtrans (Vector3d (1., 0., 0.)), joint_rot_y, body);
+
+	MatrixNd Q (MatrixNd::Zero (model.q_size, 3));
+	MatrixNd QDot (MatrixNd::Zero (model.qdot_size, 3));
+	MatrixNd Tau (MatrixNd::Zero (model.qdot_size, 3));
+
+	for (unsigned int k = 0; k < 3; k++) {
+		VectorNd q (VectorNd::Zero (model.q_size));
+		model.SetQuaternion (sph_body_id, Quaternion::fromZYXAngles (Vector3d (0.3 * k, 1.1, -0.4 * k)), q);
+		q[0] = 0.2 * k;
+		Q.col(k) = q;
+		QDot(1, k) = 0.7 * k;
+		QDot(3, k) = -0.5;
+		Tau(0, k) = 0.2 * k;
+	}
+
+	SIMDDynamicsWorkspace<4> ws (model);
+	MatrixNd QDDot;
+	ForwardDynamicsSIMD (model, ws, Q, QDot, Tau, QDDot);
+
+	for (unsigned int k = 0; k < 3; k++) {
+		VectorNd q (Q.col(k));
+		VectorNd qdot (QDot.col(k));
+		VectorNd tau (Tau.col(k));
+		VectorNd qddot (VectorNd::Zero (model.qdot_size));
+
+		ForwardDynamics (model, q, qdot, tau, qddot);
+
+		VectorNd qddot_simd (QDDot.col(k));
+		CHECK_ARRAY_CLOSE (qddot.data(), qddot_simd.data(), model.qdot_size, TEST_PREC);
+	}
+}
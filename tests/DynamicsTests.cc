@@ -659,3 +659,34 @@ TEST_FIXTURE ( FloatingBase12DoF, TestForwardDynamicsLagrangianPrealloc ) {
 
 	CHECK_ARRAY_EQUAL (QDDot.data(), QDDot_prealloc.data(), model->dof_count);
 }
+
+TEST_FIXTURE ( FloatingBase12DoF, TestForwardDynamicsLagrangianWorkspace ) {
+	for (unsigned int i = 0; i < model->dof_count; i++) {
+		Q[i] = static_cast<double>(i + 1) * 0.1;
+		QDot[i] = static_cast<double>(i + 1) * 1.1;
+		Tau[i] = static_cast<double>(i + 1) * -1.2;
+	}
+
+	VectorNd QDDot_aba (VectorNd::Zero (model->dof_count));
+	ForwardDynamics (*model, Q, QDot, Tau, QDDot_aba);
+
+	Math::LinearSolver solvers[4] = {
+		Math::LinearSolverPartialPivLU,
+		Math::LinearSolverColPivHouseholderQR,
+		Math::LinearSolverHouseholderQR,
+		Math::LinearSolverLLT
+	};
+
+	LagrangianWorkspace lws (*model);
+
+	for (unsigned int s = 0; s < 4; s++) {
+		VectorNd QDDot_lagrangian (VectorNd::Zero (model->dof_count));
+		ForwardDynamicsLagrangian (*model, *model, lws, Q, QDot, Tau, QDDot_lagrangian, solvers[s]);
+
+		CHECK_ARRAY_CLOSE (QDDot_aba.data(), QDDot_lagrangian.data(), model->dof_count, TEST_PREC * QDDot_aba.norm());
+	}
+
+	MatrixNd H (MatrixNd::Zero (model->dof_count, model->dof_count));
+	CompositeRigidBodyAlgorithm (*model, Q, H);
+	CHECK_ARRAY_CLOSE (H.data(), lws.H.data(), H.size(), TEST_PREC);
+}
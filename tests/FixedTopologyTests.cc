@@ -0,0 +1,197 @@
+#include <UnitTest++.h>
+
+#include <iostream>
+#include <sstream>
+
+#include "Fixtures.h"
+#include "rbdl/rbdl_mathutils.h"
+#include "rbdl/Logging.h"
+
+#include "rbdl/Model.h"
+#include "rbdl/Kinematics.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/FixedTopology.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double TEST_PREC = 1.0e-12;
+
+// the fixed topology models are only available with Eigen
+#ifndef RBDL_USE_SIMPLE_MATH
+
+// Topology of FixedTopologyFixture as written by WriteFixedTopology()
+struct BranchedChain {
+	enum { body_count = 8, dof_count = 7 };
+	template <unsigned int body_id> struct Body;
+};
+template <> struct BranchedChain::Body<1> { enum { parent = 0, joint_type = RigidBodyDynamics::JointTypePrismatic, q_index = 0 }; };
+template <> struct BranchedChain::Body<2> { enum { parent = 1, joint_type = RigidBodyDynamics::JointTypeRevoluteZ, q_index = 1 }; };
+template <> struct BranchedChain::Body<3> { enum { parent = 2, joint_type = RigidBodyDynamics::JointTypeRevoluteX, q_index = 2 }; };
+template <> struct BranchedChain::Body<4> { enum { parent = 2, joint_type = RigidBodyDynamics::JointTypeRevoluteZ, q_index = 3 }; };
+template <> struct BranchedChain::Body<5> { enum { parent = 4, joint_type = RigidBodyDynamics::JointTypeRevolute, q_index = 4 }; };
+template <> struct BranchedChain::Body<6> { enum { parent = 5, joint_type = RigidBodyDynamics::JointTypeRevoluteX, q_index = 5 }; };
+template <> struct BranchedChain::Body<7> { enum { parent = 3, joint_type = RigidBodyDynamics::JointTypeRevoluteY, q_index = 6 }; };
+
+struct FixedTopologyFixture {
+	FixedTopologyFixture () {
+		ClearLogOutput();
+		model = new Model;
+		model->gravity = Vector3d (0., -9.81, 0.);
+
+		Body body_a (1.1, Vector3d (0.1, 0.4, -0.2), Vector3d (0.3, 0.5, 0.2));
+		Body body_b (0.7, Vector3d (-0.2, 0.3, 0.1), Vector3d (0.2, 0.1, 0.4));
+		Body body_c (1.9, Vector3d (0.3, -0.1, 0.2), Vector3d (0.6, 0.4, 0.5));
+
+		Joint joint_3dof (
+				SpatialVector (0., 0., 1., 0., 0., 0.),
+				SpatialVector (0., 0.6, 0.8, 0., 0., 0.),
+				SpatialVector (1., 0., 0., 0., 0., 0.)
+				);
+
+		base_id = model->AddBody (0, Xtrans (Vector3d (0., 0.2, 0.)), Joint (JointTypePrismatic, Vector3d (1., 0., 0.)), body_a);
+		hip_id = model->AddBody (base_id, Xtrans (Vector3d (0., 0., 0.3)), Joint (JointTypeRevoluteZ), body_b);
+		knee_id = model->AddBody (hip_id, Xrotx (0.3) * Xtrans (Vector3d (0.5, 0., 0.)), Joint (JointTypeRevoluteX), body_c);
+		arm_id = model->AddBody (hip_id, Xtrans (Vector3d (0., 0.4, 0.)), joint_3dof, body_a);
+		foot_id = model->AddBody (knee_id, Xtrans (Vector3d (0., -0.6, 0.1)), Joint (JointTypeRevoluteY), body_b);
+		model->AddBody (foot_id, Xtrans (Vector3d (0.1, -0.1, 0.)), Joint (JointTypeFixed), body_c);
+
+		q = VectorNd::Zero (model->q_size);
+		qdot = VectorNd::Zero (model->qdot_size);
+		qddot = VectorNd::Zero (model->qdot_size);
+		tau = VectorNd::Zero (model->qdot_size);
+
+		for (unsigned int i = 0; i < model->q_size; i++) {
+			q[i] = 0.3 * i - 0.8;
+			qdot[i] = 0.7 - 0.2 * i;
+			qddot[i] = 0.1 * i * i - 0.6;
+			tau[i] = 0.4 * i - 1.2;
+			fixed_q[i] = q[i];
+			fixed_qdot[i] = qdot[i];
+			fixed_qddot[i] = qddot[i];
+			fixed_tau[i] = tau[i];
+		}
+	}
+	~FixedTopologyFixture () {
+		delete model;
+	}
+
+	Model *model;
+	unsigned int base_id, hip_id, knee_id, arm_id, foot_id;
+
+	VectorNd q, qdot, qddot, tau;
+	FixedModel<BranchedChain>::VectorQ fixed_q, fixed_qdot, fixed_qddot, fixed_tau;
+};
+
+TEST_FIXTURE (FixedTopologyFixture, TestWriteFixedTopology) {
+	std::ostringstream out;
+	CHECK (WriteFixedTopology (*model, "BranchedChain", out));
+
+	std::string expected =
+		"struct BranchedChain {\n"
+		"\tenum { body_count = 8, dof_count = 7 };\n"
+		"\ttemplate <unsigned int body_id> struct Body;\n"
+		"};\n"
+		"template <> struct BranchedChain::Body<1> { enum { parent = 0, joint_type = RigidBodyDynamics::JointTypePrismatic, q_index = 0 }; };\n"
+		"template <> struct BranchedChain::Body<2> { enum { parent = 1, joint_type = RigidBodyDynamics::JointTypeRevoluteZ, q_index = 1 }; };\n"
+		"template <> struct BranchedChain::Body<3> { enum { parent = 2, joint_type = RigidBodyDynamics::JointTypeRevoluteX, q_index = 2 }; };\n"
+		"template <> struct BranchedChain::Body<4> { enum { parent = 2, joint_type = RigidBodyDynamics::JointTypeRevoluteZ, q_index = 3 }; };\n"
+		"template <> struct BranchedChain::Body<5> { enum { parent = 4, joint_type = RigidBodyDynamics::JointTypeRevolute, q_index = 4 }; };\n"
+		"template <> struct BranchedChain::Body<6> { enum { parent = 5, joint_type = RigidBodyDynamics::JointTypeRevoluteX, q_index = 5 }; };\n"
+		"template <> struct BranchedChain::Body<7> { enum { parent = 3, joint_type = RigidBodyDynamics::JointTypeRevoluteY, q_index = 6 }; };\n";
+
+	CHECK_EQUAL (expected, out.str());
+
+	FixedModel<BranchedChain> fixed_model;
+	CHECK (fixed_model.Init (*model));
+}
+
+TEST (TestWriteFixedTopologyUnsupportedJoint) {
+	Model model;
+	Body body (1., Vector3d (0., 0., 0.), Vector3d (1., 1., 1.));
+	model.AddBody (0, Xtrans (Vector3d (0., 0., 0.)), Joint (JointTypeSpherical), body);
+
+	std::ostringstream out;
+	CHECK (!WriteFixedTopology (model, "Unsupported", out));
+	CHECK (out.str().empty());
+}
+
+TEST_FIXTURE (FixedTopologyFixture, TestFixedModelInitMismatch) {
+	Body body (1., Vector3d (0., 0., 0.), Vector3d (1., 1., 1.));
+	model->AddBody (arm_id, Xtrans (Vector3d (0., 0., 0.)), Joint (JointTypeRevoluteZ), body);
+
+	FixedModel<BranchedChain> fixed_model;
+	CHECK (!fixed_model.Init (*model));
+}
+
+TEST_FIXTURE (FixedTopologyFixture, TestFixedModelKinematics) {
+	FixedModel<BranchedChain> fixed_model (*model);
+
+	UpdateKinematics (*model, q, qdot, qddot);
+	UpdateKinematics (fixed_model, fixed_q, fixed_qdot, fixed_qddot);
+
+	for (unsigned int i = 1; i < BranchedChain::body_count; i++) {
+		CHECK_ARRAY_CLOSE (model->X_base[i].E.data(), fixed_model.X_base[i].E.data(), 9, TEST_PREC);
+		CHECK_ARRAY_CLOSE (model->X_base[i].r.data(), fixed_model.X_base[i].r.data(), 3, TEST_PREC);
+		CHECK_ARRAY_CLOSE (model->v[i].data(), fixed_model.v[i].data(), 6, TEST_PREC);
+		CHECK_ARRAY_CLOSE (model->a[i].data(), fixed_model.a[i].data(), 6, TEST_PREC);
+	}
+
+	Vector3d point (0.2, -0.3, 0.1);
+	Vector3d point_base = CalcBodyToBaseCoordinates (*model, q, foot_id, point);
+	Vector3d fixed_point_base = CalcBodyToBaseCoordinates (fixed_model, foot_id, point);
+	CHECK_ARRAY_CLOSE (point_base.data(), fixed_point_base.data(), 3, TEST_PREC);
+}
+
+TEST_FIXTURE (FixedTopologyFixture, TestFixedModelPointJacobian) {
+	FixedModel<BranchedChain> fixed_model (*model);
+	Vector3d point (0.2, -0.3, 0.1);
+
+	MatrixNd G (MatrixNd::Zero (3, model->qdot_size));
+	CalcPointJacobian (*model, q, foot_id, point, G);
+
+	FixedModel<BranchedChain>::Matrix3Q fixed_G (FixedModel<BranchedChain>::Matrix3Q::Zero());
+	CalcPointJacobian<7> (fixed_model, fixed_q, point, fixed_G);
+	CHECK_ARRAY_CLOSE (G.data(), fixed_G.data(), 3 * model->qdot_size, TEST_PREC);
+
+	G.setZero();
+	CalcPointJacobian (*model, q, arm_id, point, G);
+
+	fixed_G.setZero();
+	CalcPointJacobian<6> (fixed_model, fixed_q, point, fixed_G);
+	CHECK_ARRAY_CLOSE (G.data(), fixed_G.data(), 3 * model->qdot_size, TEST_PREC);
+}
+
+TEST_FIXTURE (FixedTopologyFixture, TestFixedModelInverseDynamics) {
+	FixedModel<BranchedChain> fixed_model (*model);
+
+	InverseDynamics (*model, q, qdot, qddot, tau);
+	InverseDynamics (fixed_model, fixed_q, fixed_qdot, fixed_qddot, fixed_tau);
+
+	CHECK_ARRAY_CLOSE (tau.data(), fixed_tau.data(), model->qdot_size, TEST_PREC);
+}
+
+TEST_FIXTURE (FixedTopologyFixture, TestFixedModelForwardDynamics) {
+	FixedModel<BranchedChain> fixed_model (*model);
+
+	ForwardDynamics (*model, q, qdot, tau, qddot);
+	ForwardDynamics (fixed_model, fixed_q, fixed_qdot, fixed_tau, fixed_qddot);
+
+	CHECK_ARRAY_CLOSE (qddot.data(), fixed_qddot.data(), model->qdot_size, TEST_PREC);
+}
+
+TEST_FIXTURE (FixedTopologyFixture, TestFixedModelCompositeRigidBody) {
+	FixedModel<BranchedChain> fixed_model (*model);
+
+	MatrixNd H (MatrixNd::Zero (model->qdot_size, model->qdot_size));
+	CompositeRigidBodyAlgorithm (*model, q, H);
+
+	FixedModel<BranchedChain>::MatrixQ fixed_H (FixedModel<BranchedChain>::MatrixQ::Zero());
+	CompositeRigidBodyAlgorithm (fixed_model, fixed_q, fixed_H);
+
+	CHECK_ARRAY_CLOSE (H.data(), fixed_H.data(), model->qdot_size * model->qdot_size, TEST_PREC);
+}
+
+/* RBDL_USE_SIMPLE_MATH */
+#endif
@@ -436,6 +436,52 @@ TEST_FIXTURE(KinematicsFixture6DoF, TestInverseKinematicTwoPoints) {
 	CHECK_ARRAY_CLOSE (target_pos[1].data(), effector.data(), 3, 1.0e-1);	
 }
 
+TEST_FIXTURE(KinematicsFixture6DoF, TestInverseKinematicUndampedOverdetermined) {
+	std::vector<unsigned int> body_ids;
+	std::vector<Vector3d> body_points;
+	std::vector<Vector3d> target_pos;
+
+	Q[0] = 0.2;
+	Q[1] = 0.1;
+	Q[2] = 0.1;
+	Q[3] = -0.3;
+	Q[4] = 0.2;
+	Q[5] = 0.4;
+
+	// 9 target coordinates for 6 degrees of freedom: J J^T is singular
+	body_ids.push_back (child_id);
+	body_points.push_back (Vector3d (1., 0., 0.));
+	target_pos.push_back (Vector3d (2., 0., 0.));
+
+	body_ids.push_back (child_id);
+	body_points.push_back (Vector3d (0., 1., 0.5));
+	target_pos.push_back (Vector3d (1., 1., 0.));
+
+	body_ids.push_back (base_id);
+	body_points.push_back (Vector3d (0.6, 1.0, 0.));
+	target_pos.push_back (Vector3d (0.5, 1.1, 0.));
+
+	MatrixNd J = MatrixNd::Zero (9, model->qdot_size);
+	VectorNd e (9);
+	CalcPointJacobians (*model, Q, body_ids, body_points, J, true);
+	for (unsigned int k = 0; k < body_ids.size(); k++) {
+		e.block(k * 3, 0, 3, 1) = target_pos[k]
+			- CalcBodyToBaseCoordinates (*model, Q, body_ids[k], body_points[k], false);
+	}
+
+	// a single undamped step has to be the least squares step
+	VectorNd Qres = VectorNd::Zero ((size_t) model->dof_count);
+	InverseKinematics (*model, Q, body_ids, body_points, target_pos, Qres, 1.0e-12, 0., 1);
+
+	MatrixNd JTJ = J.transpose() * J;
+	VectorNd JTe = J.transpose() * e;
+	VectorNd delta_ref (model->qdot_size);
+	LinSolveGaussElimPivot (JTJ, JTe, delta_ref);
+	VectorNd delta = Qres - Q;
+
+	CHECK_ARRAY_CLOSE (delta_ref.data(), delta.data(), model->qdot_size, TEST_PREC);
+}
+
 TEST ( FixedJointBodyCalcBodyToBase ) {
 	// the standard modeling using a null body
 	Body null_body;
@@ -600,3 +646,462 @@ TEST_FIXTURE ( Human36, SpatialJacobianFixedBody ) {
 
 	CHECK_ARRAY_CLOSE (v_fixed_body.data(), v_body.data(), 6, TEST_PREC);
 }
+
+static unsigned int subtree_body_count (const Model &model, unsigned int body_id) {
+	unsigned int count = 1;
+
+	for (unsigned int j = 0; j < model.mu[body_id].size(); j++) {
+		count += subtree_body_count (model, model.mu[body_id][j]);
+	}
+
+	return count;
+}
+
+static void check_kinematics_equal (const Model &model, const DynamicsWorkspace &ws_ref, const DynamicsWorkspace &ws) {
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		CHECK_ARRAY_CLOSE (ws_ref.X_base[i].E.data(), ws.X_base[i].E.data(), 9, TEST_PREC);
+		CHECK_ARRAY_CLOSE (ws_ref.X_base[i].r.data(), ws.X_base[i].r.data(), 3, TEST_PREC);
+		CHECK_ARRAY_CLOSE (ws_ref.v[i].data(), ws.v[i].data(), 6, TEST_PREC);
+		CHECK_ARRAY_CLOSE (ws_ref.a[i].data(), ws.a[i].data(), 6, TEST_PREC);
+	}
+}
+
+TEST_FIXTURE ( Human36, UpdateKinematicsIncremental ) {
+	randomizeStates();
+
+	Model &model = *model_3dof;
+	DynamicsWorkspace ws (model);
+	DynamicsWorkspace ws_ref (model);
+	unsigned int movable_body_count = model.mBodies.size() - 1;
+
+	UpdateKinematicsIncremental (model, ws, q, &qdot, &qddot);
+	CHECK_EQUAL (movable_body_count, ws.incremental_update_count);
+
+	UpdateKinematicsIncremental (model, ws, q, &qdot, &qddot);
+	CHECK_EQUAL (0u, ws.incremental_update_count);
+
+	// position of a leaf
+	unsigned int hand_r_id = model.GetBodyId ("hand_r");
+	q[model.mJoints[hand_r_id].q_index] += 0.3;
+
+	UpdateKinematicsIncremental (model, ws, q, &qdot, &qddot);
+	UpdateKinematics (model, ws_ref, q, qdot, qddot);
+	CHECK_EQUAL (subtree_body_count (model, hand_r_id), ws.incremental_update_count);
+	check_kinematics_equal (model, ws_ref, ws);
+
+	// velocity and acceleration of a subtree
+	unsigned int thigh_l_id = model.GetBodyId ("thigh_l");
+	qdot[model.mJoints[thigh_l_id].q_index + 1] -= 0.2;
+
+	UpdateKinematicsIncremental (model, ws, q, &qdot, &qddot);
+	UpdateKinematics (model, ws_ref, q, qdot, qddot);
+	CHECK_EQUAL (subtree_body_count (model, thigh_l_id), ws.incremental_update_count);
+	check_kinematics_equal (model, ws_ref, ws);
+
+	unsigned int upperarm_l_id = model.GetBodyId ("upperarm_l");
+	qddot[model.mJoints[upperarm_l_id].q_index + 2] += 1.5;
+
+	UpdateKinematicsIncremental (model, ws, q, &qdot, &qddot);
+	UpdateKinematics (model, ws_ref, q, qdot, qddot);
+	CHECK_EQUAL (subtree_body_count (model, upperarm_l_id), ws.incremental_update_count);
+	check_kinematics_equal (model, ws_ref, ws);
+
+	// other algorithms overwrite the kinematics and invalidate the last state
+	VectorNd qddot_fd (VectorNd::Zero (model.qdot_size));
+	ForwardDynamics (model, ws, q, qdot, tau, qddot_fd);
+
+	UpdateKinematicsIncremental (model, ws, q, &qdot, &qddot);
+	CHECK_EQUAL (movable_body_count, ws.incremental_update_count);
+	check_kinematics_equal (model, ws_ref, ws);
+}
+
+TEST_FIXTURE ( Human36, UpdateKinematicsIncrementalPositions ) {
+	randomizeStates();
+
+	Model &model = *model_emulated;
+	unsigned int movable_body_count = model.mBodies.size() - 1;
+
+	UpdateKinematicsIncremental (model, q);
+	CHECK_EQUAL (movable_body_count, model.incremental_update_count);
+
+	unsigned int shank_r_id = model.GetBodyId ("shank_r");
+	q[model.mJoints[shank_r_id].q_index] -= 0.1;
+
+	UpdateKinematicsIncremental (model, q);
+	CHECK_EQUAL (subtree_body_count (model, shank_r_id), model.incremental_update_count);
+
+	DynamicsWorkspace ws_ref (model);
+	UpdateKinematicsCustom (model, ws_ref, &q, NULL, NULL);
+
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		CHECK_ARRAY_CLOSE (ws_ref.X_base[i].E.data(), model.X_base[i].E.data(), 9, TEST_PREC);
+		CHECK_ARRAY_CLOSE (ws_ref.X_base[i].r.data(), model.X_base[i].r.data(), 3, TEST_PREC);
+	}
+
+	// velocities were never passed, all of them are computed
+	UpdateKinematicsIncremental (model, q, &qdot);
+	CHECK_EQUAL (movable_body_count, model.incremental_update_count);
+
+	q[0] += 0.01;
+	UpdateKinematicsIncremental (model, q, &qdot);
+	CHECK_EQUAL (movable_body_count, model.incremental_update_count);
+}
+
+TEST_FIXTURE ( Human36, JacobiansUseCurrentKinematics ) {
+	randomizeStates();
+
+	Model &model = *model_3dof;
+	unsigned int hand_l_id = model.GetBodyId ("hand_l");
+	unsigned int foot_r_id = model.GetBodyId ("foot_r");
+	Vector3d point (0.1, -0.2, 0.3);
+
+	MatrixNd G_point (MatrixNd::Zero (3, model.qdot_size));
+	MatrixNd G_spatial (MatrixNd::Zero (6, model.qdot_size));
+	CalcPointJacobian (model, q, hand_l_id, point, G_point);
+	CalcBodySpatialJacobian (model, q, foot_r_id, G_spatial);
+
+	// the motion subspaces of the first state must not be reused
+	VectorNd q_other (q);
+	for (unsigned int i = 0; i < q.size(); i++) {
+		q_other[i] += 0.1 * i;
+	}
+
+	MatrixNd G_point_ref (MatrixNd::Zero (3, model.qdot_size));
+	MatrixNd G_spatial_ref (MatrixNd::Zero (6, model.qdot_size));
+	DynamicsWorkspace ws_ref (model);
+	CalcPointJacobian (model, ws_ref, q_other, hand_l_id, point, G_point_ref);
+	CalcBodySpatialJacobian (model, ws_ref, q_other, foot_r_id, G_spatial_ref);
+
+	UpdateKinematicsCustom (model, &q_other, NULL, NULL);
+	CalcPointJacobian (model, q_other, hand_l_id, point, G_point, false);
+	CalcBodySpatialJacobian (model, q_other, foot_r_id, G_spatial, false);
+
+	CHECK_ARRAY_CLOSE (G_point_ref.data(), G_point.data(), G_point.size(), TEST_PREC);
+	CHECK_ARRAY_CLOSE (G_spatial_ref.data(), G_spatial.data(), G_spatial.size(), TEST_PREC);
+
+	// the point velocity computed from the Jacobian
+	UpdateKinematics (model, q, qdot, qddot);
+	CalcPointJacobian (model, q, hand_l_id, point, G_point, false);
+	Vector3d point_velocity = CalcPointVelocity (model, q, qdot, hand_l_id, point, false);
+	Vector3d jacobian_velocity = G_point * qdot;
+
+	CHECK_ARRAY_CLOSE (point_velocity.data(), jacobian_velocity.data(), 3, TEST_PREC);
+}
+
+TEST_FIXTURE ( Human36, CalcPointJacobiansStacked ) {
+	randomizeStates();
+
+	Model &model = *model_emulated;
+
+	std::vector<unsigned int> body_ids;
+	std::vector<Vector3d> points;
+	body_ids.push_back (model.GetBodyId ("foot_r"));
+	points.push_back (Vector3d (0.1, 0., -0.05));
+	body_ids.push_back (model.GetBodyId ("hand_l"));
+	points.push_back (Vector3d (0., 0.2, 0.));
+	body_ids.push_back (model.GetBodyId ("uppertrunk"));
+	points.push_back (Vector3d (-0.1, 0.3, 0.5));
+	body_ids.push_back (model.GetBodyId ("foot_r"));
+	points.push_back (Vector3d (-0.1, 0., -0.05));
+
+	MatrixNd G (MatrixNd::Zero (3 * body_ids.size(), model.qdot_size));
+	MatrixNd G_spatial (MatrixNd::Zero (6 * body_ids.size(), model.qdot_size));
+	CalcPointJacobians (model, q, body_ids, points, G);
+	CalcBodySpatialJacobians (model, q, body_ids, G_spatial);
+
+	for (unsigned int k = 0; k < body_ids.size(); k++) {
+		MatrixNd G_point (MatrixNd::Zero (3, model.qdot_size));
+		MatrixNd G_body (MatrixNd::Zero (6, model.qdot_size));
+		CalcPointJacobian (model, q, body_ids[k], points[k], G_point);
+		CalcBodySpatialJacobian (model, q, body_ids[k], G_body);
+
+		MatrixNd G_point_stacked = G.block (3 * k, 0, 3, model.qdot_size);
+		MatrixNd G_body_stacked = G_spatial.block (6 * k, 0, 6, model.qdot_size);
+		CHECK_ARRAY_CLOSE (G_point.data(), G_point_stacked.data(), G_point.size(), TEST_PREC);
+		CHECK_ARRAY_CLOSE (G_body.data(), G_body_stacked.data(), G_body.size(), TEST_PREC);
+	}
+}
+
+static void check_jacobian_derivatives (Model &model, const VectorNd &q, const VectorNd &qdot, const std::vector<unsigned int> &body_ids, const std::vector<Vector3d> &points) {
+	const double h = 1.0e-6;
+	const double fd_prec = 1.0e-7;
+
+	VectorNd qddot_zero (VectorNd::Zero (model.qdot_size));
+	VectorNd q_plus (q + h * qdot);
+	VectorNd q_minus (q - h * qdot);
+
+	MatrixNd G_dot_stacked (MatrixNd::Zero (3 * body_ids.size(), model.qdot_size));
+	VectorNd bias_stacked;
+	CalcPointJacobiansDot (model, q, qdot, body_ids, points, G_dot_stacked);
+	CalcPointJacobiansDotQDot (model, q, qdot, body_ids, points, bias_stacked);
+
+	for (unsigned int k = 0; k < body_ids.size(); k++) {
+		Vector3d bias = CalcPointJacobianDotQDot (model, q, qdot, body_ids[k], points[k]);
+		Vector3d bias_ref = CalcPointAcceleration (model, q, qdot, qddot_zero, body_ids[k], points[k]);
+		CHECK_ARRAY_CLOSE (bias_ref.data(), bias.data(), 3, TEST_PREC * 1.0e2);
+
+		MatrixNd G_dot (MatrixNd::Zero (3, model.qdot_size));
+		CalcPointJacobianDot (model, q, qdot, body_ids[k], points[k], G_dot);
+
+		VectorNd G_dot_qdot (G_dot * qdot);
+		CHECK_ARRAY_CLOSE (bias_ref.data(), G_dot_qdot.data(), 3, TEST_PREC * 1.0e2);
+
+		MatrixNd G_dot_row = G_dot_stacked.block (3 * k, 0, 3, model.qdot_size);
+		CHECK_ARRAY_CLOSE (G_dot.data(), G_dot_row.data(), G_dot.size(), TEST_PREC);
+		CHECK_ARRAY_CLOSE (bias.data(), bias_stacked.data() + 3 * k, 3, TEST_PREC);
+
+		// q moves along qdot (all joints of the test models have q_size == qdot_size)
+		MatrixNd G_plus (MatrixNd::Zero (3, model.qdot_size));
+		MatrixNd G_minus (MatrixNd::Zero (3, model.qdot_size));
+		CalcPointJacobian (model, q_plus, body_ids[k], points[k], G_plus);
+		CalcPointJacobian (model, q_minus, body_ids[k], points[k], G_minus);
+		MatrixNd G_dot_fd ((G_plus - G_minus) / (2. * h));
+		CHECK_ARRAY_CLOSE (G_dot_fd.data(), G_dot.data(), G_dot.size(), fd_prec);
+
+		MatrixNd S_dot (MatrixNd::Zero (6, model.qdot_size));
+		CalcBodySpatialJacobianDot (model, q, qdot, body_ids[k], S_dot);
+
+		MatrixNd S_plus (MatrixNd::Zero (6, model.qdot_size));
+		MatrixNd S_minus (MatrixNd::Zero (6, model.qdot_size));
+		CalcBodySpatialJacobian (model, q_plus, body_ids[k], S_plus);
+		CalcBodySpatialJacobian (model, q_minus, body_ids[k], S_minus);
+		MatrixNd S_dot_fd ((S_plus - S_minus) / (2. * h));
+		CHECK_ARRAY_CLOSE (S_dot_fd.data(), S_dot.data(), S_dot.size(), fd_prec);
+	}
+}
+
+TEST_FIXTURE ( Human36, CalcJacobianDerivatives ) {
+	randomizeStates();
+
+	std::vector<unsigned int> body_ids;
+	std::vector<Vector3d> points;
+	body_ids.push_back (model_emulated->GetBodyId ("foot_r"));
+	points.push_back (Vector3d (0.1, 0., -0.05));
+	body_ids.push_back (model_emulated->GetBodyId ("hand_l"));
+	points.push_back (Vector3d (0., 0.2, 0.));
+	body_ids.push_back (model_emulated->GetBodyId ("uppertrunk"));
+	points.push_back (Vector3d (-0.1, 0.3, 0.5));
+	body_ids.push_back (model_emulated->GetBodyId ("pelvis"));
+	points.push_back (Vector3d (0.2, -0.1, 0.1));
+
+	check_jacobian_derivatives (*model_emulated, q, qdot, body_ids, points);
+
+	for (unsigned int k = 0; k < body_ids.size(); k++)
+		body_ids[k] = model_3dof->GetBodyId (model_emulated->GetBodyName (body_ids[k]).c_str());
+
+	check_jacobian_derivatives (*model_3dof, q, qdot, body_ids, points);
+}
+
+TEST ( CalcPointJacobianDotQDotSpherical ) {
+	Model model;
+	model.gravity = Vector3d (0., -9.81, 0.);
+
+	Body body (1.3, Vector3d (0.4, 0.1, -0.2), Vector3d (0.7, 1.1, 0.9));
+	Joint joint_rot_y (SpatialVector (0., 1., 0., 0., 0., 0.));
+
+	unsigned int base_id = model.AppendBody (Xtrans (Vector3d (0., 0., 0.)), Joint (JointTypeTranslationXYZ), body);
+	unsigned int sph_id = model.AddBody (base_id, Xtrans (Vector3d (0.5, 0., 0.)), Joint (JointTypeSpherical), body);
+	unsigned int end_id = model.AddBody (sph_id, Xtrans (Vector3d (1., 0., 0.)), joint_rot_y, body);
+
+	VectorNd q (VectorNd::Zero (model.q_size));
+	VectorNd qdot (VectorNd::Zero (model.qdot_size));
+	VectorNd qddot (VectorNd::Zero (model.qdot_size));
+
+	for (unsigned int i = 0; i < model.qdot_size; i++) {
+		q[i] = 0.1 * i - 0.4;
+		qdot[i] = 0.3 - 0.17 * i;
+	}
+	model.SetQuaternion (sph_id, Quaternion::fromZYXAngles (Vector3d (0.3, 1.1, -0.4)), q);
+
+	Vector3d point (0.3, -0.2, 0.4);
+	Vector3d bias = CalcPointJacobianDotQDot (model, q, qdot, end_id, point);
+	Vector3d bias_ref = CalcPointAcceleration (model, q, qdot, qddot, end_id, point);
+	CHECK_ARRAY_CLOSE (bias_ref.data(), bias.data(), 3, TEST_PREC * 1.0e2);
+
+	MatrixNd G_dot (MatrixNd::Zero (3, model.qdot_size));
+	CalcPointJacobianDot (model, q, qdot, end_id, point, G_dot);
+	VectorNd G_dot_qdot (G_dot * qdot);
+	CHECK_ARRAY_CLOSE (bias_ref.data(), G_dot_qdot.data(), 3, TEST_PREC * 1.0e2);
+}
+
+TEST_FIXTURE(KinematicsFixture6DoF, TestInverseKinematicsConstraintSetPoints) {
+	VectorNd q_target (VectorNd::Zero (model->q_size));
+	q_target[0] = 0.5;
+	q_target[1] = -0.3;
+	q_target[4] = 0.9;
+
+	InverseKinematicsConstraintSet CS;
+	CS.AddPointConstraint (child_id, Vector3d (1., 0., 0.), CalcBodyToBaseCoordinates (*model, q_target, child_id, Vector3d (1., 0., 0.)));
+	CS.AddPointConstraint (base_id, Vector3d (0.6, 1.0, 0.), CalcBodyToBaseCoordinates (*model, q_target, base_id, Vector3d (0.6, 1.0, 0.)));
+	CS.constraint_tol = 1.0e-10;
+
+	Q[0] = 0.2;
+	Q[1] = 0.1;
+	Q[2] = 0.1;
+
+	VectorNd Qres (VectorNd::Zero (model->q_size));
+
+	CHECK (InverseKinematics (*model, Q, CS, Qres));
+	CHECK (CS.converged);
+	CHECK (CS.error_norm < 1.0e-10);
+	CHECK (CS.num_steps > 0);
+	CHECK_EQUAL (1u, CS.solve_count);
+	CHECK_EQUAL (CS.num_steps, CS.total_steps);
+
+	for (unsigned int k = 0; k < CS.size(); k++) {
+		Vector3d point = CalcBodyToBaseCoordinates (*model, Qres, CS.body_ids[k], CS.body_points[k]);
+		CHECK_ARRAY_CLOSE (CS.target_positions[k].data(), point.data(), 3, 1.0e-10);
+	}
+
+	// starting at the solution requires no steps, Qinit and Qres may alias
+	CHECK (InverseKinematics (*model, Qres, CS, Qres));
+	CHECK_EQUAL (0u, CS.num_steps);
+	CHECK_EQUAL (2u, CS.solve_count);
+}
+
+TEST_FIXTURE(KinematicsFixture6DoF, TestInverseKinematicsConstraintSetUnreachable) {
+	InverseKinematicsConstraintSet CS;
+	CS.AddPointConstraint (child_id, Vector3d (1., 0., 0.), Vector3d (2.2, 0., 0.));
+
+	Q[0] = 0.2;
+	Q[1] = 0.1;
+	Q[2] = 0.1;
+
+	VectorNd Qres (VectorNd::Zero (model->q_size));
+
+	CHECK_EQUAL (false, InverseKinematics (*model, Q, CS, Qres));
+	CHECK (CS.num_rejected_steps > 0);
+	CHECK (CS.num_steps <= CS.max_steps);
+
+	Vector3d point = CalcBodyToBaseCoordinates (*model, Qres, child_id, Vector3d (1., 0., 0.));
+	CHECK_ARRAY_CLOSE (Vector3d (2., 0., 0.).data(), point.data(), 3, 1.0e-6);
+	CHECK_CLOSE (0.2, CS.error_norm, 1.0e-6);
+}
+
+TEST_FIXTURE(KinematicsFixture6DoF, TestInverseKinematicsConstraintSetSingular) {
+	VectorNd q_target (VectorNd::Zero (model->q_size));
+	q_target[0] = 0.5;
+	q_target[1] = -0.3;
+	q_target[4] = 0.9;
+
+	// the duplicated constraint and the missing damping make the normal
+	// matrix singular such that the solver has to increase the damping
+	Vector3d target = CalcBodyToBaseCoordinates (*model, q_target, child_id, Vector3d (1., 0., 0.));
+
+	InverseKinematicsConstraintSet CS;
+	CS.AddPointConstraint (child_id, Vector3d (1., 0., 0.), target);
+	CS.AddPointConstraint (child_id, Vector3d (1., 0., 0.), target);
+	CS.lambda = 0.;
+	CS.constraint_tol = 1.0e-10;
+
+	Q[0] = 0.2;
+	Q[1] = 0.1;
+	Q[2] = 0.1;
+
+	VectorNd Qres (VectorNd::Zero (model->q_size));
+
+	CHECK (InverseKinematics (*model, Q, CS, Qres));
+	CHECK (CS.num_rejected_steps > 0);
+	CHECK (CS.error_norm < 1.0e-10);
+
+	Vector3d point = CalcBodyToBaseCoordinates (*model, Qres, child_id, Vector3d (1., 0., 0.));
+	CHECK_ARRAY_CLOSE (target.data(), point.data(), 3, 1.0e-10);
+}
+
+TEST_FIXTURE(KinematicsFixture6DoF, TestInverseKinematicsConstraintSetJointLimits) {
+	InverseKinematicsConstraintSet CS;
+	CS.AddPointConstraint (child_id, Vector3d (1., 0., 0.), Vector3d (1.2, 1.2, 0.));
+
+	VectorNd q_min (VectorNd::Constant (model->q_size, -0.3));
+	VectorNd q_max (VectorNd::Constant (model->q_size, 0.3));
+	CS.SetJointLimits (q_min, q_max);
+
+	VectorNd Qres (VectorNd::Zero (model->q_size));
+	InverseKinematics (*model, Q, CS, Qres);
+
+	for (unsigned int i = 0; i < model->q_size; i++) {
+		CHECK (Qres[i] >= -0.3);
+		CHECK (Qres[i] <= 0.3);
+	}
+
+	// the error is smaller than at the initial state although the target
+	// is not reachable within the limits
+	CHECK (CS.error_norm < Vector3d (0.8, -1.2, 0.).norm());
+	CHECK (CS.error_norm > 1.0e-3);
+}
+
+TEST_FIXTURE(Human36, TestInverseKinematicsConstraintSetOrientation) {
+	randomizeStates();
+
+	Model &model = *model_3dof;
+
+	// targets of a random (hence reachable) pose
+	VectorNd q_target (q);
+
+	unsigned int hand_id = model.GetBodyId ("hand_r");
+	unsigned int foot_id = model.GetBodyId ("foot_l");
+	unsigned int head_id = model.GetBodyId ("head");
+	Vector3d hand_point (0.1, 0.05, -0.1);
+
+	UpdateKinematicsCustom (model, &q_target, NULL, NULL);
+
+	InverseKinematicsConstraintSet CS;
+	CS.AddFullConstraint (hand_id, hand_point,
+			CalcBodyToBaseCoordinates (model, q_target, hand_id, hand_point, false),
+			CalcBodyWorldOrientation (model, q_target, hand_id, false));
+	CS.AddOrientationConstraint (foot_id, CalcBodyWorldOrientation (model, q_target, foot_id, false));
+	CS.AddPointConstraint (head_id, Vector3d::Zero(), CalcBodyToBaseCoordinates (model, q_target, head_id, Vector3d::Zero(), false));
+	CS.constraint_tol = 1.0e-10;
+
+	CHECK_EQUAL (12u, CS.GetNumRows());
+
+	VectorNd q_init (q_target);
+	for (unsigned int i = 0; i < q_init.size(); i++)
+		q_init[i] += 0.1 * cos (3. * i);
+
+	VectorNd Qres (VectorNd::Zero (model.q_size));
+	CHECK (InverseKinematics (model, q_init, CS, Qres));
+
+	Matrix3d E_hand = CalcBodyWorldOrientation (model, Qres, hand_id);
+	Matrix3d E_foot = CalcBodyWorldOrientation (model, Qres, foot_id, false);
+	Vector3d hand_pos = CalcBodyToBaseCoordinates (model, Qres, hand_id, hand_point, false);
+	Vector3d head_pos = CalcBodyToBaseCoordinates (model, Qres, head_id, Vector3d::Zero(), false);
+
+	CHECK_ARRAY_CLOSE (CS.target_orientations[0].data(), E_hand.data(), 9, 1.0e-9);
+	CHECK_ARRAY_CLOSE (CS.target_positions[0].data(), hand_pos.data(), 3, 1.0e-9);
+	CHECK_ARRAY_CLOSE (CS.target_orientations[1].data(), E_foot.data(), 9, 1.0e-9);
+	CHECK_ARRAY_CLOSE (CS.target_positions[2].data(), head_pos.data(), 3, 1.0e-9);
+}
+
+TEST ( TestInverseKinematicsConstraintSetSpherical ) {
+	Model model;
+
+	Body body (1., Vector3d (0.5, 0., 0.), Vector3d (1., 1., 1.));
+
+	unsigned int sph_id = model.AddBody (0, Xtrans (Vector3d (0., 0., 0.)), Joint (JointTypeSpherical), body);
+	unsigned int end_id = model.AddBody (sph_id, Xtrans (Vector3d (1., 0., 0.)), Joint (SpatialVector (0., 0., 1., 0., 0., 0.)), body);
+
+	VectorNd q_target (VectorNd::Zero (model.q_size));
+	model.SetQuaternion (sph_id, Quaternion::fromZYXAngles (Vector3d (2.8, -0.4, 1.2)), q_target);
+	q_target[3] = 0.7;
+
+	UpdateKinematicsCustom (model, &q_target, NULL, NULL);
+
+	InverseKinematicsConstraintSet CS;
+	CS.AddFullConstraint (end_id, Vector3d (0.5, 0., 0.),
+			CalcBodyToBaseCoordinates (model, q_target, end_id, Vector3d (0.5, 0., 0.), false),
+			CalcBodyWorldOrientation (model, q_target, end_id, false));
+	CS.constraint_tol = 1.0e-10;
+
+	VectorNd q_init (VectorNd::Zero (model.q_size));
+	model.SetQuaternion (sph_id, Quaternion (0., 0., 0., 1.), q_init);
+
+	VectorNd Qres (VectorNd::Zero (model.q_size));
+	CHECK (InverseKinematics (model, q_init, CS, Qres));
+
+	Quaternion quat = model.GetQuaternion (sph_id, Qres);
+	CHECK_CLOSE (1., quat.norm(), 1.0e-12);
+
+	Matrix3d E_end = CalcBodyWorldOrientation (model, Qres, end_id);
+	CHECK_ARRAY_CLOSE (CS.target_orientations[0].data(), E_end.data(), 9, 1.0e-9);
+}
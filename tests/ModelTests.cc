@@ -575,6 +575,49 @@ TEST_FIXTURE(RotZRotZYXFixed, ModelSetJointFrame) {
 	CHECK_ARRAY_EQUAL (Vector3d(0., 0., 0.).data(), transform_root.r.data(), 3);
 }
 
+TEST_FIXTURE(RotZRotZYXFixed, ModelSetJointFrameTransformKinds) {
+	CHECK_EQUAL (SpatialTransformRotationZ, model->X_J_kind[body_a_id]);
+	CHECK_EQUAL (SpatialTransformTranslation, model->X_T_kind[body_a_id]);
+	CHECK_EQUAL (SpatialTransformRotationZ, model->X_lambda_kind[body_a_id]);
+
+	SpatialTransform new_transform_a = Xroty (0.3) * Xtrans (Vector3d(-1., -2., -3.));
+	model->SetJointFrame (body_a_id, new_transform_a);
+
+	CHECK_EQUAL (SpatialTransformRotationY, model->X_T_kind[body_a_id]);
+	CHECK_EQUAL (SpatialTransformGeneral, model->X_lambda_kind[body_a_id]);
+
+	VectorNd q = VectorNd::Constant (model->q_size, 0.4);
+	jcalc_X_lambda_S (*model, body_a_id, q);
+
+	SpatialTransform X_lambda = model->X_J[body_a_id] * new_transform_a;
+	CHECK_ARRAY_CLOSE (X_lambda.E.data(), model->X_lambda[body_a_id].E.data(), 9, TEST_PREC);
+	CHECK_ARRAY_CLOSE (X_lambda.r.data(), model->X_lambda[body_a_id].r.data(), 3, TEST_PREC);
+}
+
+TEST_FIXTURE(RotZRotZYXFixed, ModelUpdateJointFrameKinds) {
+	SpatialTransform new_transform_a = Xroty (0.3) * Xtrans (Vector3d(-1., -2., -3.));
+
+	Model model_set (*model);
+	model_set.SetJointFrame (body_a_id, new_transform_a);
+
+	model->X_T[body_a_id] = new_transform_a;
+	model->UpdateJointFrameKinds();
+
+	CHECK_EQUAL (SpatialTransformRotationY, model->X_T_kind[body_a_id]);
+	CHECK_EQUAL (SpatialTransformGeneral, model->X_lambda_kind[body_a_id]);
+
+	VectorNd q = VectorNd::Constant (model->q_size, 0.4);
+	VectorNd qdot = VectorNd::Constant (model->qdot_size, -0.2);
+	VectorNd tau = VectorNd::Constant (model->qdot_size, 0.7);
+	VectorNd qddot = VectorNd::Zero (model->qdot_size);
+	VectorNd qddot_set = VectorNd::Zero (model->qdot_size);
+
+	ForwardDynamics (*model, q, qdot, tau, qddot);
+	ForwardDynamics (model_set, q, qdot, tau, qddot_set);
+
+	CHECK_ARRAY_CLOSE (qddot_set.data(), qddot.data(), qddot.size(), TEST_PREC);
+}
+
 TEST (CalcBodyWorldOrientationFixedJoint) {
 	Model model_fixed;
 	Model model_movable;
@@ -598,3 +641,132 @@ TEST (CalcBodyWorldOrientationFixedJoint) {
 	CHECK_ARRAY_CLOSE (E_movable.data(), E_fixed.data(), 9, TEST_PREC);
 }
 
+
+TEST (ModelJointKernelsAllJointTypes) {
+	Model model;
+
+	Body body (1., Vector3d (1., 1., 1.), Vector3d (1., 1., 1.));
+
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (SpatialVector (1., 0., 0., 0., 0., 0.)), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (SpatialVector (0., 1., 0., 0., 0., 0.)), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (SpatialVector (0., 0., 1., 0., 0., 0.)), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (JointTypeRevolute, Vector3d (1., 2., 3.).normalized()), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (JointTypePrismatic, Vector3d (0., 1., 0.)), body);
+	unsigned int sph_id = model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (JointTypeSpherical), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (JointTypeEulerZYX), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (JointTypeEulerXYZ), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (JointTypeEulerYXZ), body);
+	model.AppendBody (Xtrans (Vector3d (0.1, 0., 0.)), Joint (JointTypeTranslationXYZ), body);
+
+	CHECK_EQUAL (model.mJoints.size(), model.mJointKernels.size());
+	CHECK_EQUAL (model.mJoints.size(), model.mJointPositionKernels.size());
+
+	VectorNd q (VectorNd::Zero (model.q_size));
+	VectorNd qdot (VectorNd::Zero (model.qdot_size));
+
+	for (unsigned int i = 0; i < model.qdot_size; i++) {
+		q[i] = 0.1 * (i + 1);
+		qdot[i] = -0.3 * (i + 1);
+	}
+	model.SetQuaternion (sph_id, Quaternion::fromZYXAngles (Vector3d (0.3, -0.2, 0.5)), q);
+
+	DynamicsWorkspace ws (model);
+	DynamicsWorkspace ws_position (model);
+
+	for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+		CHECK (model.mJointKernels[i] == jcalc_select_kernel (model.mJoints[i].mJointType));
+		CHECK (model.mJointPositionKernels[i] == jcalc_select_position_kernel (model.mJoints[i].mJointType));
+
+		jcalc (model, ws, i, q, qdot);
+		jcalc_X_lambda_S (model, ws_position, i, q);
+
+		SpatialMatrix X_lambda = ws.X_lambda[i].toMatrix();
+		SpatialMatrix X_lambda_position = ws_position.X_lambda[i].toMatrix();
+
+		CHECK_ARRAY_CLOSE (X_lambda.data(), X_lambda_position.data(), 36, TEST_PREC);
+		CHECK_ARRAY_CLOSE (ws.multdof3_S[i].data(), ws_position.multdof3_S[i].data(), 18, TEST_PREC);
+	}
+}
+
+TEST (ModelReorderBodiesDepthFirst) {
+	Model model;
+	Body body (1.3, Vector3d (0.1, -0.2, 0.3), Vector3d (1., 2., 3.));
+	Joint joint_rot_y (SpatialVector (0., 1., 0., 0., 0., 0.));
+	Joint joint_rot_zx (
+			SpatialVector (0., 0., 1., 0., 0., 0.),
+			SpatialVector (1., 0., 0., 0., 0., 0.)
+			);
+
+	// the bodies of the two branches are added alternately
+	unsigned int a1 = model.AddBody (0, Xtrans (Vector3d (1., 0., 0.)), joint_rot_y, body, "a1");
+	unsigned int b1 = model.AddBody (0, Xtrans (Vector3d (-1., 0., 0.)), Joint (JointTypeSpherical), body, "b1");
+	unsigned int a2 = model.AddBody (a1, Xroty (0.4) * Xtrans (Vector3d (0., -1., 0.)), joint_rot_zx, body, "a2");
+	unsigned int tool = model.AddBody (a2, Xtrans (Vector3d (0., -0.5, 0.)), Joint (JointTypeFixed), body, "tool");
+	model.AddBody (b1, Xtrans (Vector3d (0., -1., 0.)), Joint (JointTypeEulerZYX), body, "b2");
+	model.AddBody (tool, Xtrans (Vector3d (0.2, -0.3, 0.)), joint_rot_y, body, "a3");
+
+	Model reordered;
+	BodyReordering reordering;
+	ReorderBodiesDepthFirst (model, reordered, &reordering);
+
+	CHECK_EQUAL (model.mBodies.size(), reordered.mBodies.size());
+	CHECK_EQUAL (model.q_size, reordered.q_size);
+	CHECK_EQUAL (tool, reordered.GetBodyId ("tool"));
+
+	// every body directly follows its parent or a descendant of its parent
+	for (unsigned int i = 2; i < reordered.mBodies.size(); i++) {
+		unsigned int ancestor = i - 1;
+		while (ancestor != 0 && ancestor != reordered.lambda[i])
+			ancestor = reordered.lambda[ancestor];
+
+		CHECK_EQUAL (reordered.lambda[i], ancestor);
+	}
+
+	const char *names[6] = { "a1", "a2", "tool", "a3", "b1", "b2" };
+	for (unsigned int k = 0; k < 6; k++) {
+		unsigned int id = model.GetBodyId (names[k]);
+		CHECK_EQUAL (reordering.GetReorderedBodyId (model, id), reordered.GetBodyId (names[k]));
+	}
+
+	VectorNd q (VectorNd::Zero (model.q_size));
+	VectorNd qdot (VectorNd::Zero (model.qdot_size));
+	VectorNd tau (VectorNd::Zero (model.qdot_size));
+	VectorNd qddot (VectorNd::Zero (model.qdot_size));
+
+	for (unsigned int i = 0; i < model.qdot_size; i++) {
+		q[i] = 0.2 * i - 0.7;
+		qdot[i] = 0.3 * i - 0.5;
+		tau[i] = -0.4 * i + 0.9;
+	}
+	Quaternion quat (0.1, 0.2, 0.3, 0.9);
+	quat.normalize();
+	model.SetQuaternion (b1, quat, q);
+
+	VectorNd q_reordered, qdot_reordered, tau_reordered;
+	VectorNd qddot_reordered (VectorNd::Zero (model.qdot_size));
+	reordering.ReorderQ (q, q_reordered);
+	reordering.ReorderQDot (qdot, qdot_reordered);
+	reordering.ReorderQDot (tau, tau_reordered);
+
+	VectorNd q_restored;
+	reordering.RestoreQ (q_reordered, q_restored);
+	CHECK_ARRAY_EQUAL (q.data(), q_restored.data(), q.size());
+
+	for (unsigned int k = 0; k < 6; k++) {
+		Vector3d point (0.1, 0.2, 0.3);
+		Vector3d base = CalcBodyToBaseCoordinates (model, q, model.GetBodyId (names[k]), point);
+		Vector3d base_reordered = CalcBodyToBaseCoordinates (reordered, q_reordered, reordered.GetBodyId (names[k]), point);
+		CHECK_ARRAY_CLOSE (base.data(), base_reordered.data(), 3, 1.0e-12);
+	}
+
+	ForwardDynamics (model, q, qdot, tau, qddot);
+	ForwardDynamics (reordered, q_reordered, qdot_reordered, tau_reordered, qddot_reordered);
+
+	VectorNd qddot_restored;
+	reordering.RestoreQDot (qddot_reordered, qddot_restored);
+	CHECK_ARRAY_CLOSE (qddot.data(), qddot_restored.data(), qddot.size(), 1.0e-10);
+
+	// reordering in place
+	ReorderBodiesDepthFirst (model, model);
+	CHECK_EQUAL (reordered.GetBodyId ("a3"), model.GetBodyId ("a3"));
+}
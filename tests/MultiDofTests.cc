@@ -1007,3 +1007,146 @@ TEST_FIXTURE(SphericalJoint, TestEulerZYXvsEmulated ) {
 
 	CHECK_ARRAY_CLOSE (QDDot_emu.data(), QDDot_eulerzyx.data(), emulated_model.qdot_size, TEST_PREC);
 }
+
+TEST_FIXTURE (Human36, TestDynamicsWorkspace) {
+	randomizeStates();
+
+	const Model &model_const = *model_3dof;
+	DynamicsWorkspace ws (model_const);
+
+	VectorNd qddot_model (qddot_3dof);
+	VectorNd qddot_ws (qddot_3dof);
+
+	ForwardDynamics (*model_3dof, q, qdot, tau, qddot_model);
+	ForwardDynamics (model_const, ws, q, qdot, tau, qddot_ws);
+	CHECK_ARRAY_EQUAL (qddot_model.data(), qddot_ws.data(), qddot_model.size());
+
+	VectorNd tau_model (tau);
+	VectorNd tau_ws (tau);
+
+	InverseDynamics (*model_3dof, q, qdot, qddot, tau_model);
+	InverseDynamics (model_const, ws, q, qdot, qddot, tau_ws);
+	CHECK_ARRAY_EQUAL (tau_model.data(), tau_ws.data(), tau_model.size());
+
+	MatrixNd H_model (MatrixNd::Zero (model_3dof->qdot_size, model_3dof->qdot_size));
+	MatrixNd H_ws (MatrixNd::Zero (model_3dof->qdot_size, model_3dof->qdot_size));
+
+	CompositeRigidBodyAlgorithm (*model_3dof, q, H_model);
+	CompositeRigidBodyAlgorithm (model_const, ws, q, H_ws);
+	CHECK_ARRAY_EQUAL (H_model.data(), H_ws.data(), H_model.size());
+
+	for (unsigned int i = 0; i < model_3dof->mBodies.size(); i++) {
+		CHECK_ARRAY_EQUAL (model_3dof->X_base[i].E.data(), ws.X_base[i].E.data(), 9);
+	}
+}
+
+TEST_FIXTURE (Human36, TestDynamicsWorkspaceDoesNotModifyModel) {
+	randomizeStates();
+
+	VectorNd qddot_model (qddot_3dof);
+	ForwardDynamics (*model_3dof, q, qdot, tau, qddot_model);
+
+	std::vector<SpatialVector> a_before = model_3dof->a;
+
+	DynamicsWorkspace ws (*model_3dof);
+	VectorNd qddot_ws (qddot_3dof);
+	VectorNd q_other (q * 0.5);
+	ForwardDynamics (*model_3dof, ws, q_other, qdot, tau, qddot_ws);
+
+	for (unsigned int i = 0; i < a_before.size(); i++) {
+		CHECK_ARRAY_EQUAL (a_before[i].data(), model_3dof->a[i].data(), 6);
+	}
+}
+
+TEST_FIXTURE (Human36, TestDynamicsWorkspaceContacts) {
+	randomizeStates();
+
+	const Model &model_const = *model_3dof;
+	DynamicsWorkspace ws (model_const);
+
+	VectorNd qddot_model (qddot_3dof);
+	VectorNd qddot_ws (qddot_3dof);
+
+	ForwardDynamicsContactsDirect (*model_3dof, q, qdot, tau, constraints_4B4C_3dof, qddot_model);
+	ForwardDynamicsContactsDirect (model_const, ws, q, qdot, tau, constraints_4B4C_3dof, qddot_ws);
+	CHECK_ARRAY_EQUAL (qddot_model.data(), qddot_ws.data(), qddot_model.size());
+
+	ForwardDynamicsContactsKokkevis (*model_3dof, q, qdot, tau, constraints_1B4C_3dof, qddot_model);
+	ForwardDynamicsContactsKokkevis (model_const, ws, q, qdot, tau, constraints_1B4C_3dof, qddot_ws);
+	CHECK_ARRAY_EQUAL (qddot_model.data(), qddot_ws.data(), qddot_model.size());
+}
+
+TEST_FIXTURE (Human36, TestForwardDynamicsBatch) {
+	unsigned int sample_count = 5;
+
+	MatrixNd Q (q.size(), sample_count);
+	MatrixNd QDot (qdot.size(), sample_count);
+	MatrixNd Tau (tau.size(), sample_count);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		randomizeStates();
+		Q.col(k) = q;
+		QDot.col(k) = qdot;
+		Tau.col(k) = tau;
+	}
+
+	BatchDynamicsWorkspace ws_emulated (*model_emulated, sample_count);
+	BatchDynamicsWorkspace ws_3dof;
+
+	MatrixNd QDDot_emulated;
+	MatrixNd QDDot_3dof;
+
+	ForwardDynamicsBatch (*model_emulated, ws_emulated, Q, QDot, Tau, QDDot_emulated);
+	ForwardDynamicsBatch (*model_3dof, ws_3dof, Q, QDot, Tau, QDDot_3dof);
+
+	CHECK_EQUAL (sample_count, ws_3dof.sample_count);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		VectorNd q_k (Q.col(k));
+		VectorNd qdot_k (QDot.col(k));
+		VectorNd tau_k (Tau.col(k));
+
+		ForwardDynamics (*model_emulated, q_k, qdot_k, tau_k, qddot_emulated);
+		ForwardDynamics (*model_3dof, q_k, qdot_k, tau_k, qddot_3dof);
+
+		VectorNd qddot_batch_emulated (QDDot_emulated.col(k));
+		VectorNd qddot_batch_3dof (QDDot_3dof.col(k));
+
+		CHECK_ARRAY_CLOSE (qddot_emulated.data(), qddot_batch_emulated.data(), qddot_emulated.size(), TEST_PREC * qddot_emulated.norm());
+		CHECK_ARRAY_CLOSE (qddot_3dof.data(), qddot_batch_3dof.data(), qddot_3dof.size(), TEST_PREC * qddot_3dof.norm());
+	}
+}
+
+TEST_FIXTURE(SphericalJoint, TestForwardDynamicsBatchSpherical) {
+	unsigned int sample_count = 3;
+
+	MatrixNd Q (multdof3_model.q_size, sample_count);
+	MatrixNd QDot (multdof3_model.qdot_size, sample_count);
+	MatrixNd Tau (multdof3_model.qdot_size, sample_count);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		sphQ.setZero();
+		multdof3_model.SetQuaternion (sph_body_id, Quaternion::fromZYXAngles (Vector3d (1.1 * k, -0.3, 0.2 * k)), sphQ);
+		sphQ[0] = 0.4 * k;
+		Q.col(k) = sphQ;
+
+		QDot.col(k) = VectorNd::Constant (multdof3_model.qdot_size, 0.3 + k);
+		Tau.col(k) = VectorNd::Constant (multdof3_model.qdot_size, -0.2 * k);
+	}
+
+	BatchDynamicsWorkspace ws (multdof3_model, sample_count);
+	MatrixNd QDDot (MatrixNd::Zero (multdof3_model.qdot_size, sample_count));
+
+	ForwardDynamicsBatch (multdof3_model, ws, Q, QDot, Tau, QDDot);
+
+	for (unsigned int k = 0; k < sample_count; k++) {
+		sphQ = Q.col(k);
+		sphQDot = QDot.col(k);
+		sphTau = Tau.col(k);
+
+		ForwardDynamics (multdof3_model, sphQ, sphQDot, sphTau, sphQDDot);
+
+		VectorNd qddot_batch (QDDot.col(k));
+		CHECK_ARRAY_CLOSE (sphQDDot.data(), qddot_batch.data(), multdof3_model.qdot_size, TEST_PREC);
+	}
+}
@@ -3,6 +3,7 @@
 #include <iostream>
 
 #include "Fixtures.h"
+#include "Human36Fixture.h"
 #include "rbdl/rbdl_mathutils.h"
 #include "rbdl/rbdl_utils.h"
 #include "rbdl/Logging.h"
@@ -10,6 +11,7 @@
 #include "rbdl/Model.h"
 #include "rbdl/Kinematics.h"
 #include "rbdl/Dynamics.h"
+#include "rbdl/Contacts.h"
 
 using namespace std;
 using namespace RigidBodyDynamics;
@@ -266,3 +268,138 @@ TEST ( TestSparseFactorizationMultiDofAndFixed) {
 
 	CHECK_ARRAY_CLOSE (x_emulated.data(), x_3dof.data(), x_emulated.size(), 1.0e-9);
 }
+
+TEST_FIXTURE (Human36, TestSparsityPatternBranched) {
+	Model *models[2] = { model_emulated, model_3dof };
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+		randomizeStates();
+
+		MatrixNd H (MatrixNd::Zero (model.qdot_size, model.qdot_size));
+		CompositeRigidBodyAlgorithm (model, q, H);
+
+		// entries of H that do not belong to a degree of freedom and one of
+		// its ancestors are zero due to the branching of the model
+		unsigned int pattern_count = 0;
+		for (unsigned int i = 1; i <= model.qdot_size; i++) {
+			std::vector<bool> is_ancestor (model.qdot_size + 1, false);
+			unsigned int j = model.lambda_q[i];
+			while (j != 0) {
+				CHECK (j < i);
+				is_ancestor[j] = true;
+				pattern_count++;
+				j = model.lambda_q[j];
+			}
+
+			for (j = 1; j < i; j++) {
+				if (!is_ancestor[j]) {
+					CHECK_EQUAL (0., H(i - 1, j - 1));
+				}
+			}
+		}
+
+		CHECK (pattern_count < model.qdot_size * (model.qdot_size - 1) / 2);
+	}
+}
+
+TEST_FIXTURE (Human36, TestSparseMultiply) {
+	Model *models[2] = { model_emulated, model_3dof };
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+		randomizeStates();
+
+		MatrixNd H (MatrixNd::Zero (model.qdot_size, model.qdot_size));
+		CompositeRigidBodyAlgorithm (model, q, H);
+
+		MatrixNd L (H);
+		SparseFactorizeLTL (model, L);
+
+		VectorNd result (VectorNd::Zero (model.qdot_size));
+		VectorNd reference (VectorNd::Zero (model.qdot_size));
+
+		SparseMultiplyHx (model, H, qdot, result);
+		reference = H * qdot;
+		CHECK_ARRAY_CLOSE (reference.data(), result.data(), model.qdot_size, TEST_PREC * reference.norm());
+
+		SparseMultiplyLx (model, L, qdot, result);
+		reference = L * qdot;
+		CHECK_ARRAY_CLOSE (reference.data(), result.data(), model.qdot_size, TEST_PREC * reference.norm());
+
+		SparseMultiplyLTx (model, L, qdot, result);
+		reference = L.transpose() * qdot;
+		CHECK_ARRAY_CLOSE (reference.data(), result.data(), model.qdot_size, TEST_PREC * reference.norm());
+	}
+}
+
+TEST_FIXTURE (Human36, TestForwardDynamicsLagrangianSparseLTL) {
+	Model *models[2] = { model_emulated, model_3dof };
+
+	for (unsigned int m = 0; m < 2; m++) {
+		Model &model = *models[m];
+		randomizeStates();
+
+		VectorNd qddot_aba (VectorNd::Zero (model.qdot_size));
+		VectorNd qddot_sparse (VectorNd::Zero (model.qdot_size));
+
+		ForwardDynamics (model, q, qdot, tau, qddot_aba);
+		ForwardDynamicsLagrangian (model, q, qdot, tau, qddot_sparse, LinearSolverSparseLTL);
+
+		CHECK_ARRAY_CLOSE (qddot_aba.data(), qddot_sparse.data(), model.qdot_size, 1.0e-10 * qddot_aba.norm());
+	}
+}
+
+typedef void (*ForwardDynamicsContactsMethod) (
+		Model &model,
+		const VectorNd &Q,
+		const VectorNd &QDot,
+		const VectorNd &Tau,
+		ConstraintSet &CS,
+		VectorNd &QDDot
+		);
+
+TEST_FIXTURE (Human36, TestContactsSparseLTL) {
+	randomizeStates();
+
+	ConstraintSet &CS = constraints_4B4C_emulated;
+	VectorNd qddot_reference (VectorNd::Zero (model_emulated->qdot_size));
+	VectorNd qddot_sparse (VectorNd::Zero (model_emulated->qdot_size));
+
+	ForwardDynamicsContactsMethod methods[3] = {
+		ForwardDynamicsContactsDirect,
+		ForwardDynamicsContactsNullSpace,
+		ForwardDynamicsContactsKokkevis
+	};
+
+	CS.linear_solver = LinearSolverColPivHouseholderQR;
+	ForwardDynamicsContactsDirect (*model_emulated, q, qdot, tau, CS, qddot_reference);
+	VectorNd force_reference (CS.force);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		CS.linear_solver = LinearSolverSparseLTL;
+		methods[i] (*model_emulated, q, qdot, tau, CS, qddot_sparse);
+
+		CHECK_ARRAY_CLOSE (qddot_reference.data(), qddot_sparse.data(), qddot_reference.size(), 1.0e-9 * qddot_reference.norm());
+
+		// the null space method computes the forces differently
+		if (i != 1) {
+			CHECK_ARRAY_CLOSE (force_reference.data(), CS.force.data(), CS.size(), 1.0e-9 * force_reference.norm());
+		}
+	}
+
+	VectorNd qdot_plus_reference (VectorNd::Zero (model_emulated->qdot_size));
+	VectorNd qdot_plus_sparse (VectorNd::Zero (model_emulated->qdot_size));
+
+	CS.linear_solver = LinearSolverColPivHouseholderQR;
+	ComputeContactImpulsesDirect (*model_emulated, q, qdot, CS, qdot_plus_reference);
+	VectorNd impulse_reference (CS.impulse);
+
+	CS.linear_solver = LinearSolverSparseLTL;
+	ComputeContactImpulsesDirect (*model_emulated, q, qdot, CS, qdot_plus_sparse);
+
+	CHECK_ARRAY_CLOSE (qdot_plus_reference.data(), qdot_plus_sparse.data(), qdot_plus_reference.size(), 1.0e-9 * qdot_plus_reference.norm());
+	CHECK_ARRAY_CLOSE (impulse_reference.data(), CS.impulse.data(), CS.size(), 1.0e-9 * impulse_reference.norm());
+
+	CS.linear_solver = LinearSolverColPivHouseholderQR;
+}
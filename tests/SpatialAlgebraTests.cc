@@ -566,6 +566,85 @@ TEST(TestSpatialRigidBodyInertiaCreateFromMatrix) {
 	CHECK_ARRAY_EQUAL (inertia.data(), rbi_I_matrix.data(), 9);
 }
 
+static std::vector<SpatialTransform> CreateKindTestTransforms () {
+	std::vector<SpatialTransform> transforms;
+	Vector3d r (0.3, -1.2, 0.7);
+
+	transforms.push_back (Xtrans (r));
+	transforms.push_back (Xrotx (0.4) * Xtrans (r));
+	transforms.push_back (Xroty (-1.1) * Xtrans (r));
+	transforms.push_back (Xrotz (2.3) * Xtrans (r));
+	transforms.push_back (Xrot (0.9, Vector3d (0., 0.6, 0.8)) * Xtrans (r));
+
+	return transforms;
+}
+
+TEST(TestSpatialTransformKindCalc) {
+	std::vector<SpatialTransform> transforms = CreateKindTestTransforms();
+
+	CHECK_EQUAL (SpatialTransformTranslation, CalcSpatialTransformKind (SpatialTransform()));
+	CHECK_EQUAL (SpatialTransformTranslation, CalcSpatialTransformKind (transforms[0]));
+	CHECK_EQUAL (SpatialTransformRotationX, CalcSpatialTransformKind (transforms[1]));
+	CHECK_EQUAL (SpatialTransformRotationY, CalcSpatialTransformKind (transforms[2]));
+	CHECK_EQUAL (SpatialTransformRotationZ, CalcSpatialTransformKind (transforms[3]));
+	CHECK_EQUAL (SpatialTransformGeneral, CalcSpatialTransformKind (transforms[4]));
+
+	CHECK_EQUAL (SpatialTransformRotationX, CombineSpatialTransformKinds (SpatialTransformTranslation, SpatialTransformRotationX));
+	CHECK_EQUAL (SpatialTransformRotationY, CombineSpatialTransformKinds (SpatialTransformRotationY, SpatialTransformTranslation));
+	CHECK_EQUAL (SpatialTransformRotationZ, CombineSpatialTransformKinds (SpatialTransformRotationZ, SpatialTransformRotationZ));
+	CHECK_EQUAL (SpatialTransformGeneral, CombineSpatialTransformKinds (SpatialTransformRotationX, SpatialTransformRotationZ));
+	CHECK_EQUAL (SpatialTransformGeneral, CombineSpatialTransformKinds (SpatialTransformGeneral, SpatialTransformTranslation));
+}
+
+TEST(TestSpatialTransformKindApply) {
+	std::vector<SpatialTransform> transforms = CreateKindTestTransforms();
+	SpatialVector v (1.1, -2.2, 3.3, -0.4, 0.5, 1.6);
+
+	for (unsigned int i = 0; i < transforms.size(); i++) {
+		const SpatialTransform &X = transforms[i];
+		SpatialTransformKind kind = CalcSpatialTransformKind (X);
+
+		SpatialVector X_v = X.apply (v);
+		SpatialVector X_v_kind = X.apply (v, kind);
+		CHECK_ARRAY_CLOSE (X_v.data(), X_v_kind.data(), 6, TEST_PREC);
+
+		SpatialVector X_T_v = X.applyTranspose (v);
+		SpatialVector X_T_v_kind = X.applyTranspose (v, kind);
+		CHECK_ARRAY_CLOSE (X_T_v.data(), X_T_v_kind.data(), 6, TEST_PREC);
+	}
+}
+
+TEST(TestSpatialTransformKindMultiply) {
+	std::vector<SpatialTransform> transforms = CreateKindTestTransforms();
+
+	for (unsigned int i = 0; i < transforms.size(); i++) {
+		for (unsigned int j = 0; j < transforms.size(); j++) {
+			const SpatialTransform &X1 = transforms[i];
+			const SpatialTransform &X2 = transforms[j];
+			SpatialTransformKind kind1 = CalcSpatialTransformKind (X1);
+			SpatialTransformKind kind2 = CalcSpatialTransformKind (X2);
+
+			SpatialTransform X_generic = X1 * X2;
+			SpatialTransform X_kind;
+			X1.multiply (kind1, X2, kind2, X_kind);
+
+			CHECK_ARRAY_CLOSE (X_generic.E.data(), X_kind.E.data(), 9, TEST_PREC);
+			CHECK_ARRAY_CLOSE (X_generic.r.data(), X_kind.r.data(), 3, TEST_PREC);
+
+			// the combined kind has to describe the product exactly
+			SpatialTransformKind kind = CombineSpatialTransformKinds (kind1, kind2);
+			if (kind != SpatialTransformGeneral) {
+				CHECK_EQUAL (kind, CalcSpatialTransformKind (X_kind));
+			}
+
+			// a general kind is always valid
+			X1.multiply (SpatialTransformGeneral, X2, SpatialTransformGeneral, X_kind);
+			CHECK_ARRAY_CLOSE (X_generic.E.data(), X_kind.E.data(), 9, TEST_PREC);
+			CHECK_ARRAY_CLOSE (X_generic.r.data(), X_kind.r.data(), 3, TEST_PREC);
+		}
+	}
+}
+
 #ifdef USE_SLOW_SPATIAL_ALGEBRA
 TEST(TestSpatialLinSolve) {
 	SpatialVector b (1, 2, 0, 1, 1, 1);